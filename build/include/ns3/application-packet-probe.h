@@ -0,0 +1 @@
+#include "/root/repo/src/applications/model/application-packet-probe.h"
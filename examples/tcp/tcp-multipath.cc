@@ -0,0 +1,198 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//        (rate1, delay1)
+//    n0 ----------------- n1
+//       ----------------- 
+//        (rate2, delay2)
+//
+// A dual-homed client (n0) sends a bulk transfer to a server (n1) over a
+// multipath connection, with one subflow per link. The packet scheduler of
+// the connection and the congestion control of each subflow can be chosen
+// from the command line; with TcpLia on both subflows, their congestion
+// windows are coupled (RFC 6356).
+//
+// The data in flight on the connection is bounded by the window option: the
+// slow subflow holds back the data that the fast one delivers out of order,
+// so the window must cover the largest RTT, queueing included, for the
+// subflows to aggregate the capacity of both links.
+//
+// At the end of the simulation, the aggregate goodput and the data sent on
+// each subflow are printed.
+//
+// Sample usage:
+//   ./ns3 run 'tcp-multipath --scheduler=MpTcpSchedulerBlest --cc1=SplineCcNew --cc2=TcpCubic'
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <iomanip>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpMultipath");
+
+static uint64_t g_received = 0; //!< Bytes received by the server
+
+/**
+ * Read the data received by the server.
+ * \param s the server socket
+ */
+static void
+ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        g_received += p->GetSize();
+    }
+}
+
+/**
+ * Accept a connection.
+ * \param s the server socket
+ * \param from the address of the client
+ */
+static void
+ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&ServerRecv));
+}
+
+/**
+ * Keep the transmission buffer of the client full.
+ * \param s the client socket
+ * \param available the free space in the transmission buffer
+ */
+static void
+ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (s->GetTxAvailable() > 0)
+    {
+        if (s->Send(Create<Packet>(s->GetTxAvailable())) <= 0)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Look up a TypeId by its name, without the ns3:: prefix.
+ * \param name the name of the type
+ * \return the TypeId
+ */
+static TypeId
+LookupType(const std::string& name)
+{
+    TypeId tid;
+    NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe("ns3::" + name, &tid),
+                        "TypeId ns3::" << name << " not found");
+    return tid;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scheduler = "MpTcpSchedulerMinRtt";
+    std::string cc1 = "TcpLia";
+    std::string cc2 = "TcpLia";
+    std::string rate1 = "10Mbps";
+    std::string rate2 = "5Mbps";
+    Time delay1 = MilliSeconds(5);
+    Time delay2 = MilliSeconds(25);
+    uint32_t window = 1 << 20;
+    Time duration = Seconds(10);
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scheduler",
+                 "Packet scheduler: MpTcpSchedulerMinRtt, MpTcpSchedulerRoundRobin, "
+                 "MpTcpSchedulerBlest",
+                 scheduler);
+    cmd.AddValue("cc1", "Congestion control of the first subflow", cc1);
+    cmd.AddValue("cc2", "Congestion control of the second subflow", cc2);
+    cmd.AddValue("rate1", "Data rate of the first link", rate1);
+    cmd.AddValue("rate2", "Data rate of the second link", rate2);
+    cmd.AddValue("delay1", "One-way delay of the first link", delay1);
+    cmd.AddValue("delay2", "One-way delay of the second link", delay2);
+    cmd.AddValue("window", "Data in flight on the connection, across the subflows", window);
+    cmd.AddValue("duration", "Duration of the transfer", duration);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(rate1));
+    p2p.SetChannelAttribute("Delay", TimeValue(delay1));
+    NetDeviceContainer devices1 = p2p.Install(nodes);
+    p2p.SetDeviceAttribute("DataRate", StringValue(rate2));
+    p2p.SetChannelAttribute("Delay", TimeValue(delay2));
+    NetDeviceContainer devices2 = p2p.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces1 = ipv4.Assign(devices1);
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces2 = ipv4.Assign(devices2);
+
+    uint16_t port = 50000;
+    Ptr<MpTcpSocket> server = CreateObject<MpTcpSocket>();
+    server->SetNode(nodes.Get(1));
+    server->SetAttribute("SchedulerType", TypeIdValue(LookupType(scheduler)));
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&ServerAccept));
+
+    Ptr<MpTcpSocket> client = CreateObject<MpTcpSocket>();
+    client->SetNode(nodes.Get(0));
+    client->SetAttribute("SchedulerType", TypeIdValue(LookupType(scheduler)));
+    client->SetAttribute("DataWindow", UintegerValue(window));
+    client->SetAttribute("SndBufSize", UintegerValue(window));
+    Ptr<MpTcpSubflow> subflow1 =
+        client->AddSubflow(InetSocketAddress(interfaces1.GetAddress(0)),
+                           InetSocketAddress(interfaces1.GetAddress(1), port),
+                           LookupType(cc1));
+    Ptr<MpTcpSubflow> subflow2 =
+        client->AddSubflow(InetSocketAddress(interfaces2.GetAddress(0)),
+                           InetSocketAddress(interfaces2.GetAddress(1), port),
+                           LookupType(cc2));
+    client->SetSendCallback(MakeCallback(&ClientSend));
+    Simulator::Schedule(Seconds(1),
+                        &Socket::Connect,
+                        client,
+                        InetSocketAddress(interfaces1.GetAddress(1), port));
+
+    Simulator::Stop(Seconds(1) + duration);
+    Simulator::Run();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Scheduler " << scheduler << ", subflows " << cc1 << " and " << cc2 << std::endl;
+    std::cout << "Aggregate goodput: " << g_received * 8 / duration.GetSeconds() / 1e6 << " Mbps"
+              << std::endl;
+    std::cout << "Subflow 1 (" << rate1 << ", " << delay1.As(Time::MS)
+              << "): " << subflow1->GetDataSent() << " bytes" << std::endl;
+    std::cout << "Subflow 2 (" << rate2 << ", " << delay2.As(Time::MS)
+              << "): " << subflow2->GetDataSent() << " bytes" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
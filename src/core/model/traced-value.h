@@ -227,6 +227,15 @@ class TracedValue
         m_cb.Disconnect(cb, path);
     }
 
+    /**
+     * \brief Checks if no Callback is connected.
+     * \return true if no Callback is connected.
+     */
+    bool IsEmpty() const
+    {
+        return m_cb.IsEmpty();
+    }
+
     /**
      * Set the value of the underlying variable.
      *
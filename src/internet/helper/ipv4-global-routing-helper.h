@@ -87,6 +87,14 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * If the GlobalRoutingIncremental global value was set when the routes
+     * were populated, the shortest path trees of the routers are kept, and
+     * only the routes affected by the changes of the topology are updated.
+     * The routes updated are moved to the end of the routing tables, and the
+     * equal-cost routes to a destination are listed in the same order as after
+     * a full computation.
+     *
+     * \see GlobalRouteManager::RecomputeRoutes
      */
     static void RecomputeRoutingTables();
 };
@@ -60,6 +60,11 @@ void
 NeighborCacheHelper::PopulateNeighborCache(Ptr<Channel> channel) const
 {
     NS_LOG_FUNCTION(this << channel);
+    if (m_sharedNeighborTable)
+    {
+        PopulateNeighborTable(channel);
+        return;
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> netDevice = channel->GetDevice(i);
@@ -125,6 +130,89 @@ NeighborCacheHelper::PopulateNeighborCache(Ptr<Channel> channel) const
     }
 }
 
+void
+NeighborCacheHelper::PopulateNeighborTable(Ptr<Channel> channel) const
+{
+    NS_LOG_FUNCTION(this << channel);
+    // The tables are owned by the channel, so that all the helpers share them
+    Ptr<ArpCache> arpTable = channel->GetObject<ArpCache>();
+    if (!arpTable)
+    {
+        arpTable = CreateObject<ArpCache>();
+        channel->AggregateObject(arpTable);
+    }
+    Ptr<NdiscCache> ndiscTable = channel->GetObject<NdiscCache>();
+    if (!ndiscTable)
+    {
+        ndiscTable = CreateObject<NdiscCache>();
+        channel->AggregateObject(ndiscTable);
+    }
+
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> netDevice = channel->GetDevice(i);
+        Ptr<Node> node = netDevice->GetNode();
+
+        Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+        int32_t ipv4InterfaceIndex = ipv4 ? ipv4->GetInterfaceForDevice(netDevice) : -1;
+        if (ipv4InterfaceIndex != -1)
+        {
+            Ptr<Ipv4Interface> ipv4Interface = ipv4->GetInterface(ipv4InterfaceIndex);
+            if (m_dynamicNeighborCache)
+            {
+                ipv4Interface->RemoveAddressCallback(
+                    MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved, this));
+                if (m_globalNeighborCache)
+                {
+                    ipv4Interface->AddAddressCallback(
+                        MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressAdded, this));
+                }
+            }
+            for (uint32_t n = 0; n < ipv4Interface->GetNAddresses(); ++n)
+            {
+                AddEntry(arpTable,
+                         ipv4Interface->GetAddress(n).GetLocal(),
+                         netDevice->GetAddress());
+            }
+            Ptr<ArpCache> arpCache = ipv4Interface->GetArpCache();
+            if (arpCache)
+            {
+                arpCache->SetNeighborTable(arpTable);
+            }
+        }
+
+        Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol>();
+        int32_t ipv6InterfaceIndex = ipv6 ? ipv6->GetInterfaceForDevice(netDevice) : -1;
+        if (ipv6InterfaceIndex != -1)
+        {
+            Ptr<Ipv6Interface> ipv6Interface = ipv6->GetInterface(ipv6InterfaceIndex);
+            if (m_dynamicNeighborCache)
+            {
+                ipv6Interface->RemoveAddressCallback(
+                    MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved, this));
+                if (m_globalNeighborCache)
+                {
+                    ipv6Interface->AddAddressCallback(
+                        MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressAdded, this));
+                }
+            }
+            for (uint32_t n = 0; n < ipv6Interface->GetNAddresses(); ++n)
+            {
+                Ipv6InterfaceAddress ifAddr = ipv6Interface->GetAddress(n);
+                if (ifAddr.GetScope() != Ipv6InterfaceAddress::HOST)
+                {
+                    AddEntry(ndiscTable, ifAddr.GetAddress(), netDevice->GetAddress());
+                }
+            }
+            Ptr<NdiscCache> ndiscCache = ipv6Interface->GetNdiscCache();
+            if (ndiscCache)
+            {
+                ndiscCache->SetNeighborTable(ndiscTable);
+            }
+        }
+    }
+}
+
 void
 NeighborCacheHelper::PopulateNeighborCache(const NetDeviceContainer& c) const
 {
@@ -367,14 +455,7 @@ NeighborCacheHelper::AddEntry(Ptr<Ipv4Interface> netDeviceInterface,
             "ArpCache doesn't exist, might be a point-to-point NetDevice without ArpCache");
         return;
     }
-    ArpCache::Entry* entry = arpCache->Lookup(ipv4Address);
-    if (!entry)
-    {
-        NS_LOG_FUNCTION("ADD an ARP entry");
-        entry = arpCache->Add(ipv4Address);
-    }
-    entry->SetMacAddress(macAddress);
-    entry->MarkAutoGenerated();
+    AddEntry(arpCache, ipv4Address, macAddress);
 }
 
 void
@@ -390,6 +471,29 @@ NeighborCacheHelper::AddEntry(Ptr<Ipv6Interface> netDeviceInterface,
             "NdiscCache doesn't exist, might be a point-to-point NetDevice without NdiscCache");
         return;
     }
+    AddEntry(ndiscCache, ipv6Address, macAddress);
+}
+
+void
+NeighborCacheHelper::AddEntry(Ptr<ArpCache> arpCache,
+                              Ipv4Address ipv4Address,
+                              Address macAddress) const
+{
+    ArpCache::Entry* entry = arpCache->Lookup(ipv4Address);
+    if (!entry)
+    {
+        NS_LOG_FUNCTION("ADD an ARP entry");
+        entry = arpCache->Add(ipv4Address);
+    }
+    entry->SetMacAddress(macAddress);
+    entry->MarkAutoGenerated();
+}
+
+void
+NeighborCacheHelper::AddEntry(Ptr<NdiscCache> ndiscCache,
+                              Ipv6Address ipv6Address,
+                              Address macAddress) const
+{
     NdiscCache::Entry* entry = ndiscCache->Lookup(ipv6Address);
     if (!entry)
     {
@@ -436,6 +540,22 @@ NeighborCacheHelper::FlushAutoGenerated() const
             }
         }
     }
+    for (uint32_t i = 0; i < ChannelList::GetNChannels(); ++i)
+    {
+        Ptr<Channel> channel = ChannelList::GetChannel(i);
+        Ptr<ArpCache> arpTable = channel->GetObject<ArpCache>();
+        if (arpTable)
+        {
+            NS_LOG_FUNCTION("Remove the shared ARP entries");
+            arpTable->RemoveAutoGeneratedEntries();
+        }
+        Ptr<NdiscCache> ndiscTable = channel->GetObject<NdiscCache>();
+        if (ndiscTable)
+        {
+            NS_LOG_FUNCTION("Remove the shared NDISC entries");
+            ndiscTable->RemoveAutoGeneratedEntries();
+        }
+    }
 }
 
 void
@@ -445,6 +565,15 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved(const Ptr<Ipv4Interface> in
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
+    Ptr<ArpCache> arpTable = channel->GetObject<ArpCache>();
+    if (arpTable)
+    {
+        ArpCache::Entry* entry = arpTable->Lookup(ifAddr.GetLocal());
+        if (entry)
+        {
+            arpTable->Remove(entry);
+        }
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
@@ -477,6 +606,12 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressAdded(const Ptr<Ipv4Interface> inte
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
+    Ptr<ArpCache> arpTable = channel->GetObject<ArpCache>();
+    if (arpTable)
+    {
+        AddEntry(arpTable, ifAddr.GetLocal(), netDevice->GetAddress());
+        return;
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
@@ -511,6 +646,15 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved(const Ptr<Ipv6Interface> in
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
+    Ptr<NdiscCache> ndiscTable = channel->GetObject<NdiscCache>();
+    if (ndiscTable)
+    {
+        NdiscCache::Entry* entry = ndiscTable->Lookup(ifAddr.GetAddress());
+        if (entry)
+        {
+            ndiscTable->Remove(entry);
+        }
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
@@ -543,6 +687,15 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressAdded(const Ptr<Ipv6Interface> inte
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
+    Ptr<NdiscCache> ndiscTable = channel->GetObject<NdiscCache>();
+    if (ndiscTable)
+    {
+        if (ifAddr.GetScope() != Ipv6InterfaceAddress::HOST)
+        {
+            AddEntry(ndiscTable, ifAddr.GetAddress(), netDevice->GetAddress());
+        }
+        return;
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
@@ -577,4 +730,11 @@ NeighborCacheHelper::SetDynamicNeighborCache(bool enable)
     m_dynamicNeighborCache = enable;
 }
 
+void
+NeighborCacheHelper::SetSharedNeighborTable(bool enable)
+{
+    NS_LOG_FUNCTION(this << enable);
+    m_sharedNeighborTable = enable;
+}
+
 } // namespace ns3
@@ -104,6 +104,18 @@ class NeighborCacheHelper
      */
     void SetDynamicNeighborCache(bool enable);
 
+    /**
+     * \brief Enable/disable the neighbor tables shared by the caches of a channel.
+     * When enabled, PopulateNeighborCache() and PopulateNeighborCache(Ptr<Channel>)
+     * aggregate to each channel an ARP and a NDISC table holding one auto-generated
+     * entry per address of the devices attached to it, whatever their subnet, and
+     * the caches of these devices consult the tables before their own entries.
+     * The memory and setup time grow linearly with the number of devices, instead
+     * of quadratically. The other scopes keep populating the caches themselves.
+     * \param enable enable state
+     */
+    void SetSharedNeighborTable(bool enable);
+
   private:
     /**
      * \brief Populate neighbor ARP entries for given IPv4 interface.
@@ -121,6 +133,12 @@ class NeighborCacheHelper
     void PopulateNeighborEntriesIpv6(Ptr<Ipv6Interface> ipv6Interface,
                                      Ptr<Ipv6Interface> neighborDeviceInterface) const;
 
+    /**
+     * \brief Populate the neighbor tables shared by the caches of a channel.
+     * \param channel the Channel to process
+     */
+    void PopulateNeighborTable(Ptr<Channel> channel) const;
+
     /**
      * \brief Add an auto_generated entry to the ARP cache of an interface.
      * \param netDeviceInterface the Ipv4Interface that ARP cache belongs to
@@ -141,6 +159,22 @@ class NeighborCacheHelper
                   Ipv6Address ipv6Address,
                   Address macAddress) const;
 
+    /**
+     * \brief Add an auto_generated entry to an ARP cache.
+     * \param arpCache the ARP cache
+     * \param ipv4Address the IPv4 address will be added to the cache.
+     * \param macAddress the MAC address will be added to the cache.
+     */
+    void AddEntry(Ptr<ArpCache> arpCache, Ipv4Address ipv4Address, Address macAddress) const;
+
+    /**
+     * \brief Add an auto_generated entry to a NDISC cache.
+     * \param ndiscCache the NDISC cache
+     * \param ipv6Address the IPv6 address will be added to the cache.
+     * \param macAddress the MAC address will be added to the cache.
+     */
+    void AddEntry(Ptr<NdiscCache> ndiscCache, Ipv6Address ipv6Address, Address macAddress) const;
+
     /**
      * \brief Update neighbor caches when an address is removed from a Ipv4Interface with auto
      * generated neighbor cache.
@@ -182,6 +216,9 @@ class NeighborCacheHelper
 
     bool m_dynamicNeighborCache{
         false}; //!< flag will set true if dynamic neighbor cache is enabled.
+
+    bool m_sharedNeighborTable{
+        false}; //!< flag will set true if the shared neighbor tables are enabled.
 };
 
 } // namespace ns3
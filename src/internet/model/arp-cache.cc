@@ -30,6 +30,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -102,6 +104,7 @@ ArpCache::DoDispose()
     Flush();
     m_device = nullptr;
     m_interface = nullptr;
+    m_neighborTable = nullptr;
     if (!m_waitReplyTimer.IsRunning())
     {
         m_waitReplyTimer.Cancel();
@@ -131,6 +134,21 @@ ArpCache::GetInterface() const
     return m_interface;
 }
 
+void
+ArpCache::SetNeighborTable(Ptr<ArpCache> table)
+{
+    NS_LOG_FUNCTION(this << table);
+    NS_ASSERT_MSG(table != this, "An ARP cache cannot be its own neighbor table");
+    m_neighborTable = table;
+}
+
+Ptr<ArpCache>
+ArpCache::GetNeighborTable() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_neighborTable;
+}
+
 void
 ArpCache::SetAliveTimeout(Time aliveTimeout)
 {
@@ -199,37 +217,43 @@ ArpCache::HandleWaitReplyTimeout()
     NS_LOG_FUNCTION(this);
     ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // Only the entries marked WAIT_REPLY are visited, in the order of their
+    // addresses; those that changed state since are forgotten
+    for (auto i = m_waitReplyEntries.begin(); i != m_waitReplyEntries.end();)
     {
-        entry = (*i).second;
-        if (entry != nullptr && entry->IsWaitReply())
+        entry = Lookup(*i);
+        if (entry == nullptr || !entry->IsWaitReply())
         {
-            if (entry->GetRetries() < m_maxRetries)
-            {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- retransmitting arp request since retries = "
-                                     << entry->GetRetries());
-                m_arpRequestCallback(this, entry->GetIpv4Address());
-                restartWaitReplyTimer = true;
-                entry->IncrementRetries();
-            }
-            else
+            i = m_waitReplyEntries.erase(i);
+            continue;
+        }
+        if (entry->GetRetries() < m_maxRetries)
+        {
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- retransmitting arp request since retries = "
+                                 << entry->GetRetries());
+            m_arpRequestCallback(this, entry->GetIpv4Address());
+            restartWaitReplyTimer = true;
+            entry->IncrementRetries();
+            i++;
+        }
+        else
+        {
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- drop since max retries exceeded: "
+                                 << entry->GetRetries());
+            entry->MarkDead();
+            entry->ClearRetries();
+            i = m_waitReplyEntries.erase(i);
+            Ipv4PayloadHeaderPair pending = entry->DequeuePending();
+            while (pending.first)
             {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- drop since max retries exceeded: "
-                                     << entry->GetRetries());
-                entry->MarkDead();
-                entry->ClearRetries();
-                Ipv4PayloadHeaderPair pending = entry->DequeuePending();
-                while (pending.first)
-                {
-                    // add the Ipv4 header for tracing purposes
-                    pending.first->AddHeader(pending.second);
-                    m_dropTrace(pending.first);
-                    pending = entry->DequeuePending();
-                }
+                // add the Ipv4 header for tracing purposes
+                pending.first->AddHeader(pending.second);
+                m_dropTrace(pending.first);
+                pending = entry->DequeuePending();
             }
         }
     }
@@ -250,6 +274,8 @@ ArpCache::Flush()
         delete (*i).second;
     }
     m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
+    m_inverseIndex.clear();
+    m_waitReplyEntries.clear();
     if (m_waitReplyTimer.IsRunning())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
@@ -264,7 +290,13 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // Print the entries in the order of their addresses
+    std::vector<std::pair<Ipv4Address, ArpCache::Entry*>> entries(m_arpCache.begin(),
+                                                                   m_arpCache.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -311,8 +343,9 @@ ArpCache::RemoveAutoGeneratedEntries()
         if (i->second->IsAutoGenerated())
         {
             i->second->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+            UnindexMacAddress(i->second, i->second->GetMacAddress());
             delete i->second;
-            m_arpCache.erase(i++);
+            i = m_arpCache.erase(i);
             continue;
         }
         i++;
@@ -325,13 +358,10 @@ ArpCache::LookupInverse(Address to)
     NS_LOG_FUNCTION(this << to);
 
     std::list<ArpCache::Entry*> entryList;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    auto it = m_inverseIndex.find(to);
+    if (it != m_inverseIndex.end())
     {
-        ArpCache::Entry* entry = (*i).second;
-        if (entry->GetMacAddress() == to)
-        {
-            entryList.push_back(entry);
-        }
+        entryList.insert(entryList.end(), it->second.begin(), it->second.end());
     }
     return entryList;
 }
@@ -357,6 +387,7 @@ ArpCache::Add(Ipv4Address to)
     auto entry = new ArpCache::Entry(this);
     m_arpCache[to] = entry;
     entry->SetIpv4Address(to);
+    ReindexMacAddress(entry, Address());
     return entry;
 }
 
@@ -365,17 +396,56 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    auto i = m_arpCache.find(entry->GetIpv4Address());
+    if (i != m_arpCache.end() && i->second == entry)
+    {
+        m_arpCache.erase(i);
+        UnindexMacAddress(entry, entry->GetMacAddress());
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        delete entry;
+        return;
+    }
+    NS_LOG_WARN("Entry not found in this ARP Cache");
+}
+
+void
+ArpCache::ReindexMacAddress(ArpCache::Entry* entry, const Address& previous)
+{
+    NS_LOG_FUNCTION(this << entry << previous);
+    UnindexMacAddress(entry, previous);
+    if (entry->GetMacAddress().IsInvalid() ||
+        m_arpCache.find(entry->GetIpv4Address()) == m_arpCache.end())
     {
-        if ((*i).second == entry)
+        return; // no MAC address yet, or not in the cache
+    }
+    std::vector<ArpCache::Entry*>& entries = m_inverseIndex[entry->GetMacAddress()];
+    auto position = std::lower_bound(entries.begin(),
+                                     entries.end(),
+                                     entry,
+                                     [](ArpCache::Entry* a, ArpCache::Entry* b) {
+                                         return a->GetIpv4Address() < b->GetIpv4Address();
+                                     });
+    entries.insert(position, entry);
+}
+
+void
+ArpCache::UnindexMacAddress(ArpCache::Entry* entry, const Address& mac)
+{
+    NS_LOG_FUNCTION(this << entry << mac);
+    auto it = m_inverseIndex.find(mac);
+    if (it == m_inverseIndex.end())
+    {
+        return;
+    }
+    auto position = std::find(it->second.begin(), it->second.end(), entry);
+    if (position != it->second.end())
+    {
+        it->second.erase(position);
+        if (it->second.empty())
         {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
+            m_inverseIndex.erase(it);
         }
     }
-    NS_LOG_WARN("Entry not found in this ARP Cache");
 }
 
 ArpCache::Entry::Entry(ArpCache* arp)
@@ -436,7 +506,9 @@ ArpCache::Entry::MarkAlive(Address macAddress)
 {
     NS_LOG_FUNCTION(this << macAddress);
     NS_ASSERT(m_state == WAIT_REPLY);
+    Address previous = m_macAddress;
     m_macAddress = macAddress;
+    m_arp->ReindexMacAddress(this, previous);
     m_state = ALIVE;
     ClearRetries();
     UpdateSeen();
@@ -492,6 +564,7 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     m_state = WAIT_REPLY;
     m_pending.push_back(waiting);
     UpdateSeen();
+    m_arp->m_waitReplyEntries.insert(m_ipv4Address);
     m_arp->StartWaitReplyTimer();
 }
 
@@ -506,7 +579,9 @@ void
 ArpCache::Entry::SetMacAddress(Address macAddress)
 {
     NS_LOG_FUNCTION(this);
+    Address previous = m_macAddress;
     m_macAddress = macAddress;
+    m_arp->ReindexMacAddress(this, previous);
 }
 
 Ipv4Address
@@ -32,8 +32,10 @@
 #include "ns3/traced-callback.h"
 
 #include <list>
-#include <map>
+#include <set>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -83,6 +85,21 @@ class ArpCache : public Object
      * \return the Ipv4Interface that this ARP cache is associated with
      */
     Ptr<Ipv4Interface> GetInterface() const;
+    /**
+     * \brief Set the neighbor table shared by the ARP caches of a channel
+     *
+     * The STATIC_AUTOGENERATED entries of the table are consulted before the
+     * entries of this cache when an address is resolved.  The table is not
+     * modified by the ARP protocol.
+     *
+     * \param table the shared neighbor table, or nullptr
+     */
+    void SetNeighborTable(Ptr<ArpCache> table);
+    /**
+     * \brief Returns the neighbor table shared by the ARP caches of a channel
+     * \return the shared neighbor table, or nullptr
+     */
+    Ptr<ArpCache> GetNeighborTable() const;
 
     /**
      * \brief Set the time the entry will be in ALIVE state (unless refreshed)
@@ -321,16 +338,21 @@ class ArpCache : public Object
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash>::iterator CacheI;
+    /**
+     * \brief Index of the ARP Cache entries by MAC address, each list sorted by IPv4 address
+     */
+    typedef std::unordered_map<Address, std::vector<ArpCache::Entry*>, AddressHash> InverseIndex;
 
     void DoDispose() override;
 
     Ptr<NetDevice> m_device;        //!< NetDevice associated with the cache
     Ptr<Ipv4Interface> m_interface; //!< Ipv4Interface associated with the cache
+    Ptr<ArpCache> m_neighborTable;  //!< neighbor table shared by the caches of a channel
     Time m_aliveTimeout;            //!< cache alive state timeout
     Time m_deadTimeout;             //!< cache dead state timeout
     Time m_waitReplyTimeout;        //!< cache reply state timeout
@@ -345,8 +367,27 @@ class ArpCache : public Object
      * If there are no Arp requests pending, this event is not scheduled.
      */
     void HandleWaitReplyTimeout();
+
+    /**
+     * \brief Move an entry in the index by MAC address, after its MAC address changed.
+     * \param entry the entry
+     * \param previous the previous MAC address of the entry
+     */
+    void ReindexMacAddress(ArpCache::Entry* entry, const Address& previous);
+
+    /**
+     * \brief Remove an entry from the index by MAC address.
+     * \param entry the entry
+     * \param mac the MAC address of the entry in the index
+     */
+    void UnindexMacAddress(ArpCache::Entry* entry, const Address& mac);
+
     uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
     Cache m_arpCache;            //!< the ARP cache
+    InverseIndex m_inverseIndex; //!< the ARP cache entries, by MAC address
+    /// The addresses of the entries marked WAIT_REPLY, some of which may have
+    /// changed state since, in the order the retries are sent
+    std::set<Ipv4Address> m_waitReplyEntries;
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
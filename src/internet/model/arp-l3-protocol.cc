@@ -293,6 +293,18 @@ ArpL3Protocol::Lookup(Ptr<Packet> packet,
                       Address* hardwareDestination)
 {
     NS_LOG_FUNCTION(this << packet << destination << device << cache << hardwareDestination);
+    Ptr<ArpCache> table = cache->GetNeighborTable();
+    if (table)
+    {
+        ArpCache::Entry* entry = table->Lookup(destination);
+        if (entry != nullptr && entry->IsAutoGenerated())
+        {
+            NS_LOG_LOGIC("node=" << m_node->GetId() << ", shared entry for " << destination
+                                 << " valid -- send");
+            *hardwareDestination = entry->GetMacAddress();
+            return true;
+        }
+    }
     ArpCache::Entry* entry = cache->Lookup(destination);
     if (entry != nullptr)
     {
@@ -58,13 +58,14 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    std::vector<CandidateQueue::Candidate> list = q.m_candidates;
+    std::sort(list.begin(), list.end(), &CandidateQueue::Precedes);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
     for (auto iter = list.begin(); iter != list.end(); iter++)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << iter->vertex->GetVertexId() << ", " << iter->vertex->GetDistanceFromRoot()
+           << ", " << iter->vertex->GetVertexType() << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
@@ -99,11 +100,9 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    auto i = std::upper_bound(m_candidates.begin(),
-                              m_candidates.end(),
-                              vNew,
-                              &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_candidates.push_back({vNew, m_order++});
+    Place(m_candidates.size() - 1, m_candidates.back());
+    SiftUp(m_candidates.size() - 1);
 }
 
 SPFVertex*
@@ -115,8 +114,19 @@ CandidateQueue::Pop()
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    SPFVertex* v = m_candidates.front().vertex;
+    auto it = m_index.find(v->GetVertexId());
+    if (it != m_index.end() && it->second == 0)
+    {
+        m_index.erase(it);
+    }
+    Candidate last = m_candidates.back();
+    m_candidates.pop_back();
+    if (!m_candidates.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
     return v;
 }
 
@@ -129,7 +139,7 @@ CandidateQueue::Top() const
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_candidates.front().vertex;
 }
 
 bool
@@ -150,18 +160,14 @@ SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    auto i = m_candidates.begin();
-
-    for (; i != m_candidates.end(); i++)
+    auto it = m_index.find(addr);
+    if (it == m_index.end() || it->second >= m_candidates.size())
     {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
-        {
-            return v;
-        }
+        return nullptr;
     }
 
-    return nullptr;
+    SPFVertex* v = m_candidates[it->second].vertex;
+    return v->GetVertexId() == addr ? v : nullptr;
 }
 
 void
@@ -169,11 +175,92 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    for (uint32_t i = m_candidates.size() / 2; i-- > 0;)
+    {
+        SiftDown(i);
+    }
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
 
+void
+CandidateQueue::Update(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+
+    auto it = m_index.find(v->GetVertexId());
+    NS_ASSERT_MSG(it != m_index.end() && m_candidates[it->second].vertex == v,
+                  "Vertex " << v->GetVertexId() << " not in the CandidateQueue");
+    uint32_t pos = it->second;
+    m_candidates[pos].order = m_order++;
+    SiftUp(pos);
+    SiftDown(it->second);
+}
+
+void
+CandidateQueue::Place(uint32_t pos, const Candidate& c)
+{
+    m_candidates[pos] = c;
+    m_index[c.vertex->GetVertexId()] = pos;
+}
+
+void
+CandidateQueue::SiftUp(uint32_t pos)
+{
+    Candidate c = m_candidates[pos];
+    while (pos > 0)
+    {
+        uint32_t parent = (pos - 1) / 2;
+        if (!Precedes(c, m_candidates[parent]))
+        {
+            break;
+        }
+        Place(pos, m_candidates[parent]);
+        pos = parent;
+    }
+    Place(pos, c);
+}
+
+void
+CandidateQueue::SiftDown(uint32_t pos)
+{
+    Candidate c = m_candidates[pos];
+    uint32_t size = m_candidates.size();
+    for (;;)
+    {
+        uint32_t child = 2 * pos + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && Precedes(m_candidates[child + 1], m_candidates[child]))
+        {
+            child++;
+        }
+        if (!Precedes(m_candidates[child], c))
+        {
+            break;
+        }
+        Place(pos, m_candidates[child]);
+        pos = child;
+    }
+    Place(pos, c);
+}
+
+bool
+CandidateQueue::Precedes(const Candidate& c1, const Candidate& c2)
+{
+    if (CompareSPFVertex(c1.vertex, c2.vertex))
+    {
+        return true;
+    }
+    if (CompareSPFVertex(c2.vertex, c1.vertex))
+    {
+        return false;
+    }
+    return c1.order < c2.order;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,8 +22,9 @@
 
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -48,6 +49,13 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple
  * enhanced priority queue.
+ *
+ * The queue is a binary heap indexed by vertex ID: Push () and Pop () take
+ * logarithmic time, Find () constant time, and Update () moves a single
+ * vertex whose distance decreased.  Vertices of equal distance and type are
+ * popped in the order they were pushed or last updated, as they were by the
+ * sorted list this queue used to be.  A vertex ID is expected to be in the
+ * queue at most once, as in the SPF calculation.
  */
 class CandidateQueue
 {
@@ -153,12 +161,25 @@ class CandidateQueue
      * increasing distance.
      *
      * This method is provided in case the values of m_distanceFromRoot change
-     * during the routing calculations.
+     * during the routing calculations.  When a single vertex changed, Update ()
+     * is cheaper.
      *
      * @see SPFVertex
      */
     void Reorder();
 
+    /**
+     * @brief Move a vertex of the Candidate Queue according to the priority
+     * scheme, after its m_distanceFromRoot changed.
+     *
+     * The vertex is ordered after the other vertices of equal distance and
+     * type, as if it had just been pushed.
+     *
+     * @see SPFVertex
+     * @param v The Shortest Path First Vertex, which must be in the queue.
+     */
+    void Update(SPFVertex* v);
+
   private:
     /**
      * \brief return true if v1 < v2
@@ -173,8 +194,44 @@ class CandidateQueue
      */
     static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    /// A vertex in the heap
+    struct Candidate
+    {
+        SPFVertex* vertex; //!< the vertex
+        uint64_t order;    //!< order of the vertex among the vertices of equal priority
+    };
+
+    /**
+     * \brief return true if c1 should be popped before c2
+     * \param c1 first operand
+     * \param c2 second operand
+     * \return True if c1 should be popped before c2; false otherwise
+     */
+    static bool Precedes(const Candidate& c1, const Candidate& c2);
+
+    /**
+     * \brief Store a candidate at a position of the heap
+     * \param pos the position
+     * \param c the candidate
+     */
+    void Place(uint32_t pos, const Candidate& c);
+
+    /**
+     * \brief Move a candidate toward the top of the heap
+     * \param pos the position of the candidate
+     */
+    void SiftUp(uint32_t pos);
+
+    /**
+     * \brief Move a candidate toward the bottom of the heap
+     * \param pos the position of the candidate
+     */
+    void SiftDown(uint32_t pos);
+
+    std::vector<Candidate> m_candidates; //!< SPFVertex candidates, as a binary heap
+    /// Position of the candidates in the heap, by vertex ID
+    std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> m_index;
+    uint64_t m_order{0}; //!< order of the next vertex pushed or updated
 
     /**
      * \brief Stream insertion operator.
@@ -29,14 +29,24 @@
 #include "ipv4.h"
 
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <queue>
+#include <set>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,6 +55,29 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * \brief The number of threads computing the global routes.
+ */
+static GlobalValue g_globalRoutingThreads(
+    "GlobalRoutingThreads",
+    "The number of threads computing the shortest path trees of the routers "
+    "when the global routes are populated (0 for one per hardware thread)",
+    UintegerValue(1),
+    MakeUintegerChecker<uint32_t>());
+
+/**
+ * \ingroup globalrouting
+ * \brief Whether the global routes are updated incrementally.
+ */
+static GlobalValue g_globalRoutingIncremental(
+    "GlobalRoutingIncremental",
+    "Keep the shortest path trees of the routers when the global routes are "
+    "populated, so that only the routes affected by a change of the topology "
+    "are updated when they are recomputed",
+    BooleanValue(false),
+    MakeBooleanChecker());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -431,6 +464,21 @@ GlobalRouteManagerLSDB::GlobalRouteManagerLSDB()
     NS_LOG_FUNCTION(this);
 }
 
+GlobalRouteManagerLSDB::GlobalRouteManagerLSDB(const GlobalRouteManagerLSDB& lsdb)
+    : m_database(),
+      m_extdatabase()
+{
+    NS_LOG_FUNCTION(this << &lsdb);
+    for (const auto& [addr, lsa] : lsdb.m_database)
+    {
+        Insert(addr, new GlobalRoutingLSA(*lsa));
+    }
+    for (GlobalRoutingLSA* lsa : lsdb.m_extdatabase)
+    {
+        Insert(lsa->GetLinkStateId(), new GlobalRoutingLSA(*lsa));
+    }
+}
+
 GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB()
 {
     NS_LOG_FUNCTION(this);
@@ -469,9 +517,23 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        // Index the transit network link records; when several LSAs have the
+        // same link data, the one with the lowest address is found first
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto [it, inserted] = m_linkDataIndex.emplace(lr->GetLinkData(), lsa);
+            if (!inserted && addr < it->second->GetLinkStateId())
+            {
+                it->second = lsa;
+            }
+        }
     }
 }
 
@@ -489,6 +551,19 @@ GlobalRouteManagerLSDB::GetNumExtLSAs() const
     return m_extdatabase.size();
 }
 
+std::vector<GlobalRoutingLSA*>
+GlobalRouteManagerLSDB::GetLSAs() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<GlobalRoutingLSA*> lsas;
+    lsas.reserve(m_database.size());
+    for (const auto& [addr, lsa] : m_database)
+    {
+        lsas.push_back(lsa);
+    }
+    return lsas;
+}
+
 GlobalRoutingLSA*
 GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
 {
@@ -496,12 +571,10 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_database.find(addr);
+    if (i != m_database.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -511,21 +584,12 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its transit network link records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkDataIndex.find(addr);
+    if (i != m_linkDataIndex.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -561,6 +625,7 @@ GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
         delete m_lsdb;
     }
     m_lsdb = lsdb;
+    m_incremental = false;
 }
 
 void
@@ -595,6 +660,9 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         delete m_lsdb;
         m_lsdb = new GlobalRouteManagerLSDB();
     }
+    m_incremental = false;
+    m_spfTrees.clear();
+    m_vertexIndex.clear();
 }
 
 //
@@ -610,6 +678,14 @@ void
 GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 {
     NS_LOG_FUNCTION(this);
+    DiscoverLSAs(m_lsdb);
+    m_incremental = false;
+}
+
+void
+GlobalRouteManagerImpl::DiscoverLSAs(GlobalRouteManagerLSDB* lsdb)
+{
+    NS_LOG_FUNCTION(this << lsdb);
     //
     // Walk the list of nodes looking for the GlobalRouter Interface.  Nodes with
     // global router interfaces are, not too surprisingly, our routers.
@@ -650,7 +726,7 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
             //
             // Write the newly discovered link state advertisement to the database.
             //
-            m_lsdb->Insert(lsa->GetLinkStateId(), lsa);
+            lsdb->Insert(lsa->GetLinkStateId(), lsa);
         }
     }
 }
@@ -690,38 +766,972 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 //
 void
 GlobalRouteManagerImpl::InitializeRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<std::pair<Ipv4Address, Ptr<Node>>> roots = GetRoots();
+
+    UintegerValue threads;
+    g_globalRoutingThreads.GetValue(threads);
+    uint32_t nThreads = threads.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nThreads = std::min<std::size_t>(nThreads, roots.size());
+
+    NS_LOG_INFO("About to start SPF calculation with " << nThreads << " threads");
+    if (nThreads > 1)
+    {
+        SPFCalculateParallel(roots, nThreads);
+    }
+    else
+    {
+        for (const auto& [root, node] : roots)
+        {
+            SPFCalculate(root, node);
+        }
+    }
+    NS_LOG_INFO("Finished SPF calculation");
+
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+    m_incremental = incremental.Get();
+    m_spfTrees.clear();
+    if (m_incremental)
+    {
+        SPFGraph graph;
+        BuildSPFGraph(m_lsdb, graph);
+        for (const auto& [root, node] : roots)
+        {
+            SPFKeepTree(root, node, graph);
+        }
+    }
+}
+
+std::vector<std::pair<Ipv4Address, Ptr<Node>>>
+GlobalRouteManagerImpl::GetRoots() const
 {
     NS_LOG_FUNCTION(this);
     //
     // Walk the list of nodes in the system.
     //
-    NS_LOG_INFO("About to start SPF calculation");
+    std::vector<std::pair<Ipv4Address, Ptr<Node>>> roots;
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // Look for the GlobalRouter interface that indicates that the node is
-        // participating in routing.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        Ptr<Node> node = *i;
+        //
+        // Look for the GlobalRouter interface that indicates that the node is
+        // participating in routing.
+        //
+        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+
+        uint32_t systemId = Simulator::GetSystemId();
+        // Ignore nodes that are not assigned to our systemId (distributed sim)
+        if (node->GetSystemId() != systemId)
+        {
+            continue;
+        }
+
+        //
+        // if the node has a global router interface, then run the global routing
+        // algorithms.
+        //
+        if (rtr && rtr->GetNumLSAs())
+        {
+            roots.emplace_back(rtr->GetRouterId(), node);
+        }
+    }
+    return roots;
+}
+
+//
+// The SPF computation of a router only writes to the routing table of that
+// router, and to the SPF status of the LSAs.  Each thread runs the SPF
+// computations of the routers it takes from the list, on its own copy of the
+// LSDB.  The nodes are looked up before the threads start, as the node list
+// and the reference counts of the objects are not thread-safe: a thread only
+// touches the objects of the routers it computes the routes of.
+//
+void
+GlobalRouteManagerImpl::SPFCalculateParallel(
+    const std::vector<std::pair<Ipv4Address, Ptr<Node>>>& roots,
+    uint32_t nThreads)
+{
+    NS_LOG_FUNCTION(this << roots.size() << nThreads);
+
+    std::vector<std::unique_ptr<GlobalRouteManagerImpl>> workers;
+    for (uint32_t i = 0; i < nThreads; i++)
+    {
+        workers.emplace_back(new GlobalRouteManagerImpl());
+        workers.back()->DebugUseLsdb(new GlobalRouteManagerLSDB(*m_lsdb));
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> threads;
+    for (auto& worker : workers)
+    {
+        threads.emplace_back([&roots, &next, impl = worker.get()]() {
+            for (std::size_t i = next++; i < roots.size(); i = next++)
+            {
+                impl->SPFCalculate(roots[i].first, roots[i].second);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// ---------------------------------------------------------------------------
+//
+// Incremental update of the global routes
+//
+// ---------------------------------------------------------------------------
+
+/// A destination of the global routes: the address and the mask, in host order
+typedef std::pair<uint32_t, uint32_t> SPFDestination;
+
+/// The destinations of the host, network and external routes
+struct SPFDestinations
+{
+    std::set<SPFDestination> hosts;     //!< Destinations of host routes
+    std::set<SPFDestination> networks;  //!< Destinations of network routes
+    std::set<SPFDestination> externals; //!< Destinations of external routes
+};
+
+/// The vertices advertising the destinations of the routes
+struct SPFAdvertisers
+{
+    std::map<SPFDestination, std::vector<uint32_t>> hosts;     //!< Routers, by host
+    std::map<SPFDestination, std::vector<uint32_t>> networks;  //!< Vertices, by network
+    std::map<SPFDestination, std::vector<uint32_t>> externals; //!< Routers, by external network
+};
+
+/// The external destinations of an LSDB, by advertising router
+typedef std::set<std::pair<Ipv4Address, SPFDestination>> SPFExternals;
+
+/**
+ * \brief Get the destination of a network
+ * \param network the network address
+ * \param mask the network mask
+ * \return the destination
+ */
+static SPFDestination
+GetDestination(Ipv4Address network, Ipv4Mask mask)
+{
+    return {network.CombineMask(mask).Get(), mask.Get()};
+}
+
+/**
+ * \brief Check if two Link State Advertisements describe the same links
+ * \param a the first LSA
+ * \param b the second LSA
+ * \return true if the LSAs only differ by their SPF status
+ */
+static bool
+IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b)
+{
+    if (a->GetLSType() != b->GetLSType() || a->GetLinkStateId() != b->GetLinkStateId() ||
+        a->GetAdvertisingRouter() != b->GetAdvertisingRouter() ||
+        a->GetNetworkLSANetworkMask() != b->GetNetworkLSANetworkMask() ||
+        a->GetNLinkRecords() != b->GetNLinkRecords() ||
+        a->GetNAttachedRouters() != b->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->GetNLinkRecords(); i++)
+    {
+        const GlobalRoutingLinkRecord* la = a->GetLinkRecord(i);
+        const GlobalRoutingLinkRecord* lb = b->GetLinkRecord(i);
+        if (la->GetLinkType() != lb->GetLinkType() || la->GetLinkId() != lb->GetLinkId() ||
+            la->GetLinkData() != lb->GetLinkData() || la->GetMetric() != lb->GetMetric())
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < a->GetNAttachedRouters(); i++)
+    {
+        if (a->GetAttachedRouter(i) != b->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Get the external destinations of an LSDB
+ * \param lsdb the LSDB
+ * \return the external destinations, by advertising router
+ */
+static SPFExternals
+GetExternals(const GlobalRouteManagerLSDB* lsdb)
+{
+    SPFExternals externals;
+    for (uint32_t i = 0; i < lsdb->GetNumExtLSAs(); i++)
+    {
+        const GlobalRoutingLSA* lsa = lsdb->GetExtLSA(i);
+        externals.emplace(lsa->GetAdvertisingRouter(),
+                          GetDestination(lsa->GetLinkStateId(), lsa->GetNetworkLSANetworkMask()));
+    }
+    return externals;
+}
+
+/**
+ * \brief Add the destinations that a vertex advertises
+ * \param lsa the LSA of the vertex, or null
+ * \param externals the external destinations of the LSDB of the LSA
+ * \param dests the destinations to add to
+ */
+static void
+AddDestinations(const GlobalRoutingLSA* lsa,
+                const SPFExternals& externals,
+                SPFDestinations& dests)
+{
+    if (!lsa)
+    {
+        return;
+    }
+    if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+    {
+        dests.networks.insert(
+            GetDestination(lsa->GetLinkStateId(), lsa->GetNetworkLSANetworkMask()));
+        return;
+    }
+    for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+    {
+        const GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+        {
+            dests.hosts.insert(GetDestination(l->GetLinkData(), Ipv4Mask::GetOnes()));
+        }
+        else if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
+        {
+            dests.networks.insert(GetDestination(l->GetLinkId(), Ipv4Mask(l->GetLinkData().Get())));
+        }
+    }
+    Ipv4Address id = lsa->GetLinkStateId();
+    for (auto i = externals.lower_bound({id, {0, 0}}); i != externals.end() && i->first == id; i++)
+    {
+        dests.externals.insert(i->second);
+    }
+}
+
+/**
+ * \brief Sort vertices in the order of their rank in a shortest path tree
+ * \param rank the ranks of the vertices of the tree
+ * \param vertices the indexes of the vertices
+ * \return the vertices sorted, the ones not in the tree last
+ */
+static std::vector<uint32_t>
+SortByRank(const std::vector<uint32_t>& rank, std::vector<uint32_t> vertices)
+{
+    auto getRank = [&rank](uint32_t v) { return v < rank.size() ? rank[v] : SPF_INFINITY; };
+    std::stable_sort(vertices.begin(), vertices.end(), [&getRank](uint32_t a, uint32_t b) {
+        return getRank(a) < getRank(b);
+    });
+    return vertices;
+}
+
+/**
+ * \brief Remove the routes of a router to some destinations, and add them
+ * again with the next hops of its shortest path tree
+ *
+ * The routes are the ones that SPFIntraAddRouter (), SPFIntraAddTransit (),
+ * SPFIntraAddStub () and SPFAddASExternal () add, and the routes to each
+ * destination are added in the same order.
+ *
+ * \param gr the routing protocol of the router
+ * \param root the index of the router vertex
+ * \param distance the distances of the vertices from the router
+ * \param exits the index of the root exits of the vertices in exitSets
+ * \param exitSets the sets of root exits
+ * \param rank the rank of the vertices in the order the routes to networks are added
+ * \param dests the destinations
+ * \param advertisers the vertices advertising the destinations
+ */
+static void
+UpdateRoutesTo(Ptr<Ipv4GlobalRouting> gr,
+               uint32_t root,
+               const std::vector<uint32_t>& distance,
+               const std::vector<uint32_t>& exits,
+               const std::vector<std::vector<SPFVertex::NodeExit_t>>& exitSets,
+               const std::vector<uint32_t>& rank,
+               const SPFDestinations& dests,
+               const SPFAdvertisers& advertisers)
+{
+    std::vector<Ipv4Address> hosts;
+    for (const auto& dest : dests.hosts)
+    {
+        hosts.emplace_back(dest.first);
+    }
+    std::vector<std::pair<Ipv4Address, Ipv4Mask>> networks;
+    for (const auto& dest : dests.networks)
+    {
+        networks.emplace_back(Ipv4Address(dest.first), Ipv4Mask(dest.second));
+    }
+    std::vector<std::pair<Ipv4Address, Ipv4Mask>> externals;
+    for (const auto& dest : dests.externals)
+    {
+        externals.emplace_back(Ipv4Address(dest.first), Ipv4Mask(dest.second));
+    }
+    gr->RemoveRoutesTo(hosts, networks, externals);
+
+    // Call add for each exit of each vertex in the shortest path tree,
+    // but the root, that advertises one of the destinations
+    auto addRoutes = [&](const std::set<SPFDestination>& destinations,
+                         const std::map<SPFDestination, std::vector<uint32_t>>& vertices,
+                         const std::function<void(const SPFDestination&,
+                                                  const SPFVertex::NodeExit_t&)>& add) {
+        for (const auto& dest : destinations)
+        {
+            auto it = vertices.find(dest);
+            if (it == vertices.end())
+            {
+                continue;
+            }
+            for (uint32_t v : it->second)
+            {
+                if (v == root || v >= distance.size() || distance[v] == SPF_INFINITY)
+                {
+                    continue;
+                }
+                for (const auto& exit : exitSets[exits[v]])
+                {
+                    if (exit.second >= 0)
+                    {
+                        add(dest, exit);
+                    }
+                }
+            }
+        }
+    };
+    addRoutes(dests.hosts, advertisers.hosts, [gr](const auto& dest, const auto& exit) {
+        gr->AddHostRouteTo(Ipv4Address(dest.first), exit.first, exit.second);
+    });
+    // A host is advertised by one vertex, and an external destination by
+    // vertices in the order of the external LSAs, but a network by several
+    // vertices, e.g., the two ends of a point-to-point link, in rank order
+    std::map<SPFDestination, std::vector<uint32_t>> networkAdvertisers;
+    for (const auto& dest : dests.networks)
+    {
+        auto it = advertisers.networks.find(dest);
+        if (it != advertisers.networks.end())
+        {
+            networkAdvertisers.emplace(dest, SortByRank(rank, it->second));
+        }
+    }
+    addRoutes(dests.networks, networkAdvertisers, [gr](const auto& dest, const auto& exit) {
+        gr->AddNetworkRouteTo(Ipv4Address(dest.first),
+                              Ipv4Mask(dest.second),
+                              exit.first,
+                              exit.second);
+    });
+    addRoutes(dests.externals, advertisers.externals, [gr](const auto& dest, const auto& exit) {
+        gr->AddASExternalRouteTo(Ipv4Address(dest.first),
+                                 Ipv4Mask(dest.second),
+                                 exit.first,
+                                 exit.second);
+    });
+}
+
+uint32_t
+GlobalRouteManagerImpl::GetVertexIndex(Ipv4Address id)
+{
+    return m_vertexIndex.emplace(id, m_vertexIndex.size()).first->second;
+}
+
+void
+GlobalRouteManagerImpl::BuildSPFGraph(const GlobalRouteManagerLSDB* lsdb, SPFGraph& graph)
+{
+    NS_LOG_FUNCTION(this << lsdb);
+    std::vector<GlobalRoutingLSA*> lsas = lsdb->GetLSAs();
+    for (GlobalRoutingLSA* lsa : lsas)
+    {
+        GetVertexIndex(lsa->GetLinkStateId());
+    }
+    graph.lsas.assign(m_vertexIndex.size(), nullptr);
+    graph.edges.assign(m_vertexIndex.size(), {});
+    for (GlobalRoutingLSA* lsa : lsas)
+    {
+        uint32_t v = GetVertexIndex(lsa->GetLinkStateId());
+        graph.lsas[v] = lsa;
+        // The edges are the ones that SPFNext () follows, in the same order
+        if (lsa->GetLSType() == GlobalRoutingLSA::RouterLSA)
+        {
+            for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+            {
+                GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+                if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                    continue;
+                }
+                GlobalRoutingLSA* w = lsdb->GetLSA(l->GetLinkId());
+                NS_ASSERT(w);
+                graph.edges[v].push_back({GetVertexIndex(w->GetLinkStateId()), l->GetMetric(), l});
+            }
+        }
+        else if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+        {
+            for (uint32_t i = 0; i < lsa->GetNAttachedRouters(); i++)
+            {
+                GlobalRoutingLSA* w = lsdb->GetLSAByLinkData(lsa->GetAttachedRouter(i));
+                if (w)
+                {
+                    graph.edges[v].push_back({GetVertexIndex(w->GetLinkStateId()), 0, nullptr});
+                }
+            }
+        }
+    }
+}
+
+bool
+GlobalRouteManagerImpl::IsStubVertex(uint32_t root, const SPFGraph& graph) const
+{
+    NS_LOG_FUNCTION(this << root);
+    // Same test as CheckForStubNode (), without adding the default route
+    const std::vector<SPFEdge>& edges = graph.edges[root];
+    if (edges.empty())
+    {
+        return true;
+    }
+    if (edges.size() > 1 ||
+        edges[0].record->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
+    {
+        return false;
+    }
+    Ipv4Address id = graph.lsas[root]->GetLinkStateId();
+    const GlobalRoutingLSA* w = graph.lsas[edges[0].vertex];
+    for (uint32_t j = 0; j < w->GetNLinkRecords(); j++)
+    {
+        const GlobalRoutingLinkRecord* l = w->GetLinkRecord(j);
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint && l->GetLinkId() == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// This is SPFCalculate () and SPFNext () on the SPF graph, without SPFVertex
+// objects: the candidates are ordered as in the CandidateQueue, by distance,
+// network vertices first, then by order of insertion or update, and the root
+// exits are computed as in SPFNexthopCalculation ().
+//
+bool
+GlobalRouteManagerImpl::SPFCalculateTree(Ipv4Address root,
+                                         Ptr<Node> node,
+                                         const SPFGraph& graph,
+                                         SPFTree& tree)
+{
+    NS_LOG_FUNCTION(this << root << node);
+    const uint8_t rootParent = 1;  // the root is a parent of the vertex
+    const uint8_t otherParent = 2; // another vertex is a parent of the vertex
+
+    uint32_t n = graph.lsas.size();
+    uint32_t r = GetVertexIndex(root);
+    tree.stub = false;
+    tree.distance.assign(n, SPF_INFINITY);
+    tree.exits.assign(n, 0);
+    tree.exitSets.assign(1, {});
+    std::vector<GlobalRoutingLSA::SPFStatus> status(n, GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+    std::vector<uint8_t> parents(n, 0);
+    std::vector<std::vector<uint32_t>> parentLists(n);
+    std::vector<uint32_t> joined{r};
+    std::vector<uint64_t> order(n, 0);
+    uint64_t nextOrder = 0;
+    // Distance, router (after network), order and index of the candidates;
+    // the entries of the candidates updated since are skipped
+    typedef std::tuple<uint32_t, bool, uint64_t, uint32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> candidates;
+    // The vertices share the sets of root exits, which are few
+    std::map<std::vector<SPFVertex::NodeExit_t>, uint32_t> exitSetIndex{{{}, 0}};
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> exitSetUnions;
+    auto getExitSet = [&tree, &exitSetIndex](std::vector<SPFVertex::NodeExit_t> exits) {
+        auto [it, inserted] = exitSetIndex.emplace(std::move(exits), tree.exitSets.size());
+        if (inserted)
+        {
+            tree.exitSets.push_back(it->first);
+        }
+        return it->second;
+    };
+    m_spfrootIpv4 = node->GetObject<Ipv4>();
+    bool found = true;
+
+    tree.distance[r] = 0;
+    status[r] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+    for (uint32_t v = r; found;)
+    {
+        const GlobalRoutingLSA* vLsa = graph.lsas[v];
+        for (const SPFEdge& edge : graph.edges[v])
+        {
+            uint32_t w = edge.vertex;
+            uint32_t distance = tree.distance[v] + edge.cost;
+            if (status[w] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE ||
+                (status[w] == GlobalRoutingLSA::LSA_SPF_CANDIDATE && tree.distance[w] < distance))
+            {
+                continue;
+            }
+            const GlobalRoutingLSA* wLsa = graph.lsas[w];
+            uint32_t exits = 0;
+            bool replace = true;
+            if (v == r && wLsa->GetLSType() == GlobalRoutingLSA::RouterLSA)
+            {
+                // The next hop is the address of the first link of w back to the root
+                const GlobalRoutingLinkRecord* remote = nullptr;
+                for (uint32_t i = 0; i < wLsa->GetNLinkRecords() && !remote; i++)
+                {
+                    if (wLsa->GetLinkRecord(i)->GetLinkId() == root)
+                    {
+                        remote = wLsa->GetLinkRecord(i);
+                    }
+                }
+                if (!remote)
+                {
+                    found = false;
+                    break;
+                }
+                exits = getExitSet(
+                    {{remote->GetLinkData(), FindOutgoingInterfaceId(edge.record->GetLinkData())}});
+            }
+            else if (v == r)
+            {
+                exits = getExitSet({{Ipv4Address::GetZero(),
+                                     FindOutgoingInterfaceId(wLsa->GetLinkStateId(),
+                                                             wLsa->GetNetworkLSANetworkMask())}});
+            }
+            else if (vLsa->GetLSType() == GlobalRoutingLSA::NetworkLSA &&
+                     (parents[v] & rootParent))
+            {
+                // SPFCalculate () takes the first parent of the network, in the
+                // order of the vertices in memory, to tell if it is the root
+                const std::vector<SPFVertex::NodeExit_t>& vExits = tree.exitSets[tree.exits[v]];
+                if ((parents[v] & otherParent) || vExits.size() != 1)
+                {
+                    found = false;
+                    break;
+                }
+                // The next hop is the address of the first link of w to the network
+                replace = false;
+                for (uint32_t i = 0; i < wLsa->GetNLinkRecords() && !replace; i++)
+                {
+                    const GlobalRoutingLinkRecord* l = wLsa->GetLinkRecord(i);
+                    if (l->GetLinkId() == vLsa->GetLinkStateId())
+                    {
+                        exits = getExitSet({{l->GetLinkData(), vExits[0].second}});
+                        replace = true;
+                    }
+                }
+            }
+            else
+            {
+                exits = tree.exits[v];
+            }
+
+            uint8_t parent = v == r ? rootParent : otherParent;
+            if (status[w] == GlobalRoutingLSA::LSA_SPF_CANDIDATE && tree.distance[w] == distance)
+            {
+                // Equal cost multiple paths: merge the sorted sets of exits
+                uint32_t wExits = tree.exits[w];
+                auto key = std::minmax(wExits, exits);
+                auto it = exitSetUnions.find(key);
+                if (it == exitSetUnions.end())
+                {
+                    const auto& a = tree.exitSets[key.first];
+                    const auto& b = tree.exitSets[key.second];
+                    std::vector<SPFVertex::NodeExit_t> merged;
+                    std::set_union(a.begin(),
+                                   a.end(),
+                                   b.begin(),
+                                   b.end(),
+                                   std::back_inserter(merged));
+                    it = exitSetUnions.emplace(key, getExitSet(std::move(merged))).first;
+                }
+                tree.exits[w] = it->second;
+                parents[w] |= parent;
+                if (std::find(parentLists[w].begin(), parentLists[w].end(), v) ==
+                    parentLists[w].end())
+                {
+                    parentLists[w].push_back(v);
+                }
+                continue;
+            }
+            // New candidate, or new lower-cost path to a candidate
+            if (replace || status[w] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+            {
+                tree.exits[w] = exits;
+            }
+            status[w] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
+            tree.distance[w] = distance;
+            parents[w] = parent;
+            parentLists[w] = {v};
+            order[w] = nextOrder++;
+            candidates.emplace(distance,
+                               wLsa->GetLSType() == GlobalRoutingLSA::RouterLSA,
+                               order[w],
+                               w);
+        }
+        if (!found)
+        {
+            break;
+        }
+
+        v = SPF_INFINITY;
+        while (!candidates.empty() && v == SPF_INFINITY)
+        {
+            auto [distance, router, candidateOrder, w] = candidates.top();
+            candidates.pop();
+            if (status[w] == GlobalRoutingLSA::LSA_SPF_CANDIDATE && order[w] == candidateOrder)
+            {
+                v = w;
+            }
+        }
+        if (v == SPF_INFINITY)
+        {
+            break;
+        }
+        status[v] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+        joined.push_back(v);
+    }
+    ResetRoot();
+    if (!found)
+    {
+        return false;
+    }
+
+    // The children of a vertex are in the order they joined the tree, as
+    // SPFVertexAddParent () adds them
+    tree.rank.assign(n, SPF_INFINITY);
+    uint32_t nextRank = 0;
+    std::vector<std::vector<uint32_t>> children(n);
+    for (uint32_t v : joined)
+    {
+        if (graph.lsas[v]->GetLSType() == GlobalRoutingLSA::NetworkLSA)
+        {
+            tree.rank[v] = nextRank++;
+        }
+        for (uint32_t p : parentLists[v])
+        {
+            children[p].push_back(v);
+        }
+    }
+    std::vector<bool> processed(n, false);
+    std::vector<uint32_t> stack{r};
+    while (!stack.empty())
+    {
+        uint32_t v = stack.back();
+        stack.pop_back();
+        if (processed[v])
+        {
+            continue;
+        }
+        processed[v] = true;
+        if (graph.lsas[v]->GetLSType() == GlobalRoutingLSA::RouterLSA)
+        {
+            tree.rank[v] = nextRank++;
+        }
+        stack.insert(stack.end(), children[v].rbegin(), children[v].rend());
+    }
+    return true;
+}
+
+void
+GlobalRouteManagerImpl::SPFKeepTree(Ipv4Address root, Ptr<Node> node, const SPFGraph& graph)
+{
+    NS_LOG_FUNCTION(this << root << node);
+    SPFTree& tree = m_spfTrees[root];
+    if (IsStubVertex(GetVertexIndex(root), graph))
+    {
+        tree = SPFTree();
+        tree.stub = true;
+    }
+    else if (!SPFCalculateTree(root, node, graph, tree))
+    {
+        // The routes of this router will always be computed from scratch
+        NS_LOG_LOGIC("Not keeping the shortest path tree of " << root);
+        m_spfTrees.erase(root);
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFRecalculate(Ipv4Address root, Ptr<Node> node, const SPFGraph& graph)
+{
+    NS_LOG_FUNCTION(this << root << node);
+    Ptr<Ipv4GlobalRouting> gr = node->GetObject<GlobalRouter>()->GetRoutingProtocol();
+    for (uint32_t j = gr->GetNRoutes(); j > 0; j--)
+    {
+        gr->RemoveRoute(0);
+    }
+    SPFCalculate(root, node);
+    SPFKeepTree(root, node, graph);
+}
+
+//
+// The LSAs are gathered again and compared to the ones of the LSDB.  The
+// shortest path tree of a router cannot change if the changed LSAs are not
+// near the root (where they define the next hops of the root exits), if no
+// link of a path in the tree was removed, and if no new link gives a path as
+// short as the ones in the tree.  Otherwise, the tree is computed again on
+// the SPF graph, which is cheap compared to SPFCalculate ().  In both cases,
+// the routes of the router are only updated for the destinations of the
+// changed LSAs, of the vertices whose root exits changed, and of the networks
+// whose advertising vertices are ranked in a different order.
+//
+bool
+GlobalRouteManagerImpl::UpdateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+    if (!incremental.Get() || !m_incremental)
+    {
+        NS_LOG_LOGIC("No shortest path trees to update the routes from");
+        return false;
+    }
+
+    auto lsdb = new GlobalRouteManagerLSDB();
+    DiscoverLSAs(lsdb);
+    SPFGraph oldGraph;
+    BuildSPFGraph(m_lsdb, oldGraph);
+    SPFGraph graph;
+    BuildSPFGraph(lsdb, graph);
+    uint32_t n = graph.lsas.size();
+    oldGraph.lsas.resize(n, nullptr);
+    oldGraph.edges.resize(n);
+
+    std::set<uint32_t> changed;
+    for (uint32_t v = 0; v < n; v++)
+    {
+        const GlobalRoutingLSA* a = oldGraph.lsas[v];
+        const GlobalRoutingLSA* b = graph.lsas[v];
+        if (a != b && (!a || !b || !IsSameLSA(a, b)))
+        {
+            changed.insert(v);
+        }
+    }
+    // The edges of a network depend on the transit link records of its routers
+    for (uint32_t v : std::set<uint32_t>(changed))
+    {
+        for (const GlobalRoutingLSA* lsa : {oldGraph.lsas[v], graph.lsas[v]})
+        {
+            for (uint32_t i = 0; lsa && i < lsa->GetNLinkRecords(); i++)
+            {
+                const GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+                auto it = m_vertexIndex.find(l->GetLinkId());
+                if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
+                    it != m_vertexIndex.end())
+                {
+                    changed.insert(it->second);
+                }
+            }
+        }
+    }
+    SPFExternals oldExternals = GetExternals(m_lsdb);
+    SPFExternals externals = GetExternals(lsdb);
+    std::vector<std::pair<Ipv4Address, SPFDestination>> externalChanges;
+    std::set_symmetric_difference(oldExternals.begin(),
+                                  oldExternals.end(),
+                                  externals.begin(),
+                                  externals.end(),
+                                  std::back_inserter(externalChanges));
+    NS_LOG_LOGIC(changed.size() << " LSAs and " << externalChanges.size()
+                                << " external LSAs changed");
+    if (changed.empty() && externalChanges.empty())
+    {
+        delete lsdb;
+        return true;
+    }
+    GlobalRouteManagerLSDB* oldLsdb = m_lsdb;
+    m_lsdb = lsdb;
+
+    // The edges removed from and added to the graph: from, to, cost, added
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t, bool>> edgeChanges;
+    for (uint32_t v : changed)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> before;
+        std::vector<std::pair<uint32_t, uint32_t>> after;
+        for (const SPFEdge& edge : oldGraph.edges[v])
+        {
+            before.emplace_back(edge.vertex, edge.cost);
+        }
+        for (const SPFEdge& edge : graph.edges[v])
+        {
+            after.emplace_back(edge.vertex, edge.cost);
+        }
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        std::vector<std::pair<uint32_t, uint32_t>> diff;
+        std::set_difference(before.begin(),
+                            before.end(),
+                            after.begin(),
+                            after.end(),
+                            std::back_inserter(diff));
+        for (const auto& [w, cost] : diff)
+        {
+            edgeChanges.emplace_back(v, w, cost, false);
+        }
+        diff.clear();
+        std::set_difference(after.begin(),
+                            after.end(),
+                            before.begin(),
+                            before.end(),
+                            std::back_inserter(diff));
+        for (const auto& [w, cost] : diff)
+        {
+            edgeChanges.emplace_back(v, w, cost, true);
+        }
+    }
 
-        uint32_t systemId = Simulator::GetSystemId();
-        // Ignore nodes that are not assigned to our systemId (distributed sim)
-        if (node->GetSystemId() != systemId)
+    SPFAdvertisers advertisers;
+    for (uint32_t v = 0; v < n; v++)
+    {
+        SPFDestinations dests;
+        AddDestinations(graph.lsas[v], SPFExternals(), dests);
+        for (const auto& dest : dests.hosts)
+        {
+            advertisers.hosts[dest].push_back(v);
+        }
+        for (const auto& dest : dests.networks)
+        {
+            advertisers.networks[dest].push_back(v);
+        }
+    }
+    for (uint32_t i = 0; i < lsdb->GetNumExtLSAs(); i++)
+    {
+        const GlobalRoutingLSA* lsa = lsdb->GetExtLSA(i);
+        auto it = m_vertexIndex.find(lsa->GetAdvertisingRouter());
+        if (it != m_vertexIndex.end())
+        {
+            advertisers.externals[GetDestination(lsa->GetLinkStateId(),
+                                                 lsa->GetNetworkLSANetworkMask())]
+                .push_back(it->second);
+        }
+    }
+
+    uint32_t nUpdated = 0;
+    for (const auto& [root, node] : GetRoots())
+    {
+        uint32_t r = GetVertexIndex(root);
+        auto it = m_spfTrees.find(root);
+        if (it == m_spfTrees.end())
+        {
+            SPFRecalculate(root, node, graph);
+            continue;
+        }
+        SPFTree& tree = it->second;
+        auto distance = [](const SPFTree& t, uint32_t v) {
+            return v < t.distance.size() ? t.distance[v] : SPF_INFINITY;
+        };
+
+        // The root exits are defined by the links of the root, and by the
+        // links of its neighbors and of the routers on its networks
+        std::set<uint32_t> near{r};
+        for (const SPFGraph* g : {&oldGraph, &graph})
+        {
+            for (const SPFEdge& edge : g->edges[r])
+            {
+                near.insert(edge.vertex);
+                if (edge.record->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                    continue;
+                }
+                for (const SPFEdge& next : g->edges[edge.vertex])
+                {
+                    near.insert(next.vertex);
+                }
+            }
+        }
+        bool affected = std::any_of(changed.begin(), changed.end(), [&near](uint32_t v) {
+            return near.count(v) > 0;
+        });
+        if (tree.stub)
         {
+            if (affected)
+            {
+                SPFRecalculate(root, node, graph);
+            }
             continue;
         }
+        for (auto i = edgeChanges.begin(); i != edgeChanges.end() && !affected; i++)
+        {
+            auto [v, w, cost, added] = *i;
+            uint32_t dv = distance(tree, v);
+            uint32_t dw = distance(tree, w);
+            affected = dv != SPF_INFINITY && (added ? dv + cost <= dw : dv + cost == dw);
+        }
 
-        //
-        // if the node has a global router interface, then run the global routing
-        // algorithms.
-        //
-        if (rtr && rtr->GetNumLSAs())
+        SPFTree newTree;
+        std::set<uint32_t> dirty;
+        std::set<SPFDestination> reordered;
+        if (affected)
+        {
+            if (IsStubVertex(r, graph) || !SPFCalculateTree(root, node, graph, newTree))
+            {
+                SPFRecalculate(root, node, graph);
+                continue;
+            }
+            for (uint32_t v = 0; v < n; v++)
+            {
+                bool reached = distance(tree, v) != SPF_INFINITY;
+                if (reached != (newTree.distance[v] != SPF_INFINITY) ||
+                    (reached && tree.exitSets[tree.exits[v]] !=
+                                    newTree.exitSets[newTree.exits[v]]))
+                {
+                    dirty.insert(v);
+                }
+            }
+            // The routes to a network advertised by several vertices are
+            // listed in the rank order of the vertices, which may change
+            for (const auto& [dest, vertices] : advertisers.networks)
+            {
+                if (vertices.size() > 1 &&
+                    SortByRank(tree.rank, vertices) != SortByRank(newTree.rank, vertices))
+                {
+                    reordered.insert(dest);
+                }
+            }
+        }
+        const SPFTree& current = affected ? newTree : tree;
+        for (uint32_t v : changed)
         {
-            SPFCalculate(rtr->GetRouterId());
+            if (distance(tree, v) != SPF_INFINITY || distance(current, v) != SPF_INFINITY)
+            {
+                dirty.insert(v);
+            }
+        }
+
+        SPFDestinations dests;
+        dests.networks = std::move(reordered);
+        for (const auto& change : externalChanges)
+        {
+            dests.externals.insert(change.second);
+        }
+        for (uint32_t v : dirty)
+        {
+            AddDestinations(oldGraph.lsas[v], oldExternals, dests);
+            AddDestinations(graph.lsas[v], externals, dests);
+        }
+        Ptr<Ipv4GlobalRouting> gr = node->GetObject<GlobalRouter>()->GetRoutingProtocol();
+        UpdateRoutesTo(gr,
+                       r,
+                       current.distance,
+                       current.exits,
+                       current.exitSets,
+                       current.rank,
+                       dests,
+                       advertisers);
+        if (affected)
+        {
+            tree = std::move(newTree);
+            nUpdated++;
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+    NS_LOG_INFO("Updated " << nUpdated << " shortest path trees");
+
+    delete oldLsdb;
+    return true;
 }
 
 //
@@ -897,6 +1907,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
              */
             SPFVertex* cw;
             cw = candidate.Find(w_lsa->GetLinkStateId());
+            NS_ASSERT(cw);
             if (cw->GetDistanceFromRoot() < distance)
             {
                 //
@@ -952,7 +1963,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                     // If we've changed the cost to get to the vertex represented by <w>, we
                     // must reorder the priority queue keyed to that cost.
                     //
-                    candidate.Reorder();
+                    candidate.Update(cw);
                 }
             } // new lower cost path found
         }     // end W is already on the candidate list
@@ -1112,7 +2123,8 @@ GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
         }
         else
         {
-            w->SetRootExitDirection(v->GetRootExitDirection());
+            // The network may be reached through several equal-cost exits
+            w->InheritAllRootExitDirections(v);
         }
     }
     else
@@ -1234,7 +2246,17 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
-    SPFCalculate(root);
+    Ptr<Node> rootNode;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            rootNode = *i;
+            break;
+        }
+    }
+    SPFCalculate(root, rootNode);
 }
 
 //
@@ -1307,9 +2329,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+                    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
                     NS_ASSERT(gr);
                     gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
                                           Ipv4Mask("0.0.0.0"),
@@ -1329,9 +2349,9 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root, Ptr<Node> node)
 {
-    NS_LOG_FUNCTION(this << root);
+    NS_LOG_FUNCTION(this << root << node);
 
     SPFVertex* v;
     //
@@ -1359,6 +2379,20 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     v->SetDistanceFromRoot(0);
     v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
     NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
+    //
+    // The routes are written to the routing table of the node at the root of
+    // the tree.  Look it up once, rather than for every route added.
+    //
+    m_spfrootNode = node;
+    if (node)
+    {
+        m_spfrootIpv4 = node->GetObject<Ipv4>();
+        NS_ASSERT_MSG(m_spfrootIpv4,
+                      "GlobalRouteManagerImpl::SPFCalculate (): "
+                      "GetObject for <Ipv4> interface failed");
+        Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+        m_spfrootRouting = router ? router->GetRoutingProtocol() : nullptr;
+    }
 
     //
     // Optimize SPF calculation, for ns-3.
@@ -1367,10 +2401,12 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (m_spfrootRouting && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
         delete m_spfroot;
+        m_spfroot = nullptr;
+        ResetRoot();
         return;
     }
 
@@ -1492,6 +2528,15 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     //
     delete m_spfroot;
     m_spfroot = nullptr;
+    ResetRoot();
+}
+
+void
+GlobalRouteManagerImpl::ResetRoot()
+{
+    m_spfrootNode = nullptr;
+    m_spfrootIpv4 = nullptr;
+    m_spfrootRouting = nullptr;
 }
 
 void
@@ -1543,108 +2588,47 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     }
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
-
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routing information is written to the routing table of the node at
+    // the root of the SPF tree, looked up by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        NS_LOG_LOGIC("No GlobalRouter interface on root " << m_spfroot->GetVertexId());
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << m_spfrootNode->GetId());
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " add external network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1702,113 +2686,51 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
     }
     NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
     //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // The routing information is written to the routing table of the node at
+    // the root of the SPF tree, looked up by SPFCalculate ().
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("No GlobalRouter interface on root " << m_spfroot->GetVertexId());
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << m_spfrootNode->GetId());
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The vertex <v> (corresponding to the node that has the stub network)
+    // has the next hops and the outbound interfaces, precalculated for us,
+    // to which the root node should send packets to be forwarded to the stub
+    // network.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1823,67 +2745,18 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    // We have an IP address <a> and the IPv4 stack of the node at the root of
+    // the SPF tree, looked up by SPFCalculate ().  Look through the interfaces
+    // on this node for one that has the IP address we're looking for.  If we
+    // find one, return the corresponding interface index, or -1 if not found.
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootIpv4)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
-        }
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node "
+                     << (m_spfroot ? m_spfroot->GetVertexId() : Ipv4Address()));
+        return -1;
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
+    return m_spfrootIpv4->GetInterfaceForPrefix(a, amask);
 }
 
 //
@@ -1910,137 +2783,86 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  SPFCalculate () looked
+    // up its routing protocol.
+    //
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("No GlobalRouter interface on root " << m_spfroot->GetVertexId());
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for node " << m_spfrootNode->GetId());
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    NS_LOG_LOGIC(" Node " << m_spfrootNode->GetId() << " found " << nLinkRecords
+                          << " link records in LSA " << lsa << "with LinkStateId "
+                          << lsa->GetLinkStateId());
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // an m_nextHop address precalculated for us that is the address to which the
+        // root node should send packets to be forwarded to these IP addresses.
+        // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+        // which the packets should be send for forwarding.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
+                NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                       << " adding host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                       << " NOT able to add host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 
@@ -2052,98 +2874,49 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  SPFCalculate () looked
+    // up its routing protocol.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("No GlobalRouter interface on root " << m_spfroot->GetVertexId());
+        return;
+    }
+    NS_LOG_LOGIC("setting routes for node " << m_spfrootNode->GetId());
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " add network route to " << tempip << " using next hop "
+                                   << nextHop << " via interface " << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Node " << m_spfrootNode->GetId()
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
@@ -39,7 +39,9 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
+class Node;
 
 /**
  * \ingroup globalrouting
@@ -591,8 +593,18 @@ class GlobalRouteManagerLSDB
      */
     ~GlobalRouteManagerLSDB();
 
-    // Delete copy constructor and assignment operator to avoid misuse
-    GlobalRouteManagerLSDB(const GlobalRouteManagerLSDB&) = delete;
+    /**
+     * @brief Copy a Global Router Manager Link State Database.
+     *
+     * The Link State Advertisements are copied, so that the SPF status of the
+     * copies can change independently of the original ones, e.g., to compute
+     * the routes of several routers in parallel.
+     *
+     * @param lsdb The database to copy.
+     */
+    GlobalRouteManagerLSDB(const GlobalRouteManagerLSDB& lsdb);
+
+    // Delete assignment operator to avoid misuse
     GlobalRouteManagerLSDB& operator=(const GlobalRouteManagerLSDB&) = delete;
 
     /**
@@ -672,6 +684,14 @@ class GlobalRouteManagerLSDB
      */
     uint32_t GetNumExtLSAs() const;
 
+    /**
+     * @brief Get the Router and Network Link State Advertisements.
+     *
+     * @returns the Link State Advertisements, in increasing order of link
+     * state ID.
+     */
+    std::vector<GlobalRoutingLSA*> GetLSAs() const;
+
   private:
     typedef std::map<Ipv4Address, GlobalRoutingLSA*>
         LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -679,6 +699,8 @@ class GlobalRouteManagerLSDB
         LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    /// Link State Advertisements by the link data of their transit network link records
+    std::map<Ipv4Address, GlobalRoutingLSA*> m_linkDataIndex;
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -722,9 +744,29 @@ class GlobalRouteManagerImpl
     /**
      * @brief Compute routes using a Dijkstra SPF computation and populate
      * per-node forwarding tables
+     *
+     * The SPF computations of the routers are independent: they run in as
+     * many threads as set by the GlobalRoutingThreads global value, each
+     * with its own copy of the LSDB.
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Update the routes after a change of the topology, incrementally
+     *
+     * This is only possible when the GlobalRoutingIncremental global value
+     * was set when the routes were initialized.  The Link State Advertisements
+     * are gathered again and compared to the ones of the LSDB.  The shortest
+     * path trees that the changed advertisements cannot affect are kept; the
+     * other ones are computed again on a compact copy of the LSDB.  In both
+     * cases, only the routes to the destinations whose next hops changed are
+     * removed and added again.
+     *
+     * @returns false if the routes cannot be updated incrementally, and must
+     * be deleted and initialized again
+     */
+    virtual bool UpdateRoutes();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -741,6 +783,119 @@ class GlobalRouteManagerImpl
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+    Ptr<Node> m_spfrootNode;                 //!< the node of the root router
+    Ptr<Ipv4> m_spfrootIpv4;                 //!< the IPv4 stack of the root router
+    Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< the routing protocol of the root router
+
+    /// An edge of the SPF graph
+    struct SPFEdge
+    {
+        uint32_t vertex;                 //!< Index of the vertex the edge leads to
+        uint32_t cost;                   //!< Cost of the edge
+        GlobalRoutingLinkRecord* record; //!< Link record of a router, or null for a network
+    };
+
+    /// The transit vertices of an LSDB, with their edges, by vertex index
+    struct SPFGraph
+    {
+        std::vector<GlobalRoutingLSA*> lsas;     //!< LSA of the vertex, or null if none
+        std::vector<std::vector<SPFEdge>> edges; //!< Edges of the vertex, in SPFNext () order
+    };
+
+    /// The shortest path tree of a router, kept to update its routes incrementally
+    struct SPFTree
+    {
+        bool stub{false};               //!< The router only has a default route
+        std::vector<uint32_t> distance; //!< Distance of the vertices, or SPF_INFINITY
+        std::vector<uint32_t> exits;    //!< Index of the root exits of the vertices in exitSets
+        std::vector<std::vector<SPFVertex::NodeExit_t>> exitSets; //!< Sets of root exits
+        /// Rank of the vertices in the order SPFCalculate () adds the routes to the
+        /// networks they advertise, or SPF_INFINITY
+        std::vector<uint32_t> rank;
+    };
+
+    bool m_incremental{false};                     //!< Whether m_spfTrees match the LSDB
+    std::map<Ipv4Address, uint32_t> m_vertexIndex; //!< Index of the vertices, by link state ID
+    std::map<Ipv4Address, SPFTree> m_spfTrees;     //!< Shortest path trees, by router ID
+
+    /**
+     * \brief Gather the Link State Advertisements of the routers
+     * \param lsdb the database to insert the advertisements in
+     */
+    void DiscoverLSAs(GlobalRouteManagerLSDB* lsdb);
+
+    /**
+     * \brief Get the routers whose routes are computed
+     * \return the router IDs and the nodes of the routers
+     */
+    std::vector<std::pair<Ipv4Address, Ptr<Node>>> GetRoots() const;
+
+    /**
+     * \brief Get the index of a vertex, allocating one for a new vertex
+     * \param id the link state ID of the vertex
+     * \return the index
+     */
+    uint32_t GetVertexIndex(Ipv4Address id);
+
+    /**
+     * \brief Build the SPF graph of an LSDB
+     * \param lsdb the LSDB
+     * \param graph filled with the vertices of the LSDB
+     */
+    void BuildSPFGraph(const GlobalRouteManagerLSDB* lsdb, SPFGraph& graph);
+
+    /**
+     * \brief Check if a router is a stub, in the sense of CheckForStubNode ()
+     * \param root the index of the router
+     * \param graph the SPF graph
+     * \return true if the router only needs a default route
+     */
+    bool IsStubVertex(uint32_t root, const SPFGraph& graph) const;
+
+    /**
+     * \brief Compute the shortest path tree of a router on an SPF graph
+     *
+     * The distances and root exits are the ones that SPFCalculate () finds
+     * on the same LSDB, and the ranks follow the order in which it adds the
+     * routes to networks: SPFIntraAddTransit () adds the routes of the network
+     * vertices as they join the tree, then SPFProcessStubs () the routes of the
+     * router vertices, walking the tree depth first.
+     *
+     * \param root the router ID
+     * \param node the node of the router
+     * \param graph the SPF graph
+     * \param tree filled with the shortest path tree
+     * \return false if the root exits depend on the order of the vertices in
+     * memory, as in SPFCalculate (): the tree must not be used
+     */
+    bool SPFCalculateTree(Ipv4Address root, Ptr<Node> node, const SPFGraph& graph, SPFTree& tree);
+
+    /**
+     * \brief Keep the shortest path tree of a router, to update its routes
+     * incrementally later on
+     * \param root the router ID
+     * \param node the node of the router
+     * \param graph the SPF graph of the LSDB
+     */
+    void SPFKeepTree(Ipv4Address root, Ptr<Node> node, const SPFGraph& graph);
+
+    /**
+     * \brief Delete the routes of a router and compute them again from scratch
+     * \param root the router ID
+     * \param node the node of the router
+     * \param graph the SPF graph of the LSDB
+     */
+    void SPFRecalculate(Ipv4Address root, Ptr<Node> node, const SPFGraph& graph);
+
+    /**
+     * \brief Run the SPF computations of several routers in parallel threads
+     *
+     * \param roots the router IDs and the nodes of the routers
+     * \param nThreads the number of threads
+     */
+    void SPFCalculateParallel(const std::vector<std::pair<Ipv4Address, Ptr<Node>>>& roots,
+                              uint32_t nThreads);
+
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
      *
@@ -758,8 +913,15 @@ class GlobalRouteManagerImpl
      *
      * Equivalent to quagga ospf_spf_calculate
      * \param root the root node
+     * \param node the node of the root router, whose routing table is populated
+     * (no route is added if it is null)
+     */
+    void SPFCalculate(Ipv4Address root, Ptr<Node> node);
+
+    /**
+     * \brief Forget the node of the root router, once its SPF tree is computed
      */
-    void SPFCalculate(Ipv4Address root);
+    void ResetRoot();
 
     /**
      * \brief Process Stub nodes
@@ -57,6 +57,19 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+void
+GlobalRouteManager::RecomputeRoutes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    GlobalRouteManagerImpl* impl = SimulationSingleton<GlobalRouteManagerImpl>::Get();
+    if (!impl->UpdateRoutes())
+    {
+        impl->DeleteGlobalRoutes();
+        impl->BuildGlobalRoutingDatabase();
+        impl->InitializeRoutes();
+    }
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
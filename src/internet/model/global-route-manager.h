@@ -70,6 +70,16 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after a change of the topology
+     *
+     * If the GlobalRoutingIncremental global value is set, only the routes
+     * affected by the change are updated.  Otherwise, or if the routes were
+     * not initialized with that global value set, all the routes are deleted,
+     * and the routing database is built and the routes initialized again.
+     */
+    static void RecomputeRoutes();
 };
 
 } // namespace ns3
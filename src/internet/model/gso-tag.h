@@ -0,0 +1,78 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GSO_TAG_H
+#define GSO_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ *
+ * \brief Mark a packet built by generic segmentation offload (GSO)
+ *
+ * A transport protocol may hand down to IP a "super-segment" carrying the
+ * payload of several wire-sized segments. Such a packet is neither
+ * fragmented by IP nor handed to a device as is: it is split into segments
+ * of at most GetSegmentSize() payload bytes, each with its own copy of the
+ * transport and IP headers, when it leaves the traffic control layer of the
+ * sending node (see QueueDiscItem::GsoSegment).
+ *
+ * This is the equivalent of the gso_size field of the Linux skb_shared_info.
+ */
+class GsoTag : public Tag
+{
+  public:
+    GsoTag();
+
+    /**
+     * \brief Constructor
+     * \param segmentSize the payload size of the segments
+     */
+    GsoTag(uint16_t segmentSize);
+
+    /**
+     * \brief Set the payload size of the segments
+     * \param segmentSize the payload size of the segments
+     */
+    void SetSegmentSize(uint16_t segmentSize);
+
+    /**
+     * \brief Get the payload size of the segments
+     * \returns the payload size of the segments
+     */
+    uint16_t GetSegmentSize() const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    uint16_t m_segmentSize; //!< Payload size of the segments
+};
+
+} // namespace ns3
+
+#endif /* GSO_TAG_H */
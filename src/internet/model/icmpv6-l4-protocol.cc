@@ -1690,6 +1690,27 @@ Icmpv6L4Protocol::FindCache(Ptr<NetDevice> device)
     return nullptr;
 }
 
+bool
+Icmpv6L4Protocol::LookupNeighborTable(Ipv6Address dst,
+                                      Ptr<NdiscCache> cache,
+                                      Address* hardwareDestination) const
+{
+    NS_LOG_FUNCTION(this << dst << cache << hardwareDestination);
+
+    Ptr<NdiscCache> table = cache->GetNeighborTable();
+    if (!table)
+    {
+        return false;
+    }
+    NdiscCache::Entry* entry = table->Lookup(dst);
+    if (entry && entry->IsAutoGenerated())
+    {
+        *hardwareDestination = entry->GetMacAddress();
+        return true;
+    }
+    return false;
+}
+
 Ptr<NdiscCache>
 Icmpv6L4Protocol::CreateCache(Ptr<NetDevice> device, Ptr<Ipv6Interface> interface)
 {
@@ -1718,6 +1739,10 @@ Icmpv6L4Protocol::Lookup(Ipv6Address dst,
     }
     if (cache)
     {
+        if (LookupNeighborTable(dst, cache, hardwareDestination))
+        {
+            return true;
+        }
         NdiscCache::Entry* entry = cache->Lookup(dst);
         if (entry)
         {
@@ -1759,6 +1784,11 @@ Icmpv6L4Protocol::Lookup(Ptr<Packet> p,
         return false;
     }
 
+    if (LookupNeighborTable(dst, cache, hardwareDestination))
+    {
+        return true;
+    }
+
     NdiscCache::Entry* entry = cache->Lookup(dst);
     if (entry)
     {
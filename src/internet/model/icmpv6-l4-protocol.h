@@ -592,6 +592,17 @@ class Icmpv6L4Protocol : public IpL4Protocol
      */
     Ptr<NdiscCache> FindCache(Ptr<NetDevice> device);
 
+    /**
+     * \brief Lookup in the neighbor table shared by the NDISC caches of a channel.
+     * \param dst destination address
+     * \param cache the neighbor cache
+     * \param hardwareDestination hardware address
+     * \return true if the address is in the shared table, the hardwareDestination is updated.
+     */
+    bool LookupNeighborTable(Ipv6Address dst,
+                             Ptr<NdiscCache> cache,
+                             Address* hardwareDestination) const;
+
     // From IpL4Protocol
     void SetDownTarget(IpL4Protocol::DownTargetCallback cb) override;
     void SetDownTarget6(IpL4Protocol::DownTargetCallback6 cb) override;
@@ -24,11 +24,30 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Ipv4EndPointDemux");
 
+bool
+Ipv4EndPointDemux::FourTuple::operator==(const FourTuple& other) const
+{
+    return localPort == other.localPort && peerPort == other.peerPort &&
+           localAddress == other.localAddress && peerAddress == other.peerAddress;
+}
+
+std::size_t
+Ipv4EndPointDemux::FourTupleHash::operator()(const FourTuple& tuple) const
+{
+    uint64_t addresses = (static_cast<uint64_t>(tuple.localAddress.Get()) << 32) |
+                         tuple.peerAddress.Get();
+    uint64_t ports = (static_cast<uint64_t>(tuple.localPort) << 16) | tuple.peerPort;
+    uint64_t h = (addresses ^ (ports * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux()
     : m_ephemeral(49152),
       m_portLast(65535),
@@ -40,9 +59,13 @@ Ipv4EndPointDemux::Ipv4EndPointDemux()
 Ipv4EndPointDemux::~Ipv4EndPointDemux()
 {
     NS_LOG_FUNCTION(this);
+    m_index.clear();
+    m_localPorts.clear();
+    m_positions.clear();
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         Ipv4EndPoint* endPoint = *i;
+        endPoint->m_demux = nullptr;
         delete endPoint;
     }
     m_endPoints.clear();
@@ -52,20 +75,18 @@ bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
+    if (!LookupPortLocal(port))
+    {
+        return false;
+    }
+    // Only used when binding, so a scan of the end points is good enough
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
@@ -88,7 +109,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -104,7 +125,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -127,7 +148,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -140,19 +161,21 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto bucket = m_index.find({localAddress, localPort, peerAddress, peerPort});
+    if (bucket != m_index.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (auto endP : bucket->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -163,15 +186,16 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto position = m_positions.find(endPoint);
+    if (position == m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    RemoveFromIndex(endPoint);
+    m_endPoints.erase(position->second);
+    m_positions.erase(position);
+    endPoint->m_demux = nullptr;
+    delete endPoint;
 }
 
 /*
@@ -205,157 +229,69 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; // Matches exact on local port, wildcards on others
-    EndPoints retval2; // Matches exact on local port/adder, wildcards on others
-    EndPoints retval3; // Matches all but local address
-    EndPoints retval4; // Exact match on all 4
-
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        Ipv4EndPoint* endP = *i;
 
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
+    EndPoints retval;
+    if (!LookupPortLocal(dport))
+    {
+        return retval;
+    }
 
-        if (endP->GetLocalPort() != dport)
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
-        if (endP->GetBoundNetDevice())
+    // Exact match on all 4 - this is the case of an open TCP connection, for example.
+    AppendMatches({daddr, dport, saddr, sport}, incomingInterface, retval);
+    if (!retval.empty())
+    {
+        NS_LOG_LOGIC("Found an endpoint for case 4");
+    }
+    else
+    {
+        // Local addresses that match the destination address as a wildcard:
+        // Any, and x.y.z.0 for a subnet-directed broadcast packet (e.g.,
+        // x.y.z.255 in a /24 net) or a direct destination in that subnet.
+        std::vector<Ipv4Address> wildcards{Ipv4Address::GetAny()};
+        for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses(); i++)
         {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+            Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+            if (addrNetpart != daddr && daddr.CombineMask(addr.GetMask()) == addrNetpart &&
+                std::find(wildcards.begin(), wildcards.end(), addrNetpart) == wildcards.end())
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                wildcards.push_back(addrNetpart);
             }
         }
 
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
-
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
-
-        if (endP->GetLocalAddress() == daddr)
+        // All but local address - no idea what this case could be.
+        for (const auto& local : wildcards)
         {
-            // Case 1:
-            localAddressMatchesExact = true;
+            AppendMatches({local, dport, saddr, sport}, incomingInterface, retval);
         }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+        if (!retval.empty())
         {
-            // Case 2:
-            localAddressIsAny = true;
+            NS_LOG_LOGIC("Found an endpoint for case 3");
         }
         else
         {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
+            // Only local port and local address matches exactly - Not yet opened connection
+            AppendMatches({daddr, dport, Ipv4Address::GetAny(), 0}, incomingInterface, retval);
+            if (!retval.empty())
             {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
-
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
-                {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
-
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
-                    {
-                        localAddressIsSubnetAny = true;
-                    }
-                }
+                NS_LOG_LOGIC("Found an endpoint for case 2");
             }
-
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
+            else
             {
-                continue;
+                // Only local port matches exactly - Endpoint open to "any" connection
+                for (const auto& local : wildcards)
+                {
+                    AppendMatches({local, dport, Ipv4Address::GetAny(), 0},
+                                  incomingInterface,
+                                  retval);
+                }
+                if (!retval.empty())
+                {
+                    NS_LOG_LOGIC("Found an endpoint for case 1");
+                }
             }
         }
-
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
-
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
-
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
-
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
-        }
-    }
-
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
-    {
-        retval = retval4;
-    }
-    else if (!retval3.empty())
-    {
-        retval = retval3;
-    }
-    else if (!retval2.empty())
-    {
-        retval = retval2;
-    }
-    else
-    {
-        retval = retval1;
     }
 
     NS_ABORT_MSG_IF(retval.size() > 1,
@@ -372,6 +308,17 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
+    if (!LookupPortLocal(dport))
+    {
+        return nullptr;
+    }
+    auto bucket = m_index.find({daddr, dport, saddr, sport});
+    if (bucket != m_index.end())
+    {
+        /* this is an exact match. */
+        return bucket->second.front();
+    }
+
     // this code is a copy/paste version of an old BSD ip stack lookup
     // function.
     uint32_t genericity = 3;
@@ -382,12 +329,6 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
         {
             continue;
         }
-        if ((*i)->GetLocalAddress() == daddr && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == saddr)
-        {
-            /* this is an exact match. */
-            return *i;
-        }
         uint32_t tmp = 0;
         if ((*i)->GetLocalAddress() == Ipv4Address::GetAny())
         {
@@ -429,4 +370,79 @@ Ipv4EndPointDemux::AllocateEphemeralPort()
     return port;
 }
 
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_positions[endPoint] = m_endPoints.insert(m_endPoints.end(), endPoint);
+    endPoint->m_demux = this;
+    AddToIndex(endPoint);
+}
+
+void
+Ipv4EndPointDemux::AddToIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    FourTuple tuple{endPoint->GetLocalAddress(),
+                    endPoint->GetLocalPort(),
+                    endPoint->GetPeerAddress(),
+                    endPoint->GetPeerPort()};
+    m_index[tuple].push_back(endPoint);
+    m_localPorts[tuple.localPort]++;
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto bucket = m_index.find({endPoint->GetLocalAddress(),
+                                endPoint->GetLocalPort(),
+                                endPoint->GetPeerAddress(),
+                                endPoint->GetPeerPort()});
+    NS_ASSERT_MSG(bucket != m_index.end(), "End point " << endPoint << " is not indexed");
+    auto& endPoints = bucket->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_index.erase(bucket);
+    }
+    auto port = m_localPorts.find(endPoint->GetLocalPort());
+    if (--port->second == 0)
+    {
+        m_localPorts.erase(port);
+    }
+}
+
+void
+Ipv4EndPointDemux::AppendMatches(const FourTuple& tuple,
+                                 Ptr<Ipv4Interface> incomingInterface,
+                                 EndPoints& matches) const
+{
+    auto bucket = m_index.find(tuple);
+    if (bucket == m_index.end())
+    {
+        return;
+    }
+    for (auto endP : bucket->second)
+    {
+        if (!endP->IsRxEnabled())
+        {
+            NS_LOG_LOGIC("Skipping endpoint " << endP
+                                              << " because endpoint can not receive packets");
+            continue;
+        }
+        if (endP->GetBoundNetDevice())
+        {
+            if (!incomingInterface || endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            {
+                NS_LOG_LOGIC("Skipping endpoint "
+                             << endP << " because endpoint is bound to specific device "
+                             << endP->GetBoundNetDevice() << " that does not match packet device");
+                continue;
+            }
+        }
+        matches.push_back(endP);
+    }
+}
+
 } // namespace ns3
@@ -22,6 +22,7 @@
 #include "ipv4-routing-table-entry.h"
 
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -29,8 +30,11 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <set>
 #include <vector>
 
 namespace ns3
@@ -48,11 +52,43 @@ Ipv4GlobalRouting::GetTypeId()
             .SetParent<Object>()
             .SetGroupName("Internet")
             .AddAttribute("RandomEcmpRouting",
-                          "Set to true if packets are randomly routed among ECMP; set to false for "
-                          "using only one route consistently",
+                          "Set to true if packets are randomly routed among ECMP, whatever the "
+                          "EcmpMode; set to false for choosing the routes according to EcmpMode",
                           BooleanValue(false),
                           MakeBooleanAccessor(&Ipv4GlobalRouting::m_randomEcmpRouting),
                           MakeBooleanChecker())
+            .AddAttribute("EcmpMode",
+                          "How a route is chosen among the equal-cost routes to a destination: "
+                          "always the first one, at random for each packet, by the hash of the "
+                          "five-tuple of the packet, or at random for each flowlet",
+                          EnumValue(Ipv4GlobalRouting::ECMP_NONE),
+                          MakeEnumAccessor(&Ipv4GlobalRouting::m_ecmpMode),
+                          MakeEnumChecker(Ipv4GlobalRouting::ECMP_NONE,
+                                          "None",
+                                          Ipv4GlobalRouting::ECMP_RANDOM,
+                                          "Random",
+                                          Ipv4GlobalRouting::ECMP_FLOW_HASH,
+                                          "FlowHash",
+                                          Ipv4GlobalRouting::ECMP_FLOWLET,
+                                          "Flowlet"))
+            .AddAttribute("EcmpHashSeed",
+                          "The seed of the hash of the five-tuples, for the FlowHash and Flowlet "
+                          "EcmpMode",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&Ipv4GlobalRouting::m_ecmpHashSeed),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FlowletGap",
+                          "The idle time after which the next packet of a flow starts a new "
+                          "flowlet, which may take another route, for the Flowlet EcmpMode",
+                          TimeValue(MicroSeconds(500)),
+                          MakeTimeAccessor(&Ipv4GlobalRouting::m_flowletGap),
+                          MakeTimeChecker())
+            .AddAttribute("FlowletTableSize",
+                          "The number of slots of the flowlet table, among which the flows are "
+                          "hashed, for the Flowlet EcmpMode",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&Ipv4GlobalRouting::m_flowletTableSize),
+                          MakeUintegerChecker<uint32_t>(1))
             .AddAttribute("RespondToInterfaceEvents",
                           "Set to true if you want to dynamically recompute the global routes upon "
                           "Interface notification events (up/down, or add/remove address)",
@@ -64,7 +100,10 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_ecmpMode(ECMP_NONE),
+      m_ecmpHashSeed(0),
+      m_flowletTableSize(1024)
 {
     NS_LOG_FUNCTION(this);
 
@@ -83,6 +122,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    m_routesVersion++;
 }
 
 void
@@ -92,6 +132,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    m_routesVersion++;
 }
 
 void
@@ -104,6 +145,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    m_routesVersion++;
 }
 
 void
@@ -113,6 +155,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    m_routesVersion++;
 }
 
 void
@@ -125,103 +168,126 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    m_routesVersion++;
+}
+
+void
+Ipv4GlobalRouting::UpdateIndex()
+{
+    if (m_indexVersion == m_routesVersion)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    m_index.Clear();
+    m_indexedRoutes.clear();
+    m_indexedRoutes.insert(m_indexedRoutes.end(), m_hostRoutes.begin(), m_hostRoutes.end());
+    m_indexedRoutes.insert(m_indexedRoutes.end(), m_networkRoutes.begin(), m_networkRoutes.end());
+    m_indexedRoutes.insert(m_indexedRoutes.end(),
+                           m_ASexternalRoutes.begin(),
+                           m_ASexternalRoutes.end());
+    m_nIndexedHostRoutes = m_hostRoutes.size();
+    m_nIndexedNetworkRoutes = m_networkRoutes.size();
+    for (uint32_t i = 0; i < m_indexedRoutes.size(); i++)
+    {
+        const Ipv4RoutingTableEntry* route = m_indexedRoutes[i];
+        m_index.Insert(route->GetDestNetwork(), route->GetDestNetworkMask(), i);
+    }
+    m_indexedRouteEntries.assign(m_indexedRoutes.size(), nullptr);
+    m_indexVersion = m_routesVersion;
 }
 
 Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4GlobalRouting::LookupGlobal(const Ipv4Header& header, Ptr<const Packet> p, Ptr<NetDevice> oif)
 {
-    NS_LOG_FUNCTION(this << dest << oif);
+    Ipv4Address dest = header.GetDestination();
+    NS_LOG_FUNCTION(this << dest << p << oif);
     NS_LOG_LOGIC("Looking for route for destination " << dest);
-    Ptr<Ipv4Route> rtentry = nullptr;
-    // store all available routes that bring packets to their destination
-    typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-    RouteVec_t allRoutes;
+    // store the positions of all available routes that bring packets to their
+    // destination, in a vector reused from lookup to lookup
+    std::vector<uint32_t>& allRoutes = m_ecmpRoutes;
+    allRoutes.clear();
+
+    // The index gives the host, network and external routes matching the
+    // destination, in this order, and in the order of their tables
+    UpdateIndex();
+    m_index.Lookup(dest, m_matches);
+    auto match = m_matches.begin();
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    for (; match != m_matches.end() && *match < m_nIndexedHostRoutes; match++)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        Ipv4RoutingTableEntry* route = m_indexedRoutes[*match];
+        NS_ASSERT(route->IsHost() && route->GetDest() == dest);
+        if (oif)
         {
-            if (oif)
+            if (oif != m_ipv4->GetNetDevice(route->GetInterface()))
             {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
+                NS_LOG_LOGIC("Not on requested interface, skipping");
+                continue;
             }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
         }
+        allRoutes.push_back(*match);
+        NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << route);
     }
+    uint32_t endNetworkRoutes = m_nIndexedHostRoutes + m_nIndexedNetworkRoutes;
     if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+        for (; match != m_matches.end() && *match < endNetworkRoutes; match++)
         {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            Ipv4RoutingTableEntry* route = m_indexedRoutes[*match];
+            if (oif)
             {
-                if (oif)
+                if (oif != m_ipv4->GetNetDevice(route->GetInterface()))
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
+                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    continue;
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
             }
+            allRoutes.push_back(*match);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << route);
         }
     }
     if (allRoutes.empty()) // consider external if no host/network found
     {
-        for (auto k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+        for (; match != m_matches.end(); match++)
         {
-            Ipv4Mask mask = (*k)->GetDestNetworkMask();
-            Ipv4Address entry = (*k)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            Ipv4RoutingTableEntry* route = m_indexedRoutes[*match];
+            if (*match < endNetworkRoutes)
             {
-                NS_LOG_LOGIC("Found external route" << *k);
-                if (oif)
+                continue;
+            }
+            NS_LOG_LOGIC("Found external route" << route);
+            if (oif)
+            {
+                if (oif != m_ipv4->GetNetDevice(route->GetInterface()))
                 {
-                    if (oif != m_ipv4->GetNetDevice((*k)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
+                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    continue;
                 }
-                allRoutes.push_back(*k);
-                break;
             }
+            allRoutes.push_back(*match);
+            break;
         }
     }
     if (!allRoutes.empty()) // if route(s) is found
     {
-        // pick up one of the routes uniformly at random if random
-        // ECMP routing is enabled, or always select the first route
-        // consistently if random ECMP routing is disabled
-        uint32_t selectIndex;
-        if (m_randomEcmpRouting)
-        {
-            selectIndex = m_rand->GetInteger(0, allRoutes.size() - 1);
-        }
-        else
+        uint32_t position = allRoutes[SelectEcmpRoute(header, p)];
+        // the Ipv4Route object of the selected routing table entry is created
+        // once, and shared by the packets routed with it
+        Ptr<Ipv4Route>& rtentry = m_indexedRouteEntries[position];
+        if (!rtentry)
         {
-            selectIndex = 0;
+            Ipv4RoutingTableEntry* route = m_indexedRoutes[position];
+            rtentry = Create<Ipv4Route>();
+            rtentry->SetDestination(route->GetDest());
+            /// \todo handle multi-address case
+            rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
+            rtentry->SetGateway(route->GetGateway());
+            uint32_t interfaceIdx = route->GetInterface();
+            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
         }
-        Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
-        // create a Ipv4Route object from the selected routing table entry
-        rtentry = Create<Ipv4Route>();
-        rtentry->SetDestination(route->GetDest());
-        /// \todo handle multi-address case
-        rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
-        rtentry->SetGateway(route->GetGateway());
-        uint32_t interfaceIdx = route->GetInterface();
-        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
         return rtentry;
     }
     else
@@ -230,6 +296,121 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+uint32_t
+Ipv4GlobalRouting::SelectEcmpRoute(const Ipv4Header& header, Ptr<const Packet> p)
+{
+    EcmpMode mode = m_randomEcmpRouting ? ECMP_RANDOM : m_ecmpMode;
+    uint32_t nRoutes = m_ecmpRoutes.size();
+    if (mode == ECMP_NONE || (nRoutes == 1 && mode != ECMP_RANDOM))
+    {
+        // always select the first route consistently
+        return 0;
+    }
+
+    // The routes are chosen in proportion to their weight, or uniformly if
+    // they all have a weight of 0
+    uint32_t totalWeight = 0;
+    for (uint32_t position : m_ecmpRoutes)
+    {
+        totalWeight += GetEcmpWeight(m_indexedRoutes[position]->GetInterface());
+    }
+    bool uniform = totalWeight == 0;
+    if (uniform)
+    {
+        totalWeight = nRoutes;
+    }
+    auto pick = [this, uniform, nRoutes](uint32_t value) {
+        for (uint32_t i = 0; i + 1 < nRoutes; i++)
+        {
+            uint32_t weight =
+                uniform ? 1 : GetEcmpWeight(m_indexedRoutes[m_ecmpRoutes[i]]->GetInterface());
+            if (value < weight)
+            {
+                return i;
+            }
+            value -= weight;
+        }
+        return nRoutes - 1;
+    };
+
+    switch (mode)
+    {
+    case ECMP_FLOW_HASH:
+        return pick(HashFlow(header, p) % totalWeight);
+    case ECMP_FLOWLET: {
+        if (m_flowlets.empty())
+        {
+            m_flowlets.resize(m_flowletTableSize);
+        }
+        Flowlet& flowlet = m_flowlets[HashFlow(header, p) % m_flowlets.size()];
+        Time now = Simulator::Now();
+        if (now - flowlet.lastSeen <= m_flowletGap)
+        {
+            // Keep the route of the flowlet, if it is still one of the routes
+            for (uint32_t i = 0; i < nRoutes; i++)
+            {
+                const Ipv4RoutingTableEntry* route = m_indexedRoutes[m_ecmpRoutes[i]];
+                if (route->GetInterface() == flowlet.interface &&
+                    route->GetGateway() == flowlet.gateway)
+                {
+                    flowlet.lastSeen = now;
+                    return i;
+                }
+            }
+        }
+        uint32_t i = pick(m_rand->GetInteger(0, totalWeight - 1));
+        const Ipv4RoutingTableEntry* route = m_indexedRoutes[m_ecmpRoutes[i]];
+        flowlet = Flowlet{now, route->GetInterface(), route->GetGateway()};
+        NS_LOG_LOGIC("New flowlet on interface " << flowlet.interface);
+        return i;
+    }
+    default:
+        // pick up one of the routes at random for each packet
+        return pick(m_rand->GetInteger(0, totalWeight - 1));
+    }
+}
+
+/**
+ * \brief Mix the bits of a 64-bit value (the finalizer of MurmurHash3).
+ * \param x the value
+ * \return the mixed value
+ */
+static inline uint64_t
+MixBits(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+uint32_t
+Ipv4GlobalRouting::HashFlow(const Ipv4Header& header, Ptr<const Packet> p) const
+{
+    static const uint8_t TCP_PROT_NUMBER = 6;
+    static const uint8_t UDP_PROT_NUMBER = 17;
+    uint8_t protocol = header.GetProtocol();
+    uint32_t ports = 0;
+    // Only the first fragment has the ports, so that the ports of the
+    // fragmented packets are not hashed at all
+    if (p && (protocol == TCP_PROT_NUMBER || protocol == UDP_PROT_NUMBER) &&
+        header.IsLastFragment() && header.GetFragmentOffset() == 0 && p->GetSize() >= 4)
+    {
+        uint8_t buffer[4];
+        p->CopyData(buffer, 4);
+        ports = (buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+    }
+    // The node id is hashed too, so that the routers make different choices
+    // for the same flows, rather than sending them all on the same paths
+    uint64_t hash = MixBits((static_cast<uint64_t>(m_ecmpHashSeed) << 32) | m_nodeId);
+    hash = MixBits(hash ^ ((static_cast<uint64_t>(header.GetSource().Get()) << 32) |
+                           header.GetDestination().Get()));
+    hash = MixBits(hash ^ ((static_cast<uint64_t>(protocol) << 32) | ports));
+    return hash >> 32;
+}
+
 uint32_t
 Ipv4GlobalRouting::GetNRoutes() const
 {
@@ -299,6 +480,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
                 delete *i;
                 m_hostRoutes.erase(i);
+                m_routesVersion++;
                 NS_LOG_LOGIC("Done removing host route "
                              << index << "; host route remaining size = " << m_hostRoutes.size());
                 return;
@@ -315,6 +497,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
             delete *j;
             m_networkRoutes.erase(j);
+            m_routesVersion++;
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -330,6 +513,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
             delete *k;
             m_ASexternalRoutes.erase(k);
+            m_routesVersion++;
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -339,6 +523,96 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
     NS_ASSERT(false);
 }
 
+/**
+ * \brief Remove the routes matching a predicate from a list of routes
+ * \param routes the routes
+ * \param match the predicate
+ * \return true if a route was removed
+ */
+template <class Predicate>
+static bool
+RemoveMatchingRoutes(std::list<Ipv4RoutingTableEntry*>& routes, Predicate match)
+{
+    bool removed = false;
+    for (auto i = routes.begin(); i != routes.end();)
+    {
+        if (match(**i))
+        {
+            delete *i;
+            i = routes.erase(i);
+            removed = true;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return removed;
+}
+
+void
+Ipv4GlobalRouting::RemoveRoutesTo(const std::vector<Ipv4Address>& hosts,
+                                  const std::vector<std::pair<Ipv4Address, Ipv4Mask>>& networks,
+                                  const std::vector<std::pair<Ipv4Address, Ipv4Mask>>& externals)
+{
+    NS_LOG_FUNCTION(this << hosts.size() << networks.size() << externals.size());
+    typedef std::set<std::pair<uint32_t, uint32_t>> Destinations;
+    auto toSet = [](const std::vector<std::pair<Ipv4Address, Ipv4Mask>>& dests) {
+        Destinations set;
+        for (const auto& [network, mask] : dests)
+        {
+            set.emplace(network.Get(), mask.Get());
+        }
+        return set;
+    };
+    std::set<Ipv4Address> hostSet(hosts.begin(), hosts.end());
+    Destinations networkSet = toSet(networks);
+    Destinations externalSet = toSet(externals);
+    auto isTo = [](const Destinations& set) {
+        return [&set](const Ipv4RoutingTableEntry& route) {
+            return set.count({route.GetDestNetwork().Get(), route.GetDestNetworkMask().Get()}) >
+                   0;
+        };
+    };
+
+    bool removed = false;
+    if (!hostSet.empty())
+    {
+        removed |= RemoveMatchingRoutes(m_hostRoutes, [&hostSet](const auto& route) {
+            return hostSet.count(route.GetDest()) > 0;
+        });
+    }
+    if (!networkSet.empty())
+    {
+        removed |= RemoveMatchingRoutes(m_networkRoutes, isTo(networkSet));
+    }
+    if (!externalSet.empty())
+    {
+        removed |= RemoveMatchingRoutes(m_ASexternalRoutes, isTo(externalSet));
+    }
+    if (removed)
+    {
+        m_routesVersion++;
+    }
+}
+
+void
+Ipv4GlobalRouting::SetEcmpWeight(uint32_t interface, uint32_t weight)
+{
+    NS_LOG_FUNCTION(this << interface << weight);
+    if (interface >= m_ecmpWeights.size())
+    {
+        m_ecmpWeights.resize(interface + 1, 1);
+    }
+    m_ecmpWeights[interface] = weight;
+}
+
+uint32_t
+Ipv4GlobalRouting::GetEcmpWeight(uint32_t interface) const
+{
+    return interface < m_ecmpWeights.size() ? m_ecmpWeights[interface] : 1;
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams(int64_t stream)
 {
@@ -364,10 +638,22 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_routesVersion++;
+    m_indexedRoutes.clear();
+    m_indexedRouteEntries.clear();
+    m_index.Clear();
+    m_indexVersion = 0;
 
     Ipv4RoutingProtocol::DoDispose();
 }
 
+uint64_t
+Ipv4GlobalRouting::GetRoutesVersion() const
+{
+    // Routes chosen among ECMP routes for each packet or flow cannot be cached
+    return m_randomEcmpRouting || m_ecmpMode != ECMP_NONE ? 0 : m_routesVersion;
+}
+
 // Formatted like output of "route -n" command
 void
 Ipv4GlobalRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
@@ -456,7 +742,8 @@ Ipv4GlobalRouting::RouteOutput(Ptr<Packet> p,
     // See if this is a unicast packet we have a route for.
     //
     NS_LOG_LOGIC("Unicast destination- looking up");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination(), oif);
+    // The transport header is not added yet, so the ports are not hashed
+    Ptr<Ipv4Route> rtentry = LookupGlobal(header, nullptr, oif);
     if (rtentry)
     {
         sockerr = Socket::ERROR_NOTERROR;
@@ -511,7 +798,7 @@ Ipv4GlobalRouting::RouteInput(Ptr<const Packet> p,
     }
     // Next, try to find a route
     NS_LOG_LOGIC("Unicast destination- looking up global route");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination());
+    Ptr<Ipv4Route> rtentry = LookupGlobal(header, p);
     if (rtentry)
     {
         NS_LOG_LOGIC("Found unicast destination- calling unicast callback");
@@ -532,9 +819,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -544,9 +829,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -554,11 +837,11 @@ void
 Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    // The source address of the routes may change
+    std::fill(m_indexedRouteEntries.begin(), m_indexedRouteEntries.end(), nullptr);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -566,11 +849,11 @@ void
 Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << interface << address);
+    // The source address of the routes may change
+    std::fill(m_indexedRouteEntries.begin(), m_indexedRouteEntries.end(), nullptr);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -580,6 +863,8 @@ Ipv4GlobalRouting::SetIpv4(Ptr<Ipv4> ipv4)
     NS_LOG_FUNCTION(this << ipv4);
     NS_ASSERT(!m_ipv4 && ipv4);
     m_ipv4 = ipv4;
+    Ptr<Node> node = ipv4->GetObject<Node>();
+    m_nodeId = node ? node->GetId() : 0;
 }
 
 } // namespace ns3
@@ -20,15 +20,18 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-prefix-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
 #include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -77,6 +80,16 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      * \return the object TypeId
      */
     static TypeId GetTypeId();
+
+    /// How a route is chosen among the equal-cost routes to a destination
+    enum EcmpMode
+    {
+        ECMP_NONE,      //!< Always the first route
+        ECMP_RANDOM,    //!< A route drawn at random for each packet
+        ECMP_FLOW_HASH, //!< A route given by the hash of the five-tuple of the packet
+        ECMP_FLOWLET,   //!< A route drawn at random for each burst of packets of a flow
+    };
+
     /**
      * \brief Construct an empty Ipv4GlobalRouting routing protocol,
      *
@@ -108,6 +121,7 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesVersion() const override;
 
     /**
      * \brief Add a host route to the global routing table.
@@ -222,6 +236,41 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     void RemoveRoute(uint32_t i);
 
+    /**
+     * \brief Remove all the routes to some destinations.
+     *
+     * The routing table is walked once, however many destinations are given:
+     * this is how the global routes are updated incrementally.
+     *
+     * \param hosts The destinations of the host routes to remove.
+     * \param networks The destination networks and masks of the network routes to remove.
+     * \param externals The destination networks and masks of the external routes to remove.
+     */
+    void RemoveRoutesTo(const std::vector<Ipv4Address>& hosts,
+                        const std::vector<std::pair<Ipv4Address, Ipv4Mask>>& networks,
+                        const std::vector<std::pair<Ipv4Address, Ipv4Mask>>& externals);
+
+    /**
+     * \brief Set the weight of the routes through an interface, among the
+     * equal-cost routes to a destination.
+     *
+     * The routes are chosen in proportion to their weight, whatever the
+     * EcmpMode other than None.  A route of weight 0 is not used, unless all
+     * the equal-cost routes have a weight of 0.  The default weight is 1.
+     *
+     * \param interface The interface index.
+     * \param weight The weight of the routes through the interface.
+     */
+    void SetEcmpWeight(uint32_t interface, uint32_t weight);
+
+    /**
+     * \brief Get the weight of the routes through an interface.
+     * \param interface The interface index.
+     * \return The weight of the routes through the interface.
+     * \see SetEcmpWeight
+     */
+    uint32_t GetEcmpWeight(uint32_t interface) const;
+
     /**
      * Assign a fixed random variable stream number to the random variables
      * used by this model.  Return the number of streams (possibly zero) that
@@ -236,14 +285,30 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     void DoDispose() override;
 
   private:
-    /// Set to true if packets are randomly routed among ECMP; set to false for using only one route
-    /// consistently
+    /// Set to true if packets are randomly routed among ECMP, whatever m_ecmpMode; set to false
+    /// for choosing the routes according to m_ecmpMode
     bool m_randomEcmpRouting;
     /// Set to true if this interface should respond to interface events by globallly recomputing
     /// routes
     bool m_respondToInterfaceEvents;
     /// A uniform random number generator for randomly routing packets among ECMP
     Ptr<UniformRandomVariable> m_rand;
+    EcmpMode m_ecmpMode;                 //!< How a route is chosen among ECMP
+    uint32_t m_ecmpHashSeed;             //!< Seed of the hash of the five-tuples
+    Time m_flowletGap;                   //!< Idle time after which a flow may change route
+    uint32_t m_flowletTableSize;         //!< Number of slots of the flowlet table
+    std::vector<uint32_t> m_ecmpWeights; //!< Weights of the routes, by interface
+    uint32_t m_nodeId{0};                //!< Id of the node, mixed in the hash
+
+    /// The last packet of the flows hashed to a slot of the flowlet table, and their route
+    struct Flowlet
+    {
+        Time lastSeen;                  //!< Time of the last packet
+        uint32_t interface{UINT32_MAX}; //!< Output interface of the route
+        Ipv4Address gateway;            //!< Gateway of the route
+    };
+
+    std::vector<Flowlet> m_flowlets; //!< Flowlet table, allocated on first use
 
     /// container of Ipv4RoutingTableEntry (routes to hosts)
     typedef std::list<Ipv4RoutingTableEntry*> HostRoutes;
@@ -266,18 +331,58 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /**
+     * \brief Rebuild the index of the routes, if they changed since the last lookup.
+     */
+    void UpdateIndex();
+
     /**
      * \brief Lookup in the forwarding table for destination.
-     * \param dest destination address
+     * \param header the IPv4 header of the packet
+     * \param p the packet, starting with its transport header, if any (put 0 otherwise)
      * \param oif output interface if any (put 0 otherwise)
      * \return Ipv4Route to route the packet to reach dest address
      */
-    Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
+    Ptr<Ipv4Route> LookupGlobal(const Ipv4Header& header,
+                                Ptr<const Packet> p,
+                                Ptr<NetDevice> oif = nullptr);
+
+    /**
+     * \brief Choose one of the equal-cost routes found by a lookup.
+     * \param header the IPv4 header of the packet
+     * \param p the packet, starting with its transport header, if any (put 0 otherwise)
+     * \return the position of the route in m_ecmpRoutes
+     */
+    uint32_t SelectEcmpRoute(const Ipv4Header& header, Ptr<const Packet> p);
+
+    /**
+     * \brief Hash the five-tuple of a packet.
+     *
+     * The ports are only hashed if the packet is given, and is a TCP or UDP
+     * packet that is not fragmented.
+     *
+     * \param header the IPv4 header of the packet
+     * \param p the packet, starting with its transport header, if any (put 0 otherwise)
+     * \return the hash
+     */
+    uint32_t HashFlow(const Ipv4Header& header, Ptr<const Packet> p) const;
 
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    /// The host, network and external routes, by their position in the index
+    std::vector<Ipv4RoutingTableEntry*> m_indexedRoutes;
+    uint32_t m_nIndexedHostRoutes{0};    //!< Number of host routes in the index
+    uint32_t m_nIndexedNetworkRoutes{0}; //!< Number of network routes in the index
+    Ipv4PrefixTrie m_index;              //!< Index of the routes by destination
+    uint64_t m_routesVersion{1};         //!< Version of the routes
+    uint64_t m_indexVersion{0};          //!< Version of the routes in the index
+    std::vector<uint32_t> m_matches;     //!< Positions of the routes matching a lookup
+    std::vector<uint32_t> m_ecmpRoutes;  //!< Positions of the equal-cost routes of a lookup
+    /// The Ipv4Route of each indexed route, created on first use
+    std::vector<Ptr<Ipv4Route>> m_indexedRouteEntries;
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -21,12 +21,14 @@
 
 #include "arp-cache.h"
 #include "arp-l3-protocol.h"
+#include "gso-tag.h"
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-header.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
 #include "ipv4-route.h"
 #include "loopback-net-device.h"
+#include "tcp-l4-protocol.h"
 
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
@@ -87,6 +89,14 @@ Ipv4L3Protocol::GetTypeId()
                           TimeValue(Seconds(1)),
                           MakeTimeAccessor(&Ipv4L3Protocol::m_purge),
                           MakeTimeChecker(Seconds(0)))
+            .AddAttribute("RouteCacheSize",
+                          "The maximum number of routes cached for the forwarded packets, "
+                          "and for the packets sent without a route; 0 disables the caches. "
+                          "Only the routes of the routing protocols with a version are cached "
+                          "(see Ipv4RoutingProtocol::GetRoutesVersion).",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&Ipv4L3Protocol::m_routeCacheSize),
+                          MakeUintegerChecker<uint32_t>())
             .AddTraceSource("Tx",
                             "Send ipv4 packet to outgoing interface.",
                             MakeTraceSourceAccessor(&Ipv4L3Protocol::m_txTrace),
@@ -299,6 +309,7 @@ void
 Ipv4L3Protocol::SetRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol)
 {
     NS_LOG_FUNCTION(this << routingProtocol);
+    FlushRouteCache();
     m_routingProtocol = routingProtocol;
     m_routingProtocol->SetIpv4(this);
 }
@@ -326,6 +337,7 @@ Ipv4L3Protocol::DoDispose()
     }
     m_interfaces.clear();
     m_reverseInterfacesContainer.clear();
+    FlushRouteCache();
 
     m_sockets.clear();
     m_node = nullptr;
@@ -433,6 +445,7 @@ uint32_t
 Ipv4L3Protocol::AddIpv4Interface(Ptr<Ipv4Interface> interface)
 {
     NS_LOG_FUNCTION(this << interface);
+    FlushRouteCache();
     uint32_t index = m_interfaces.size();
     m_interfaces.push_back(interface);
     m_reverseInterfacesContainer[interface->GetDevice()] = index;
@@ -671,7 +684,24 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     }
 
     NS_ASSERT_MSG(m_routingProtocol, "Need a routing protocol object to process packets");
-    if (!m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
+    Ipv4Address destination = ipHeader.GetDestination();
+    if (m_routeCacheSize > 0 && !destination.IsBroadcast() && !destination.IsMulticast())
+    {
+        RouteCacheKey key{destination, static_cast<uint32_t>(interface), ipHeader.GetTos()};
+        Ptr<Ipv4Route> route = LookupRouteCache(m_inputRouteCache, key);
+        if (route)
+        {
+            IpForward(route, packet, ipHeader);
+            return;
+        }
+        // Cache the route if the routing protocol forwards the packet
+        m_cacheForward = m_routeCacheVersion != 0;
+        m_cacheForwardKey = key;
+    }
+    bool routed =
+        m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb);
+    m_cacheForward = false;
+    if (!routed)
     {
         NS_LOG_WARN("No route found for forwarding packet.  Drop.");
         m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, interface);
@@ -785,9 +815,24 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
         tos = ipTosTag.GetTos();
     }
 
+    // The segments of a GSO packet take consecutive identification values
+    // (see Ipv4QueueDiscItem::GsoSegment), as in Linux ip_select_ident_segs()
+    uint16_t idCount = 1;
+    GsoTag gsoTag;
+    if (protocol == TcpL4Protocol::PROT_NUMBER && packet->PeekPacketTag(gsoTag))
+    {
+        idCount = TcpL4Protocol::GetGsoSegmentCount(packet, gsoTag.GetSegmentSize());
+    }
+
     // can construct the header here
-    Ipv4Header ipHeader =
-        BuildHeader(source, destination, protocol, packet->GetSize(), ttl, tos, mayFragment);
+    Ipv4Header ipHeader = BuildHeader(source,
+                                      destination,
+                                      protocol,
+                                      packet->GetSize(),
+                                      ttl,
+                                      tos,
+                                      mayFragment,
+                                      idCount);
 
     // Handle a few cases:
     // 1) packet is passed in with a route entry
@@ -852,7 +897,7 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
                 route->SetGateway(Ipv4Address::GetAny());
                 route->SetSource(source);
                 route->SetOutputDevice(outInterface->GetDevice());
-                DecreaseIdentification(source, destination, protocol);
+                DecreaseIdentification(source, destination, protocol, idCount);
                 Send(pktCopyWithTags, source, destination, protocol, route);
             }
         }
@@ -881,7 +926,7 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
                 route->SetGateway(Ipv4Address::GetAny());
                 route->SetSource(source);
                 route->SetOutputDevice(outInterface->GetDevice());
-                DecreaseIdentification(source, destination, protocol);
+                DecreaseIdentification(source, destination, protocol, idCount);
                 Send(pktCopyWithTags, source, destination, protocol, route);
                 return;
             }
@@ -896,7 +941,19 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
     Ptr<Ipv4Route> newRoute;
     if (m_routingProtocol)
     {
-        newRoute = m_routingProtocol->RouteOutput(pktCopyWithTags, ipHeader, oif, errno_);
+        RouteCacheKey key{destination, Ipv4::IF_ANY, tos};
+        if (m_routeCacheSize > 0)
+        {
+            newRoute = LookupRouteCache(m_outputRouteCache, key);
+        }
+        if (!newRoute)
+        {
+            newRoute = m_routingProtocol->RouteOutput(pktCopyWithTags, ipHeader, oif, errno_);
+            if (newRoute && m_routeCacheSize > 0 && m_routeCacheVersion != 0)
+            {
+                AddRouteCache(m_outputRouteCache, key, newRoute);
+            }
+        }
     }
     else
     {
@@ -904,27 +961,28 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
     }
     if (newRoute)
     {
-        DecreaseIdentification(source, destination, protocol);
+        DecreaseIdentification(source, destination, protocol, idCount);
         Send(pktCopyWithTags, source, destination, protocol, newRoute);
     }
     else
     {
         NS_LOG_WARN("No route to host.  Drop.");
         m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, 0);
-        DecreaseIdentification(source, destination, protocol);
+        DecreaseIdentification(source, destination, protocol, idCount);
     }
 }
 
 void
 Ipv4L3Protocol::DecreaseIdentification(Ipv4Address source,
                                        Ipv4Address destination,
-                                       uint8_t protocol)
+                                       uint8_t protocol,
+                                       uint16_t count)
 {
     uint64_t src = source.Get();
     uint64_t dst = destination.Get();
     uint64_t srcDst = dst | (src << 32);
     std::pair<uint64_t, uint8_t> key = std::make_pair(srcDst, protocol);
-    m_identification[key]--;
+    m_identification[key] -= count;
 }
 
 Ipv4Header
@@ -934,10 +992,11 @@ Ipv4L3Protocol::BuildHeader(Ipv4Address source,
                             uint16_t payloadSize,
                             uint8_t ttl,
                             uint8_t tos,
-                            bool mayFragment)
+                            bool mayFragment,
+                            uint16_t count)
 {
     NS_LOG_FUNCTION(this << source << destination << (uint16_t)protocol << payloadSize
-                         << (uint16_t)ttl << (uint16_t)tos << mayFragment);
+                         << (uint16_t)ttl << (uint16_t)tos << mayFragment << count);
     Ipv4Header ipHeader;
     ipHeader.SetSource(source);
     ipHeader.SetDestination(destination);
@@ -955,7 +1014,7 @@ Ipv4L3Protocol::BuildHeader(Ipv4Address source,
     {
         ipHeader.SetMayFragment();
         ipHeader.SetIdentification(m_identification[key]);
-        m_identification[key]++;
+        m_identification[key] += count;
     }
     else
     {
@@ -965,7 +1024,7 @@ Ipv4L3Protocol::BuildHeader(Ipv4Address source,
         // >> Originating sources MAY set the IPv4 ID field of atomic datagrams
         //    to any value.
         ipHeader.SetIdentification(m_identification[key]);
-        m_identification[key]++;
+        m_identification[key] += count;
     }
     if (Node::ChecksumEnabled())
     {
@@ -1007,10 +1066,13 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        // GSO packets are segmented by the traffic control layer, not fragmented
+        GsoTag gsoTag;
+        uint32_t mtu = outInterface->GetDevice()->GetMtu();
+        if (packet->GetSize() + ipHeader.GetSerializedSize() > mtu && !packet->PeekPacketTag(gsoTag))
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
-            DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
+            DoFragmentation(packet, ipHeader, mtu, listFragments);
             for (auto it = listFragments.begin(); it != listFragments.end(); it++)
             {
                 NS_LOG_LOGIC("Sending fragment " << *(it->first));
@@ -1064,11 +1126,66 @@ Ipv4L3Protocol::IpMulticastForward(Ptr<Ipv4MulticastRoute> mrtentry,
 }
 
 // This function analogous to Linux ip_forward()
+bool
+Ipv4L3Protocol::RouteCacheKey::operator==(const RouteCacheKey& other) const
+{
+    return destination == other.destination && interface == other.interface && tos == other.tos;
+}
+
+std::size_t
+Ipv4L3Protocol::RouteCacheKeyHash::operator()(const RouteCacheKey& key) const
+{
+    uint64_t value = (uint64_t(key.destination.Get()) << 32) ^ (uint64_t(key.tos) << 24) ^
+                     key.interface;
+    return std::hash<uint64_t>()(value);
+}
+
+Ptr<Ipv4Route>
+Ipv4L3Protocol::LookupRouteCache(const RouteCache_t& cache, const RouteCacheKey& key)
+{
+    uint64_t version = m_routingProtocol->GetRoutesVersion();
+    if (version != m_routeCacheVersion)
+    {
+        NS_LOG_LOGIC("Routes changed from version " << m_routeCacheVersion << " to " << version);
+        FlushRouteCache();
+        m_routeCacheVersion = version;
+    }
+    if (version == 0)
+    {
+        return nullptr;
+    }
+    auto it = cache.find(key);
+    return it != cache.end() ? it->second : nullptr;
+}
+
+void
+Ipv4L3Protocol::AddRouteCache(RouteCache_t& cache, const RouteCacheKey& key, Ptr<Ipv4Route> route)
+{
+    NS_LOG_FUNCTION(this << key.destination << key.interface << +key.tos << route);
+    if (cache.size() >= m_routeCacheSize)
+    {
+        cache.clear();
+    }
+    cache.emplace(key, route);
+}
+
+void
+Ipv4L3Protocol::FlushRouteCache()
+{
+    m_inputRouteCache.clear();
+    m_outputRouteCache.clear();
+}
+
 void
 Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv4Header& header)
 {
     NS_LOG_FUNCTION(this << rtentry << p << header);
     NS_LOG_LOGIC("Forwarding logic for node: " << m_node->GetId());
+    if (m_cacheForward)
+    {
+        m_cacheForward = false;
+        AddRouteCache(m_inputRouteCache, m_cacheForwardKey, rtentry);
+    }
     // Forwarding
     Ipv4Header ipHeader = header;
     Ptr<Packet> packet = p->Copy();
@@ -1168,6 +1285,7 @@ bool
 Ipv4L3Protocol::AddAddress(uint32_t i, Ipv4InterfaceAddress address)
 {
     NS_LOG_FUNCTION(this << i << address);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(i);
     bool retVal = interface->AddAddress(address);
     if (m_routingProtocol)
@@ -1197,6 +1315,7 @@ bool
 Ipv4L3Protocol::RemoveAddress(uint32_t i, uint32_t addressIndex)
 {
     NS_LOG_FUNCTION(this << i << addressIndex);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(i);
     Ipv4InterfaceAddress address = interface->RemoveAddress(addressIndex);
     if (address != Ipv4InterfaceAddress())
@@ -1214,6 +1333,7 @@ bool
 Ipv4L3Protocol::RemoveAddress(uint32_t i, Ipv4Address address)
 {
     NS_LOG_FUNCTION(this << i << address);
+    FlushRouteCache();
 
     if (address == Ipv4Address::GetLoopback())
     {
@@ -1326,6 +1446,7 @@ void
 Ipv4L3Protocol::SetMetric(uint32_t i, uint16_t metric)
 {
     NS_LOG_FUNCTION(this << i << metric);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(i);
     interface->SetMetric(metric);
 }
@@ -1358,6 +1479,7 @@ void
 Ipv4L3Protocol::SetUp(uint32_t i)
 {
     NS_LOG_FUNCTION(this << i);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(i);
 
     // RFC 791, pg.25:
@@ -1386,6 +1508,7 @@ void
 Ipv4L3Protocol::SetDown(uint32_t ifaceIndex)
 {
     NS_LOG_FUNCTION(this << ifaceIndex);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(ifaceIndex);
     interface->SetDown();
 
@@ -1408,6 +1531,7 @@ void
 Ipv4L3Protocol::SetForwarding(uint32_t i, bool val)
 {
     NS_LOG_FUNCTION(this << i);
+    FlushRouteCache();
     Ptr<Ipv4Interface> interface = GetInterface(i);
     interface->SetForwarding(val);
 }
@@ -1423,6 +1547,7 @@ void
 Ipv4L3Protocol::SetIpForward(bool forward)
 {
     NS_LOG_FUNCTION(this << forward);
+    FlushRouteCache();
     m_ipForward = forward;
     for (auto i = m_interfaces.begin(); i != m_interfaces.end(); i++)
     {
@@ -1477,8 +1602,6 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
 
     NS_LOG_FUNCTION(this << *packet << outIfaceMtu << &listFragments);
 
-    Ptr<Packet> p = packet->Copy();
-
     NS_ASSERT_MSG((ipv4Header.GetSerializedSize() == 5 * 4),
                   "IPv4 fragmentation implementation only works without option headers.");
 
@@ -1499,7 +1622,7 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
     {
         Ipv4Header fragmentHeader = ipv4Header;
 
-        if (p->GetSize() > offset + fragmentSize)
+        if (packet->GetSize() > offset + fragmentSize)
         {
             moreFragment = true;
             currentFragmentablePartSize = fragmentSize;
@@ -1508,7 +1631,7 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
         else
         {
             moreFragment = false;
-            currentFragmentablePartSize = p->GetSize() - offset;
+            currentFragmentablePartSize = packet->GetSize() - offset;
             if (!isLastFragment)
             {
                 fragmentHeader.SetMoreFragments();
@@ -1519,8 +1642,9 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
             }
         }
 
+        // The fragment is a view of the buffer of the packet: the payload is not copied
         NS_LOG_LOGIC("Fragment creation - " << offset << ", " << currentFragmentablePartSize);
-        Ptr<Packet> fragment = p->CreateFragment(offset, currentFragmentablePartSize);
+        Ptr<Packet> fragment = packet->CreateFragment(offset, currentFragmentablePartSize);
         NS_LOG_LOGIC("Fragment created - " << offset << ", " << fragment->GetSize());
 
         fragmentHeader.SetFragmentOffset(offset + originalOffset);
@@ -1534,11 +1658,6 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
         NS_LOG_LOGIC("Fragment check - " << fragmentHeader.GetFragmentOffset());
 
         NS_LOG_LOGIC("New fragment Header " << fragmentHeader);
-
-        std::ostringstream oss;
-        oss << fragmentHeader;
-        fragment->Print(oss);
-
         NS_LOG_LOGIC("New fragment " << *fragment);
 
         listFragments.emplace_back(fragment, fragmentHeader);
@@ -1559,7 +1678,6 @@ Ipv4L3Protocol::ProcessFragment(Ptr<Packet>& packet, Ipv4Header& ipHeader, uint3
         uint32_t(ipHeader.GetIdentification()) << 16 | uint32_t(ipHeader.GetProtocol());
     FragmentKey_t key;
     bool ret = false;
-    Ptr<Packet> p = packet->Copy();
 
     key.first = addressCombination;
     key.second = idProto;
@@ -1583,7 +1701,8 @@ Ipv4L3Protocol::ProcessFragment(Ptr<Packet>& packet, Ipv4Header& ipHeader, uint3
     NS_LOG_LOGIC("Adding fragment - Size: " << packet->GetSize()
                                             << " - Offset: " << (ipHeader.GetFragmentOffset()));
 
-    fragments->AddFragment(p, ipHeader.GetFragmentOffset(), !ipHeader.IsLastFragment());
+    // The fragment is owned by the reassembly from now on: it is not copied
+    fragments->AddFragment(packet, ipHeader.GetFragmentOffset(), !ipHeader.IsLastFragment());
 
     if (fragments->IsEntire())
     {
@@ -1598,7 +1717,9 @@ Ipv4L3Protocol::ProcessFragment(Ptr<Packet>& packet, Ipv4Header& ipHeader, uint3
 }
 
 Ipv4L3Protocol::Fragments::Fragments()
-    : m_moreFragment(false)
+    : m_moreFragment(false),
+      m_lastOffset(0),
+      m_size(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -1610,22 +1731,46 @@ Ipv4L3Protocol::Fragments::AddFragment(Ptr<Packet> fragment,
 {
     NS_LOG_FUNCTION(this << fragment << fragmentOffset << moreFragment);
 
-    std::list<std::pair<Ptr<Packet>, uint16_t>>::iterator it;
+    // The fragment with the largest offset tells if other fragments will be sent
+    if (m_fragments.empty() || fragmentOffset >= m_lastOffset)
+    {
+        m_lastOffset = fragmentOffset;
+        m_moreFragment = moreFragment;
+    }
 
-    for (it = m_fragments.begin(); it != m_fragments.end(); it++)
+    // Add the parts of the fragment which were not received yet.
+    // We do not overwrite the "old" with the "new" because we do not know when each
+    // arrived. This is different from what Linux does. It is not possible to emulate a
+    // fragmentation attack.
+    uint32_t start = fragmentOffset;
+    uint32_t end = start + fragment->GetSize();
+    auto it = m_fragments.upper_bound(start);
+    if (it != m_fragments.begin())
+    {
+        auto previous = std::prev(it);
+        start = std::max(start, previous->first + previous->second->GetSize());
+    }
+    while (start < end)
     {
-        if (it->second > fragmentOffset)
+        uint32_t gapEnd = (it == m_fragments.end()) ? end : std::min(end, it->first);
+        if (start < gapEnd)
+        {
+            NS_LOG_LOGIC("Adding: " << start << " - " << gapEnd);
+            Ptr<Packet> part = fragment;
+            if (gapEnd - start != fragment->GetSize())
+            {
+                part = fragment->CreateFragment(start - fragmentOffset, gapEnd - start);
+            }
+            m_fragments.emplace_hint(it, start, part);
+            m_size += gapEnd - start;
+        }
+        if (it == m_fragments.end())
         {
             break;
         }
+        start = std::max(start, it->first + it->second->GetSize());
+        it++;
     }
-
-    if (it == m_fragments.end())
-    {
-        m_moreFragment = moreFragment;
-    }
-
-    m_fragments.insert(it, std::pair<Ptr<Packet>, uint16_t>(fragment, fragmentOffset));
 }
 
 bool
@@ -1633,29 +1778,13 @@ Ipv4L3Protocol::Fragments::IsEntire() const
 {
     NS_LOG_FUNCTION(this);
 
-    bool ret = !m_moreFragment && !m_fragments.empty();
-
-    if (ret)
+    if (m_moreFragment || m_fragments.empty())
     {
-        uint16_t lastEndOffset = 0;
-
-        for (auto it = m_fragments.begin(); it != m_fragments.end(); it++)
-        {
-            // overlapping fragments do exist
-            NS_LOG_LOGIC("Checking overlaps " << lastEndOffset << " - " << it->second);
-
-            if (lastEndOffset < it->second)
-            {
-                ret = false;
-                break;
-            }
-            // fragments might overlap in strange ways
-            uint16_t fragmentEnd = it->first->GetSize() + it->second;
-            lastEndOffset = std::max(lastEndOffset, fragmentEnd);
-        }
+        return false;
     }
-
-    return ret;
+    // The intervals are disjoint: there is no hole if they add up to the end of the last one
+    auto last = m_fragments.rbegin();
+    return m_size == last->first + last->second->GetSize();
 }
 
 Ptr<Packet>
@@ -1665,32 +1794,13 @@ Ipv4L3Protocol::Fragments::GetPacket() const
 
     auto it = m_fragments.begin();
 
-    Ptr<Packet> p = it->first->Copy();
-    uint16_t lastEndOffset = p->GetSize();
+    Ptr<Packet> p = it->second->Copy();
     it++;
 
     for (; it != m_fragments.end(); it++)
     {
-        if (lastEndOffset > it->second)
-        {
-            // The fragments are overlapping.
-            // We do not overwrite the "old" with the "new" because we do not know when each
-            // arrived. This is different from what Linux does. It is not possible to emulate a
-            // fragmentation attack.
-            uint32_t newStart = lastEndOffset - it->second;
-            if (it->first->GetSize() > newStart)
-            {
-                uint32_t newSize = it->first->GetSize() - newStart;
-                Ptr<Packet> tempFragment = it->first->CreateFragment(newStart, newSize);
-                p->AddAtEnd(tempFragment);
-            }
-        }
-        else
-        {
-            NS_LOG_LOGIC("Adding: " << *(it->first));
-            p->AddAtEnd(it->first);
-        }
-        lastEndOffset = p->GetSize();
+        NS_LOG_LOGIC("Adding: " << *(it->second));
+        p->AddAtEnd(it->second);
     }
 
     return p;
@@ -1701,31 +1811,16 @@ Ipv4L3Protocol::Fragments::GetPartialPacket() const
 {
     NS_LOG_FUNCTION(this);
 
-    auto it = m_fragments.begin();
-
     Ptr<Packet> p = Create<Packet>();
-    uint16_t lastEndOffset = 0;
-
-    if (m_fragments.begin()->second > 0)
-    {
-        return p;
-    }
 
-    for (it = m_fragments.begin(); it != m_fragments.end(); it++)
+    for (auto it = m_fragments.begin(); it != m_fragments.end(); it++)
     {
-        if (lastEndOffset > it->second)
+        if (it->first != p->GetSize())
         {
-            uint32_t newStart = lastEndOffset - it->second;
-            uint32_t newSize = it->first->GetSize() - newStart;
-            Ptr<Packet> tempFragment = it->first->CreateFragment(newStart, newSize);
-            p->AddAtEnd(tempFragment);
-        }
-        else if (lastEndOffset == it->second)
-        {
-            NS_LOG_LOGIC("Adding: " << *(it->first));
-            p->AddAtEnd(it->first);
+            break;
         }
-        lastEndOffset = p->GetSize();
+        NS_LOG_LOGIC("Adding: " << *(it->second));
+        p->AddAtEnd(it->second);
     }
 
     return p;
@@ -34,6 +34,7 @@
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 class Ipv4L3ProtocolTestCase;
@@ -303,8 +304,12 @@ class Ipv4L3Protocol : public Ipv4
      * \param source source IPv4 address
      * \param destination destination IPv4 address
      * \param protocol L4 protocol
+     * \param count number of identification values taken by the packet
      */
-    void DecreaseIdentification(Ipv4Address source, Ipv4Address destination, uint8_t protocol);
+    void DecreaseIdentification(Ipv4Address source,
+                                Ipv4Address destination,
+                                uint8_t protocol,
+                                uint16_t count = 1);
 
     /**
      * \brief Construct an IPv4 header.
@@ -315,6 +320,8 @@ class Ipv4L3Protocol : public Ipv4
      * \param ttl Time to Live
      * \param tos Type of Service
      * \param mayFragment true if the packet can be fragmented
+     * \param count number of identification values taken by the packet, e.g.,
+     * one per segment of a GSO packet
      * \return newly created IPv4 header
      */
     Ipv4Header BuildHeader(Ipv4Address source,
@@ -323,7 +330,8 @@ class Ipv4L3Protocol : public Ipv4
                            uint16_t payloadSize,
                            uint8_t ttl,
                            uint8_t tos,
-                           bool mayFragment);
+                           bool mayFragment,
+                           uint16_t count = 1);
 
     /**
      * \brief Send packet with route.
@@ -537,6 +545,11 @@ class Ipv4L3Protocol : public Ipv4
 
     /**
      * \brief A Set of Fragment belonging to the same packet (src, dst, identification and proto)
+     *
+     * The fragments are stored as disjoint intervals indexed by offset: the
+     * bytes already received are cut off the fragments added later, as views
+     * of their buffer, so that the completeness check takes constant time and
+     * the packet is rebuilt by appending each interval once.
      */
     class Fragments : public SimpleRefCount<Fragments>
     {
@@ -591,9 +604,19 @@ class Ipv4L3Protocol : public Ipv4
         bool m_moreFragment;
 
         /**
-         * \brief The current fragments.
+         * \brief The largest offset of the fragments added.
+         */
+        uint32_t m_lastOffset;
+
+        /**
+         * \brief The number of bytes received.
          */
-        std::list<std::pair<Ptr<Packet>, uint16_t>> m_fragments;
+        uint32_t m_size;
+
+        /**
+         * \brief The disjoint intervals received, indexed by offset.
+         */
+        std::map<uint32_t, Ptr<Packet>> m_fragments;
 
         /**
          * \brief Timeout iterator to "event" handler
@@ -632,6 +655,67 @@ class Ipv4L3Protocol : public Ipv4
     Time m_purge;       //!< time between purging expired duplicate entries
     EventId m_cleanDpd; //!< event to cleanup expired duplicate entries
 
+    /// Key of the route cache
+    struct RouteCacheKey
+    {
+        Ipv4Address destination; //!< Destination address
+        uint32_t interface;      //!< Input interface, or Ipv4::IF_ANY for the sent packets
+        uint8_t tos;             //!< Type of service
+
+        /**
+         * \brief Compare two keys
+         * \param other the other key
+         * \return true if the keys are equal
+         */
+        bool operator==(const RouteCacheKey& other) const;
+    };
+
+    /// Hash of the keys of the route cache
+    struct RouteCacheKeyHash
+    {
+        /**
+         * \brief Hash a key
+         * \param key the key
+         * \return the hash
+         */
+        std::size_t operator()(const RouteCacheKey& key) const;
+    };
+
+    /// Container of the cached routes
+    typedef std::unordered_map<RouteCacheKey, Ptr<Ipv4Route>, RouteCacheKeyHash> RouteCache_t;
+
+    /**
+     * \brief Look up a route in a route cache
+     *
+     * The caches are flushed first if the version of the routes of the
+     * routing protocol changed.
+     *
+     * \param cache the route cache
+     * \param key the key of the route
+     * \return the cached route, or nullptr
+     */
+    Ptr<Ipv4Route> LookupRouteCache(const RouteCache_t& cache, const RouteCacheKey& key);
+
+    /**
+     * \brief Add a route to a route cache, emptying the cache if it is full
+     * \param cache the route cache
+     * \param key the key of the route
+     * \param route the route
+     */
+    void AddRouteCache(RouteCache_t& cache, const RouteCacheKey& key, Ptr<Ipv4Route> route);
+
+    /**
+     * \brief Flush the route caches, e.g., when an interface changes
+     */
+    void FlushRouteCache();
+
+    uint32_t m_routeCacheSize;       //!< Maximum number of routes in each cache
+    RouteCache_t m_inputRouteCache;  //!< Routes of the forwarded packets
+    RouteCache_t m_outputRouteCache; //!< Routes of the packets sent without a route
+    uint64_t m_routeCacheVersion{0}; //!< Version of the routes in the caches
+    bool m_cacheForward{false};      //!< Whether to cache the route of the next forwarded packet
+    RouteCacheKey m_cacheForwardKey; //!< Key of the route of the next forwarded packet
+
     Ipv4RoutingProtocol::UnicastForwardCallback m_ucb;   ///< Unicast forward callback
     Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; ///< Multicast forward callback
     Ipv4RoutingProtocol::LocalDeliverCallback m_lcb;     ///< Local delivery callback
@@ -68,6 +68,24 @@ Ipv4ListRouting::DoDispose()
     m_ipv4 = nullptr;
 }
 
+uint64_t
+Ipv4ListRouting::GetRoutesVersion() const
+{
+    // The version of the list is increased when a protocol is added, and the
+    // versions of the protocols only increase: their sum is a version too
+    uint64_t version = m_routesVersion;
+    for (const auto& [priority, protocol] : m_routingProtocols)
+    {
+        uint64_t protocolVersion = protocol->GetRoutesVersion();
+        if (protocolVersion == 0)
+        {
+            return 0;
+        }
+        version += protocolVersion;
+    }
+    return version;
+}
+
 void
 Ipv4ListRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
 {
@@ -253,6 +271,7 @@ Ipv4ListRouting::AddRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol, in
     NS_LOG_FUNCTION(this << routingProtocol->GetInstanceTypeId() << priority);
     m_routingProtocols.emplace_back(priority, routingProtocol);
     m_routingProtocols.sort(Compare);
+    m_routesVersion++;
     if (m_ipv4)
     {
         routingProtocol->SetIpv4(m_ipv4);
@@ -100,6 +100,7 @@ class Ipv4ListRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesVersion() const override;
 
   protected:
     void DoDispose() override;
@@ -123,7 +124,8 @@ class Ipv4ListRouting : public Ipv4RoutingProtocol
      * \return true if they are the same, false otherwise
      */
     static bool Compare(const Ipv4RoutingProtocolEntry& a, const Ipv4RoutingProtocolEntry& b);
-    Ptr<Ipv4> m_ipv4; //!< Ipv4 this protocol is associated with.
+    Ptr<Ipv4> m_ipv4;            //!< Ipv4 this protocol is associated with.
+    uint64_t m_routesVersion{1}; //!< Version of the list of routing protocols
 };
 
 } // namespace ns3
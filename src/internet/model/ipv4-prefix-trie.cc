@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-prefix-trie.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+/**
+ * \brief Get the mask of a prefix length
+ * \param length the prefix length
+ * \return the mask, in host order
+ */
+static inline uint32_t
+PrefixMask(uint8_t length)
+{
+    return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+/**
+ * \brief Get a bit of an address
+ * \param address the address, in host order
+ * \param position the position of the bit, 0 being the most significant
+ * \return the bit
+ */
+static inline uint32_t
+PrefixBit(uint32_t address, uint8_t position)
+{
+    return (address >> (31 - position)) & 1;
+}
+
+/**
+ * \brief Get the length of the common prefix of two addresses
+ * \param a the first address, in host order
+ * \param b the second address, in host order
+ * \return the number of leading bits in common
+ */
+static uint8_t
+CommonPrefixLength(uint32_t a, uint32_t b)
+{
+    uint32_t diff = a ^ b;
+    uint8_t length = 0;
+    while (length < 32 && !(diff & 0x80000000))
+    {
+        diff <<= 1;
+        length++;
+    }
+    return length;
+}
+
+void
+Ipv4PrefixTrie::Clear()
+{
+    m_nodes.clear();
+    m_others.clear();
+}
+
+bool
+Ipv4PrefixTrie::IsEmpty() const
+{
+    return m_nodes.empty() && m_others.empty();
+}
+
+int32_t
+Ipv4PrefixTrie::NewNode(uint32_t prefix, uint8_t length)
+{
+    m_nodes.push_back(Node{prefix, length});
+    return m_nodes.size() - 1;
+}
+
+void
+Ipv4PrefixTrie::Insert(Ipv4Address network, Ipv4Mask mask, uint32_t position)
+{
+    uint8_t length = mask.GetPrefixLength();
+    uint32_t prefix = network.Get() & mask.Get();
+    if (mask.Get() != PrefixMask(length))
+    {
+        m_others.push_back(Other{prefix, mask.Get(), position});
+        return;
+    }
+
+    if (m_nodes.empty())
+    {
+        NewNode(0, 0);
+    }
+    // The node 0 is the root, with an empty prefix.  Every node on the way
+    // down matches the prefix inserted, and is not longer.
+    int32_t current = 0;
+    while (m_nodes[current].length < length)
+    {
+        uint32_t bit = PrefixBit(prefix, m_nodes[current].length);
+        int32_t next = m_nodes[current].child[bit];
+        if (next < 0)
+        {
+            next = NewNode(prefix, length);
+            m_nodes[current].child[bit] = next;
+        }
+        else
+        {
+            uint8_t common = std::min({CommonPrefixLength(prefix, m_nodes[next].prefix),
+                                       length,
+                                       m_nodes[next].length});
+            if (common < m_nodes[next].length)
+            {
+                // The child is more specific: insert the common prefix above it
+                int32_t split = NewNode(prefix & PrefixMask(common), common);
+                m_nodes[split].child[PrefixBit(m_nodes[next].prefix, common)] = next;
+                m_nodes[current].child[bit] = split;
+                next = split;
+            }
+        }
+        current = next;
+    }
+    NS_ASSERT(m_nodes[current].prefix == prefix && m_nodes[current].length == length);
+    NS_ASSERT(m_nodes[current].routes.empty() || m_nodes[current].routes.back() < position);
+    m_nodes[current].routes.push_back(position);
+}
+
+void
+Ipv4PrefixTrie::Lookup(Ipv4Address dest, std::vector<uint32_t>& positions) const
+{
+    positions.clear();
+    uint32_t address = dest.Get();
+
+    int32_t current = m_nodes.empty() ? -1 : 0;
+    while (current >= 0)
+    {
+        const Node& node = m_nodes[current];
+        if ((address & PrefixMask(node.length)) != node.prefix)
+        {
+            break;
+        }
+        if (!node.routes.empty())
+        {
+            std::size_t middle = positions.size();
+            positions.insert(positions.end(), node.routes.begin(), node.routes.end());
+            if (middle > 0)
+            {
+                std::inplace_merge(positions.begin(),
+                                   positions.begin() + middle,
+                                   positions.end());
+            }
+        }
+        if (node.length == 32)
+        {
+            break;
+        }
+        current = node.child[PrefixBit(address, node.length)];
+    }
+
+    for (const auto& other : m_others)
+    {
+        if ((address & other.mask) == other.network)
+        {
+            positions.insert(std::upper_bound(positions.begin(), positions.end(), other.position),
+                             other.position);
+        }
+    }
+}
+
+} // namespace ns3
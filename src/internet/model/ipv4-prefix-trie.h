@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_PREFIX_TRIE_H
+#define IPV4_PREFIX_TRIE_H
+
+#include "ns3/ipv4-address.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Index of the routes of a routing table by destination prefix
+ *
+ * The routes are identified by their position in the routing table, and
+ * stored in a path-compressed binary trie (Patricia trie) keyed by their
+ * destination prefix: a lookup only visits the prefixes that match the
+ * destination, instead of every route of the table.  The nodes of the trie
+ * are kept in a single vector.
+ *
+ * Lookup() returns the positions of all the routes matching the
+ * destination, in increasing order, so that the routing protocols can apply
+ * their own rules (longest prefix, metric, ECMP) exactly as they would by
+ * scanning the table.  Routes with a non-contiguous mask cannot be stored in
+ * the trie, and are checked one by one.
+ *
+ * The routing protocols rebuild the trie lazily, on the first lookup after
+ * their table changed.
+ */
+class Ipv4PrefixTrie
+{
+  public:
+    /**
+     * \brief Remove all the routes
+     */
+    void Clear();
+
+    /**
+     * \brief Add a route
+     *
+     * The routes must be added in increasing order of position.
+     *
+     * \param network the destination network of the route
+     * \param mask the mask of the destination network
+     * \param position the position of the route in its routing table
+     */
+    void Insert(Ipv4Address network, Ipv4Mask mask, uint32_t position);
+
+    /**
+     * \brief Find the routes matching a destination
+     * \param dest the destination address
+     * \param positions filled with the positions of the matching routes, in
+     * increasing order
+     */
+    void Lookup(Ipv4Address dest, std::vector<uint32_t>& positions) const;
+
+    /**
+     * \brief Check if the trie holds no route
+     * \return true if there is no route
+     */
+    bool IsEmpty() const;
+
+  private:
+    /// A prefix, with the routes to it and the longer prefixes below it
+    struct Node
+    {
+        uint32_t prefix;                //!< Prefix, masked
+        uint8_t length;                 //!< Prefix length
+        int32_t child[2]{-1, -1};       //!< Longer prefixes, by their next bit
+        std::vector<uint32_t> routes{}; //!< Positions of the routes to this prefix
+    };
+
+    /// A route with a non-contiguous mask
+    struct Other
+    {
+        uint32_t network;  //!< Destination network, masked
+        uint32_t mask;     //!< Mask of the destination network
+        uint32_t position; //!< Position of the route
+    };
+
+    /**
+     * \brief Add a node to the trie
+     * \param prefix the prefix, masked
+     * \param length the prefix length
+     * \return the index of the node
+     */
+    int32_t NewNode(uint32_t prefix, uint8_t length);
+
+    std::vector<Node> m_nodes;   //!< Nodes of the trie, the root first
+    std::vector<Other> m_others; //!< Routes with a non-contiguous mask
+};
+
+} // namespace ns3
+
+#endif /* IPV4_PREFIX_TRIE_H */
@@ -17,7 +17,9 @@
 
 #include "ipv4-queue-disc-item.h"
 
+#include "gso-tag.h"
 #include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 #include "udp-header.h"
 
 #include "ns3/log.h"
@@ -170,4 +172,37 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
     return hash;
 }
 
+std::vector<Ptr<QueueDiscItem>>
+Ipv4QueueDiscItem::GsoSegment()
+{
+    NS_LOG_FUNCTION(this);
+
+    GsoTag gsoTag;
+    if (m_headerAdded || !GetPacket()->PeekPacketTag(gsoTag))
+    {
+        return {};
+    }
+    NS_ASSERT_MSG(m_header.GetProtocol() == TcpL4Protocol::PROT_NUMBER,
+                  "Generic segmentation offload is only supported for TCP");
+
+    std::vector<Ptr<Packet>> segments = TcpL4Protocol::GsoSegment(GetPacket(),
+                                                                  gsoTag.GetSegmentSize(),
+                                                                  m_header.GetSource(),
+                                                                  m_header.GetDestination());
+    std::vector<Ptr<QueueDiscItem>> items;
+    items.reserve(segments.size());
+    for (uint16_t i = 0; i < segments.size(); ++i)
+    {
+        Ipv4Header header = m_header;
+        header.SetPayloadSize(segments[i]->GetSize());
+        header.SetIdentification(m_header.GetIdentification() + i);
+        Ptr<QueueDiscItem> item =
+            Create<Ipv4QueueDiscItem>(segments[i], GetAddress(), GetProtocol(), header);
+        item->SetTxQueueIndex(GetTxQueueIndex());
+        item->SetTimeStamp(GetTimeStamp());
+        items.push_back(item);
+    }
+    return items;
+}
+
 } // namespace ns3
@@ -105,6 +105,17 @@ class Ipv4QueueDiscItem : public QueueDiscItem
      */
     uint32_t Hash(uint32_t perturbation) const override;
 
+    /**
+     * \brief Split a TCP packet built by generic segmentation offload
+     *
+     * Each segment is carried by a new item whose IPv4 header is a copy of the
+     * one of this item, with the payload length of the segment and a new identification.
+     *
+     * \return the items carrying the segments, or an empty list if the packet
+     *         carries no GsoTag
+     */
+    std::vector<Ptr<QueueDiscItem>> GsoSegment() override;
+
   private:
     Ipv4Header m_header; //!< The IPv4 header.
     bool m_headerAdded;  //!< True if the header has already been added to the packet.
@@ -181,6 +181,20 @@ class Ipv4RoutingProtocol : public Object
      */
     virtual void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                                    Time::Unit unit = Time::S) const = 0;
+
+    /**
+     * \brief Get the version of the routes
+     *
+     * Ipv4L3Protocol caches the routes of the packets it forwards, and of the
+     * packets it sends without a route, by destination, input interface and
+     * TOS, and flushes its caches when the version changes.  A protocol returning a non-zero version must route
+     * the packets as a function of these fields and of its version only, and
+     * must increase its version whenever its routes change.
+     *
+     * \return the version of the routes, or zero (the default) if the routes
+     * must not be cached
+     */
+    virtual uint64_t GetRoutesVersion() const;
 };
 
 } // namespace ns3
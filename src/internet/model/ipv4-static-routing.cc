@@ -80,6 +80,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_routesVersion++;
     }
 }
 
@@ -98,6 +99,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         auto routePtr = new Ipv4RoutingTableEntry(route);
 
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_routesVersion++;
     }
 }
 
@@ -153,6 +155,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_routesVersion++;
 }
 
 uint32_t
@@ -239,6 +242,24 @@ Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metr
     return false;
 }
 
+void
+Ipv4StaticRouting::UpdateIndex()
+{
+    if (m_indexVersion == m_routesVersion)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+    m_index.Clear();
+    m_indexedRoutes.assign(m_networkRoutes.begin(), m_networkRoutes.end());
+    for (uint32_t i = 0; i < m_indexedRoutes.size(); i++)
+    {
+        const Ipv4RoutingTableEntry* route = m_indexedRoutes[i].first;
+        m_index.Insert(route->GetDestNetwork(), route->GetDestNetworkMask(), i);
+    }
+    m_indexVersion = m_routesVersion;
+}
+
 Ptr<Ipv4Route>
 Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
@@ -261,54 +282,51 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    // The index gives the routes matching the destination, in the order of the table
+    UpdateIndex();
+    m_index.Lookup(dest, m_matches);
+    for (uint32_t position : m_matches)
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
+        Ipv4RoutingTableEntry* j = m_indexedRoutes[position].first;
+        uint32_t metric = m_indexedRoutes[position].second;
         Ipv4Mask mask = (j)->GetDestNetworkMask();
         uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+        NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
+                                                   << ", metric " << metric);
+        if (oif)
         {
-            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
-                                                       << ", metric " << metric);
-            if (oif)
-            {
-                if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
-            }
-            if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-                NS_LOG_LOGIC("Previous match longer, skipping");
-                continue;
-            }
-            if (masklen > longest_mask) // Reset metric if longer masklen
+            if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
             {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
-            if (metric > shortest_metric)
-            {
-                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                NS_LOG_LOGIC("Not on requested interface, skipping");
                 continue;
             }
-            shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-            if (masklen == 32)
-            {
-                break;
-            }
+        }
+        if (masklen < longest_mask) // Not interested if got shorter mask
+        {
+            NS_LOG_LOGIC("Previous match longer, skipping");
+            continue;
+        }
+        if (masklen > longest_mask) // Reset metric if longer masklen
+        {
+            shortest_metric = 0xffffffff;
+        }
+        longest_mask = masklen;
+        if (metric > shortest_metric)
+        {
+            NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+            continue;
+        }
+        shortest_metric = metric;
+        Ipv4RoutingTableEntry* route = (j);
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+        if (masklen == 32)
+        {
+            break;
         }
     }
     if (rtentry)
@@ -459,6 +477,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
         {
             delete j->first;
             m_networkRoutes.erase(j);
+            m_routesVersion++;
             return;
         }
         tmp++;
@@ -592,6 +611,10 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_routesVersion++;
+    m_indexedRoutes.clear();
+    m_index.Clear();
+    m_indexVersion = 0;
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -633,6 +656,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_routesVersion++;
         }
         else
         {
@@ -678,6 +702,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_routesVersion++;
         }
         else
         {
@@ -705,6 +730,12 @@ Ipv4StaticRouting::SetIpv4(Ptr<Ipv4> ipv4)
     }
 }
 
+uint64_t
+Ipv4StaticRouting::GetRoutesVersion() const
+{
+    return m_routesVersion;
+}
+
 // Formatted like output of "route -n" command
 void
 Ipv4StaticRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
@@ -22,6 +22,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-prefix-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -32,6 +33,7 @@
 #include <list>
 #include <stdint.h>
 #include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -96,6 +98,7 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    uint64_t GetRoutesVersion() const override;
 
     /**
      * \brief Add a network route to the static routing table.
@@ -389,6 +392,12 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     bool LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric);
 
+    /**
+     * \brief Rebuild the index of the network routes, if they changed since
+     * the last lookup.
+     */
+    void UpdateIndex();
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -411,6 +420,16 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the network routes, by their position in the index.
+     */
+    std::vector<std::pair<Ipv4RoutingTableEntry*, uint32_t>> m_indexedRoutes;
+
+    Ipv4PrefixTrie m_index;          //!< Index of the network routes by destination
+    uint64_t m_routesVersion{1};     //!< Version of the routes
+    uint64_t m_indexVersion{0};      //!< Version of the routes in the index
+    std::vector<uint32_t> m_matches; //!< Positions of the routes matching a lookup
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -23,11 +23,38 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Ipv6EndPointDemux");
 
+bool
+Ipv6EndPointDemux::FourTuple::operator==(const FourTuple& other) const
+{
+    return localPort == other.localPort && peerPort == other.peerPort &&
+           localAddress == other.localAddress && peerAddress == other.peerAddress;
+}
+
+std::size_t
+Ipv6EndPointDemux::FourTupleHash::operator()(const FourTuple& tuple) const
+{
+    uint8_t buf[32];
+    tuple.localAddress.GetBytes(buf);
+    tuple.peerAddress.GetBytes(buf + 16);
+    uint64_t h = (static_cast<uint64_t>(tuple.localPort) << 16) | tuple.peerPort;
+    for (uint32_t i = 0; i < sizeof(buf); i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, buf + i, sizeof(word));
+        h = (h ^ word) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    return static_cast<std::size_t>(h);
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux()
     : m_ephemeral(49152),
       m_portFirst(49152),
@@ -39,9 +66,13 @@ Ipv6EndPointDemux::Ipv6EndPointDemux()
 Ipv6EndPointDemux::~Ipv6EndPointDemux()
 {
     NS_LOG_FUNCTION(this);
+    m_index.clear();
+    m_localPorts.clear();
+    m_positions.clear();
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         Ipv6EndPoint* endPoint = *i;
+        endPoint->m_demux = nullptr;
         delete endPoint;
     }
     m_endPoints.clear();
@@ -51,20 +82,18 @@ bool
 Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
+    if (!LookupPortLocal(port))
+    {
+        return false;
+    }
+    // Only used when binding, so a scan of the end points is good enough
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
@@ -87,7 +116,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -103,7 +132,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -111,7 +140,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
 Ipv6EndPoint*
 Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, uint16_t port)
 {
-    NS_LOG_FUNCTION(this << boundNetDevice << port);
+    NS_LOG_FUNCTION(this << port << boundNetDevice);
 
     return Allocate(boundNetDevice, Ipv6Address::GetAny(), port);
 }
@@ -119,14 +148,14 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, uint16_t port)
 Ipv6EndPoint*
 Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address, uint16_t port)
 {
-    NS_LOG_FUNCTION(this << boundNetDevice << address << port);
+    NS_LOG_FUNCTION(this << address << port << boundNetDevice);
     if (LookupLocal(boundNetDevice, address, port) || LookupLocal(nullptr, address, port))
     {
         NS_LOG_WARN("Duplicated endpoint.");
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -138,20 +167,22 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             Ipv6Address peerAddress,
                             uint16_t peerPort)
 {
-    NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
+    auto bucket = m_index.find({localAddress, localPort, peerAddress, peerPort});
+    if (bucket != m_index.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (auto endP : bucket->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice())
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -161,16 +192,17 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
 void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
-    NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    NS_LOG_FUNCTION(this << endPoint);
+    auto position = m_positions.find(endPoint);
+    if (position == m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    RemoveFromIndex(endPoint);
+    m_endPoints.erase(position->second);
+    m_positions.erase(position);
+    endPoint->m_demux = nullptr;
+    delete endPoint;
 }
 
 /*
@@ -187,118 +219,48 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport << incomingInterface);
 
-    EndPoints retval1; /* Matches exact on local port, wildcards on others */
-    EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
-    EndPoints retval3; /* Matches all but local address */
-    EndPoints retval4; /* Exact match on all 4 */
+    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
 
-    NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    EndPoints retval;
+    if (!LookupPortLocal(dport))
     {
-        Ipv6EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
+        return retval;
+    }
 
-        if (endP->GetLocalPort() != dport)
+    // Exact match on all 4 - this is the case of an open TCP connection, for example.
+    AppendMatches({daddr, dport, saddr, sport}, incomingInterface, retval);
+    if (!retval.empty())
+    {
+        NS_LOG_LOGIC("Found an endpoint for case 4");
+    }
+    else
+    {
+        // All but local address - no idea what this case could be.
+        AppendMatches({Ipv6Address::GetAny(), dport, saddr, sport}, incomingInterface, retval);
+        if (!retval.empty())
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
+            NS_LOG_LOGIC("Found an endpoint for case 3");
         }
-
-        if (endP->GetBoundNetDevice())
+        else
         {
-            if (!incomingInterface)
+            // Only local port and local address matches exactly - Not yet opened connection
+            AppendMatches({daddr, dport, Ipv6Address::GetAny(), 0}, incomingInterface, retval);
+            if (!retval.empty())
             {
-                continue;
+                NS_LOG_LOGIC("Found an endpoint for case 2");
             }
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            else
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
-                continue;
+                // Only local port matches exactly - Endpoint open to "any" connection
+                AppendMatches({Ipv6Address::GetAny(), dport, Ipv6Address::GetAny(), 0},
+                              incomingInterface,
+                              retval);
+                if (!retval.empty())
+                {
+                    NS_LOG_LOGIC("Found an endpoint for case 1");
+                }
             }
         }
-
-        /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-        NS_LOG_DEBUG("dest addr " << daddr);
-
-        bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
-        bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
-        bool localAddressMatchesAllRouters =
-            endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
-
-        /* if no match here, keep looking */
-        if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-            continue;
-        }
-        bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
-
-        /* If remote does not match either with exact or wildcard,i
-           skip this one */
-        if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
-
-        /* Now figure out which return list to add this one to */
-        if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
-            remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-            retval1.push_back(endP);
-        }
-        if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
-            remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All but local address */
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All 4 match */
-            retval4.push_back(endP);
-        }
-    }
-
-    // Here we find the most exact match
-    EndPoints retval;
-    if (!retval4.empty())
-    {
-        retval = retval4;
-    }
-    else if (!retval3.empty())
-    {
-        retval = retval3;
-    }
-    else if (!retval2.empty())
-    {
-        retval = retval2;
-    }
-    else
-    {
-        retval = retval1;
     }
 
     NS_ABORT_MSG_IF(retval.size() > 1,
@@ -310,35 +272,36 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 Ipv6EndPoint*
 Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+    NS_LOG_FUNCTION(this << dst << dport << src << sport);
+
+    if (!LookupPortLocal(dport))
+    {
+        return nullptr;
+    }
+    auto bucket = m_index.find({dst, dport, src, sport});
+    if (bucket != m_index.end())
+    {
+        /* this is an exact match. */
+        return bucket->second.front();
+    }
+
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
-
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
-        uint32_t tmp = 0;
-
         if ((*i)->GetLocalPort() != dport)
         {
             continue;
         }
-
-        if ((*i)->GetLocalAddress() == dst && (*i)->GetPeerPort() == sport &&
-            (*i)->GetPeerAddress() == src)
-        {
-            /* this is an exact match. */
-            return *i;
-        }
-
+        uint32_t tmp = 0;
         if ((*i)->GetLocalAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
-
         if ((*i)->GetPeerAddress() == Ipv6Address::GetAny())
         {
             tmp++;
         }
-
         if (tmp < genericity)
         {
             generic = (*i);
@@ -370,6 +333,81 @@ Ipv6EndPointDemux::AllocateEphemeralPort()
     return port;
 }
 
+void
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_positions[endPoint] = m_endPoints.insert(m_endPoints.end(), endPoint);
+    endPoint->m_demux = this;
+    AddToIndex(endPoint);
+}
+
+void
+Ipv6EndPointDemux::AddToIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    FourTuple tuple{endPoint->GetLocalAddress(),
+                    endPoint->GetLocalPort(),
+                    endPoint->GetPeerAddress(),
+                    endPoint->GetPeerPort()};
+    m_index[tuple].push_back(endPoint);
+    m_localPorts[tuple.localPort]++;
+}
+
+void
+Ipv6EndPointDemux::RemoveFromIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto bucket = m_index.find({endPoint->GetLocalAddress(),
+                                endPoint->GetLocalPort(),
+                                endPoint->GetPeerAddress(),
+                                endPoint->GetPeerPort()});
+    NS_ASSERT_MSG(bucket != m_index.end(), "End point " << endPoint << " is not indexed");
+    auto& endPoints = bucket->second;
+    endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+    if (endPoints.empty())
+    {
+        m_index.erase(bucket);
+    }
+    auto port = m_localPorts.find(endPoint->GetLocalPort());
+    if (--port->second == 0)
+    {
+        m_localPorts.erase(port);
+    }
+}
+
+void
+Ipv6EndPointDemux::AppendMatches(const FourTuple& tuple,
+                                 Ptr<Ipv6Interface> incomingInterface,
+                                 EndPoints& matches) const
+{
+    auto bucket = m_index.find(tuple);
+    if (bucket == m_index.end())
+    {
+        return;
+    }
+    for (auto endP : bucket->second)
+    {
+        if (!endP->IsRxEnabled())
+        {
+            NS_LOG_LOGIC("Skipping endpoint " << endP
+                                              << " because endpoint can not receive packets");
+            continue;
+        }
+        if (endP->GetBoundNetDevice())
+        {
+            if (!incomingInterface || endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            {
+                NS_LOG_LOGIC("Skipping endpoint "
+                             << endP << " because endpoint is bound to specific device "
+                             << endP->GetBoundNetDevice() << " that does not match packet device");
+                continue;
+            }
+        }
+        matches.push_back(endP);
+    }
+}
+
 Ipv6EndPointDemux::EndPoints
 Ipv6EndPointDemux::GetEndPoints() const
 {
@@ -26,6 +26,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -36,6 +38,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed by their four-tuple, unconnected ones with a
+ * wildcard peer, so the cost of Lookup() does not grow with the number of
+ * end points.
  */
 class Ipv6EndPointDemux
 {
@@ -161,12 +167,76 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    friend class Ipv6EndPoint;
+
     /**
      * \brief Allocate a ephemeral port.
      * \return a port
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Four-tuple of an end point, the key of the end point index.
+     */
+    struct FourTuple
+    {
+        Ipv6Address localAddress; //!< local address
+        uint16_t localPort;       //!< local port
+        Ipv6Address peerAddress;  //!< peer address (any if unconnected)
+        uint16_t peerPort;        //!< peer port (0 if unconnected)
+
+        /**
+         * \param other the four-tuple to compare to
+         * \return true if both four-tuples are equal
+         */
+        bool operator==(const FourTuple& other) const;
+    };
+
+    /**
+     * \brief Hash function of a FourTuple.
+     */
+    struct FourTupleHash
+    {
+        /**
+         * \param tuple the four-tuple
+         * \return the hash of the four-tuple
+         */
+        std::size_t operator()(const FourTuple& tuple) const;
+    };
+
+    /**
+     * \brief Store a new end point and index it.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Index an end point under its current four-tuple.
+     *
+     * Also called by Ipv6EndPoint when its four-tuple changes.
+     *
+     * \param endPoint the end point
+     */
+    void AddToIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the index, before its four-tuple changes
+     * or when it is deallocated.
+     * \param endPoint the end point
+     */
+    void RemoveFromIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Append the end points indexed under a four-tuple that can receive
+     * packets from the incoming interface.
+     * \param tuple the four-tuple
+     * \param incomingInterface the incoming interface
+     * \param matches the list the matching end points are appended to
+     */
+    void AppendMatches(const FourTuple& tuple,
+                       Ptr<Ipv6Interface> incomingInterface,
+                       EndPoints& matches) const;
+
     /**
      * \brief The ephemeral port.
      */
@@ -186,6 +256,24 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief End points by four-tuple, each bucket in insertion order.
+     *
+     * Unconnected end points are indexed with a wildcard peer, so that the
+     * listeners matching a packet are found by looking up the wildcard keys.
+     */
+    std::unordered_map<FourTuple, std::vector<Ipv6EndPoint*>, FourTupleHash> m_index;
+
+    /**
+     * \brief Number of end points using each local port.
+     */
+    std::unordered_map<uint16_t, uint32_t> m_localPorts;
+
+    /**
+     * \brief Position of each end point in m_endPoints.
+     */
+    std::unordered_map<Ipv6EndPoint*, EndPointsI> m_positions;
 };
 
 } /* namespace ns3 */
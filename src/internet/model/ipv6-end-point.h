@@ -33,6 +33,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv6EndPointDemux;
 class Packet;
 
 /**
@@ -195,6 +196,8 @@ class Ipv6EndPoint
     bool IsRxEnabled() const;
 
   private:
+    friend class Ipv6EndPointDemux;
+
     /**
      * \brief The local address.
      */
@@ -239,6 +242,11 @@ class Ipv6EndPoint
      * \brief true if the endpoint can receive packets.
      */
     bool m_rxEnabled;
+
+    /**
+     * \brief The demux indexing this endpoint by its four-tuple (if any).
+     */
+    Ipv6EndPointDemux* m_demux;
 };
 
 } /* namespace ns3 */
@@ -19,6 +19,7 @@
 
 #include "ipv6-l3-protocol.h"
 
+#include "gso-tag.h"
 #include "icmpv6-l4-protocol.h"
 #include "ipv6-autoconfigured-prefix.h"
 #include "ipv6-extension-demux.h"
@@ -1262,7 +1263,10 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
-    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
+    // GSO packets are segmented by the traffic control layer, not fragmented
+    GsoTag gsoTag;
+    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu &&
+        !(fromMe && packet->PeekPacketTag(gsoTag)))
     {
         // Router => drop
         if (!fromMe)
@@ -105,6 +105,17 @@ class Ipv6QueueDiscItem : public QueueDiscItem
      */
     uint32_t Hash(uint32_t perturbation) const override;
 
+    /**
+     * \brief Split a TCP packet built by generic segmentation offload
+     *
+     * Each segment is carried by a new item whose IPv6 header is a copy of the
+     * one of this item, with the payload length of the segment.
+     *
+     * \return the items carrying the segments, or an empty list if the packet
+     *         carries no GsoTag
+     */
+    std::vector<Ptr<QueueDiscItem>> GsoSegment() override;
+
   private:
     Ipv6Header m_header; //!< The IPv6 header.
     bool m_headerAdded;  //!< True if the header has already been added to the packet.
@@ -0,0 +1,123 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-header.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpHeader);
+
+MpTcpHeader::MpTcpHeader()
+{
+}
+
+TypeId
+MpTcpHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpHeader>();
+    return tid;
+}
+
+TypeId
+MpTcpHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+MpTcpHeader::Print(std::ostream& os) const
+{
+    switch (m_kind)
+    {
+    case JOIN:
+        os << "JOIN token=" << m_dataSeq;
+        break;
+    case DATA:
+        os << "DATA dsn=" << m_dataSeq << " length=" << m_length;
+        break;
+    case DATA_FIN:
+        os << "DATA_FIN dsn=" << m_dataSeq;
+        break;
+    }
+}
+
+uint32_t
+MpTcpHeader::GetSerializedSize() const
+{
+    return SIZE;
+}
+
+void
+MpTcpHeader::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    i.WriteU8(m_kind);
+    i.WriteU8(0);
+    i.WriteHtonU16(m_length);
+    i.WriteHtonU64(m_dataSeq);
+}
+
+uint32_t
+MpTcpHeader::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    m_kind = static_cast<Kind_t>(i.ReadU8());
+    i.Next(1);
+    m_length = i.ReadNtohU16();
+    m_dataSeq = i.ReadNtohU64();
+    return GetSerializedSize();
+}
+
+void
+MpTcpHeader::SetKind(Kind_t kind)
+{
+    m_kind = kind;
+}
+
+MpTcpHeader::Kind_t
+MpTcpHeader::GetKind() const
+{
+    return m_kind;
+}
+
+void
+MpTcpHeader::SetLength(uint16_t length)
+{
+    m_length = length;
+}
+
+uint16_t
+MpTcpHeader::GetLength() const
+{
+    return m_length;
+}
+
+void
+MpTcpHeader::SetDataSequence(uint64_t dataSeq)
+{
+    m_dataSeq = dataSeq;
+}
+
+uint64_t
+MpTcpHeader::GetDataSequence() const
+{
+    return m_dataSeq;
+}
+
+} // namespace ns3
@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_HEADER_H
+#define MPTCP_HEADER_H
+
+#include "ns3/header.h"
+
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Header of the frames carried in the byte stream of a subflow
+ *
+ * The byte stream of every subflow of an MpTcpSocket is a sequence of
+ * frames. The first frame of a subflow joins it to a connection, and
+ * carries the token of the connection; the next frames carry the data of
+ * the connection, mapped to its data sequence space, as the Data Sequence
+ * Signal option of MPTCP (RFC 8684) does. The last frame marks the end of
+ * the data of the connection (DATA_FIN).
+ *
+ * \verbatim
+    0                   1                   2                   3
+    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |      Kind     |   Reserved    |            Length             |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |                                                               |
+   +        Data Sequence Number (DATA, DATA_FIN) or Token         +
+   |                                                               |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   \endverbatim
+ */
+class MpTcpHeader : public Header
+{
+  public:
+    /**
+     * \brief Kind of frame
+     */
+    enum Kind_t : uint8_t
+    {
+        JOIN = 0,    //!< Join the subflow to the connection with the token
+        DATA = 1,    //!< Data of the connection
+        DATA_FIN = 2 //!< End of the data of the connection
+    };
+
+    MpTcpHeader();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    /**
+     * \brief Set the kind of frame
+     * \param kind the kind of frame
+     */
+    void SetKind(Kind_t kind);
+
+    /**
+     * \brief Get the kind of frame
+     * \return the kind of frame
+     */
+    Kind_t GetKind() const;
+
+    /**
+     * \brief Set the length of the data following the header
+     * \param length the length of the data
+     */
+    void SetLength(uint16_t length);
+
+    /**
+     * \brief Get the length of the data following the header
+     * \return the length of the data
+     */
+    uint16_t GetLength() const;
+
+    /**
+     * \brief Set the data sequence number, or the token of a JOIN frame
+     * \param dataSeq the data sequence number
+     */
+    void SetDataSequence(uint64_t dataSeq);
+
+    /**
+     * \brief Get the data sequence number, or the token of a JOIN frame
+     * \return the data sequence number
+     */
+    uint64_t GetDataSequence() const;
+
+    /// Size of the header, in bytes
+    static constexpr uint32_t SIZE = 12;
+
+  private:
+    Kind_t m_kind{DATA};   //!< Kind of frame
+    uint16_t m_length{0};  //!< Length of the data following the header
+    uint64_t m_dataSeq{0}; //!< Data sequence number or token
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_HEADER_H */
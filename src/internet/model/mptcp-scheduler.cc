@@ -0,0 +1,275 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-scheduler.h"
+
+#include "mptcp-subflow.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpScheduler);
+
+TypeId
+MpTcpScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MpTcpScheduler").SetParent<Object>().SetGroupName("Internet");
+    return tid;
+}
+
+MpTcpScheduler::MpTcpScheduler()
+    : Object()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpScheduler::MpTcpScheduler(const MpTcpScheduler& other)
+    : Object(other)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpScheduler::~MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+/**
+ * \brief Get the available subflow with the lowest smoothed RTT
+ * \param subflows the subflows
+ * \return the subflow, or nullptr if no subflow is available
+ */
+static Ptr<MpTcpSubflow>
+GetMinRttAvailable(const std::vector<Ptr<MpTcpSubflow>>& subflows)
+{
+    Ptr<MpTcpSubflow> best;
+    for (const auto& subflow : subflows)
+    {
+        if (subflow->IsAvailable() && (!best || subflow->GetRtt() < best->GetRtt()))
+        {
+            best = subflow;
+        }
+    }
+    return best;
+}
+
+// MpTcpSchedulerRoundRobin
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSchedulerRoundRobin);
+
+TypeId
+MpTcpSchedulerRoundRobin::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSchedulerRoundRobin")
+                            .SetParent<MpTcpScheduler>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSchedulerRoundRobin>();
+    return tid;
+}
+
+MpTcpSchedulerRoundRobin::MpTcpSchedulerRoundRobin()
+    : MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerRoundRobin::MpTcpSchedulerRoundRobin(const MpTcpSchedulerRoundRobin& other)
+    : MpTcpScheduler(other)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerRoundRobin::~MpTcpSchedulerRoundRobin()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+MpTcpSchedulerRoundRobin::GetName() const
+{
+    return "MpTcpSchedulerRoundRobin";
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSchedulerRoundRobin::GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                         uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+    for (std::size_t i = 0; i < subflows.size(); i++)
+    {
+        std::size_t index = (m_next + i) % subflows.size();
+        if (subflows[index]->IsAvailable())
+        {
+            m_next = index + 1;
+            return subflows[index];
+        }
+    }
+    return nullptr;
+}
+
+Ptr<MpTcpScheduler>
+MpTcpSchedulerRoundRobin::Fork()
+{
+    return CopyObject<MpTcpSchedulerRoundRobin>(this);
+}
+
+// MpTcpSchedulerMinRtt
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSchedulerMinRtt);
+
+TypeId
+MpTcpSchedulerMinRtt::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSchedulerMinRtt")
+                            .SetParent<MpTcpScheduler>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSchedulerMinRtt>();
+    return tid;
+}
+
+MpTcpSchedulerMinRtt::MpTcpSchedulerMinRtt()
+    : MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerMinRtt::MpTcpSchedulerMinRtt(const MpTcpSchedulerMinRtt& other)
+    : MpTcpScheduler(other)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerMinRtt::~MpTcpSchedulerMinRtt()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+MpTcpSchedulerMinRtt::GetName() const
+{
+    return "MpTcpSchedulerMinRtt";
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSchedulerMinRtt::GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                     uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+    return GetMinRttAvailable(subflows);
+}
+
+Ptr<MpTcpScheduler>
+MpTcpSchedulerMinRtt::Fork()
+{
+    return CopyObject<MpTcpSchedulerMinRtt>(this);
+}
+
+// MpTcpSchedulerBlest
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSchedulerBlest);
+
+TypeId
+MpTcpSchedulerBlest::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSchedulerBlest")
+                            .SetParent<MpTcpScheduler>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSchedulerBlest>()
+                            .AddAttribute("Lambda",
+                                          "Scaling factor of the data the fastest subflow is "
+                                          "estimated to send during one RTT of a slower one",
+                                          DoubleValue(1.0),
+                                          MakeDoubleAccessor(&MpTcpSchedulerBlest::m_lambda),
+                                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+MpTcpSchedulerBlest::MpTcpSchedulerBlest()
+    : MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerBlest::MpTcpSchedulerBlest(const MpTcpSchedulerBlest& other)
+    : MpTcpScheduler(other),
+      m_lambda(other.m_lambda)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerBlest::~MpTcpSchedulerBlest()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+MpTcpSchedulerBlest::GetName() const
+{
+    return "MpTcpSchedulerBlest";
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSchedulerBlest::GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                    uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+
+    Ptr<MpTcpSubflow> best = GetMinRttAvailable(subflows);
+    if (!best)
+    {
+        return nullptr;
+    }
+
+    Ptr<MpTcpSubflow> fastest;
+    for (const auto& subflow : subflows)
+    {
+        if (subflow->IsEstablished() && !subflow->IsClosed() &&
+            (!fastest || subflow->GetRtt() < fastest->GetRtt()))
+        {
+            fastest = subflow;
+        }
+    }
+    if (best == fastest || !fastest->GetRtt().IsStrictlyPositive())
+    {
+        return best;
+    }
+
+    double rtts = best->GetRtt().GetSeconds() / fastest->GetRtt().GetSeconds();
+    uint32_t segmentSize = fastest->GetSegmentSize();
+    double fastBytes =
+        segmentSize * (static_cast<double>(fastest->GetCongestionWindow()) / segmentSize * rtts +
+                       rtts * (rtts - 1) / 2);
+    if (m_lambda * fastBytes + best->GetSegmentSize() > window)
+    {
+        NS_LOG_LOGIC("Waiting for the fastest subflow: " << fastBytes << " bytes in "
+                                                         << best->GetRtt().As(Time::MS));
+        return nullptr;
+    }
+    return best;
+}
+
+Ptr<MpTcpScheduler>
+MpTcpSchedulerBlest::Fork()
+{
+    return CopyObject<MpTcpSchedulerBlest>(this);
+}
+
+} // namespace ns3
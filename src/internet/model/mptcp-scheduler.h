@@ -0,0 +1,211 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SCHEDULER_H
+#define MPTCP_SCHEDULER_H
+
+#include "ns3/object.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class MpTcpSubflow;
+
+/**
+ * \ingroup tcp
+ * \defgroup mptcpScheduler Multipath TCP Schedulers.
+ *
+ * The packet schedulers of MpTcpSocket, which pick the subflow sending
+ * each segment of data. The interface is defined in class MpTcpScheduler.
+ */
+
+/**
+ * \ingroup mptcpScheduler
+ *
+ * \brief Packet scheduler abstract class
+ *
+ * MpTcpSocket asks its scheduler for a subflow every time it has a segment
+ * of data to send. The scheduler returns a subflow able to send a full
+ * segment right away (MpTcpSubflow::IsAvailable), or nothing to make the
+ * connection wait for an ACK.
+ *
+ * \see MpTcpSchedulerRoundRobin
+ * \see MpTcpSchedulerMinRtt
+ * \see MpTcpSchedulerBlest
+ */
+class MpTcpScheduler : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpScheduler();
+
+    /**
+     * \brief Copy constructor.
+     * \param other object to copy.
+     */
+    MpTcpScheduler(const MpTcpScheduler& other);
+
+    ~MpTcpScheduler() override;
+
+    /**
+     * \brief Get the name of the scheduler
+     * \return the name of the scheduler
+     */
+    virtual std::string GetName() const = 0;
+
+    /**
+     * \brief Pick the subflow sending the next segment of data
+     *
+     * \param subflows the subflows of the connection
+     * \param window the data that can still be sent before the lowest data
+     * sequence number not acknowledged yet blocks the connection
+     * \return the subflow, or nullptr to wait
+     */
+    virtual Ptr<MpTcpSubflow> GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                             uint32_t window) = 0;
+
+    /**
+     * \brief Copy the scheduler
+     * \return a new scheduler, with the configuration of this one
+     */
+    virtual Ptr<MpTcpScheduler> Fork() = 0;
+};
+
+/**
+ * \ingroup mptcpScheduler
+ *
+ * \brief Round-robin scheduler
+ *
+ * The subflows take turns, skipping the ones that are not available.
+ */
+class MpTcpSchedulerRoundRobin : public MpTcpScheduler
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSchedulerRoundRobin();
+
+    /**
+     * \brief Copy constructor.
+     * \param other object to copy.
+     */
+    MpTcpSchedulerRoundRobin(const MpTcpSchedulerRoundRobin& other);
+
+    ~MpTcpSchedulerRoundRobin() override;
+
+    std::string GetName() const override;
+    Ptr<MpTcpSubflow> GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                     uint32_t window) override;
+    Ptr<MpTcpScheduler> Fork() override;
+
+  private:
+    std::size_t m_next{0}; //!< Index of the subflow whose turn it is
+};
+
+/**
+ * \ingroup mptcpScheduler
+ *
+ * \brief Lowest-RTT-first scheduler
+ *
+ * The default scheduler of Linux: the available subflow with the lowest
+ * smoothed RTT sends.
+ */
+class MpTcpSchedulerMinRtt : public MpTcpScheduler
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSchedulerMinRtt();
+
+    /**
+     * \brief Copy constructor.
+     * \param other object to copy.
+     */
+    MpTcpSchedulerMinRtt(const MpTcpSchedulerMinRtt& other);
+
+    ~MpTcpSchedulerMinRtt() override;
+
+    std::string GetName() const override;
+    Ptr<MpTcpSubflow> GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                     uint32_t window) override;
+    Ptr<MpTcpScheduler> Fork() override;
+};
+
+/**
+ * \ingroup mptcpScheduler
+ *
+ * \brief Blocking estimation scheduler (BLEST)
+ *
+ * Over paths of heterogeneous RTTs, the data sent on the slow subflow
+ * blocks the connection window until it arrives, while the fast subflow
+ * could have sent it earlier. BLEST (Ferlin et al., IFIP Networking 2016)
+ * sends on the lowest-RTT subflow as MpTcpSchedulerMinRtt does, but when
+ * only a slower subflow is available, it estimates the data the fastest
+ * subflow can send during one RTT of the slower one, with its congestion
+ * window growing by one segment per RTT:
+ *
+ * \f$ X = MSS_f (\frac{cwnd_f}{MSS_f} \frac{rtt_s}{rtt_f} +
+ *        \frac{\frac{rtt_s}{rtt_f} (\frac{rtt_s}{rtt_f} - 1)}{2}) \f$
+ *
+ * and it waits for the fastest subflow if \f$ \lambda X + MSS_s \f$ does
+ * not fit in the connection window. The scaling factor \f$ \lambda \f$ is
+ * a fixed attribute, instead of being adapted to the blocking observed.
+ */
+class MpTcpSchedulerBlest : public MpTcpScheduler
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSchedulerBlest();
+
+    /**
+     * \brief Copy constructor.
+     * \param other object to copy.
+     */
+    MpTcpSchedulerBlest(const MpTcpSchedulerBlest& other);
+
+    ~MpTcpSchedulerBlest() override;
+
+    std::string GetName() const override;
+    Ptr<MpTcpSubflow> GetNextSubflow(const std::vector<Ptr<MpTcpSubflow>>& subflows,
+                                     uint32_t window) override;
+    Ptr<MpTcpScheduler> Fork() override;
+
+  private:
+    double m_lambda{1.0}; //!< Scaling factor of the estimate of the fastest subflow
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_H */
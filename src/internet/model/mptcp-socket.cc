@@ -0,0 +1,883 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-socket.h"
+
+#include "mptcp-header.h"
+#include "mptcp-scheduler.h"
+#include "mptcp-subflow.h"
+#include "tcp-l4-protocol.h"
+#include "tcp-lia.h"
+#include "tcp-socket-base.h"
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSocket");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSocket);
+
+TypeId
+MpTcpSocket::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MpTcpSocket")
+            .SetParent<Socket>()
+            .SetGroupName("Internet")
+            .AddConstructor<MpTcpSocket>()
+            .AddAttribute("SchedulerType",
+                          "Type of the packet scheduler picking the subflow of each segment",
+                          TypeIdValue(MpTcpSchedulerMinRtt::GetTypeId()),
+                          MakeTypeIdAccessor(&MpTcpSocket::m_schedulerTypeId),
+                          MakeTypeIdChecker())
+            .AddAttribute("SndBufSize",
+                          "Size of the transmission buffer of the connection",
+                          UintegerValue(131072),
+                          MakeUintegerAccessor(&MpTcpSocket::m_sndBufSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("DataWindow",
+                          "Maximum data sent beyond the lowest data sequence number not "
+                          "acknowledged yet, which bounds the reordering buffer of the receiver",
+                          UintegerValue(131072),
+                          MakeUintegerAccessor(&MpTcpSocket::m_dataWindow),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+MpTcpSocket::MpTcpSocket()
+    : m_coupling(Create<TcpLiaCoupling>()),
+      m_tokenRng(CreateObject<UniformRandomVariable>()),
+      m_sendBuffer(Create<Packet>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSocket::~MpTcpSocket()
+{
+    NS_LOG_FUNCTION(this);
+    DetachSubflows();
+}
+
+void
+MpTcpSocket::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    NotifyClosed();
+    DetachSubflows();
+    m_scheduler = nullptr;
+    m_tokenRng = nullptr;
+    m_node = nullptr;
+    Socket::DoDispose();
+}
+
+void
+MpTcpSocket::DetachSubflows()
+{
+    // The sockets of the subflows may outlive this socket, e.g., in TIME_WAIT
+    std::vector<Ptr<MpTcpSubflow>> subflows;
+    subflows.swap(m_subflows);
+    subflows.insert(subflows.end(), m_joining.begin(), m_joining.end());
+    m_joining.clear();
+    for (const auto& subflow : subflows)
+    {
+        Ptr<TcpSocketBase> socket = subflow->GetSocket();
+        if (socket)
+        {
+            socket->SetConnectCallback(MakeNullCallback<void, Ptr<Socket>>(),
+                                       MakeNullCallback<void, Ptr<Socket>>());
+            socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+            socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+            socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(),
+                                      MakeNullCallback<void, Ptr<Socket>>());
+        }
+        subflow->Dispose();
+    }
+    if (m_listener)
+    {
+        m_listener->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                      MakeNullCallback<void, Ptr<Socket>, const Address&>());
+        m_listener = nullptr;
+    }
+    // The connections accepted may outlive this socket too
+    for (const auto& [token, connection] : m_connections)
+    {
+        connection->m_closedCallback = MakeNullCallback<void, uint64_t>();
+    }
+    m_connections.clear();
+}
+
+void
+MpTcpSocket::SetNode(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(this << node);
+    m_node = node;
+}
+
+void
+MpTcpSocket::SetScheduler(Ptr<MpTcpScheduler> scheduler)
+{
+    NS_LOG_FUNCTION(this << scheduler);
+    m_scheduler = scheduler;
+}
+
+Ptr<MpTcpScheduler>
+MpTcpSocket::GetScheduler()
+{
+    if (!m_scheduler)
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(m_schedulerTypeId);
+        m_scheduler = factory.Create<MpTcpScheduler>();
+    }
+    return m_scheduler;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::CreateSubflow(const Address& local, TypeId congestionTypeId)
+{
+    NS_LOG_FUNCTION(this << local << congestionTypeId);
+    NS_ASSERT_MSG(m_node, "MpTcpSocket without a node");
+
+    Ptr<TcpSocketBase> socket =
+        DynamicCast<TcpSocketBase>(m_node->GetObject<TcpL4Protocol>()->CreateSocket());
+    if (congestionTypeId != TypeId())
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(congestionTypeId);
+        Ptr<TcpCongestionOps> congestion = factory.Create<TcpCongestionOps>();
+        Ptr<TcpLia> lia = DynamicCast<TcpLia>(congestion);
+        if (lia)
+        {
+            lia->SetCoupling(m_coupling);
+        }
+        socket->SetCongestionControlAlgorithm(congestion);
+    }
+
+    int ret;
+    if (!local.IsInvalid())
+    {
+        ret = socket->Bind(local);
+    }
+    else if (Inet6SocketAddress::IsMatchingType(m_local))
+    {
+        ret = socket->Bind(m_local);
+    }
+    else
+    {
+        ret = InetSocketAddress::IsMatchingType(m_local) ? socket->Bind(m_local) : socket->Bind();
+    }
+    if (ret != 0)
+    {
+        m_errno = socket->GetErrno();
+        socket->Close();
+        return nullptr;
+    }
+
+    Ptr<MpTcpSubflow> subflow = CreateObject<MpTcpSubflow>(socket);
+    AttachSubflow(subflow);
+    m_subflows.push_back(subflow);
+    return subflow;
+}
+
+void
+MpTcpSocket::AttachSubflow(Ptr<MpTcpSubflow> subflow)
+{
+    Ptr<TcpSocketBase> socket = subflow->GetSocket();
+    socket->SetConnectCallback(MakeCallback(&MpTcpSocket::SubflowConnected, this),
+                               MakeCallback(&MpTcpSocket::SubflowConnectionFailed, this));
+    socket->SetRecvCallback(MakeCallback(&MpTcpSocket::SubflowRecv, this));
+    socket->SetSendCallback(MakeCallback(&MpTcpSocket::SubflowSend, this));
+    // A subflow closed by the peer can still send: the end of the data is
+    // signaled by the DATA_FIN
+    socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(),
+                              MakeCallback(&MpTcpSocket::SubflowErrorClose, this));
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::FindSubflow(Ptr<Socket> socket, const std::vector<Ptr<MpTcpSubflow>>& subflows)
+{
+    for (const auto& subflow : subflows)
+    {
+        if (subflow->GetSocket() == socket)
+        {
+            return subflow;
+        }
+    }
+    return nullptr;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::AddSubflow(const Address& local, const Address& remote, TypeId congestionTypeId)
+{
+    NS_LOG_FUNCTION(this << local << remote << congestionTypeId);
+    if (m_listener || m_closeRequested)
+    {
+        m_errno = ERROR_INVAL;
+        return nullptr;
+    }
+    Ptr<MpTcpSubflow> subflow = CreateSubflow(local, congestionTypeId);
+    if (subflow)
+    {
+        subflow->SetRemote(remote);
+        if (m_connecting)
+        {
+            ConnectSubflow(subflow);
+        }
+    }
+    return subflow;
+}
+
+uint32_t
+MpTcpSocket::GetNSubflows() const
+{
+    return m_subflows.size();
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::GetSubflow(uint32_t i) const
+{
+    NS_ASSERT(i < m_subflows.size());
+    return m_subflows[i];
+}
+
+int64_t
+MpTcpSocket::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_tokenRng->SetStream(stream);
+    return 1;
+}
+
+Socket::SocketErrno
+MpTcpSocket::GetErrno() const
+{
+    return m_errno;
+}
+
+Socket::SocketType
+MpTcpSocket::GetSocketType() const
+{
+    return NS3_SOCK_STREAM;
+}
+
+Ptr<Node>
+MpTcpSocket::GetNode() const
+{
+    return m_node;
+}
+
+int
+MpTcpSocket::Bind()
+{
+    NS_LOG_FUNCTION(this);
+    return Bind(InetSocketAddress(Ipv4Address::GetAny(), 0));
+}
+
+int
+MpTcpSocket::Bind6()
+{
+    NS_LOG_FUNCTION(this);
+    return Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 0));
+}
+
+int
+MpTcpSocket::Bind(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (!InetSocketAddress::IsMatchingType(address) &&
+        !Inet6SocketAddress::IsMatchingType(address))
+    {
+        m_errno = ERROR_INVAL;
+        return -1;
+    }
+    m_local = address;
+    return 0;
+}
+
+int
+MpTcpSocket::Connect(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (m_listener || m_connecting)
+    {
+        m_errno = m_connecting ? ERROR_ISCONN : ERROR_INVAL;
+        return -1;
+    }
+    if (m_subflows.empty() && !AddSubflow(Address(), address))
+    {
+        return -1;
+    }
+
+    // The token identifies the connection at the server among those of the node
+    m_token = (static_cast<uint64_t>(m_node->GetId()) << 32) |
+              m_tokenRng->GetInteger(1, std::numeric_limits<uint32_t>::max());
+    m_connecting = true;
+    for (const auto& subflow : m_subflows)
+    {
+        ConnectSubflow(subflow);
+    }
+    return 0;
+}
+
+void
+MpTcpSocket::ConnectSubflow(Ptr<MpTcpSubflow> subflow)
+{
+    NS_LOG_FUNCTION(this << subflow);
+    if (subflow->GetSocket()->Connect(subflow->GetRemote()) != 0)
+    {
+        subflow->SetClosed();
+    }
+}
+
+int
+MpTcpSocket::Listen()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_connecting || m_listener)
+    {
+        m_errno = ERROR_INVAL;
+        return -1;
+    }
+    NS_ASSERT_MSG(m_node, "MpTcpSocket without a node");
+    m_listener = DynamicCast<TcpSocketBase>(m_node->GetObject<TcpL4Protocol>()->CreateSocket());
+    int ret = m_local.IsInvalid() ? m_listener->Bind() : m_listener->Bind(m_local);
+    if (ret != 0 || m_listener->Listen() != 0)
+    {
+        m_errno = m_listener->GetErrno();
+        m_listener->Close();
+        m_listener = nullptr;
+        return -1;
+    }
+    m_listener->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                  MakeCallback(&MpTcpSocket::SubflowAccepted, this));
+    return 0;
+}
+
+int
+MpTcpSocket::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_listener)
+    {
+        m_listener->Close();
+        return 0;
+    }
+    m_closeRequested = true;
+    if (m_sendBuffer->GetSize() == 0)
+    {
+        SendDataFin();
+    }
+    return 0;
+}
+
+int
+MpTcpSocket::ShutdownSend()
+{
+    NS_LOG_FUNCTION(this);
+    return Close();
+}
+
+int
+MpTcpSocket::ShutdownRecv()
+{
+    NS_LOG_FUNCTION(this);
+    return 0;
+}
+
+uint32_t
+MpTcpSocket::GetTxAvailable() const
+{
+    uint64_t used = m_sndNxt - m_sndUna + m_sendBuffer->GetSize();
+    return used < m_sndBufSize ? m_sndBufSize - used : 0;
+}
+
+int
+MpTcpSocket::Send(Ptr<Packet> p, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << p << flags);
+    if (m_listener || !m_connecting)
+    {
+        m_errno = ERROR_NOTCONN;
+        return -1;
+    }
+    if (m_closeRequested)
+    {
+        m_errno = ERROR_SHUTDOWN;
+        return -1;
+    }
+    if (p->GetSize() > GetTxAvailable())
+    {
+        m_errno = ERROR_MSGSIZE;
+        return -1;
+    }
+    uint32_t size = p->GetSize();
+    m_sendBuffer->AddAtEnd(p);
+    SendPending();
+    return size;
+}
+
+int
+MpTcpSocket::SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress)
+{
+    return Send(p, flags);
+}
+
+uint32_t
+MpTcpSocket::GetRxAvailable() const
+{
+    return m_rxAvailable;
+}
+
+Ptr<Packet>
+MpTcpSocket::Recv(uint32_t maxSize, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << maxSize << flags);
+    if (m_rcvQueue.empty() || maxSize == 0)
+    {
+        return nullptr;
+    }
+    Ptr<Packet> p = m_rcvQueue.front();
+    m_rcvQueue.pop_front();
+    while (p->GetSize() < maxSize && !m_rcvQueue.empty())
+    {
+        p->AddAtEnd(m_rcvQueue.front());
+        m_rcvQueue.pop_front();
+    }
+    if (p->GetSize() > maxSize)
+    {
+        m_rcvQueue.push_front(p->CreateFragment(maxSize, p->GetSize() - maxSize));
+        p->RemoveAtEnd(p->GetSize() - maxSize);
+    }
+    m_rxAvailable -= p->GetSize();
+    return p;
+}
+
+Ptr<Packet>
+MpTcpSocket::RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress)
+{
+    Ptr<Packet> p = Recv(maxSize, flags);
+    if (p)
+    {
+        GetPeerName(fromAddress);
+    }
+    return p;
+}
+
+int
+MpTcpSocket::GetSockName(Address& address) const
+{
+    if (m_listener)
+    {
+        return m_listener->GetSockName(address);
+    }
+    if (m_subflows.empty())
+    {
+        address = m_local;
+        return 0;
+    }
+    return m_subflows.front()->GetSocket()->GetSockName(address);
+}
+
+int
+MpTcpSocket::GetPeerName(Address& address) const
+{
+    for (const auto& subflow : m_subflows)
+    {
+        if (subflow->IsEstablished())
+        {
+            return subflow->GetSocket()->GetPeerName(address);
+        }
+    }
+    const_cast<MpTcpSocket*>(this)->m_errno = ERROR_NOTCONN;
+    return -1;
+}
+
+bool
+MpTcpSocket::SetAllowBroadcast(bool allowBroadcast)
+{
+    return !allowBroadcast;
+}
+
+bool
+MpTcpSocket::GetAllowBroadcast() const
+{
+    return false;
+}
+
+void
+MpTcpSocket::SubflowConnected(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<MpTcpSubflow> subflow = FindSubflow(socket, m_subflows);
+    if (!subflow)
+    {
+        return;
+    }
+    subflow->SetEstablished();
+    subflow->SendJoin(m_token);
+    if (m_dataFinSent)
+    {
+        subflow->SendDataFin(m_sndNxt);
+        subflow->Close();
+        return;
+    }
+    if (!m_connected)
+    {
+        m_connected = true;
+        NotifyConnectionSucceeded();
+        if (GetTxAvailable() > 0)
+        {
+            NotifySend(GetTxAvailable());
+        }
+    }
+    SendPending();
+}
+
+void
+MpTcpSocket::SubflowConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<MpTcpSubflow> subflow = FindSubflow(socket, m_subflows);
+    if (!subflow)
+    {
+        return;
+    }
+    subflow->SetClosed();
+    bool allClosed = std::all_of(m_subflows.begin(), m_subflows.end(), [](const auto& s) {
+        return s->IsClosed();
+    });
+    if (!m_connected && allClosed)
+    {
+        NotifyConnectionFailed();
+    }
+    CheckClosed();
+}
+
+void
+MpTcpSocket::SubflowRecv(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<MpTcpSubflow> subflow = FindSubflow(socket, m_subflows);
+    if (subflow)
+    {
+        ReceiveFrames(subflow);
+    }
+}
+
+void
+MpTcpSocket::SubflowSend(Ptr<Socket> socket, uint32_t available)
+{
+    NS_LOG_FUNCTION(this << socket << available);
+    Ptr<MpTcpSubflow> subflow = FindSubflow(socket, m_subflows);
+    if (!subflow)
+    {
+        return;
+    }
+    // The frames waiting for room in the subflow, e.g., the DATA_FIN, go first
+    subflow->Flush();
+
+    std::vector<std::pair<uint64_t, uint32_t>> acked;
+    subflow->PopAckedData(acked);
+    for (const auto& [dataSeq, length] : acked)
+    {
+        m_sndAcked.emplace(dataSeq, dataSeq + length);
+    }
+    uint64_t sndUna = m_sndUna;
+    while (!m_sndAcked.empty() && m_sndAcked.begin()->first == m_sndUna)
+    {
+        m_sndUna = m_sndAcked.begin()->second;
+        m_sndAcked.erase(m_sndAcked.begin());
+    }
+
+    SendPending();
+    if (m_sndUna > sndUna && !m_closeRequested && GetTxAvailable() > 0)
+    {
+        NotifySend(GetTxAvailable());
+    }
+}
+
+void
+MpTcpSocket::SubflowErrorClose(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<MpTcpSubflow> subflow = FindSubflow(socket, m_subflows);
+    if (!subflow)
+    {
+        return;
+    }
+    subflow->SetClosed();
+    bool allClosed = std::all_of(m_subflows.begin(), m_subflows.end(), [](const auto& s) {
+        return s->IsClosed();
+    });
+    if (allClosed && !m_closeNotified && !m_dataFinSent)
+    {
+        m_closeNotified = true;
+        NotifyErrorClose();
+    }
+    CheckClosed();
+}
+
+void
+MpTcpSocket::SubflowAccepted(Ptr<Socket> socket, const Address& from)
+{
+    NS_LOG_FUNCTION(this << socket << from);
+    Ptr<MpTcpSubflow> subflow = CreateObject<MpTcpSubflow>(DynamicCast<TcpSocketBase>(socket));
+    subflow->SetRemote(from);
+    subflow->SetEstablished();
+    m_joining.push_back(subflow);
+    socket->SetRecvCallback(MakeCallback(&MpTcpSocket::JoinRecv, this));
+}
+
+void
+MpTcpSocket::JoinRecv(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    auto it = std::find_if(m_joining.begin(), m_joining.end(), [&socket](const auto& subflow) {
+        return subflow->GetSocket() == socket;
+    });
+    if (it == m_joining.end())
+    {
+        return;
+    }
+    Ptr<MpTcpSubflow> subflow = *it;
+    subflow->Receive();
+    MpTcpHeader header;
+    Ptr<Packet> data;
+    if (!subflow->NextFrame(header, data))
+    {
+        return;
+    }
+    m_joining.erase(it);
+    if (header.GetKind() != MpTcpHeader::JOIN)
+    {
+        NS_LOG_WARN("Subflow not joined to a connection");
+        socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        socket->Close();
+        return;
+    }
+
+    uint64_t token = header.GetDataSequence();
+    Ptr<MpTcpSocket> connection;
+    auto found = m_connections.find(token);
+    bool created = found == m_connections.end();
+    if (!created)
+    {
+        connection = found->second;
+    }
+    else if (!NotifyConnectionRequest(subflow->GetRemote()))
+    {
+        NS_LOG_LOGIC("Connection " << token << " refused");
+        socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        socket->Close();
+        return;
+    }
+    else
+    {
+        connection = CreateObject<MpTcpSocket>();
+        connection->SetNode(m_node);
+        connection->SetScheduler(GetScheduler()->Fork());
+        connection->m_sndBufSize = m_sndBufSize;
+        connection->m_dataWindow = m_dataWindow;
+        connection->m_token = token;
+        connection->m_connecting = true;
+        connection->m_connected = true;
+        connection->m_closedCallback = MakeCallback(&MpTcpSocket::ConnectionClosed, this);
+        m_connections[token] = connection;
+    }
+    connection->AttachSubflow(subflow);
+    connection->m_subflows.push_back(subflow);
+    NS_LOG_LOGIC("Subflow joined to connection " << token);
+    if (created)
+    {
+        NotifyNewConnectionCreated(connection, subflow->GetRemote());
+    }
+    connection->ReceiveFrames(subflow);
+    connection->SendPending();
+}
+
+void
+MpTcpSocket::ConnectionClosed(uint64_t token)
+{
+    NS_LOG_FUNCTION(this << token);
+    m_connections.erase(token);
+}
+
+void
+MpTcpSocket::CheckClosed()
+{
+    if (m_closedCallback.IsNull())
+    {
+        return;
+    }
+    bool allClosed = std::all_of(m_subflows.begin(), m_subflows.end(), [](const auto& s) {
+        return s->IsClosed();
+    });
+    if ((m_dataFinSent && m_closeNotified) || allClosed)
+    {
+        // The listening socket may hold the last reference to this socket: it
+        // forgets it once the callbacks in progress have returned
+        Simulator::ScheduleNow(&MpTcpSocket::NotifyClosed, Ptr<MpTcpSocket>(this));
+    }
+}
+
+void
+MpTcpSocket::NotifyClosed()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_closedCallback.IsNull())
+    {
+        Callback<void, uint64_t> closedCallback = m_closedCallback;
+        m_closedCallback = MakeNullCallback<void, uint64_t>();
+        closedCallback(m_token);
+    }
+}
+
+void
+MpTcpSocket::ReceiveFrames(Ptr<MpTcpSubflow> subflow)
+{
+    NS_LOG_FUNCTION(this << subflow);
+    subflow->Receive();
+
+    bool delivered = false;
+    MpTcpHeader header;
+    Ptr<Packet> data;
+    while (subflow->NextFrame(header, data))
+    {
+        uint64_t dataSeq = header.GetDataSequence();
+        if (header.GetKind() == MpTcpHeader::DATA_FIN)
+        {
+            m_rcvDataFin = true;
+            m_rcvDataFinSeq = dataSeq;
+            continue;
+        }
+        if (header.GetKind() != MpTcpHeader::DATA || !data ||
+            dataSeq + data->GetSize() <= m_rcvNxt)
+        {
+            continue;
+        }
+        if (dataSeq != m_rcvNxt)
+        {
+            m_rcvOutOfOrder.emplace(dataSeq, data);
+            continue;
+        }
+        m_rcvQueue.push_back(data);
+        m_rxAvailable += data->GetSize();
+        m_rcvNxt += data->GetSize();
+        delivered = true;
+        for (auto it = m_rcvOutOfOrder.begin();
+             it != m_rcvOutOfOrder.end() && it->first == m_rcvNxt;
+             it = m_rcvOutOfOrder.erase(it))
+        {
+            m_rcvQueue.push_back(it->second);
+            m_rxAvailable += it->second->GetSize();
+            m_rcvNxt += it->second->GetSize();
+        }
+    }
+
+    if (delivered)
+    {
+        NotifyDataRecv();
+    }
+    CheckPeerClose();
+}
+
+void
+MpTcpSocket::CheckPeerClose()
+{
+    if (m_rcvDataFin && m_rcvNxt == m_rcvDataFinSeq && !m_closeNotified)
+    {
+        m_closeNotified = true;
+        NotifyNormalClose();
+        CheckClosed();
+    }
+}
+
+void
+MpTcpSocket::SendPending()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Sending on a subflow may call back into this socket
+    if (m_sending || m_dataFinSent)
+    {
+        return;
+    }
+    m_sending = true;
+    Ptr<MpTcpScheduler> scheduler = GetScheduler();
+    while (m_sendBuffer->GetSize() > 0 && m_sndNxt < m_sndUna + m_dataWindow)
+    {
+        uint32_t window = m_sndUna + m_dataWindow - m_sndNxt;
+        Ptr<MpTcpSubflow> subflow = scheduler->GetNextSubflow(m_subflows, window);
+        if (!subflow)
+        {
+            break;
+        }
+        NS_ASSERT(subflow->GetSegmentSize() > MpTcpHeader::SIZE);
+        uint32_t size = std::min({m_sendBuffer->GetSize(),
+                                  window,
+                                  subflow->GetSegmentSize() - MpTcpHeader::SIZE});
+        Ptr<Packet> data = m_sendBuffer->CreateFragment(0, size);
+        m_sendBuffer->RemoveAtStart(size);
+        uint64_t dataSeq = m_sndNxt;
+        m_sndNxt += size;
+        subflow->SendData(dataSeq, data);
+        NotifyDataSent(size);
+    }
+    m_sending = false;
+
+    if (m_closeRequested && m_sendBuffer->GetSize() == 0)
+    {
+        SendDataFin();
+    }
+}
+
+void
+MpTcpSocket::SendDataFin()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_dataFinSent)
+    {
+        return;
+    }
+    m_dataFinSent = true;
+    for (const auto& subflow : m_subflows)
+    {
+        if (subflow->IsEstablished() && !subflow->IsClosed())
+        {
+            subflow->SendDataFin(m_sndNxt);
+            subflow->Close();
+        }
+        else if (!subflow->IsEstablished())
+        {
+            subflow->GetSocket()->Close();
+        }
+    }
+    CheckClosed();
+}
+
+} // namespace ns3
@@ -0,0 +1,329 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SOCKET_H
+#define MPTCP_SOCKET_H
+
+#include "ns3/socket.h"
+#include "ns3/type-id.h"
+
+#include <deque>
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+class MpTcpScheduler;
+class MpTcpSubflow;
+class Node;
+class Packet;
+class TcpLiaCoupling;
+class TcpSocketBase;
+class UniformRandomVariable;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A multipath TCP connection, in the spirit of MPTCP (RFC 8684)
+ *
+ * An MpTcpSocket spreads a byte stream over several subflows, each an
+ * ordinary TCP connection (TcpSocketBase) between a local and a remote
+ * address, e.g., one per interface of a dual-homed node. Every subflow
+ * runs its own congestion control: any TcpCongestionOps (TcpCubic,
+ * TcpBbr, ...) can be selected per subflow, and the subflows running
+ * TcpLia are coupled with each other.
+ *
+ * The data of the connection is numbered by a 64-bit data sequence number.
+ * A packet scheduler (MpTcpScheduler, MpTcpSchedulerMinRtt by default)
+ * picks the subflow sending each segment of data, among the subflows with
+ * room in their congestion window, and the data is framed in the byte
+ * stream of the subflow with its data sequence number (MpTcpHeader). The
+ * receiver reorders the data of all the subflows; the data acknowledged
+ * by a subflow is acknowledged at the connection level, and the data sent
+ * beyond the lowest data sequence number not acknowledged yet is bounded by
+ * the DataWindow attribute, which bounds the reordering buffer of the
+ * receiver.
+ *
+ * The client adds its subflows with AddSubflow(), and opens them with
+ * Connect(); a connection without subflows opens a single subflow to the
+ * address passed to Connect(). The server binds and listens as a TCP
+ * server does: the first subflow of a connection creates a new
+ * MpTcpSocket, passed to the accept callback, and the next subflows join
+ * it with the token of the connection. The token is drawn at random, as
+ * the keys of MPTCP are, with the id of the node of the client in its
+ * high-order bits.
+ *
+ * Differences with MPTCP: the signaling is carried in the byte stream of
+ * the subflows instead of TCP options, the subflows are not advertised
+ * (ADD_ADDR) but configured at the client, and the data of a failed
+ * subflow is not reinjected on the other subflows.
+ */
+class MpTcpSocket : public Socket
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSocket();
+    ~MpTcpSocket() override;
+
+    /**
+     * \brief Set the node of the socket
+     * \param node the node
+     */
+    void SetNode(Ptr<Node> node);
+
+    /**
+     * \brief Set the packet scheduler, instead of one of type SchedulerType
+     * \param scheduler the packet scheduler
+     */
+    void SetScheduler(Ptr<MpTcpScheduler> scheduler);
+
+    /**
+     * \brief Get the packet scheduler
+     * \return the packet scheduler
+     */
+    Ptr<MpTcpScheduler> GetScheduler();
+
+    /**
+     * \brief Add a subflow
+     *
+     * The subflow is opened by Connect(), or right away if the connection is
+     * already open.
+     *
+     * \param local the local address of the subflow (an invalid address binds
+     * it to any address)
+     * \param remote the address of the server
+     * \param congestionTypeId the congestion control of the subflow (an
+     * invalid TypeId selects the SocketType of TcpL4Protocol)
+     * \return the subflow
+     */
+    Ptr<MpTcpSubflow> AddSubflow(const Address& local,
+                                 const Address& remote,
+                                 TypeId congestionTypeId = TypeId());
+
+    /**
+     * \brief Get the number of subflows
+     * \return the number of subflows
+     */
+    uint32_t GetNSubflows() const;
+
+    /**
+     * \brief Get a subflow
+     * \param i the index of the subflow
+     * \return the subflow
+     */
+    Ptr<MpTcpSubflow> GetSubflow(uint32_t i) const;
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    // Implementation of ns3::Socket
+    SocketErrno GetErrno() const override;
+    SocketType GetSocketType() const override;
+    Ptr<Node> GetNode() const override;
+    int Bind() override;
+    int Bind6() override;
+    int Bind(const Address& address) override;
+    int Close() override;
+    int ShutdownSend() override;
+    int ShutdownRecv() override;
+    int Connect(const Address& address) override;
+    int Listen() override;
+    uint32_t GetTxAvailable() const override;
+    int Send(Ptr<Packet> p, uint32_t flags) override;
+    int SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress) override;
+    uint32_t GetRxAvailable() const override;
+    Ptr<Packet> Recv(uint32_t maxSize, uint32_t flags) override;
+    Ptr<Packet> RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress) override;
+    int GetSockName(Address& address) const override;
+    int GetPeerName(Address& address) const override;
+    bool SetAllowBroadcast(bool allowBroadcast) override;
+    bool GetAllowBroadcast() const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Create a subflow socket
+     * \param local the local address of the subflow
+     * \param congestionTypeId the congestion control of the subflow
+     * \return the subflow
+     */
+    Ptr<MpTcpSubflow> CreateSubflow(const Address& local, TypeId congestionTypeId);
+
+    /**
+     * \brief Hook the callbacks of the socket of a subflow
+     * \param subflow the subflow
+     */
+    void AttachSubflow(Ptr<MpTcpSubflow> subflow);
+
+    /**
+     * \brief Unhook the callbacks of the sockets of the subflows and of the
+     * connections accepted, and forget them
+     */
+    void DetachSubflows();
+
+    /**
+     * \brief Find the subflow of a TCP socket
+     * \param socket the TCP socket
+     * \param subflows the subflows to search
+     * \return the subflow, or nullptr if not found
+     */
+    static Ptr<MpTcpSubflow> FindSubflow(Ptr<Socket> socket,
+                                         const std::vector<Ptr<MpTcpSubflow>>& subflows);
+
+    /**
+     * \brief Connect a subflow to its remote address
+     * \param subflow the subflow
+     */
+    void ConnectSubflow(Ptr<MpTcpSubflow> subflow);
+
+    /**
+     * \brief Subflow connected
+     * \param socket the socket of the subflow
+     */
+    void SubflowConnected(Ptr<Socket> socket);
+
+    /**
+     * \brief Subflow connection failed
+     * \param socket the socket of the subflow
+     */
+    void SubflowConnectionFailed(Ptr<Socket> socket);
+
+    /**
+     * \brief Data received by a subflow
+     * \param socket the socket of the subflow
+     */
+    void SubflowRecv(Ptr<Socket> socket);
+
+    /**
+     * \brief Room in the transmission buffer of a subflow, i.e., data acknowledged
+     * \param socket the socket of the subflow
+     * \param available the room in the transmission buffer
+     */
+    void SubflowSend(Ptr<Socket> socket, uint32_t available);
+
+    /**
+     * \brief Subflow closed on an error
+     * \param socket the socket of the subflow
+     */
+    void SubflowErrorClose(Ptr<Socket> socket);
+
+    /**
+     * \brief Subflow accepted by the listening socket
+     * \param socket the socket of the subflow
+     * \param from the address of the peer
+     */
+    void SubflowAccepted(Ptr<Socket> socket, const Address& from);
+
+    /**
+     * \brief Data received by a subflow accepted, not joined to a connection yet
+     * \param socket the socket of the subflow
+     */
+    void JoinRecv(Ptr<Socket> socket);
+
+    /**
+     * \brief Forget a connection accepted, once closed
+     * \param token the token of the connection
+     */
+    void ConnectionClosed(uint64_t token);
+
+    /**
+     * \brief Check if the connection is closed in both directions, or all its
+     * subflows failed, to notify the listening socket that accepted it
+     */
+    void CheckClosed();
+
+    /**
+     * \brief Notify the listening socket that accepted the connection of its close
+     */
+    void NotifyClosed();
+
+    /**
+     * \brief Process the frames received by a subflow
+     * \param subflow the subflow
+     */
+    void ReceiveFrames(Ptr<MpTcpSubflow> subflow);
+
+    /**
+     * \brief Send the data that the scheduler and the data window allow
+     */
+    void SendPending();
+
+    /**
+     * \brief Send the end of the data on all the subflows, and close them
+     */
+    void SendDataFin();
+
+    /**
+     * \brief Notify the application of the close of the connection by the peer
+     */
+    void CheckPeerClose();
+
+    Ptr<Node> m_node;                          //!< The node
+    Ptr<MpTcpScheduler> m_scheduler;           //!< The packet scheduler
+    TypeId m_schedulerTypeId;                  //!< Type of the packet scheduler
+    uint32_t m_sndBufSize;                     //!< Size of the transmission buffer
+    uint32_t m_dataWindow;                     //!< Maximum data beyond the data not acknowledged
+    Ptr<TcpLiaCoupling> m_coupling;            //!< Coupling of the subflows running TcpLia
+    Ptr<UniformRandomVariable> m_tokenRng;     //!< Draws the token of the connection
+    std::vector<Ptr<MpTcpSubflow>> m_subflows; //!< The subflows
+    Address m_local;                           //!< Address the socket is bound to
+    uint64_t m_token{0};                       //!< Token of the connection
+    SocketErrno m_errno{ERROR_NOTERROR};       //!< Error of the last operation
+    bool m_connecting{false};                  //!< Whether Connect() was called
+    bool m_connected{false};                   //!< Whether a subflow has been established
+    bool m_closeRequested{false};              //!< Whether the application closed the socket
+    bool m_dataFinSent{false};                 //!< Whether the end of the data was sent
+    bool m_closeNotified{false};               //!< Whether the close was notified
+    bool m_sending{false};                     //!< Whether data is being handed to the subflows
+
+    // Listening socket
+    Ptr<TcpSocketBase> m_listener;                      //!< TCP socket accepting subflows
+    std::vector<Ptr<MpTcpSubflow>> m_joining;           //!< Subflows not joined yet
+    std::map<uint64_t, Ptr<MpTcpSocket>> m_connections; //!< Connections by token
+    Callback<void, uint64_t> m_closedCallback;          //!< Forgets the connection once closed
+
+    // Transmission
+    Ptr<Packet> m_sendBuffer;                //!< Data not handed to a subflow yet
+    uint64_t m_sndUna{0};                    //!< Lowest data sequence not acknowledged
+    uint64_t m_sndNxt{0};                    //!< Next data sequence to send
+    std::map<uint64_t, uint64_t> m_sndAcked; //!< Ranges acknowledged above m_sndUna
+
+    // Reception
+    uint64_t m_rcvNxt{0};                           //!< Next data sequence expected
+    std::map<uint64_t, Ptr<Packet>> m_rcvOutOfOrder; //!< Data received out of order
+    std::deque<Ptr<Packet>> m_rcvQueue;              //!< Data ready for the application
+    uint32_t m_rxAvailable{0};                       //!< Bytes in m_rcvQueue
+    bool m_rcvDataFin{false};                        //!< Whether the DATA_FIN was received
+    uint64_t m_rcvDataFinSeq{0};                     //!< Data sequence of the DATA_FIN
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SOCKET_H */
@@ -0,0 +1,298 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-subflow.h"
+
+#include "tcp-socket-base.h"
+#include "tcp-tx-buffer.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSubflow");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSubflow);
+
+TypeId
+MpTcpSubflow::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSubflow").SetParent<Object>().SetGroupName("Internet");
+    return tid;
+}
+
+MpTcpSubflow::MpTcpSubflow()
+    : m_rxPending(Create<Packet>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSubflow::MpTcpSubflow(Ptr<TcpSocketBase> socket)
+    : m_socket(socket),
+      m_rxPending(Create<Packet>())
+{
+    NS_LOG_FUNCTION(this << socket);
+}
+
+MpTcpSubflow::~MpTcpSubflow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MpTcpSubflow::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_socket = nullptr;
+    m_mappings.clear();
+    m_txPending.clear();
+    m_rxPending = nullptr;
+    Object::DoDispose();
+}
+
+Ptr<TcpSocketBase>
+MpTcpSubflow::GetSocket() const
+{
+    return m_socket;
+}
+
+void
+MpTcpSubflow::SetRemote(const Address& remote)
+{
+    m_remote = remote;
+}
+
+Address
+MpTcpSubflow::GetRemote() const
+{
+    return m_remote;
+}
+
+void
+MpTcpSubflow::SetEstablished()
+{
+    NS_LOG_FUNCTION(this);
+    m_established = true;
+    m_headSeq = m_socket->GetTxBuffer()->HeadSequence();
+}
+
+bool
+MpTcpSubflow::IsEstablished() const
+{
+    return m_established;
+}
+
+void
+MpTcpSubflow::SetClosed()
+{
+    NS_LOG_FUNCTION(this);
+    m_closed = true;
+}
+
+bool
+MpTcpSubflow::IsClosed() const
+{
+    return m_closed;
+}
+
+Time
+MpTcpSubflow::GetRtt() const
+{
+    // The last RTT of the congestion state is the smoothed RTT estimate
+    return m_socket->GetSocketState()->m_lastRtt;
+}
+
+uint32_t
+MpTcpSubflow::GetCongestionWindow() const
+{
+    return m_socket->GetSocketState()->m_cWnd;
+}
+
+uint32_t
+MpTcpSubflow::GetSegmentSize() const
+{
+    return m_socket->GetSocketState()->m_segmentSize;
+}
+
+uint32_t
+MpTcpSubflow::GetAvailableWindow() const
+{
+    Ptr<const TcpSocketState> tcb = m_socket->GetSocketState();
+    uint32_t cwnd = tcb->m_cWnd;
+    uint32_t used =
+        tcb->m_bytesInFlight + m_socket->GetTxBuffer()->SizeFromSequence(tcb->m_highTxMark);
+    return cwnd > used ? cwnd - used : 0;
+}
+
+bool
+MpTcpSubflow::IsAvailable() const
+{
+    if (!m_established || m_closed)
+    {
+        return false;
+    }
+    uint32_t segmentSize = GetSegmentSize();
+    return m_txPending.empty() && GetAvailableWindow() >= segmentSize &&
+           m_socket->GetTxAvailable() >= segmentSize;
+}
+
+uint64_t
+MpTcpSubflow::GetDataSent() const
+{
+    return m_dataSent;
+}
+
+void
+MpTcpSubflow::Write(Ptr<Packet> frame)
+{
+    // The frame takes its place in the byte stream now, even if it waits for
+    // room in the transmission buffer of the TCP socket
+    m_streamSent += frame->GetSize();
+    m_txPending.push_back(frame);
+    Flush();
+}
+
+bool
+MpTcpSubflow::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_txPending.empty() && m_socket->GetTxAvailable() >= m_txPending.front()->GetSize())
+    {
+        if (m_socket->Send(m_txPending.front(), 0) < 0)
+        {
+            break;
+        }
+        m_txPending.pop_front();
+    }
+    if (m_txPending.empty() && m_closeOnFlush)
+    {
+        m_closeOnFlush = false;
+        m_socket->Close();
+    }
+    return m_txPending.empty();
+}
+
+void
+MpTcpSubflow::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_txPending.empty())
+    {
+        m_socket->Close();
+    }
+    else
+    {
+        NS_LOG_LOGIC("Close deferred until " << m_txPending.size() << " frames are queued");
+        m_closeOnFlush = true;
+    }
+}
+
+void
+MpTcpSubflow::SendJoin(uint64_t token)
+{
+    NS_LOG_FUNCTION(this << token);
+    MpTcpHeader header;
+    header.SetKind(MpTcpHeader::JOIN);
+    header.SetDataSequence(token);
+    Ptr<Packet> frame = Create<Packet>();
+    frame->AddHeader(header);
+    Write(frame);
+}
+
+void
+MpTcpSubflow::SendData(uint64_t dataSeq, Ptr<Packet> data)
+{
+    NS_LOG_FUNCTION(this << dataSeq << data->GetSize());
+    MpTcpHeader header;
+    header.SetKind(MpTcpHeader::DATA);
+    header.SetLength(data->GetSize());
+    header.SetDataSequence(dataSeq);
+    Ptr<Packet> frame = data->Copy();
+    frame->AddHeader(header);
+    Write(frame);
+    m_mappings.push_back({m_streamSent, dataSeq, data->GetSize()});
+    m_dataSent += data->GetSize();
+}
+
+void
+MpTcpSubflow::SendDataFin(uint64_t dataSeq)
+{
+    NS_LOG_FUNCTION(this << dataSeq);
+    MpTcpHeader header;
+    header.SetKind(MpTcpHeader::DATA_FIN);
+    header.SetDataSequence(dataSeq);
+    Ptr<Packet> frame = Create<Packet>();
+    frame->AddHeader(header);
+    Write(frame);
+}
+
+void
+MpTcpSubflow::PopAckedData(std::vector<std::pair<uint64_t, uint32_t>>& acked)
+{
+    if (!m_established)
+    {
+        return;
+    }
+    SequenceNumber32 head = m_socket->GetTxBuffer()->HeadSequence();
+    if (head > m_headSeq)
+    {
+        m_streamAcked += head - m_headSeq;
+        m_headSeq = head;
+    }
+    while (!m_mappings.empty() && m_mappings.front().streamEnd <= m_streamAcked)
+    {
+        acked.emplace_back(m_mappings.front().dataSeq, m_mappings.front().length);
+        m_mappings.pop_front();
+    }
+}
+
+void
+MpTcpSubflow::Receive()
+{
+    NS_LOG_FUNCTION(this);
+    while (Ptr<Packet> p = m_socket->Recv(std::numeric_limits<uint32_t>::max(), 0))
+    {
+        m_rxPending->AddAtEnd(p);
+    }
+}
+
+bool
+MpTcpSubflow::NextFrame(MpTcpHeader& header, Ptr<Packet>& data)
+{
+    if (m_rxPending->GetSize() < MpTcpHeader::SIZE)
+    {
+        return false;
+    }
+    m_rxPending->PeekHeader(header);
+    uint32_t length = header.GetKind() == MpTcpHeader::DATA ? header.GetLength() : 0;
+    if (m_rxPending->GetSize() < MpTcpHeader::SIZE + length)
+    {
+        return false;
+    }
+    m_rxPending->RemoveAtStart(MpTcpHeader::SIZE);
+    data = nullptr;
+    if (length > 0)
+    {
+        data = m_rxPending->CreateFragment(0, length);
+        m_rxPending->RemoveAtStart(length);
+    }
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,240 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SUBFLOW_H
+#define MPTCP_SUBFLOW_H
+
+#include "mptcp-header.h"
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class TcpSocketBase;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A subflow of an MpTcpSocket
+ *
+ * A subflow is a TCP connection carrying a part of the data of an
+ * MpTcpSocket, framed by MpTcpHeader. The subflow remembers which data
+ * sequence numbers it carries, to report the data acknowledged by its TCP
+ * connection, and reassembles the frames received from its TCP connection.
+ *
+ * The schedulers of MpTcpSocket (MpTcpScheduler) pick the subflows from
+ * their congestion state.
+ */
+class MpTcpSubflow : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSubflow();
+
+    /**
+     * \brief Constructor
+     * \param socket the TCP socket of the subflow
+     */
+    MpTcpSubflow(Ptr<TcpSocketBase> socket);
+
+    ~MpTcpSubflow() override;
+
+    /**
+     * \brief Get the TCP socket of the subflow
+     * \return the TCP socket
+     */
+    Ptr<TcpSocketBase> GetSocket() const;
+
+    /**
+     * \brief Set the address the subflow connects to
+     * \param remote the address of the peer
+     */
+    void SetRemote(const Address& remote);
+
+    /**
+     * \brief Get the address the subflow connects to
+     * \return the address of the peer
+     */
+    Address GetRemote() const;
+
+    /**
+     * \brief Mark the TCP connection of the subflow as established
+     */
+    void SetEstablished();
+
+    /**
+     * \brief Check if the TCP connection of the subflow is established
+     * \return true if the subflow is established
+     */
+    bool IsEstablished() const;
+
+    /**
+     * \brief Mark the subflow as closed: no data is scheduled on it anymore
+     */
+    void SetClosed();
+
+    /**
+     * \brief Check if the subflow is closed
+     * \return true if the subflow is closed
+     */
+    bool IsClosed() const;
+
+    /**
+     * \brief Get the smoothed RTT of the subflow
+     * \return the smoothed RTT, or zero if not measured yet
+     */
+    Time GetRtt() const;
+
+    /**
+     * \brief Get the congestion window of the subflow
+     * \return the congestion window, in bytes
+     */
+    uint32_t GetCongestionWindow() const;
+
+    /**
+     * \brief Get the segment size of the subflow
+     * \return the segment size, in bytes
+     */
+    uint32_t GetSegmentSize() const;
+
+    /**
+     * \brief Get the room left in the congestion window
+     *
+     * The data queued in the TCP socket, and not sent yet, takes room in the
+     * congestion window as the data in flight does.
+     *
+     * \return the room left, in bytes
+     */
+    uint32_t GetAvailableWindow() const;
+
+    /**
+     * \brief Check if the subflow can send a full segment of data right away
+     *
+     * A subflow with frames waiting for room in the transmission buffer of its
+     * TCP socket is not available.
+     *
+     * \return true if the subflow is available
+     */
+    bool IsAvailable() const;
+
+    /**
+     * \brief Get the data of the connection sent on the subflow
+     * \return the bytes of data, without the framing
+     */
+    uint64_t GetDataSent() const;
+
+    /**
+     * \brief Send the frame joining the subflow to a connection
+     * \param token the token of the connection
+     */
+    void SendJoin(uint64_t token);
+
+    /**
+     * \brief Send data of the connection
+     * \param dataSeq the data sequence number of the first byte
+     * \param data the data
+     */
+    void SendData(uint64_t dataSeq, Ptr<Packet> data);
+
+    /**
+     * \brief Send the end of the data of the connection
+     * \param dataSeq the data sequence number following the last byte of data
+     */
+    void SendDataFin(uint64_t dataSeq);
+
+    /**
+     * \brief Queue the frames waiting for room in the transmission buffer of the
+     * TCP socket, e.g., once the TCP connection has acknowledged data
+     * \return true if no frame is waiting anymore
+     */
+    bool Flush();
+
+    /**
+     * \brief Close the TCP connection, once the frames waiting for room in the
+     * transmission buffer are queued
+     */
+    void Close();
+
+    /**
+     * \brief Get the data newly acknowledged by the TCP connection
+     * \param acked the ranges of data (data sequence number and length) to append to
+     */
+    void PopAckedData(std::vector<std::pair<uint64_t, uint32_t>>& acked);
+
+    /**
+     * \brief Read the data received by the TCP socket
+     */
+    void Receive();
+
+    /**
+     * \brief Extract the next complete frame received
+     * \param header the header of the frame
+     * \param data the data of a DATA frame
+     * \return true if a frame was extracted
+     */
+    bool NextFrame(MpTcpHeader& header, Ptr<Packet>& data);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Write a frame in the byte stream of the subflow
+     *
+     * The frame waits, after the frames already waiting, if the transmission
+     * buffer of the TCP socket has no room for it.
+     *
+     * \param frame the frame
+     */
+    void Write(Ptr<Packet> frame);
+
+    /// Data of the connection carried by the subflow
+    struct Mapping
+    {
+        uint64_t streamEnd; //!< Offset in the byte stream of the end of the frame
+        uint64_t dataSeq;   //!< Data sequence number of the data
+        uint32_t length;    //!< Length of the data
+    };
+
+    Ptr<TcpSocketBase> m_socket;         //!< TCP socket of the subflow
+    Address m_remote;                    //!< Address of the peer
+    bool m_established{false};           //!< Whether the TCP connection is established
+    bool m_closed{false};                //!< Whether the subflow is closed
+    bool m_closeOnFlush{false};          //!< Whether to close the TCP connection once flushed
+    SequenceNumber32 m_headSeq{0};       //!< Head of the transmission buffer at the last update
+    uint64_t m_streamSent{0};            //!< Bytes written in the byte stream
+    uint64_t m_streamAcked{0};           //!< Bytes of the byte stream acknowledged
+    uint64_t m_dataSent{0};              //!< Bytes of data sent
+    std::deque<Mapping> m_mappings;      //!< Data not acknowledged yet
+    std::deque<Ptr<Packet>> m_txPending; //!< Frames waiting for room in the TCP socket
+    Ptr<Packet> m_rxPending;             //!< Bytes received, not forming a complete frame yet
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SUBFLOW_H */
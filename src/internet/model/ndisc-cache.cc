@@ -28,6 +28,8 @@
 #include "ns3/node.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -68,6 +70,7 @@ NdiscCache::DoDispose()
     m_device = nullptr;
     m_interface = nullptr;
     m_icmpv6 = nullptr;
+    m_neighborTable = nullptr;
     Object::DoDispose();
 }
 
@@ -96,14 +99,30 @@ NdiscCache::GetDevice() const
     return m_device;
 }
 
+void
+NdiscCache::SetNeighborTable(Ptr<NdiscCache> table)
+{
+    NS_LOG_FUNCTION(this << table);
+    NS_ASSERT_MSG(table != this, "A NDISC cache cannot be its own neighbor table");
+    m_neighborTable = table;
+}
+
+Ptr<NdiscCache>
+NdiscCache::GetNeighborTable() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_neighborTable;
+}
+
 NdiscCache::Entry*
 NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    auto it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
@@ -118,10 +137,10 @@ NdiscCache::LookupInverse(Address dst)
     NS_LOG_FUNCTION(this << dst);
 
     std::list<NdiscCache::Entry*> entryList;
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    auto it = m_inverseIndex.find(dst);
+    if (it != m_inverseIndex.end())
     {
-        NdiscCache::Entry* entry = (*i).second;
-        if (entry->GetMacAddress() == dst)
+        for (NdiscCache::Entry* entry : it->second)
         {
             NS_LOG_LOGIC("Found an entry:" << (*entry));
             entryList.push_back(entry);
@@ -139,6 +158,7 @@ NdiscCache::Add(Ipv6Address to)
     auto entry = new NdiscCache::Entry(this);
     entry->SetIpv6Address(to);
     m_ndCache[to] = entry;
+    ReindexMacAddress(entry, Address());
     return entry;
 }
 
@@ -147,14 +167,52 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    auto i = m_ndCache.find(entry->GetIpv6Address());
+    if (i != m_ndCache.end() && i->second == entry)
     {
-        if ((*i).second == entry)
+        m_ndCache.erase(i);
+        UnindexMacAddress(entry, entry->GetMacAddress());
+        entry->ClearWaitingPacket();
+        delete entry;
+    }
+}
+
+void
+NdiscCache::ReindexMacAddress(NdiscCache::Entry* entry, const Address& previous)
+{
+    NS_LOG_FUNCTION(this << entry << previous);
+    UnindexMacAddress(entry, previous);
+    if (entry->GetMacAddress().IsInvalid() ||
+        m_ndCache.find(entry->GetIpv6Address()) == m_ndCache.end())
+    {
+        return; // no MAC address yet, or not in the cache
+    }
+    std::vector<NdiscCache::Entry*>& entries = m_inverseIndex[entry->GetMacAddress()];
+    auto position = std::lower_bound(entries.begin(),
+                                     entries.end(),
+                                     entry,
+                                     [](NdiscCache::Entry* a, NdiscCache::Entry* b) {
+                                         return a->GetIpv6Address() < b->GetIpv6Address();
+                                     });
+    entries.insert(position, entry);
+}
+
+void
+NdiscCache::UnindexMacAddress(NdiscCache::Entry* entry, const Address& mac)
+{
+    NS_LOG_FUNCTION(this << entry << mac);
+    auto it = m_inverseIndex.find(mac);
+    if (it == m_inverseIndex.end())
+    {
+        return;
+    }
+    auto position = std::find(it->second.begin(), it->second.end(), entry);
+    if (position != it->second.end())
+    {
+        it->second.erase(position);
+        if (it->second.empty())
         {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
-            return;
+            m_inverseIndex.erase(it);
         }
     }
 }
@@ -170,6 +228,7 @@ NdiscCache::Flush()
     }
 
     m_ndCache.erase(m_ndCache.begin(), m_ndCache.end());
+    m_inverseIndex.clear();
 }
 
 void
@@ -192,7 +251,13 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    // Print the entries in the order of their addresses
+    std::vector<std::pair<Ipv6Address, NdiscCache::Entry*>> entries(m_ndCache.begin(),
+                                                                     m_ndCache.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -294,6 +359,13 @@ void
 NdiscCache::Entry::FunctionReachableTimeout()
 {
     NS_LOG_FUNCTION(this);
+    Time left = m_lastReachabilityConfirmation + m_nudTimer.GetDelay() - Simulator::Now();
+    if (left.IsStrictlyPositive())
+    {
+        // The reachability was confirmed since the timer was started
+        m_nudTimer.Schedule(left);
+        return;
+    }
     this->MarkStale();
 }
 
@@ -487,12 +559,13 @@ NdiscCache::Entry::UpdateReachableTimer()
 
     if (m_state == REACHABLE)
     {
+        // Rather than rescheduling the timer for each packet received, the
+        // timer is started again for the time left when it expires
         m_lastReachabilityConfirmation = Simulator::Now();
-        if (m_nudTimer.IsRunning())
+        if (!m_nudTimer.IsRunning())
         {
-            m_nudTimer.Cancel();
+            m_nudTimer.Schedule();
         }
-        m_nudTimer.Schedule();
     }
 }
 
@@ -563,7 +636,9 @@ NdiscCache::Entry::MarkReachable(Address mac)
 {
     NS_LOG_FUNCTION(this << mac);
     m_state = REACHABLE;
+    Address previous = m_macAddress;
     m_macAddress = mac;
+    m_ndCache->ReindexMacAddress(this, previous);
     return m_waiting;
 }
 
@@ -593,7 +668,9 @@ NdiscCache::Entry::MarkStale(Address mac)
 {
     NS_LOG_FUNCTION(this << mac);
     m_state = STALE;
+    Address previous = m_macAddress;
     m_macAddress = mac;
+    m_ndCache->ReindexMacAddress(this, previous);
     return m_waiting;
 }
 
@@ -680,7 +757,9 @@ void
 NdiscCache::Entry::SetMacAddress(Address mac)
 {
     NS_LOG_FUNCTION(this << mac << int(m_state));
+    Address previous = m_macAddress;
     m_macAddress = mac;
+    m_ndCache->ReindexMacAddress(this, previous);
 }
 
 void
@@ -722,8 +801,9 @@ NdiscCache::RemoveAutoGeneratedEntries()
         if (i->second->IsAutoGenerated())
         {
             i->second->ClearWaitingPacket();
+            UnindexMacAddress(i->second, i->second->GetMacAddress());
             delete i->second;
-            m_ndCache.erase(i++);
+            i = m_ndCache.erase(i);
             continue;
         }
         i++;
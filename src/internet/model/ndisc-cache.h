@@ -29,8 +29,9 @@
 #include "ns3/timer.h"
 
 #include <list>
-#include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -87,6 +88,23 @@ class NdiscCache : public Object
      */
     Ptr<Ipv6Interface> GetInterface() const;
 
+    /**
+     * \brief Set the neighbor table shared by the NDISC caches of a channel.
+     *
+     * The STATIC_AUTOGENERATED entries of the table are consulted before the
+     * entries of this cache when an address is resolved.  The table is not
+     * modified by the Neighbor Discovery protocol.
+     *
+     * \param table the shared neighbor table, or nullptr
+     */
+    void SetNeighborTable(Ptr<NdiscCache> table);
+
+    /**
+     * \brief Get the neighbor table shared by the NDISC caches of a channel.
+     * \return the shared neighbor table, or nullptr
+     */
+    Ptr<NdiscCache> GetNeighborTable() const;
+
     /**
      * \brief Lookup in the cache.
      * \param dst destination address.
@@ -335,6 +353,9 @@ class NdiscCache : public Object
 
         /**
          * \brief Update the reachable timer.
+         *
+         * The timer is not rescheduled: when it expires, it is started again
+         * for the time left since the last reachability confirmation.
          */
         void UpdateReachableTimer();
 
@@ -457,11 +478,11 @@ class NdiscCache : public Object
     /**
      * \brief Neighbor Discovery Cache container
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash> Cache;
     /**
      * \brief Neighbor Discovery Cache container iterator
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*>::iterator CacheI;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash>::iterator CacheI;
 
     /**
      * \brief A list of Entry.
@@ -469,6 +490,30 @@ class NdiscCache : public Object
     Cache m_ndCache;
 
   private:
+    /**
+     * \brief Index of the entries by MAC address, each list sorted by IPv6 address
+     */
+    typedef std::unordered_map<Address, std::vector<NdiscCache::Entry*>, AddressHash> InverseIndex;
+
+    /**
+     * \brief Move an entry in the index by MAC address, after its MAC address changed.
+     * \param entry the entry
+     * \param previous the previous MAC address of the entry
+     */
+    void ReindexMacAddress(NdiscCache::Entry* entry, const Address& previous);
+
+    /**
+     * \brief Remove an entry from the index by MAC address.
+     * \param entry the entry
+     * \param mac the MAC address of the entry in the index
+     */
+    void UnindexMacAddress(NdiscCache::Entry* entry, const Address& mac);
+
+    /**
+     * \brief The entries, by MAC address.
+     */
+    InverseIndex m_inverseIndex;
+
     /**
      * \brief The NetDevice.
      */
@@ -484,6 +529,11 @@ class NdiscCache : public Object
      */
     Ptr<Icmpv6L4Protocol> m_icmpv6;
 
+    /**
+     * \brief the neighbor table shared by the caches of the channel.
+     */
+    Ptr<NdiscCache> m_neighborTable;
+
     /**
      * \brief Max number of packet stored in m_waiting.
      */
@@ -51,6 +51,7 @@ private:
         uint32_t probe_mode;
         uint32_t epp;
         uint32_t epp_min_rtt;
+        uint32_t min_cwnd;
     } m_state;
 
     void     SplineCCAlgo(Ptr<TcpSocketState> tcb, uint32_t curr_rtt, uint64_t throughput, uint32_t num_acks);
@@ -281,18 +281,69 @@ TcpHeader::GetSerializedSize() const
     return CalculateHeaderLength() * 4;
 }
 
+/**
+ * \brief Write a 16-bit value in network order.
+ * \param buf the bytes to write
+ * \param data the value
+ */
+static void
+WriteHtonU16(uint8_t* buf, uint16_t data)
+{
+    buf[0] = data >> 8;
+    buf[1] = data & 0xff;
+}
+
+/**
+ * \brief Write a 32-bit value in network order.
+ * \param buf the bytes to write
+ * \param data the value
+ */
+static void
+WriteHtonU32(uint8_t* buf, uint32_t data)
+{
+    WriteHtonU16(buf, data >> 16);
+    WriteHtonU16(buf + 2, data & 0xffff);
+}
+
+/**
+ * \brief Read a 16-bit value in network order.
+ * \param buf the bytes to read
+ * \return the value
+ */
+static uint16_t
+ReadNtohU16(const uint8_t* buf)
+{
+    return (buf[0] << 8) | buf[1];
+}
+
+/**
+ * \brief Read a 32-bit value in network order.
+ * \param buf the bytes to read
+ * \return the value
+ */
+static uint32_t
+ReadNtohU32(const uint8_t* buf)
+{
+    return (static_cast<uint32_t>(ReadNtohU16(buf)) << 16) | ReadNtohU16(buf + 2);
+}
+
 void
 TcpHeader::Serialize(Buffer::Iterator start) const
 {
     Buffer::Iterator i = start;
-    i.WriteHtonU16(m_sourcePort);
-    i.WriteHtonU16(m_destinationPort);
-    i.WriteHtonU32(m_sequenceNumber.GetValue());
-    i.WriteHtonU32(m_ackNumber.GetValue());
-    i.WriteHtonU16(GetLength() << 12 | m_flags); // reserved bits are all zero
-    i.WriteHtonU16(m_windowSize);
-    i.WriteHtonU16(0);
-    i.WriteHtonU16(m_urgentPointer);
+
+    // Lay out the 20 bytes of the fixed part of the header, and write them
+    // into the buffer at once.
+    uint8_t header[20];
+    WriteHtonU16(&header[0], m_sourcePort);
+    WriteHtonU16(&header[2], m_destinationPort);
+    WriteHtonU32(&header[4], m_sequenceNumber.GetValue());
+    WriteHtonU32(&header[8], m_ackNumber.GetValue());
+    WriteHtonU16(&header[12], GetLength() << 12 | m_flags); // reserved bits are all zero
+    WriteHtonU16(&header[14], m_windowSize);
+    WriteHtonU16(&header[16], 0);
+    WriteHtonU16(&header[18], m_urgentPointer);
+    i.Write(header, 20);
 
     // Serialize options if they exist
     // This implementation does not presently try to align options on word
@@ -331,16 +382,19 @@ TcpHeader::Deserialize(Buffer::Iterator start)
 {
     m_optionsLen = 0;
     Buffer::Iterator i = start;
-    m_sourcePort = i.ReadNtohU16();
-    m_destinationPort = i.ReadNtohU16();
-    m_sequenceNumber = i.ReadNtohU32();
-    m_ackNumber = i.ReadNtohU32();
-    uint16_t field = i.ReadNtohU16();
+
+    // Read the 20 bytes of the fixed part of the header at once
+    uint8_t header[20];
+    i.Read(header, 20);
+    m_sourcePort = ReadNtohU16(&header[0]);
+    m_destinationPort = ReadNtohU16(&header[2]);
+    m_sequenceNumber = ReadNtohU32(&header[4]);
+    m_ackNumber = ReadNtohU32(&header[8]);
+    uint16_t field = ReadNtohU16(&header[12]);
     m_flags = field & 0xFF;
     m_length = field >> 12;
-    m_windowSize = i.ReadNtohU16();
-    i.Next(2);
-    m_urgentPointer = i.ReadNtohU16();
+    m_windowSize = ReadNtohU16(&header[14]);
+    m_urgentPointer = ReadNtohU16(&header[18]);
 
     // Deserialize options if they exist
     m_options.clear();
@@ -19,8 +19,10 @@
 
 #include "tcp-l4-protocol.h"
 
+#include "gso-tag.h"
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
+#include "ipv4-interface.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv6-end-point-demux.h"
@@ -31,7 +33,8 @@
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-cubic.h"
-#include "tcp-header.h"
+#include "tcp-option-ts.h"
+#include "tcp-pacing-wheel.h"
 #include "tcp-prr-recovery.h"
 #include "tcp-recovery-ops.h"
 #include "tcp-socket-base.h"
@@ -45,6 +48,7 @@
 #include "ns3/object-map.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <iomanip>
 #include <sstream>
@@ -99,7 +103,34 @@ TcpL4Protocol::GetTypeId()
                           "is kept for backward compatibility.",
                           ObjectMapValue(),
                           MakeObjectMapAccessor(&TcpL4Protocol::m_sockets),
-                          MakeObjectMapChecker<TcpSocketBase>());
+                          MakeObjectMapChecker<TcpSocketBase>())
+            .AddAttribute("GroTimeout",
+                          "Maximum time in-order data segments received over IPv4 are held to "
+                          "be coalesced with the following segments of their flow into a "
+                          "single segment (generic receive offload). Zero disables GRO.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpL4Protocol::m_groTimeout),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("GroMaxSize",
+                          "Maximum payload size of a segment coalesced by GRO",
+                          UintegerValue(65000),
+                          MakeUintegerAccessor(&TcpL4Protocol::m_groMaxSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PacingGranularity",
+                          "Granularity of the pacing wheel releasing the segments of all the "
+                          "paced sockets of the node, one event per tick. Zero makes each "
+                          "socket schedule its own pacing events.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpL4Protocol::m_pacingGranularity),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("SocketTemplates",
+                          "Create the sockets as copies of a template socket, constructed "
+                          "once per socket type, instead of constructing each of them from "
+                          "the default values of their attributes. The default values "
+                          "changed after the first socket of a type is created are ignored.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpL4Protocol::m_socketTemplates),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -170,6 +201,15 @@ TcpL4Protocol::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     m_sockets.clear();
+    m_socketIds.clear();
+    m_templates.clear();
+    m_groFlushEvent.Cancel();
+    m_groFlows.clear();
+    if (m_pacingWheel)
+    {
+        m_pacingWheel->Dispose();
+        m_pacingWheel = nullptr;
+    }
 
     if (m_endPoints != nullptr)
     {
@@ -195,10 +235,52 @@ TcpL4Protocol::CreateSocket(TypeId congestionTypeId)
     return CreateSocket(congestionTypeId, m_recoveryTypeId);
 }
 
+Ptr<TcpPacingWheel>
+TcpL4Protocol::GetPacingWheel()
+{
+    if (!m_pacingGranularity.IsStrictlyPositive())
+    {
+        return nullptr;
+    }
+    if (!m_pacingWheel)
+    {
+        m_pacingWheel = CreateObject<TcpPacingWheel>();
+        m_pacingWheel->SetGranularity(m_pacingGranularity);
+    }
+    return m_pacingWheel;
+}
+
 Ptr<Socket>
 TcpL4Protocol::CreateSocket(TypeId congestionTypeId, TypeId recoveryTypeId)
 {
     NS_LOG_FUNCTION(this << congestionTypeId.GetName());
+
+    Ptr<TcpSocketBase> socket;
+    if (m_socketTemplates)
+    {
+        // Copying a socket is what a listening socket does for every
+        // connection it accepts: the attributes are not set one by one again
+        Ptr<TcpSocketBase>& socketTemplate =
+            m_templates[std::make_tuple(m_rttTypeId, congestionTypeId, recoveryTypeId)];
+        if (!socketTemplate)
+        {
+            socketTemplate = ConstructSocket(congestionTypeId, recoveryTypeId);
+        }
+        socket = CopyObject<TcpSocketBase>(socketTemplate);
+    }
+    else
+    {
+        socket = ConstructSocket(congestionTypeId, recoveryTypeId);
+    }
+
+    AddSocket(socket);
+    return socket;
+}
+
+Ptr<TcpSocketBase>
+TcpL4Protocol::ConstructSocket(TypeId congestionTypeId, TypeId recoveryTypeId)
+{
+    NS_LOG_FUNCTION(this << congestionTypeId.GetName() << recoveryTypeId.GetName());
     ObjectFactory rttFactory;
     ObjectFactory congestionAlgorithmFactory;
     ObjectFactory recoveryAlgorithmFactory;
@@ -216,8 +298,6 @@ TcpL4Protocol::CreateSocket(TypeId congestionTypeId, TypeId recoveryTypeId)
     socket->SetRtt(rtt);
     socket->SetCongestionControlAlgorithm(algo);
     socket->SetRecoveryAlgorithm(recovery);
-
-    m_sockets[m_socketIndex++] = socket;
     return socket;
 }
 
@@ -472,6 +552,21 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
         return checksumControl;
     }
 
+    if (m_groTimeout.IsStrictlyPositive())
+    {
+        return GroReceive(packet, incomingTcpHeader, incomingIpHeader, incomingInterface);
+    }
+    return Deliver(packet, incomingTcpHeader, incomingIpHeader, incomingInterface);
+}
+
+IpL4Protocol::RxStatus
+TcpL4Protocol::Deliver(Ptr<Packet> packet,
+                       const TcpHeader& incomingTcpHeader,
+                       const Ipv4Header& incomingIpHeader,
+                       Ptr<Ipv4Interface> incomingInterface)
+{
+    NS_LOG_FUNCTION(this << packet << incomingTcpHeader << incomingIpHeader << incomingInterface);
+
     Ipv4EndPointDemux::EndPoints endPoints;
     endPoints = m_endPoints->Lookup(incomingIpHeader.GetDestination(),
                                     incomingTcpHeader.GetDestinationPort(),
@@ -523,6 +618,148 @@ TcpL4Protocol::Receive(Ptr<Packet> packet,
     return IpL4Protocol::RX_OK;
 }
 
+/**
+ * \param header a TCP header
+ * \return true if the header carries no option but timestamps (and padding)
+ */
+static bool
+HasOnlyTimestamps(const TcpHeader& header)
+{
+    for (const auto& option : header.GetOptionList())
+    {
+        if (option->GetKind() != TcpOption::TS && option->GetKind() != TcpOption::END &&
+            option->GetKind() != TcpOption::NOP)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \param a a TCP header
+ * \param b another TCP header
+ * \return true if both headers carry the same timestamps, or none
+ */
+static bool
+HaveSameTimestamps(const TcpHeader& a, const TcpHeader& b)
+{
+    if (a.HasOption(TcpOption::TS) != b.HasOption(TcpOption::TS))
+    {
+        return false;
+    }
+    if (!a.HasOption(TcpOption::TS))
+    {
+        return true;
+    }
+    auto tsA = DynamicCast<const TcpOptionTS>(a.GetOption(TcpOption::TS));
+    auto tsB = DynamicCast<const TcpOptionTS>(b.GetOption(TcpOption::TS));
+    return tsA->GetTimestamp() == tsB->GetTimestamp() && tsA->GetEcho() == tsB->GetEcho();
+}
+
+IpL4Protocol::RxStatus
+TcpL4Protocol::GroReceive(Ptr<Packet> packet,
+                          const TcpHeader& incomingTcpHeader,
+                          const Ipv4Header& incomingIpHeader,
+                          Ptr<Ipv4Interface> incomingInterface)
+{
+    NS_LOG_FUNCTION(this << packet << incomingTcpHeader << incomingIpHeader << incomingInterface);
+
+    GroKey key(incomingIpHeader.GetSource().Get(),
+               incomingIpHeader.GetDestination().Get(),
+               incomingTcpHeader.GetSourcePort(),
+               incomingTcpHeader.GetDestinationPort());
+    uint32_t size = packet->GetSize() - incomingTcpHeader.GetSerializedSize();
+    uint8_t flags = incomingTcpHeader.GetFlags();
+    // Only data segments carrying nothing but an acknowledgment are coalesced
+    bool coalescable = size > 0 && (flags & ~TcpHeader::PSH) == TcpHeader::ACK &&
+                       HasOnlyTimestamps(incomingTcpHeader);
+
+    auto it = m_groFlows.find(key);
+    if (it != m_groFlows.end())
+    {
+        GroFlow& flow = it->second;
+        if (coalescable && incomingTcpHeader.GetSequenceNumber() == flow.nextSeq &&
+            incomingTcpHeader.GetAckNumber() == flow.header.GetAckNumber() &&
+            incomingTcpHeader.GetWindowSize() == flow.header.GetWindowSize() &&
+            incomingIpHeader.GetTos() == flow.ipHeader.GetTos() &&
+            incomingInterface == flow.interface && size <= flow.segmentSize &&
+            flow.payload->GetSize() + size <= m_groMaxSize &&
+            HaveSameTimestamps(incomingTcpHeader, flow.header))
+        {
+            TcpHeader header;
+            packet->RemoveHeader(header);
+            flow.payload->AddAtEnd(packet);
+            flow.header.SetFlags(flow.header.GetFlags() | flags);
+            flow.nextSeq += size;
+            flow.segments++;
+            NS_LOG_LOGIC("GRO coalesced " << flow.segments << " segments, "
+                                          << flow.payload->GetSize() << " bytes");
+            // A short or PSH segment ends the batch, as well as reaching the maximum size
+            if (size < flow.segmentSize || (flags & TcpHeader::PSH) ||
+                flow.payload->GetSize() + flow.segmentSize > m_groMaxSize)
+            {
+                GroFlush(it);
+            }
+            return IpL4Protocol::RX_OK;
+        }
+        GroFlush(it);
+    }
+
+    if (!coalescable)
+    {
+        return Deliver(packet, incomingTcpHeader, incomingIpHeader, incomingInterface);
+    }
+
+    GroFlow flow;
+    flow.payload = packet->Copy();
+    flow.payload->RemoveHeader(flow.header);
+    flow.header = incomingTcpHeader;
+    flow.ipHeader = incomingIpHeader;
+    flow.interface = incomingInterface;
+    flow.nextSeq = incomingTcpHeader.GetSequenceNumber() + SequenceNumber32(size);
+    flow.segmentSize = size;
+    flow.segments = 1;
+    m_groFlows.emplace(key, flow);
+    if (!m_groFlushEvent.IsRunning())
+    {
+        m_groFlushEvent = Simulator::Schedule(m_groTimeout, &TcpL4Protocol::GroFlushAll, this);
+    }
+    return IpL4Protocol::RX_OK;
+}
+
+void
+TcpL4Protocol::GroFlush(std::map<GroKey, GroFlow>::iterator it)
+{
+    NS_LOG_FUNCTION(this);
+
+    GroFlow flow = it->second;
+    m_groFlows.erase(it);
+
+    Ptr<Packet> packet = flow.payload;
+    if (flow.segments > 1)
+    {
+        // Like Linux, tell the socket the size of the segments making up this one
+        packet->AddPacketTag(GsoTag(flow.segmentSize));
+    }
+    flow.ipHeader.SetPayloadSize(packet->GetSize() + flow.header.GetSerializedSize());
+    packet->AddHeader(flow.header);
+    Deliver(packet, flow.header, flow.ipHeader, flow.interface);
+}
+
+void
+TcpL4Protocol::GroFlushAll()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Delivering may reenter GroReceive, hence the flows are flushed in order of
+    // their keys until none is left
+    while (!m_groFlows.empty())
+    {
+        GroFlush(m_groFlows.begin());
+    }
+}
+
 IpL4Protocol::RxStatus
 TcpL4Protocol::Receive(Ptr<Packet> packet,
                        const Ipv6Header& incomingIpHeader,
@@ -693,6 +930,62 @@ TcpL4Protocol::SendPacketV6(Ptr<Packet> packet,
     }
 }
 
+std::vector<Ptr<Packet>>
+TcpL4Protocol::GsoSegment(Ptr<const Packet> packet,
+                          uint32_t segmentSize,
+                          const Address& saddr,
+                          const Address& daddr)
+{
+    NS_ASSERT(segmentSize > 0);
+
+    Ptr<Packet> payload = packet->Copy();
+    TcpHeader header;
+    payload->RemoveHeader(header);
+    GsoTag gsoTag;
+    payload->RemovePacketTag(gsoTag);
+
+    std::vector<Ptr<Packet>> segments;
+    uint32_t size = payload->GetSize();
+    segments.reserve((size + segmentSize - 1) / segmentSize);
+    for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+        uint32_t length = std::min(segmentSize, size - offset);
+        Ptr<Packet> segment = payload->CreateFragment(offset, length);
+
+        TcpHeader segmentHeader = header;
+        segmentHeader.SetSequenceNumber(header.GetSequenceNumber() + SequenceNumber32(offset));
+        uint8_t flags = header.GetFlags();
+        if (offset > 0)
+        {
+            flags &= ~TcpHeader::CWR;
+        }
+        if (offset + length < size)
+        {
+            flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+        segmentHeader.SetFlags(flags);
+        if (Node::ChecksumEnabled())
+        {
+            segmentHeader.EnableChecksums();
+        }
+        segmentHeader.InitializeChecksum(saddr, daddr, PROT_NUMBER);
+        segment->AddHeader(segmentHeader);
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
+uint32_t
+TcpL4Protocol::GetGsoSegmentCount(Ptr<const Packet> packet, uint32_t segmentSize)
+{
+    NS_ASSERT(segmentSize > 0);
+
+    TcpHeader header;
+    packet->PeekHeader(header);
+    uint32_t size = packet->GetSize() - header.GetSerializedSize();
+    return std::max<uint32_t>((size + segmentSize - 1) / segmentSize, 1);
+}
+
 void
 TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
                           const TcpHeader& outgoing,
@@ -752,14 +1045,10 @@ TcpL4Protocol::AddSocket(Ptr<TcpSocketBase> socket)
 {
     NS_LOG_FUNCTION(this << socket);
 
-    for (auto& socketItem : m_sockets)
+    if (m_socketIds.emplace(PeekPointer(socket), m_socketIndex).second)
     {
-        if (socketItem.second == socket)
-        {
-            return;
-        }
+        m_sockets[m_socketIndex++] = socket;
     }
-    m_sockets[m_socketIndex++] = socket;
 }
 
 bool
@@ -767,17 +1056,15 @@ TcpL4Protocol::RemoveSocket(Ptr<TcpSocketBase> socket)
 {
     NS_LOG_FUNCTION(this << socket);
 
-    for (auto& socketItem : m_sockets)
+    auto it = m_socketIds.find(PeekPointer(socket));
+    if (it == m_socketIds.end())
     {
-        if (socketItem.second == socket)
-        {
-            socketItem.second = nullptr;
-            m_sockets.erase(socketItem.first);
-            return true;
-        }
+        return false;
     }
-
-    return false;
+    uint64_t id = it->second;
+    m_socketIds.erase(it);
+    m_sockets.erase(id);
+    return true;
 }
 
 void
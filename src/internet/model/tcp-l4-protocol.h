@@ -21,24 +21,30 @@
 #define TCP_L4_PROTOCOL_H
 
 #include "ip-l4-protocol.h"
+#include "tcp-header.h"
 
+#include "ns3/event-id.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
 #include "ns3/sequence-number.h"
 
+#include <map>
 #include <stdint.h>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
 
 class Node;
 class Socket;
-class TcpHeader;
 class Ipv4EndPointDemux;
 class Ipv6EndPointDemux;
 class Ipv4Interface;
 class TcpSocketBase;
+class TcpPacingWheel;
 class Ipv4EndPoint;
 class Ipv6EndPoint;
 class NetDevice;
@@ -133,6 +139,17 @@ class TcpL4Protocol : public IpL4Protocol
      */
     Ptr<Socket> CreateSocket(TypeId congestionTypeId);
 
+    /**
+     * \brief Get the pacing wheel shared by the sockets of this node
+     *
+     * The wheel is created on first use, with the granularity set by the
+     * PacingGranularity attribute.
+     *
+     * \return the pacing wheel, or nullptr if PacingGranularity is zero, i.e.,
+     * if each socket paces its segments with its own timer
+     */
+    Ptr<TcpPacingWheel> GetPacingWheel();
+
     /**
      * \brief Allocate an IPv4 Endpoint
      * \return the Endpoint
@@ -229,6 +246,33 @@ class TcpL4Protocol : public IpL4Protocol
                     const Address& daddr,
                     Ptr<NetDevice> oif = nullptr) const;
 
+    /**
+     * \brief Split a packet built by generic segmentation offload into
+     * wire-sized segments
+     *
+     * Each segment gets a copy of the TCP header of the packet, with the
+     * sequence number advanced to the first byte of the segment. CWR is only
+     * kept on the first segment, and FIN and PSH on the last one.
+     *
+     * \param packet the packet, starting with its TCP header
+     * \param segmentSize the maximum payload size of the segments
+     * \param saddr The source address, for the checksum
+     * \param daddr The destination address, for the checksum
+     * \return the segments, starting with their TCP header
+     */
+    static std::vector<Ptr<Packet>> GsoSegment(Ptr<const Packet> packet,
+                                               uint32_t segmentSize,
+                                               const Address& saddr,
+                                               const Address& daddr);
+
+    /**
+     * \brief Get the number of segments GsoSegment() splits a packet into
+     * \param packet the packet, starting with its TCP header
+     * \param segmentSize the maximum payload size of the segments
+     * \return the number of segments
+     */
+    static uint32_t GetGsoSegmentCount(Ptr<const Packet> packet, uint32_t segmentSize);
+
     /**
      * \brief Make a socket fully operational
      *
@@ -342,11 +386,96 @@ class TcpL4Protocol : public IpL4Protocol
     TypeId m_congestionTypeId;       //!< The socket TypeId
     TypeId m_recoveryTypeId;         //!< The recovery TypeId
     std::unordered_map<uint64_t, Ptr<TcpSocketBase>>
-        m_sockets;             //!< Unordered map of socket IDs and corresponding sockets
+        m_sockets; //!< Unordered map of socket IDs and corresponding sockets
+    std::unordered_map<const TcpSocketBase*, uint64_t>
+        m_socketIds;           //!< IDs of the sockets in m_sockets
     uint64_t m_socketIndex{0}; //!< index of the next socket to be created
     IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
     IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
 
+    /// Flow of a segment, as source and destination addresses and ports
+    using GroKey = std::tuple<uint32_t, uint32_t, uint16_t, uint16_t>;
+
+    /// In-order segments of a flow being coalesced by generic receive offload
+    struct GroFlow
+    {
+        Ptr<Packet> payload;          //!< Coalesced payload
+        TcpHeader header;             //!< TCP header of the first segment
+        Ipv4Header ipHeader;          //!< IP header of the first segment
+        Ptr<Ipv4Interface> interface; //!< Incoming interface
+        SequenceNumber32 nextSeq;     //!< Sequence number of the next segment to coalesce
+        uint32_t segmentSize;         //!< Payload size of the first segment
+        uint32_t segments;            //!< Number of coalesced segments
+    };
+
+    std::map<GroKey, GroFlow> m_groFlows; //!< Flows being coalesced
+    EventId m_groFlushEvent;              //!< Delivery of the coalesced flows
+    Time m_groTimeout;                    //!< Maximum time a segment is held by GRO
+    uint32_t m_groMaxSize;                //!< Maximum payload size of a coalesced segment
+
+    Time m_pacingGranularity;          //!< Granularity of the pacing wheel
+    Ptr<TcpPacingWheel> m_pacingWheel; //!< Pacing wheel shared by the sockets
+
+    bool m_socketTemplates; //!< Whether new sockets are copies of a template socket
+    /// Template sockets, by RTT estimator, congestion control and recovery TypeIds
+    std::map<std::tuple<TypeId, TypeId, TypeId>, Ptr<TcpSocketBase>> m_templates;
+
+    /**
+     * \brief Construct a socket from the default values of its attributes
+     *
+     * \param congestionTypeId the congestion control algorithm TypeId
+     * \param recoveryTypeId the recovery algorithm TypeId
+     * \return the new socket
+     */
+    Ptr<TcpSocketBase> ConstructSocket(TypeId congestionTypeId, TypeId recoveryTypeId);
+
+    /**
+     * \brief Deliver a segment received over IPv4 to its end point
+     *
+     * \param packet the segment, with its TCP header
+     * \param incomingTcpHeader the TCP header of the segment
+     * \param incomingIpHeader the IPv4 header of the segment
+     * \param incomingInterface the interface the segment was received on
+     * \return RX_ENDPOINT_CLOSED if no end point matches the segment, RX_OK otherwise
+     */
+    IpL4Protocol::RxStatus Deliver(Ptr<Packet> packet,
+                                   const TcpHeader& incomingTcpHeader,
+                                   const Ipv4Header& incomingIpHeader,
+                                   Ptr<Ipv4Interface> incomingInterface);
+
+    /**
+     * \brief Coalesce a segment received over IPv4 with the segments of its flow
+     *
+     * Modelled after the Linux tcp_gro_receive: a data segment which directly
+     * follows the segments held for its flow, with the same acknowledgment,
+     * window, options and IP TOS, and not larger than the first one, is
+     * appended to them. The coalesced segment is delivered, carrying a GsoTag
+     * with the size of the first segment, when a segment cannot be coalesced,
+     * when a short or PSH segment ends the batch, when GroMaxSize bytes are held,
+     * or GroTimeout after the oldest segment held by GRO was received.
+     *
+     * \param packet the segment, with its TCP header
+     * \param incomingTcpHeader the TCP header of the segment
+     * \param incomingIpHeader the IPv4 header of the segment
+     * \param incomingInterface the interface the segment was received on
+     * \return RX_OK if the segment is held, the delivery status otherwise
+     */
+    IpL4Protocol::RxStatus GroReceive(Ptr<Packet> packet,
+                                      const TcpHeader& incomingTcpHeader,
+                                      const Ipv4Header& incomingIpHeader,
+                                      Ptr<Ipv4Interface> incomingInterface);
+
+    /**
+     * \brief Deliver the segments coalesced for a flow
+     * \param it the flow
+     */
+    void GroFlush(std::map<GroKey, GroFlow>::iterator it);
+
+    /**
+     * \brief Deliver the segments coalesced for all the flows
+     */
+    void GroFlushAll();
+
     /**
      * \brief Send a packet via TCP (IPv4)
      *
@@ -0,0 +1,165 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-lia.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpLia");
+
+void
+TcpLiaCoupling::Add(Ptr<const TcpSocketState> tcb)
+{
+    if (std::find(m_subflows.begin(), m_subflows.end(), tcb) == m_subflows.end())
+    {
+        m_subflows.push_back(tcb);
+    }
+}
+
+void
+TcpLiaCoupling::Remove(Ptr<const TcpSocketState> tcb)
+{
+    m_subflows.erase(std::remove(m_subflows.begin(), m_subflows.end(), tcb), m_subflows.end());
+}
+
+const std::vector<Ptr<const TcpSocketState>>&
+TcpLiaCoupling::GetSubflows() const
+{
+    return m_subflows;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpLia);
+
+TypeId
+TcpLia::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpLia")
+                            .SetParent<TcpNewReno>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpLia>();
+    return tid;
+}
+
+TcpLia::TcpLia()
+    : TcpNewReno()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpLia::TcpLia(const TcpLia& sock)
+    : TcpNewReno(sock)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpLia::~TcpLia()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_coupling && m_tcb)
+    {
+        m_coupling->Remove(m_tcb);
+    }
+}
+
+std::string
+TcpLia::GetName() const
+{
+    return "TcpLia";
+}
+
+void
+TcpLia::Init(Ptr<TcpSocketState> tcb)
+{
+    NS_LOG_FUNCTION(this << tcb);
+    if (m_coupling && m_tcb)
+    {
+        m_coupling->Remove(m_tcb);
+    }
+    m_tcb = tcb;
+    if (m_coupling)
+    {
+        m_coupling->Add(m_tcb);
+    }
+}
+
+Ptr<TcpCongestionOps>
+TcpLia::Fork()
+{
+    return CopyObject<TcpLia>(this);
+}
+
+void
+TcpLia::SetCoupling(Ptr<TcpLiaCoupling> coupling)
+{
+    NS_LOG_FUNCTION(this << coupling);
+    if (m_coupling && m_tcb)
+    {
+        m_coupling->Remove(m_tcb);
+    }
+    m_coupling = coupling;
+    if (m_coupling && m_tcb)
+    {
+        m_coupling->Add(m_tcb);
+    }
+}
+
+void
+TcpLia::CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+    NS_LOG_FUNCTION(this << tcb << segmentsAcked);
+
+    if (segmentsAcked == 0)
+    {
+        return;
+    }
+
+    double total = 0;
+    double maxWeight = 0;
+    double sumRate = 0;
+    if (m_coupling)
+    {
+        for (const auto& subflow : m_coupling->GetSubflows())
+        {
+            double cwnd = subflow->m_cWnd;
+            total += cwnd;
+            double rtt = subflow->m_lastRtt.Get().GetSeconds();
+            if (rtt > 0)
+            {
+                maxWeight = std::max(maxWeight, cwnd / (rtt * rtt));
+                sumRate += cwnd / rtt;
+            }
+        }
+    }
+
+    double segmentSize = tcb->m_segmentSize;
+    double adder = segmentSize * segmentSize / tcb->m_cWnd.Get();
+    if (sumRate > 0 && tcb->m_lastRtt.Get().IsStrictlyPositive())
+    {
+        double alpha = total * maxWeight / (sumRate * sumRate);
+        adder = std::min(alpha * segmentSize * segmentSize / total, adder);
+        NS_LOG_INFO("Coupled increase: alpha " << alpha << " total cwnd " << total);
+    }
+    adder = std::max(1.0, adder);
+    tcb->m_cWnd += static_cast<uint32_t>(adder);
+    NS_LOG_INFO("In CongAvoid, updated to cwnd " << tcb->m_cWnd << " ssthresh "
+                                                 << tcb->m_ssThresh);
+}
+
+} // namespace ns3
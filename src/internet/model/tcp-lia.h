@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_LIA_H
+#define TCP_LIA_H
+
+#include "tcp-congestion-ops.h"
+
+#include "ns3/simple-ref-count.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief The congestion states of the subflows coupled by TcpLia
+ */
+class TcpLiaCoupling : public SimpleRefCount<TcpLiaCoupling>
+{
+  public:
+    /**
+     * \brief Add the congestion state of a subflow
+     * \param tcb the congestion state
+     */
+    void Add(Ptr<const TcpSocketState> tcb);
+
+    /**
+     * \brief Remove the congestion state of a subflow
+     * \param tcb the congestion state
+     */
+    void Remove(Ptr<const TcpSocketState> tcb);
+
+    /**
+     * \brief Get the congestion states of the subflows
+     * \return the congestion states
+     */
+    const std::vector<Ptr<const TcpSocketState>>& GetSubflows() const;
+
+  private:
+    std::vector<Ptr<const TcpSocketState>> m_subflows; //!< Congestion states of the subflows
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Linked Increases Algorithm (RFC 6356)
+ *
+ * The coupled congestion control of multipath TCP: the subflows of a
+ * connection, sharing a TcpLiaCoupling, grow their congestion windows in
+ * congestion avoidance by
+ *
+ * \f$ \min(\frac{\alpha \cdot MSS_i^2}{cwnd_{total}}, \frac{MSS_i^2}{cwnd_i}) \f$
+ *
+ * per ACK, with
+ *
+ * \f$ \alpha = cwnd_{total} \frac{\max_i(cwnd_i / rtt_i^2)}{(\sum_i cwnd_i / rtt_i)^2} \f$
+ *
+ * so that the connection takes no more capacity than a single TCP flow on
+ * the best of its paths, and moves its traffic away from the congested
+ * paths. Slow start and the reaction to losses are those of TcpNewReno. A
+ * subflow without coupling (or whose RTT is not measured yet) behaves as
+ * TcpNewReno.
+ */
+class TcpLia : public TcpNewReno
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpLia();
+
+    /**
+     * \brief Copy constructor.
+     *
+     * The copy is not coupled with the subflows of the original.
+     *
+     * \param sock object to copy.
+     */
+    TcpLia(const TcpLia& sock);
+
+    ~TcpLia() override;
+
+    std::string GetName() const override;
+    void Init(Ptr<TcpSocketState> tcb) override;
+    Ptr<TcpCongestionOps> Fork() override;
+
+    /**
+     * \brief Couple the congestion window with the subflows of a connection
+     * \param coupling the congestion states of the subflows
+     */
+    void SetCoupling(Ptr<TcpLiaCoupling> coupling);
+
+  protected:
+    void CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked) override;
+
+  private:
+    Ptr<TcpLiaCoupling> m_coupling; //!< Congestion states of the coupled subflows
+    Ptr<TcpSocketState> m_tcb;      //!< Congestion state of this subflow
+};
+
+} // namespace ns3
+
+#endif /* TCP_LIA_H */
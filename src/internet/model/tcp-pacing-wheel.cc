@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-pacing-wheel.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpPacingWheel");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpPacingWheel);
+
+TypeId
+TcpPacingWheel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpPacingWheel")
+                            .SetParent<Object>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpPacingWheel>()
+                            .AddAttribute("Granularity",
+                                          "Duration of a tick of the wheel",
+                                          TimeValue(MicroSeconds(10)),
+                                          MakeTimeAccessor(&TcpPacingWheel::SetGranularity,
+                                                           &TcpPacingWheel::GetGranularity),
+                                          MakeTimeChecker(TimeStep(1)));
+    return tid;
+}
+
+TcpPacingWheel::TcpPacingWheel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpPacingWheel::~TcpPacingWheel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TcpPacingWheel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_event.Cancel();
+    m_ticks.clear();
+    m_nPending = 0;
+    Object::DoDispose();
+}
+
+void
+TcpPacingWheel::SetGranularity(Time granularity)
+{
+    NS_LOG_FUNCTION(this << granularity);
+    NS_ABORT_MSG_IF(!granularity.IsStrictlyPositive(), "The granularity must be positive");
+    NS_ABORT_MSG_IF(m_nPending > 0, "Cannot change the granularity with pending departures");
+    m_granularity = granularity;
+}
+
+Time
+TcpPacingWheel::GetGranularity() const
+{
+    return m_granularity;
+}
+
+uint32_t
+TcpPacingWheel::GetNPending() const
+{
+    return m_nPending;
+}
+
+void
+TcpPacingWheel::Schedule(Time departure, const Callback<void>& release)
+{
+    NS_LOG_FUNCTION(this << departure);
+    int64_t g = m_granularity.GetTimeStep();
+    // Round up to a tick, and never schedule a departure in the past
+    int64_t tick = (std::max(departure, Simulator::Now()).GetTimeStep() + g - 1) / g;
+    m_ticks[tick].push_back(release);
+    m_nPending++;
+    if (m_event.IsRunning() && tick < m_eventTick)
+    {
+        m_event.Cancel();
+    }
+    ScheduleNextTick();
+}
+
+void
+TcpPacingWheel::ScheduleNextTick()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_event.IsRunning() || m_ticks.empty())
+    {
+        return;
+    }
+    m_eventTick = m_ticks.begin()->first;
+    Time at = TimeStep(m_eventTick * m_granularity.GetTimeStep());
+    m_event = Simulator::Schedule(at - Simulator::Now(), &TcpPacingWheel::Release, this);
+}
+
+void
+TcpPacingWheel::Release()
+{
+    NS_LOG_FUNCTION(this);
+    auto it = m_ticks.begin();
+    NS_ASSERT(it != m_ticks.end() && it->first == m_eventTick);
+    // The callbacks may schedule new departures, possibly at this same tick:
+    // detach the bucket before invoking them
+    std::vector<Callback<void>> due = std::move(it->second);
+    m_ticks.erase(it);
+    m_nPending -= due.size();
+    NS_LOG_LOGIC("Releasing " << due.size() << " departures");
+    for (const auto& release : due)
+    {
+        release();
+    }
+    ScheduleNextTick();
+}
+
+} // namespace ns3
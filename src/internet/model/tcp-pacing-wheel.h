@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_PACING_WHEEL_H
+#define TCP_PACING_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Per-node scheduler of the departures of paced TCP sockets
+ *
+ * Without a pacing wheel, every paced socket owns a timer and schedules one
+ * simulator event per paced segment. A node with many paced flows then
+ * spends most of its time scheduling and cancelling events.
+ *
+ * The pacing wheel instead keeps the next departure time of every paced
+ * socket of a node, rounded up to a multiple of the granularity (a "tick"),
+ * much like the time-ordered flow list of the Linux fq qdisc. A single
+ * simulator event, at the earliest tick with pending departures, releases
+ * all the sockets due at that tick at once.
+ *
+ * A departure is never released before the requested time, and is released
+ * at most one granularity later.
+ */
+class TcpPacingWheel : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpPacingWheel();
+    ~TcpPacingWheel() override;
+
+    /**
+     * \brief Set the granularity of the wheel
+     * \param granularity the duration of a tick (must be strictly positive)
+     */
+    void SetGranularity(Time granularity);
+
+    /**
+     * \brief Get the granularity of the wheel
+     * \return the duration of a tick
+     */
+    Time GetGranularity() const;
+
+    /**
+     * \brief Schedule a departure
+     *
+     * A departure time in the past is released at the next tick.
+     *
+     * \param departure the earliest time of the departure
+     * \param release the callback invoked at the tick of the departure
+     */
+    void Schedule(Time departure, const Callback<void>& release);
+
+    /**
+     * \brief Get the number of departures not released yet
+     * \return the number of pending departures
+     */
+    uint32_t GetNPending() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Release all the departures of the earliest tick
+     */
+    void Release();
+
+    /**
+     * \brief Schedule the event of the earliest tick, if not already done
+     */
+    void ScheduleNextTick();
+
+    Time m_granularity; //!< Duration of a tick
+    std::map<int64_t, std::vector<Callback<void>>> m_ticks; //!< Pending departures by tick
+    uint32_t m_nPending{0};                                  //!< Number of pending departures
+    EventId m_event;                                         //!< Event of the earliest tick
+    int64_t m_eventTick{0};                                  //!< Tick of m_event
+};
+
+} // namespace ns3
+
+#endif /* TCP_PACING_WHEEL_H */
@@ -0,0 +1,201 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-rack-tlp.h"
+
+#include "tcp-tx-buffer.h"
+#include "tcp-tx-item.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpRackTlp");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpRackTlp);
+
+TypeId
+TcpRackTlp::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpRackTlp")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<TcpRackTlp>()
+            .AddAttribute("TailLossProbe",
+                          "Send a probe segment when no ACK arrives within the probe timeout",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&TcpRackTlp::m_tlpEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("MaxAckDelay",
+                          "Worst case delayed ACK timer of the receiver, added to the probe "
+                          "timeout when a single segment is in flight",
+                          TimeValue(MilliSeconds(200)),
+                          MakeTimeAccessor(&TcpRackTlp::m_maxAckDelay),
+                          MakeTimeChecker(Seconds(0)));
+    return tid;
+}
+
+TcpRackTlp::TcpRackTlp()
+    : Object()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpRackTlp::TcpRackTlp(const TcpRackTlp& other)
+    : Object(other),
+      m_tlpEnabled(other.m_tlpEnabled),
+      m_maxAckDelay(other.m_maxAckDelay)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpRackTlp::~TcpRackTlp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<TcpRackTlp>
+TcpRackTlp::Fork() const
+{
+    return CopyObject<TcpRackTlp>(this);
+}
+
+void
+TcpRackTlp::UpdateDelivered(const TcpTxItem* item, const Time& minRtt)
+{
+    NS_LOG_FUNCTION(this << item << minRtt);
+
+    Time rtt = Simulator::Now() - item->GetLastSent();
+    SequenceNumber32 endSeq = item->GetStartSeq() + item->GetSeqSize();
+    if (item->IsRetrans() && rtt < minRtt)
+    {
+        // Too early to be the ACK of the retransmission: it is ambiguous
+        return;
+    }
+
+    if (m_xmitTs == Time::Min() || endSeq > m_fack)
+    {
+        m_fack = endSeq;
+    }
+    else if (endSeq < m_fack && !item->IsRetrans())
+    {
+        NS_LOG_DEBUG("Reordering seen: " << endSeq << " delivered below " << m_fack);
+        m_reorderingSeen = true;
+    }
+
+    if (m_xmitTs == Time::Min() || item->GetLastSent() > m_xmitTs ||
+        (item->GetLastSent() == m_xmitTs && endSeq > m_endSeq))
+    {
+        m_xmitTs = item->GetLastSent();
+        m_endSeq = endSeq;
+        m_rtt = rtt;
+    }
+}
+
+Time
+TcpRackTlp::GetReorderWindow(const Time& minRtt,
+                             const Time& srtt,
+                             bool inRecovery,
+                             uint32_t sackedSegments,
+                             uint32_t dupThresh) const
+{
+    if (!m_reorderingSeen && (inRecovery || sackedSegments >= dupThresh))
+    {
+        return Time(0);
+    }
+    if (minRtt == Time::Max())
+    {
+        return Time(0);
+    }
+    Time reoWnd = minRtt / 4;
+    return srtt.IsStrictlyPositive() ? Min(reoWnd, srtt) : reoWnd;
+}
+
+Time
+TcpRackTlp::DetectLoss(Ptr<TcpTxBuffer> txBuffer, const Time& reoWnd) const
+{
+    NS_LOG_FUNCTION(this << reoWnd);
+
+    if (m_xmitTs == Time::Min())
+    {
+        return Time(0);
+    }
+    return txBuffer->MarkLostSentBefore(m_xmitTs, m_endSeq, m_rtt + reoWnd);
+}
+
+bool
+TcpRackTlp::IsTlpEnabled() const
+{
+    return m_tlpEnabled;
+}
+
+Time
+TcpRackTlp::GetProbeTimeout(const Time& srtt, uint32_t bytesInFlight, uint32_t segmentSize) const
+{
+    if (!srtt.IsStrictlyPositive())
+    {
+        return Seconds(1);
+    }
+    Time pto = srtt * 2;
+    if (bytesInFlight <= segmentSize)
+    {
+        // The ACK of a single segment may be delayed by the receiver
+        pto += m_maxAckDelay;
+    }
+    return pto;
+}
+
+void
+TcpRackTlp::ProbeSent(const SequenceNumber32& endSeq, bool isRetransmission)
+{
+    NS_LOG_FUNCTION(this << endSeq << isRetransmission);
+    m_probeOutstanding = true;
+    m_probeEndSeq = endSeq;
+    m_probeRetrans = isRetransmission;
+}
+
+bool
+TcpRackTlp::IsProbeOutstanding() const
+{
+    return m_probeOutstanding;
+}
+
+bool
+TcpRackTlp::ProbeAcked(const SequenceNumber32& ack)
+{
+    NS_LOG_FUNCTION(this << ack);
+
+    if (!m_probeOutstanding || ack < m_probeEndSeq)
+    {
+        return false;
+    }
+    m_probeOutstanding = false;
+    // Without DSACK, the ACK of a retransmitted probe cannot tell whether the
+    // original segment was delivered: assume the probe repaired its loss
+    return m_probeRetrans;
+}
+
+void
+TcpRackTlp::ResetProbe()
+{
+    NS_LOG_FUNCTION(this);
+    m_probeOutstanding = false;
+}
+
+} // namespace ns3
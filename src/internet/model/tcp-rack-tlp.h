@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_RACK_TLP_H
+#define TCP_RACK_TLP_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3
+{
+
+class TcpTxBuffer;
+class TcpTxItem;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief RACK-TLP loss detection (RFC 8985)
+ *
+ * The loss detection of TcpSocketBase counts the segments SACKed above a
+ * hole: a segment is lost once DupThresh segments above it are SACKed
+ * (RFC 6675). A tail loss leaves too few segments behind the hole, and
+ * ends with a retransmission timeout.
+ *
+ * RACK (Recent ACKnowledgment) detects the losses in time instead: the
+ * transmission time of every segment is kept in its TcpTxItem, and a
+ * segment is lost when a segment sent after it has been delivered, and
+ * more than the RTT of that delivery plus a reordering window have elapsed
+ * since its own transmission. The reordering window is a quarter of the
+ * minimum RTT; until some reordering is observed, it is zero in loss
+ * recovery and once DupThresh segments are SACKed. A timer marks the
+ * segments that are not overdue yet when the window expires.
+ *
+ * TLP (Tail Loss Probe) sends a probe segment, new data or the last
+ * segment sent, when no ACK arrives within two smoothed RTTs. The ACK of
+ * the probe carries the SACK information that RACK needs to repair the
+ * tail without waiting for the retransmission timeout.
+ *
+ * This class keeps the RACK and TLP state of a connection, and computes
+ * the timers; TcpSocketBase owns the timers and drives the recovery. The
+ * receivers in ns-3 do not send DSACKs, so the reordering window is not
+ * adapted to spurious retransmissions, and a probe retransmitting the last
+ * segment is always assumed to have repaired a loss.
+ *
+ * \see TcpSocketBase
+ */
+class TcpRackTlp : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpRackTlp();
+
+    /**
+     * \brief Copy constructor.
+     * \param other object to copy.
+     */
+    TcpRackTlp(const TcpRackTlp& other);
+
+    ~TcpRackTlp() override;
+
+    /**
+     * \brief Copy the configuration of this object, without the connection state
+     * \return a new object
+     */
+    Ptr<TcpRackTlp> Fork() const;
+
+    /**
+     * \brief Account for a segment newly delivered (cumulatively ACKed or SACKed)
+     *
+     * Remember the most recently sent segment delivered (RFC 8985, Step 2),
+     * and whether the network reorders segments (Step 3).
+     *
+     * \param item the delivered segment
+     * \param minRtt the minimum RTT of the connection
+     */
+    void UpdateDelivered(const TcpTxItem* item, const Time& minRtt);
+
+    /**
+     * \brief Get the reordering window (RFC 8985, Step 4)
+     *
+     * \param minRtt the minimum RTT of the connection
+     * \param srtt the smoothed RTT of the connection
+     * \param inRecovery whether the connection is in loss recovery
+     * \param sackedSegments the number of segments SACKed
+     * \param dupThresh the DupThresh of the connection
+     * \return the reordering window
+     */
+    Time GetReorderWindow(const Time& minRtt,
+                          const Time& srtt,
+                          bool inRecovery,
+                          uint32_t sackedSegments,
+                          uint32_t dupThresh) const;
+
+    /**
+     * \brief Mark the lost segments of a transmission buffer (RFC 8985, Step 5)
+     *
+     * \param txBuffer the transmission buffer
+     * \param reoWnd the reordering window
+     * \return the delay of the reordering timer, or zero if it is not needed
+     */
+    Time DetectLoss(Ptr<TcpTxBuffer> txBuffer, const Time& reoWnd) const;
+
+    /**
+     * \brief Check if tail loss probes are enabled
+     * \return true if TLP is enabled
+     */
+    bool IsTlpEnabled() const;
+
+    /**
+     * \brief Get the probe timeout (RFC 8985, Section 7.2)
+     *
+     * \param srtt the smoothed RTT of the connection (zero if not measured yet)
+     * \param bytesInFlight the bytes in flight
+     * \param segmentSize the segment size
+     * \return the probe timeout
+     */
+    Time GetProbeTimeout(const Time& srtt, uint32_t bytesInFlight, uint32_t segmentSize) const;
+
+    /**
+     * \brief Record the transmission of a probe
+     * \param endSeq the highest sequence sent, probe included
+     * \param isRetransmission whether the probe retransmitted the last segment
+     */
+    void ProbeSent(const SequenceNumber32& endSeq, bool isRetransmission);
+
+    /**
+     * \brief Check if a probe has been sent and not acknowledged yet
+     * \return true if a probe is outstanding
+     */
+    bool IsProbeOutstanding() const;
+
+    /**
+     * \brief Process a cumulative ACK for the outstanding probe (RFC 8985, Section 7.4)
+     *
+     * \param ack the cumulative ACK
+     * \return true if the probe repaired a loss, which the congestion
+     * control must react to
+     */
+    bool ProbeAcked(const SequenceNumber32& ack);
+
+    /**
+     * \brief Forget the outstanding probe, e.g., after a retransmission timeout
+     */
+    void ResetProbe();
+
+  private:
+    // RACK
+    Time m_xmitTs{Time::Min()};   //!< Transmission time of the most recent delivered segment
+    SequenceNumber32 m_endSeq{0}; //!< End sequence of the most recent delivered segment
+    Time m_rtt{0};                //!< RTT of the most recent delivered segment
+    SequenceNumber32 m_fack{0};   //!< Highest end sequence delivered
+    bool m_reorderingSeen{false}; //!< Whether reordering has been observed
+
+    // TLP
+    bool m_tlpEnabled{true};           //!< Whether tail loss probes are enabled
+    Time m_maxAckDelay;                //!< Worst case delayed ACK of the receiver
+    bool m_probeOutstanding{false};    //!< Whether a probe is outstanding
+    SequenceNumber32 m_probeEndSeq{0}; //!< Highest sequence sent with the probe
+    bool m_probeRetrans{false};        //!< Whether the probe was a retransmission
+};
+
+} // namespace ns3
+
+#endif /* TCP_RACK_TLP_H */
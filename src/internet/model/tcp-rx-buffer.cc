@@ -117,9 +117,9 @@ TcpRxBuffer::MaxRxSequence() const
     { // No data allowed beyond FIN
         return m_finSeq;
     }
-    else if (!m_data.empty() && m_nextRxSeq > m_data.begin()->first)
+    else if (!m_inOrder.empty())
     { // No data allowed beyond Rx window allowed
-        return m_data.begin()->first + SequenceNumber32(m_maxBuffer);
+        return m_inOrderSeq + SequenceNumber32(m_maxBuffer);
     }
     return m_nextRxSeq + SequenceNumber32(m_maxBuffer);
 }
@@ -159,9 +159,11 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     {
         headSeq = m_nextRxSeq;
     }
-    if (!m_data.empty())
+    if (m_size > 0)
     {
-        SequenceNumber32 maxSeq = m_data.begin()->first + SequenceNumber32(m_maxBuffer);
+        SequenceNumber32 firstSeq =
+            m_inOrder.empty() ? m_outOfOrder.begin()->first : m_inOrderSeq;
+        SequenceNumber32 maxSeq = firstSeq + SequenceNumber32(m_maxBuffer);
         if (maxSeq < tailSeq)
         {
             tailSeq = maxSeq;
@@ -171,9 +173,14 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
-    while (i != m_data.end() && i->first <= tailSeq)
+    // Remove overlapped bytes from packet. In-order data is below m_nextRxSeq,
+    // so only the out-of-order segments from the one holding headSeq can overlap
+    auto i = m_outOfOrder.upper_bound(headSeq);
+    if (i != m_outOfOrder.begin())
+    {
+        --i;
+    }
+    while (i != m_outOfOrder.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
         if (lastByteSeq > headSeq)
@@ -181,7 +188,7 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             if (i->first > headSeq && lastByteSeq < tailSeq)
             { // Rare case: Existing packet is embedded fully in the new packet
                 m_size -= i->second->GetSize();
-                m_data.erase(i++);
+                m_outOfOrder.erase(i++);
                 continue;
             }
             if (i->first <= headSeq)
@@ -205,35 +212,30 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     {
         uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
         auto length = static_cast<uint32_t>(tailSeq - headSeq);
-        p = p->CreateFragment(start, length);
+        // The buffer owns the stored packets, as Extract appends to them
+        p = (start == 0 && length == pktSize) ? p->Copy() : p->CreateFragment(start, length);
         NS_ASSERT(length == p->GetSize());
     }
-    // Insert packet into buffer
-    NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
 
-    if (headSeq > m_nextRxSeq)
+    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
+    m_size += p->GetSize(); // Occupancy
+    if (headSeq == m_nextRxSeq)
+    {
+        AppendInOrder(p);
+    }
+    else
     {
+        NS_ASSERT(m_outOfOrder.find(headSeq) == m_outOfOrder.end()); // Shouldn't be there yet
+        m_outOfOrder.emplace(headSeq, p);
         // Generate a new SACK block
         UpdateSackList(headSeq, tailSeq);
     }
 
-    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
-    // Update variables
-    m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    // Move the out-of-order segments that became contiguous to the in-order data
+    while (!m_outOfOrder.empty() && m_outOfOrder.begin()->first == m_nextRxSeq)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
-        ClearSackList(m_nextRxSeq);
+        AppendInOrder(m_outOfOrder.begin()->second);
+        m_outOfOrder.erase(m_outOfOrder.begin());
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
     if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -243,6 +245,21 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     return true;
 }
 
+void
+TcpRxBuffer::AppendInOrder(Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+
+    if (m_inOrder.empty())
+    {
+        m_inOrderSeq = m_nextRxSeq;
+    }
+    m_inOrder.push_back(p);
+    m_nextRxSeq = m_nextRxSeq + SequenceNumber32(p->GetSize());
+    m_availBytes += p->GetSize();
+    ClearSackList(m_nextRxSeq);
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize() const
 {
@@ -387,41 +404,41 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
-    NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
-    BufIterator i;
+    NS_ASSERT(!m_inOrder.empty()); // At least we have something to extract
+    Ptr<Packet> outPkt;            // The packet that contains all the data to return
     while (extractSize)
     { // Check the buffered data for delivery
-        i = m_data.begin();
-        NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
+        Ptr<Packet>& head = m_inOrder.front();
         // Check if we send the whole pkt or just a partial
-        uint32_t pktSize = i->second->GetSize();
+        uint32_t pktSize = head->GetSize();
+        Ptr<Packet> data;
         if (pktSize <= extractSize)
-        { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
-            m_data.erase(i);
-            m_size -= pktSize;
-            m_availBytes -= pktSize;
-            extractSize -= pktSize;
+        { // Whole packet is extracted, the buffer hands it over without a copy
+            data = head;
+            m_inOrder.pop_front();
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
-            m_data.erase(i);
-            m_size -= extractSize;
-            m_availBytes -= extractSize;
-            extractSize = 0;
+            data = head->CreateFragment(0, extractSize);
+            head->RemoveAtStart(extractSize);
         }
-    }
-    if (outPkt->GetSize() == 0)
-    {
-        NS_LOG_LOGIC("Nothing extracted.");
-        return nullptr;
+        uint32_t dataSize = data->GetSize();
+        if (outPkt)
+        {
+            outPkt->AddAtEnd(data);
+        }
+        else
+        {
+            outPkt = data;
+        }
+        m_inOrderSeq = m_inOrderSeq + SequenceNumber32(dataSize);
+        m_size -= dataSize;
+        m_availBytes -= dataSize;
+        extractSize -= dataSize;
     }
     NS_LOG_LOGIC("Extracted " << outPkt->GetSize() << " bytes, bufsize=" << m_size
-                              << ", num pkts in buffer=" << m_data.size());
+                              << ", num pkts in buffer="
+                              << m_inOrder.size() + m_outOfOrder.size());
     return outPkt;
 }
 
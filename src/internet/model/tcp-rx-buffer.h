@@ -24,6 +24,7 @@
 #include "tcp-option-sack.h"
 
 #include "ns3/ptr.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/sequence-number.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
@@ -55,6 +56,15 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * In-order data, waiting to be read, is kept in a ring of packets: a segment
+ * received in order is appended to it without allocating any memory once the
+ * ring has grown, and Extract hands the buffered packets to the application
+ * without copying them when it reads whole segments. Out-of-order segments
+ * are kept in a map, ordered by sequence number, whose non-overlapping entries
+ * form the set of the received intervals: trimming an incoming segment only
+ * looks at its neighbours, and the segments that become contiguous are moved
+ * to the ring.
+ *
  * SACK list
  * ---------
  *
@@ -220,10 +230,16 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
+    /**
+     * \brief Append a segment starting at the next expected sequence to the
+     * in-order data, making it available to be read
+     *
+     * \param p the segment
+     */
+    void AppendInOrder(Ptr<Packet> p);
+
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
-    /// container for data stored in the buffer
-    typedef std::map<SequenceNumber32, Ptr<Packet>>::iterator BufIterator;
     TracedValue<SequenceNumber32>
         m_nextRxSeq;           //!< Seqnum of the first missing byte in data (RCV.NXT)
     SequenceNumber32 m_finSeq; //!< Seqnum of the FIN packet
@@ -231,7 +247,9 @@ class TcpRxBuffer : public Object
     uint32_t m_size;       //!< Number of total data bytes in the buffer, not necessarily contiguous
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
-    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    RingBuffer<Ptr<Packet>> m_inOrder; //!< In-order data, not read yet
+    SequenceNumber32 m_inOrderSeq;     //!< Seqnum of the first byte in m_inOrder
+    std::map<SequenceNumber32, Ptr<Packet>> m_outOfOrder; //!< Out-of-order data, by seqnum
 };
 
 } // namespace ns3
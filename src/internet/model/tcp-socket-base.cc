@@ -26,6 +26,7 @@
 
 #include "tcp-socket-base.h"
 
+#include "gso-tag.h"
 #include "ipv4-end-point.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
@@ -42,6 +43,8 @@
 #include "tcp-option-sack.h"
 #include "tcp-option-ts.h"
 #include "tcp-option-winscale.h"
+#include "tcp-pacing-wheel.h"
+#include "tcp-rack-tlp.h"
 #include "tcp-rate-ops.h"
 #include "tcp-recovery-ops.h"
 #include "tcp-rx-buffer.h"
@@ -121,6 +124,33 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_timestampEnabled),
                           MakeBooleanChecker())
+            .AddAttribute("GsoMaxSize",
+                          "Maximum amount of new data sent to the IP layer as a single packet, "
+                          "split into segments by the traffic control layer (0 disables GSO)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpSocketBase::m_gsoMaxSize),
+                          MakeUintegerChecker<uint32_t>(0, 65000))
+            .AddAttribute("AckThinningInterval",
+                          "Minimum interval between two ACKs of in-order data: an ACK due "
+                          "earlier is delayed until the interval has elapsed, acknowledging "
+                          "all the data received meanwhile (zero disables ACK thinning)",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpSocketBase::m_ackThinningInterval),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("QueueDiscPacing",
+                          "Leave the pacing of the segments to the queue disc of the outgoing "
+                          "device (e.g., FqQueueDisc), which reads the pacing rate from the "
+                          "SocketPacingRateTag of the packets, instead of using a timer",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::m_queueDiscPacing),
+                          MakeBooleanChecker())
+            .AddAttribute("RackTlp",
+                          "Enable or disable the RACK-TLP time-based loss detection and tail "
+                          "loss probes (RFC 8985) on SACK connections",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::SetRackTlpEnabled,
+                                              &TcpSocketBase::IsRackTlpEnabled),
+                          MakeBooleanChecker())
             .AddAttribute(
                 "MinRto",
                 "Minimum retransmit timeout value",
@@ -280,48 +310,7 @@ TcpSocketBase::TcpSocketBase()
 
     m_tcb->m_sendEmptyPacketCallback = MakeCallback(&TcpSocketBase::SendEmptyPacket, this);
 
-    bool ok;
-
-    ok = m_tcb->TraceConnectWithoutContext(
-        "PacingRate",
-        MakeCallback(&TcpSocketBase::UpdatePacingRateTrace, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("CongestionWindow",
-                                           MakeCallback(&TcpSocketBase::UpdateCwnd, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("CongestionWindowInflated",
-                                           MakeCallback(&TcpSocketBase::UpdateCwndInfl, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("SlowStartThreshold",
-                                           MakeCallback(&TcpSocketBase::UpdateSsThresh, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("CongState",
-                                           MakeCallback(&TcpSocketBase::UpdateCongState, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("EcnState",
-                                           MakeCallback(&TcpSocketBase::UpdateEcnState, this));
-    NS_ASSERT(ok == true);
-
-    ok =
-        m_tcb->TraceConnectWithoutContext("NextTxSequence",
-                                          MakeCallback(&TcpSocketBase::UpdateNextTxSequence, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("HighestSequence",
-                                           MakeCallback(&TcpSocketBase::UpdateHighTxMark, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("BytesInFlight",
-                                           MakeCallback(&TcpSocketBase::UpdateBytesInFlight, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("RTT", MakeCallback(&TcpSocketBase::UpdateRtt, this));
-    NS_ASSERT(ok == true);
+    ConnectTcbTraces();
 }
 
 TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
@@ -372,6 +361,9 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
       m_pacingTimer(Timer::CANCEL_ON_DESTROY),
+      m_queueDiscPacing(sock.m_queueDiscPacing),
+      m_gsoMaxSize(sock.m_gsoMaxSize),
+      m_ackThinningInterval(sock.m_ackThinningInterval),
       m_ecnEchoSeq(sock.m_ecnEchoSeq),
       m_ecnCESeq(sock.m_ecnCESeq),
       m_ecnCWRSeq(sock.m_ecnCWRSeq)
@@ -411,53 +403,39 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
         m_recoveryOps = sock.m_recoveryOps->Fork();
     }
 
+    if (sock.m_rackTlp)
+    {
+        m_rackTlp = sock.m_rackTlp->Fork();
+    }
+
     m_rateOps = CreateObject<TcpRateLinux>();
     if (m_tcb->m_sendEmptyPacketCallback.IsNull())
     {
         m_tcb->m_sendEmptyPacketCallback = MakeCallback(&TcpSocketBase::SendEmptyPacket, this);
     }
 
-    bool ok;
+    ConnectTcbTraces();
+}
 
-    ok = m_tcb->TraceConnectWithoutContext(
-        "PacingRate",
+void
+TcpSocketBase::ConnectTcbTraces()
+{
+    // The trace sources are connected directly rather than by name, as this
+    // is done for every socket created, and every connection accepted
+    m_tcb->m_pacingRate.ConnectWithoutContext(
         MakeCallback(&TcpSocketBase::UpdatePacingRateTrace, this));
-
-    ok = m_tcb->TraceConnectWithoutContext("CongestionWindow",
-                                           MakeCallback(&TcpSocketBase::UpdateCwnd, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("CongestionWindowInflated",
-                                           MakeCallback(&TcpSocketBase::UpdateCwndInfl, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("SlowStartThreshold",
-                                           MakeCallback(&TcpSocketBase::UpdateSsThresh, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("CongState",
-                                           MakeCallback(&TcpSocketBase::UpdateCongState, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("EcnState",
-                                           MakeCallback(&TcpSocketBase::UpdateEcnState, this));
-    NS_ASSERT(ok == true);
-
-    ok =
-        m_tcb->TraceConnectWithoutContext("NextTxSequence",
-                                          MakeCallback(&TcpSocketBase::UpdateNextTxSequence, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("HighestSequence",
-                                           MakeCallback(&TcpSocketBase::UpdateHighTxMark, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("BytesInFlight",
-                                           MakeCallback(&TcpSocketBase::UpdateBytesInFlight, this));
-    NS_ASSERT(ok == true);
-
-    ok = m_tcb->TraceConnectWithoutContext("RTT", MakeCallback(&TcpSocketBase::UpdateRtt, this));
-    NS_ASSERT(ok == true);
+    m_tcb->m_cWnd.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateCwnd, this));
+    m_tcb->m_cWndInfl.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateCwndInfl, this));
+    m_tcb->m_ssThresh.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateSsThresh, this));
+    m_tcb->m_congState.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateCongState, this));
+    m_tcb->m_ecnState.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateEcnState, this));
+    m_tcb->m_nextTxSequence.ConnectWithoutContext(
+        MakeCallback(&TcpSocketBase::UpdateNextTxSequence, this));
+    m_tcb->m_highTxMark.ConnectWithoutContext(
+        MakeCallback(&TcpSocketBase::UpdateHighTxMark, this));
+    m_tcb->m_bytesInFlight.ConnectWithoutContext(
+        MakeCallback(&TcpSocketBase::UpdateBytesInFlight, this));
+    m_tcb->m_lastRtt.ConnectWithoutContext(MakeCallback(&TcpSocketBase::UpdateRtt, this));
 }
 
 TcpSocketBase::~TcpSocketBase()
@@ -1849,7 +1827,9 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
     }
 
-    m_txBuffer->DiscardUpTo(ackNumber, MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    m_txBuffer->DiscardUpTo(ackNumber,
+                            m_rackTlp ? MakeCallback(&TcpSocketBase::RackAcked, this)
+                                      : MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
 
     auto currentDelivered =
         static_cast<uint32_t>(m_rateOps->GetConnectionRate().m_delivered - previousDelivered);
@@ -1890,6 +1870,10 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
         m_tcb->m_ecnState = TcpSocketState::ECN_IDLE;
     }
 
+    // RFC 8985, Section 6.2, Step 5: mark the segments lost in time before
+    // the ACK is processed, as it may take the losses into account
+    bool rackLost = m_rackTlp && m_sackEnabled && RackDetectLoss();
+
     // Update bytes in flight before processing the ACK for proper calculation of congestion window
     NS_LOG_INFO("Update bytes in flight before processing the ACK.");
     BytesInFlight();
@@ -1899,6 +1883,19 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
     ProcessAck(ackNumber, (bytesSacked > 0), currentDelivered, oldHeadSequence);
     m_tcb->m_isRetransDataAcked = false;
 
+    if (rackLost)
+    {
+        RackEnterRecovery(currentDelivered);
+    }
+    if (m_rackTlp && m_rackTlp->ProbeAcked(ackNumber) &&
+        (m_tcb->m_congState == TcpSocketState::CA_OPEN ||
+         m_tcb->m_congState == TcpSocketState::CA_DISORDER))
+    {
+        // RFC 8985, Section 7.4: the probe repaired a loss, reduce the window
+        NS_LOG_DEBUG("Tail loss probe repaired a loss");
+        EnterCwr(currentDelivered);
+    }
+
     if (m_congestionControl->HasCongControl())
     {
         uint32_t currentLost = m_txBuffer->GetLost();
@@ -1922,6 +1919,11 @@ TcpSocketBase::ReceivedAck(Ptr<Packet> packet, const TcpHeader& tcpHeader)
     // RFC 6675, Section 5, point (C), try to send more data. NB: (C) is implemented
     // inside SendPendingData
     SendPendingData(m_connected);
+
+    if (m_rackTlp && ackNumber > oldHeadSequence)
+    {
+        ScheduleTlp();
+    }
 }
 
 void
@@ -2822,6 +2824,7 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
     { // If sending an ACK, cancel the delay ACK as well
         m_delAckEvent.Cancel();
         m_delAckCount = 0;
+        m_lastAckTime = Simulator::Now();
         if (m_highTxAck < header.GetAckNumber())
         {
             m_highTxAck = header.GetAckNumber();
@@ -3120,12 +3123,30 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_LOG_FUNCTION(this << seq << maxSize << withAck);
 
     bool isStartOfTransmission = BytesInFlight() == 0U;
-    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(maxSize, seq);
+    bool isGso = m_gsoMaxSize > 0 && maxSize > m_tcb->m_segmentSize;
+    TcpTxItem* outItem =
+        m_txBuffer->CopyFromSequence(isGso ? m_tcb->m_segmentSize : maxSize, seq);
 
     m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
     bool isRetransmission = outItem->IsRetrans();
     Ptr<Packet> p = outItem->GetPacketCopy();
+
+    // A GSO packet is recorded in the transmission buffer as one item per segment,
+    // so that SACK and loss detection keep working at the segment granularity
+    while (isGso && !isRetransmission && p->GetSize() < maxSize &&
+           p->GetSize() % m_tcb->m_segmentSize == 0)
+    {
+        TcpTxItem* item =
+            m_txBuffer->CopyFromSequence(std::min(maxSize - p->GetSize(), m_tcb->m_segmentSize),
+                                         seq + SequenceNumber32(p->GetSize()));
+        if (item == nullptr)
+        {
+            break;
+        }
+        m_rateOps->SkbSent(item, false);
+        p->AddAtEnd(item->GetPacketCopy());
+    }
     uint32_t sz = p->GetSize(); // Size of packet
     uint8_t flags = withAck ? TcpHeader::ACK : 0;
     uint32_t remainingData = m_txBuffer->SizeFromSequence(seq + SequenceNumber32(sz));
@@ -3135,15 +3156,15 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_ASSERT(isRetransmission ||
               ((m_highRxAckMark + SequenceNumber32(m_rWnd)) >= (seq + SequenceNumber32(maxSize))));
 
-    if (IsPacingEnabled())
+    if (IsPacingEnabled() && !m_queueDiscPacing)
     {
         NS_LOG_INFO("Pacing is enabled");
-        if (m_pacingTimer.IsExpired())
+        if (!IsPacingPending())
         {
             NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
             NS_LOG_DEBUG("Timer is in expired state, activate it "
                          << m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
-            m_pacingTimer.Schedule(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
+            SchedulePacing(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
         }
         else
         {
@@ -3159,6 +3180,7 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     {
         m_delAckEvent.Cancel();
         m_delAckCount = 0;
+        m_lastAckTime = Simulator::Now();
     }
 
     if (m_tcb->m_ecnState == TcpSocketState::ECN_ECE_RCVD &&
@@ -3173,6 +3195,20 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
 
     AddSocketTags(p);
 
+    if (IsPacingEnabled())
+    {
+        // Let the queue disc (e.g., FqQueueDisc) know the pacing rate of this flow
+        SocketPacingRateTag pacingRateTag;
+        pacingRateTag.SetPacingRate(m_tcb->m_pacingRate);
+        p->ReplacePacketTag(pacingRateTag);
+    }
+
+    if (isGso && sz > m_tcb->m_segmentSize)
+    {
+        // Tell the traffic control layer how to segment this GSO packet
+        p->AddPacketTag(GsoTag(m_tcb->m_segmentSize));
+    }
+
     if (m_closeOnEmpty && (remainingData == 0))
     {
         flags |= TcpHeader::FIN;
@@ -3257,6 +3293,11 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     }
     // Update highTxMark
     m_tcb->m_highTxMark = std::max(seq + sz, m_tcb->m_highTxMark.Get());
+
+    if (m_rackTlp && !isRetransmission)
+    {
+        ScheduleTlp();
+    }
     return sz;
 }
 
@@ -3310,12 +3351,12 @@ TcpSocketBase::SendPendingData(bool withAck)
     // else branch to control silly window syndrome and Nagle)
     while (availableWindow > 0)
     {
-        if (IsPacingEnabled())
+        if (IsPacingEnabled() && !m_queueDiscPacing)
         {
             NS_LOG_INFO("Pacing is enabled");
-            if (m_pacingTimer.IsRunning())
+            if (IsPacingPending())
             {
-                NS_LOG_INFO("Skipping Packet due to pacing" << m_pacingTimer.GetDelayLeft());
+                NS_LOG_INFO("Skipping Packet due to pacing");
                 break;
             }
             NS_LOG_INFO("Timer is not running");
@@ -3373,6 +3414,17 @@ TcpSocketBase::SendPendingData(bool withAck)
             auto maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // With GSO, new data is handed to the IP layer as a single packet made of
+            // several full segments, which is split by the traffic control layer
+            if (s == m_tcb->m_segmentSize && next == m_tcb->m_highTxMark && GetGsoSize() > s)
+            {
+                uint32_t unAcked = UnAckDataCount();
+                uint32_t rWndLeft = m_rWnd.Get() > unAcked ? m_rWnd.Get() - unAcked : 0;
+                uint32_t gsoSize =
+                    std::min({GetGsoSize(), availableWindow, availableData, rWndLeft});
+                s = std::max(s, gsoSize - gsoSize % m_tcb->m_segmentSize);
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3401,15 +3453,15 @@ TcpSocketBase::SendPendingData(bool withAck)
                                   << " sent seq " << m_tcb->m_nextTxSequence << " size " << sz);
             m_tcb->m_nextTxSequence += sz;
             ++nPacketsSent;
-            if (IsPacingEnabled())
+            if (IsPacingEnabled() && !m_queueDiscPacing)
             {
                 NS_LOG_INFO("Pacing is enabled");
-                if (m_pacingTimer.IsExpired())
+                if (!IsPacingPending())
                 {
                     NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
                     NS_LOG_DEBUG("Timer is in expired state, activate it "
                                  << m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
-                    m_pacingTimer.Schedule(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
+                    SchedulePacing(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
                     break;
                 }
             }
@@ -3526,6 +3578,14 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     NS_LOG_DEBUG("Data segment, seq=" << tcpHeader.GetSequenceNumber()
                                       << " pkt size=" << p->GetSize());
 
+    // A segment coalesced by GRO counts as the segments it is made of
+    uint32_t segments = 1;
+    GsoTag gsoTag;
+    if (p->RemovePacketTag(gsoTag))
+    {
+        segments = (p->GetSize() + gsoTag.GetSegmentSize() - 1) / gsoTag.GetSegmentSize();
+    }
+
     // Put into Rx buffer
     SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence();
     if (!m_tcb->m_rxBuffer->Add(p, tcpHeader))
@@ -3581,8 +3641,23 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         }
     }
     else
-    { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+    { // In-sequence packet: ACK if delayed ack count and ACK thinning allow
+        m_delAckCount += segments;
+        Time thinnedUntil = m_lastAckTime + m_ackThinningInterval;
+        if (m_delAckCount >= m_delAckMaxCount && thinnedUntil > Simulator::Now())
+        {
+            // Acknowledge when the thinning interval elapses
+            m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
+            if (m_delAckEvent.IsExpired() ||
+                Simulator::GetDelayLeft(m_delAckEvent) > thinnedUntil - Simulator::Now())
+            {
+                m_delAckEvent.Cancel();
+                m_delAckEvent = Simulator::Schedule(thinnedUntil - Simulator::Now(),
+                                                    &TcpSocketBase::DelAckTimeout,
+                                                    this);
+            }
+        }
+        else if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -3837,7 +3912,13 @@ TcpSocketBase::ReTxTimeout()
     m_tcb->m_cWnd = m_tcb->m_segmentSize;
     m_tcb->m_cWndInfl = m_tcb->m_cWnd;
 
-    m_pacingTimer.Cancel();
+    CancelPacing();
+    m_rackEvent.Cancel();
+    m_tlpEvent.Cancel();
+    if (m_rackTlp)
+    {
+        m_rackTlp->ResetProbe();
+    }
 
     NS_LOG_DEBUG("RTO. Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " << m_tcb->m_ssThresh
                                        << ", restart from seqnum " << m_txBuffer->HeadSequence()
@@ -3990,6 +4071,151 @@ TcpSocketBase::DoRetransmit()
     NS_ASSERT(sz > 0);
 }
 
+void
+TcpSocketBase::RackAcked(TcpTxItem* item)
+{
+    m_rateOps->SkbDelivered(item);
+    // A segment SACKed earlier was accounted for when the SACK arrived
+    if (!item->IsSacked())
+    {
+        m_rackTlp->UpdateDelivered(item, m_tcb->m_minRtt);
+    }
+}
+
+void
+TcpSocketBase::RackSacked(TcpTxItem* item)
+{
+    m_rateOps->SkbDelivered(item);
+    m_rackTlp->UpdateDelivered(item, m_tcb->m_minRtt);
+}
+
+bool
+TcpSocketBase::RackDetectLoss()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t lostBefore = m_txBuffer->GetLost();
+    bool inRecovery = m_tcb->m_congState == TcpSocketState::CA_RECOVERY ||
+                      m_tcb->m_congState == TcpSocketState::CA_LOSS;
+    Time reoWnd = m_rackTlp->GetReorderWindow(m_tcb->m_minRtt,
+                                              m_rtt->GetEstimate(),
+                                              inRecovery,
+                                              m_txBuffer->GetSacked() / m_tcb->m_segmentSize,
+                                              m_retxThresh);
+    Time timeout = m_rackTlp->DetectLoss(m_txBuffer, reoWnd);
+
+    m_rackEvent.Cancel();
+    if (timeout.IsStrictlyPositive())
+    {
+        NS_LOG_LOGIC("Reordering window expires in " << timeout.As(Time::MS));
+        m_rackEvent = Simulator::Schedule(timeout, &TcpSocketBase::RackReorderTimeout, this);
+    }
+    return m_txBuffer->GetLost() > lostBefore;
+}
+
+void
+TcpSocketBase::RackEnterRecovery(uint32_t currentDelivered)
+{
+    NS_LOG_FUNCTION(this << currentDelivered);
+
+    // As with DupThresh, a new recovery waits for the end of the previous one
+    if ((m_tcb->m_congState == TcpSocketState::CA_OPEN ||
+         m_tcb->m_congState == TcpSocketState::CA_DISORDER) &&
+        ((m_highRxAckMark >= m_recover) || (!m_recoverActive)))
+    {
+        NS_LOG_INFO("RACK detected a loss, entering recovery");
+        EnterRecovery(currentDelivered);
+    }
+}
+
+void
+TcpSocketBase::RackReorderTimeout()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (RackDetectLoss())
+    {
+        RackEnterRecovery(0);
+    }
+    SendPendingData(m_connected);
+}
+
+void
+TcpSocketBase::ScheduleTlp()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_tlpEvent.Cancel();
+    // RFC 8985, Section 7.2: a probe is sent only out of loss recovery, and
+    // one at a time
+    if (!m_sackEnabled || !m_rackTlp->IsTlpEnabled() || m_rackTlp->IsProbeOutstanding() ||
+        (m_tcb->m_congState != TcpSocketState::CA_OPEN &&
+         m_tcb->m_congState != TcpSocketState::CA_DISORDER) ||
+        m_tcb->m_highTxMark.Get() <= m_txBuffer->HeadSequence())
+    {
+        return;
+    }
+
+    Time pto = m_rackTlp->GetProbeTimeout(m_rtt->GetEstimate(),
+                                          m_txBuffer->BytesInFlight(),
+                                          m_tcb->m_segmentSize);
+    if (m_retxEvent.IsRunning() && pto >= Simulator::GetDelayLeft(m_retxEvent))
+    {
+        // The probe is sent when the retransmission timer would expire, and
+        // the timer is rescheduled after it, to fire only if no probe is sent
+        NS_LOG_LOGIC("The retransmission timer expires before the probe timeout");
+        pto = Simulator::GetDelayLeft(m_retxEvent);
+        m_tlpEvent = Simulator::Schedule(pto, &TcpSocketBase::TlpTimeout, this);
+        m_retxEvent.Cancel();
+        m_retxEvent = Simulator::Schedule(pto, &TcpSocketBase::ReTxTimeout, this);
+        return;
+    }
+    m_tlpEvent = Simulator::Schedule(pto, &TcpSocketBase::TlpTimeout, this);
+}
+
+void
+TcpSocketBase::TlpTimeout()
+{
+    NS_LOG_FUNCTION(this);
+
+    if ((m_state != ESTABLISHED && m_state != CLOSE_WAIT && m_state != FIN_WAIT_1 &&
+         m_state != CLOSING && m_state != LAST_ACK) ||
+        (m_tcb->m_congState != TcpSocketState::CA_OPEN &&
+         m_tcb->m_congState != TcpSocketState::CA_DISORDER) ||
+        m_tcb->m_highTxMark.Get() <= m_txBuffer->HeadSequence())
+    {
+        return;
+    }
+
+    // RFC 8985, Section 7.3: send new data if possible, otherwise retransmit
+    // the last segment sent
+    bool isRetransmission = true;
+    if ((m_state == ESTABLISHED || m_state == CLOSE_WAIT) &&
+        m_tcb->m_nextTxSequence == m_tcb->m_highTxMark &&
+        m_txBuffer->SizeFromSequence(m_tcb->m_nextTxSequence) > 0 &&
+        (m_highRxAckMark + SequenceNumber32(m_rWnd)) >=
+            (m_tcb->m_nextTxSequence + SequenceNumber32(m_tcb->m_segmentSize)))
+    {
+        uint32_t sz = SendDataPacket(m_tcb->m_nextTxSequence, m_tcb->m_segmentSize, m_connected);
+        m_tcb->m_nextTxSequence += sz;
+        isRetransmission = false;
+    }
+    else
+    {
+        SequenceNumber32 seq = std::max(m_txBuffer->HeadSequence(),
+                                        m_tcb->m_highTxMark.Get() - m_tcb->m_segmentSize);
+        SendDataPacket(seq, m_tcb->m_highTxMark.Get() - seq, m_connected);
+    }
+    NS_LOG_INFO("Sent a tail loss probe, retransmission: " << isRetransmission);
+
+    m_rackTlp->ProbeSent(m_tcb->m_highTxMark, isRetransmission);
+    m_tlpEvent.Cancel();
+
+    // The retransmission timer is restarted after the probe
+    m_retxEvent.Cancel();
+    m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+}
+
 void
 TcpSocketBase::CancelAllTimers()
 {
@@ -3999,7 +4225,9 @@ TcpSocketBase::CancelAllTimers()
     m_lastAckEvent.Cancel();
     m_timewaitEvent.Cancel();
     m_sendPendingDataEvent.Cancel();
-    m_pacingTimer.Cancel();
+    m_rackEvent.Cancel();
+    m_tlpEvent.Cancel();
+    CancelPacing();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -4274,7 +4502,9 @@ TcpSocketBase::ProcessOptionSack(const Ptr<const TcpOption> option)
     NS_LOG_FUNCTION(this << option);
 
     Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack>(option);
-    return m_txBuffer->Update(s->GetSackList(), MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    return m_txBuffer->Update(s->GetSackList(),
+                              m_rackTlp ? MakeCallback(&TcpSocketBase::RackSacked, this)
+                                        : MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
 }
 
 void
@@ -4454,6 +4684,12 @@ TcpSocketBase::GetRxBuffer() const
     return m_tcb->m_rxBuffer;
 }
 
+Ptr<const TcpSocketState>
+TcpSocketBase::GetSocketState() const
+{
+    return m_tcb;
+}
+
 void
 TcpSocketBase::SetRetxThresh(uint32_t retxThresh)
 {
@@ -4539,6 +4775,28 @@ TcpSocketBase::SetRecoveryAlgorithm(Ptr<TcpRecoveryOps> recovery)
     m_recoveryOps = recovery;
 }
 
+void
+TcpSocketBase::SetRackTlpEnabled(bool enable)
+{
+    NS_LOG_FUNCTION(this << enable);
+    if (!enable)
+    {
+        m_rackEvent.Cancel();
+        m_tlpEvent.Cancel();
+        m_rackTlp = nullptr;
+    }
+    else if (!m_rackTlp)
+    {
+        m_rackTlp = CreateObject<TcpRackTlp>();
+    }
+}
+
+bool
+TcpSocketBase::IsRackTlpEnabled() const
+{
+    return m_rackTlp != nullptr;
+}
+
 Ptr<TcpSocketBase>
 TcpSocketBase::Fork()
 {
@@ -4564,6 +4822,61 @@ TcpSocketBase::NotifyPacingPerformed()
     SendPendingData(m_connected);
 }
 
+void
+TcpSocketBase::SchedulePacing(Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    Ptr<TcpPacingWheel> wheel = m_tcp ? m_tcp->GetPacingWheel() : nullptr;
+    if (!wheel)
+    {
+        m_pacingTimer.Schedule(delay);
+        return;
+    }
+    // The wheel releases a socket up to one tick after its departure time:
+    // count the delay from the departure time of the previous segment if it
+    // was released in the last tick, so that the rounding to ticks does not
+    // accumulate and lower the pacing rate.
+    Time start = Simulator::Now();
+    if (start >= m_pacingDeparture && start - m_pacingDeparture < wheel->GetGranularity())
+    {
+        start = m_pacingDeparture;
+    }
+    m_pacingDeparture = start + delay;
+    m_pacingPending = true;
+    wheel->Schedule(m_pacingDeparture,
+                    MakeCallback(&TcpSocketBase::PacingReleased, Ptr<TcpSocketBase>(this)));
+}
+
+bool
+TcpSocketBase::IsPacingPending() const
+{
+    return m_pacingPending || m_pacingTimer.IsRunning();
+}
+
+void
+TcpSocketBase::CancelPacing()
+{
+    NS_LOG_FUNCTION(this);
+    m_pacingTimer.Cancel();
+    m_pacingPending = false;
+    // The next departure is counted from now, not from the cancelled one
+    m_pacingDeparture = Simulator::Now();
+}
+
+void
+TcpSocketBase::PacingReleased()
+{
+    NS_LOG_FUNCTION(this);
+    // A departure cancelled and then scheduled again leaves a stale entry in
+    // the wheel, which must not release the socket ahead of time
+    if (!m_pacingPending || Simulator::Now() < m_pacingDeparture)
+    {
+        return;
+    }
+    m_pacingPending = false;
+    NotifyPacingPerformed();
+}
+
 bool
 TcpSocketBase::IsPacingEnabled() const
 {
@@ -4586,6 +4899,18 @@ TcpSocketBase::IsPacingEnabled() const
     return false;
 }
 
+uint32_t
+TcpSocketBase::GetGsoSize() const
+{
+    if (m_gsoMaxSize == 0 || !IsPacingEnabled())
+    {
+        return m_gsoMaxSize;
+    }
+    uint64_t bytesPerMs = m_tcb->m_pacingRate.Get().GetBitRate() / 8000;
+    return static_cast<uint32_t>(
+        std::min<uint64_t>(m_gsoMaxSize, std::max<uint64_t>(bytesPerMs, 2 * m_tcb->m_segmentSize)));
+}
+
 void
 TcpSocketBase::UpdatePacingRate()
 {
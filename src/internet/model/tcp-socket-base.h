@@ -45,9 +45,11 @@ class TcpL4Protocol;
 class TcpHeader;
 class TcpCongestionOps;
 class TcpRecoveryOps;
+class TcpRackTlp;
 class RttEstimator;
 class TcpRxBuffer;
 class TcpTxBuffer;
+class TcpTxItem;
 class TcpOption;
 class Ipv4Interface;
 class Ipv6Interface;
@@ -307,6 +309,12 @@ class TcpSocketBase : public TcpSocket
      */
     Ptr<TcpRxBuffer> GetRxBuffer() const;
 
+    /**
+     * \brief Get a pointer to the congestion state
+     * \return a pointer to the TcpSocketState
+     */
+    Ptr<const TcpSocketState> GetSocketState() const;
+
     /**
      * \brief Set the retransmission threshold (dup ack threshold for a fast retransmit)
      * \param retxThresh the threshold
@@ -458,6 +466,23 @@ class TcpSocketBase : public TcpSocket
      */
     void SetRecoveryAlgorithm(Ptr<TcpRecoveryOps> recovery);
 
+    /**
+     * \brief Enable or disable the RACK-TLP loss detection (RFC 8985)
+     *
+     * RACK-TLP requires SACK: it is inactive on connections without it.
+     *
+     * \param enable true to enable RACK-TLP, false to disable it
+     *
+     * \see TcpRackTlp
+     */
+    void SetRackTlpEnabled(bool enable);
+
+    /**
+     * \brief Check if the RACK-TLP loss detection is enabled
+     * \return true if RACK-TLP is enabled
+     */
+    bool IsRackTlpEnabled() const;
+
     /**
      * \brief Mark ECT(0) codepoint
      *
@@ -1022,6 +1047,11 @@ class TcpSocketBase : public TcpSocket
      */
     virtual Ptr<TcpSocketBase> Fork();
 
+    /**
+     * \brief Connect the trace sources of the TcpSocketState to the socket
+     */
+    void ConnectTcbTraces();
+
     /**
      * \brief Received an ACK packet
      * \param packet the packet
@@ -1119,6 +1149,45 @@ class TcpSocketBase : public TcpSocket
      */
     void DoRetransmit();
 
+    /**
+     * \brief Account for a segment cumulatively ACKed, with RACK-TLP
+     * \param item the segment, about to be removed from the transmission buffer
+     */
+    void RackAcked(TcpTxItem* item);
+
+    /**
+     * \brief Account for a segment newly SACKed, with RACK-TLP
+     * \param item the segment
+     */
+    void RackSacked(TcpTxItem* item);
+
+    /**
+     * \brief Mark the segments that RACK deems lost, and arm the reordering timer
+     * \return true if some segment has been newly marked as lost
+     */
+    bool RackDetectLoss();
+
+    /**
+     * \brief Enter the recovery after RACK marked some segments as lost
+     * \param currentDelivered Currently (S)ACKed bytes
+     */
+    void RackEnterRecovery(uint32_t currentDelivered);
+
+    /**
+     * \brief The RACK reordering window of a segment expired
+     */
+    void RackReorderTimeout();
+
+    /**
+     * \brief Arm the tail loss probe timer, if a probe is allowed
+     */
+    void ScheduleTlp();
+
+    /**
+     * \brief The tail loss probe timer expired: send a probe segment
+     */
+    void TlpTimeout();
+
     /** \brief Add options to TcpHeader
      *
      * Test each option, and if it is enabled on our side, add it
@@ -1243,12 +1312,49 @@ class TcpSocketBase : public TcpSocket
      */
     void NotifyPacingPerformed();
 
+    /**
+     * \brief Hold the transmission of paced segments for some time
+     *
+     * The pacing wheel of the node is used if there is one, the pacing timer
+     * of the socket otherwise.
+     *
+     * \param delay the time to wait before the next transmission
+     */
+    void SchedulePacing(Time delay);
+
+    /**
+     * \brief Check whether the transmission of paced segments is on hold
+     * \return true if SchedulePacing was called and the delay has not elapsed yet
+     */
+    bool IsPacingPending() const;
+
+    /**
+     * \brief Cancel the pending pacing delay, if any
+     */
+    void CancelPacing();
+
+    /**
+     * \brief Called by the pacing wheel at the tick of the departure time
+     */
+    void PacingReleased();
+
     /**
      * \brief Return true if packets in the current window should be paced
      * \return true if pacing is currently enabled
      */
     bool IsPacingEnabled() const;
 
+    /**
+     * \brief Get the amount of new data to send in a single GSO packet
+     *
+     * Like Linux (tcp_tso_autosize), when pacing is enabled the size is
+     * limited to about 1 ms worth of data at the pacing rate, but not less
+     * than two segments.
+     *
+     * \return the maximum size of the next GSO packet, 0 if GSO is disabled
+     */
+    uint32_t GetGsoSize() const;
+
     /**
      * \brief Dynamically update the pacing rate
      */
@@ -1367,6 +1473,9 @@ class TcpSocketBase : public TcpSocket
     Ptr<TcpCongestionOps> m_congestionControl; //!< Congestion control
     Ptr<TcpRecoveryOps> m_recoveryOps;         //!< Recovery Algorithm
     Ptr<TcpRateOps> m_rateOps;                 //!< Rate operations
+    Ptr<TcpRackTlp> m_rackTlp;                 //!< RACK-TLP loss detection (null if disabled)
+    EventId m_rackEvent{};                     //!< RACK reordering timer
+    EventId m_tlpEvent{};                      //!< Tail loss probe timer
 
     // Guesses over the other connection end
     bool m_isFirstPartialAck{true}; //!< First partial ACK during RECOVERY
@@ -1384,6 +1493,15 @@ class TcpSocketBase : public TcpSocket
 
     // Pacing related variable
     Timer m_pacingTimer{Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
+    bool m_pacingPending{false};                   //!< Waiting for the pacing wheel
+    Time m_pacingDeparture{0};                     //!< Departure time given to the pacing wheel
+    bool m_queueDiscPacing{false};                 //!< Pacing left to the queue disc
+
+    uint32_t m_gsoMaxSize{0}; //!< Maximum size of a GSO packet (0 disables GSO)
+
+    // ACK thinning
+    Time m_ackThinningInterval{0};   //!< Minimum interval between ACKs of in-order data
+    Time m_lastAckTime{Time::Min()}; //!< Time the last ACK was sent
 
     // Parameters related to Explicit Congestion Notification
     TracedValue<SequenceNumber32> m_ecnEchoSeq{
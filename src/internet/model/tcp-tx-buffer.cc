@@ -295,7 +295,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    Index(m_sentList.insert(m_sentList.end(), item));
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -309,37 +309,34 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    auto pos = m_sentIndex.find(seq);
+    if (pos != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = pos->second;
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -347,8 +344,10 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
 
     if (!item->m_retrans)
     {
+        uint8_t oldClass = GetClass(item);
         m_retrans += item->m_packet->GetSize();
         item->m_retrans = true;
+        Reclassify(item, oldClass);
     }
 
     return item;
@@ -359,23 +358,103 @@ TcpTxBuffer::FindHighestSacked() const
 {
     NS_LOG_FUNCTION(this);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
+    auto ret = std::make_pair(m_sentList.cend(), SequenceNumber32(0));
 
-    auto ret = std::make_pair(m_sentList.end(), SequenceNumber32(0));
-
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    if (!m_sentList.empty())
     {
-        const TcpTxItem* item = *it;
-        if (item->m_sacked)
+        auto it = FindLast(GetClasses(SACKED, 0), m_sentList.back()->m_startSeq);
+        if (it != m_sentList.end())
         {
-            ret = std::make_pair(it, beginOfCurrentPacket);
+            ret = std::make_pair(it, (*it)->m_startSeq);
         }
-        beginOfCurrentPacket += item->m_packet->GetSize();
     }
 
     return ret;
 }
 
+uint8_t
+TcpTxBuffer::GetClass(const TcpTxItem* item)
+{
+    return (item->m_sacked ? SACKED : 0) | (item->m_lost ? LOST : 0) |
+           (item->m_retrans ? RETRANS : 0);
+}
+
+uint8_t
+TcpTxBuffer::GetClasses(uint8_t set, uint8_t unset)
+{
+    uint8_t classes = 0;
+    for (uint8_t c = 0; c < N_CLASSES; ++c)
+    {
+        if ((c & set) == set && (c & unset) == 0)
+        {
+            classes |= 1 << c;
+        }
+    }
+    return classes;
+}
+
+void
+TcpTxBuffer::Index(PacketList::iterator it)
+{
+    const TcpTxItem* item = *it;
+    m_sentIndex.emplace(item->m_startSeq, it);
+    m_scoreboard[GetClass(item)].insert(item->m_startSeq);
+}
+
+void
+TcpTxBuffer::Unindex(const TcpTxItem* item)
+{
+    m_sentIndex.erase(item->m_startSeq);
+    m_scoreboard[GetClass(item)].erase(item->m_startSeq);
+}
+
+void
+TcpTxBuffer::Reclassify(const TcpTxItem* item, uint8_t oldClass)
+{
+    uint8_t newClass = GetClass(item);
+    if (newClass != oldClass)
+    {
+        m_scoreboard[oldClass].erase(item->m_startSeq);
+        m_scoreboard[newClass].insert(item->m_startSeq);
+    }
+}
+
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindFirst(uint8_t classes, const SequenceNumber32& seq) const
+{
+    const SequenceNumber32* first = nullptr;
+    for (uint8_t c = 0; c < N_CLASSES; ++c)
+    {
+        if (classes & (1 << c))
+        {
+            auto it = m_scoreboard[c].lower_bound(seq);
+            if (it != m_scoreboard[c].end() && (first == nullptr || *it < *first))
+            {
+                first = &(*it);
+            }
+        }
+    }
+    return first ? PacketList::const_iterator(m_sentIndex.at(*first)) : m_sentList.end();
+}
+
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindLast(uint8_t classes, const SequenceNumber32& seq) const
+{
+    const SequenceNumber32* last = nullptr;
+    for (uint8_t c = 0; c < N_CLASSES; ++c)
+    {
+        if (classes & (1 << c))
+        {
+            auto it = m_scoreboard[c].upper_bound(seq);
+            if (it != m_scoreboard[c].begin() && (last == nullptr || *last < *std::prev(it)))
+            {
+                last = &(*std::prev(it));
+            }
+        }
+    }
+    return last ? PacketList::const_iterator(m_sentIndex.at(*last)) : m_sentList.end();
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
@@ -401,7 +480,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                const SequenceNumber32& listStartFrom,
                                uint32_t numBytes,
                                const SequenceNumber32& seq,
-                               bool* listEdited) const
+                               bool* listEdited)
 {
     NS_LOG_FUNCTION(this << numBytes << seq);
 
@@ -437,12 +516,22 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     TcpTxItem* outItem = nullptr;
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
+    bool indexed = &list == &m_sentList;
+
+    if (indexed && seq > listStartFrom)
+    {
+        // Skip directly to the sent item containing seq
+        auto pos = m_sentIndex.upper_bound(seq);
+        NS_ASSERT(pos != m_sentIndex.begin());
+        it = (--pos)->second;
+        beginOfCurrentPacket = (*it)->m_startSeq;
+    }
 
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!indexed || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -468,10 +557,19 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                          << " and now we recurse because packet ends at "
                                          << beginOfCurrentPacket + currentPacket->GetSize());
                 auto firstPart = new TcpTxItem();
+                if (indexed)
+                {
+                    Unindex(currentItem);
+                }
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (indexed)
+                {
+                    Index(firstPartIt);
+                    Index(it);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -534,10 +632,19 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 // the end is inside the current packet, but it isn't exactly
                 // the packet end. Just fragment, fix the list, and return.
                 auto firstPart = new TcpTxItem();
+                if (indexed)
+                {
+                    Unindex(currentItem);
+                }
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (indexed)
+                {
+                    Index(firstPartIt);
+                    Index(it);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -565,8 +672,17 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
             TcpTxItem* next = (*it); // Please remember we have incremented it
                                      // in the previous if
 
+            if (indexed)
+            {
+                Unindex(currentItem);
+                Unindex(next);
+            }
             MergeItems(currentItem, next);
-            list.erase(it);
+            auto currentIt = list.erase(it);
+            if (indexed)
+            {
+                Index(--currentIt);
+            }
 
             delete next;
 
@@ -650,16 +766,15 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // Only the last item starting before ack can end at ack
+    auto pos = m_sentIndex.lower_bound(ack);
+    if (pos == m_sentIndex.begin())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    TcpTxItem* item = *(--pos)->second;
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -707,6 +822,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            Unindex(item);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -723,9 +839,11 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
         { // Part of the packet is behind the seqnum. Fragment
             pktSize -= offset;
             NS_LOG_INFO(*item);
+            Unindex(item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
             item->m_startSeq += offset;
+            Index(i);
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -753,7 +871,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             // It is not possible to have the UNA sacked; otherwise, it would
             // have been ACKed. This is, most likely, our wrong guessing
             // when adding Reno dupacks in the count.
+            uint8_t oldClass = GetClass(head);
             head->m_sacked = false;
+            Reclassify(head, oldClass);
             m_sackedOut -= head->m_packet->GetSize();
             NS_LOG_INFO("Moving the SACK flag from the HEAD to another segment");
             AddRenoSack();
@@ -788,15 +908,21 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Items starting before the block cannot be covered by it
+        auto pos = m_sentIndex.lower_bound((*option_it).first);
+        if (pos == m_sentIndex.end())
+        {
+            continue;
+        }
+        PacketList::const_iterator item_it = pos->second;
+        SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -818,6 +944,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                 }
                 else
                 {
+                    uint8_t oldClass = GetClass(*item_it);
                     if ((*item_it)->m_lost)
                     {
                         (*item_it)->m_lost = false;
@@ -825,6 +952,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     }
 
                     (*item_it)->m_sacked = true;
+                    Reclassify(*item_it, oldClass);
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
 
@@ -877,7 +1005,6 @@ TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
     uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
     if (m_highestSack.first == m_sentList.end())
     {
         NS_LOG_INFO("Status before the update: " << *this
@@ -889,32 +1016,50 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    // Walk the sacked items down from the highest SACK, excluding the head,
+    // until dupAckThresh of them have been counted: every item below the last
+    // one counted that is neither sacked nor lost is now lost.
+    NS_ASSERT(m_highestSack.first != m_sentList.end());
+    TcpTxItem* head = m_sentList.front();
+    SequenceNumber32 highestSackSeq = (*m_highestSack.first)->m_startSeq;
+    SequenceNumber32 thresholdSeq = highestSackSeq;
+    SequenceNumber32 searchFrom = highestSackSeq;
+    while (sacked < m_dupAckThresh)
     {
-        TcpTxItem* item = *it;
-        if (item->m_sacked)
+        auto it = FindLast(GetClasses(SACKED, 0), searchFrom);
+        if (it == m_sentList.end() || (*it)->m_startSeq <= head->m_startSeq)
         {
-            sacked++;
+            break;
         }
+        sacked++;
+        thresholdSeq = (*it)->m_startSeq;
+        searchFrom = thresholdSeq - 1;
+    }
 
-        if (sacked >= m_dupAckThresh)
+    if (sacked >= m_dupAckThresh)
+    {
+        uint8_t unmarked = GetClasses(0, SACKED | LOST);
+        for (auto it = FindFirst(unmarked, head->m_startSeq + 1); it != m_sentList.end();
+             it = FindFirst(unmarked, (*it)->m_startSeq))
         {
-            if (!item->m_sacked && !item->m_lost)
+            // With a null threshold, the highest sacked item itself is reached
+            if (m_dupAckThresh > 0 ? (*it)->m_startSeq >= thresholdSeq
+                                   : (*it)->m_startSeq > highestSackSeq)
             {
-                item->m_lost = true;
-                m_lostOut += item->m_packet->GetSize();
+                break;
             }
+            uint8_t oldClass = GetClass(*it);
+            (*it)->m_lost = true;
+            Reclassify(*it, oldClass);
+            m_lostOut += (*it)->m_packet->GetSize();
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
-    }
 
-    if (sacked >= m_dupAckThresh)
-    {
-        TcpTxItem* item = *m_sentList.begin();
-        if (!item->m_lost)
+        if (!head->m_lost)
         {
-            item->m_lost = true;
-            m_lostOut += item->m_packet->GetSize();
+            uint8_t oldClass = GetClass(head);
+            head->m_lost = true;
+            Reclassify(head, oldClass);
+            m_lostOut += head->m_packet->GetSize();
         }
     }
     NS_LOG_INFO("Status after the update: " << *this);
@@ -926,37 +1071,26 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
     if (seq >= m_highestSack.second)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // The first item from seq onwards that is lost or sacked decides
+    auto lost = FindFirst(GetClasses(LOST, 0), seq);
+    if (lost == m_sentList.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if (beginOfCurrentPacket >= seq)
-        {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
-
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
-        }
-
-        beginOfCurrentPacket += (*it)->m_packet->GetSize();
+        return false;
+    }
+    auto sacked = FindFirst(GetClasses(SACKED, LOST), seq);
+    if (sacked != m_sentList.end() && (*sacked)->m_startSeq < (*lost)->m_startSeq)
+    {
+        NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+        return false;
     }
 
-    return false;
+    NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+    return true;
 }
 
 bool
@@ -977,35 +1111,37 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *
      *     (1.c) IsLost (S2) returns true.
      */
-    TcpTxItem* item;
+    auto lost = FindFirst(GetClasses(LOST, SACKED | RETRANS), m_firstByteSeq);
+    if (lost != m_sentList.end())
+    {
+        NS_LOG_INFO("IsLost, returning" << (*lost)->m_startSeq);
+        *seq = (*lost)->m_startSeq;
+        *seqHigh = *seq + m_segmentSize;
+        return true;
+    }
+
+    // Candidate for rule 3: the first item neither sacked, lost nor retransmitted
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
-
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    if (isRecovery)
     {
-        item = *it;
-
-        // Condition 1.a , 1.b , and 1.c
-        if (!item->m_retrans && !item->m_sacked)
+        uint8_t unmarked = GetClasses(0, SACKED | LOST | RETRANS);
+        auto it = FindFirst(unmarked, m_firstByteSeq);
+        if (it != m_sentList.end())
         {
-            if (item->m_lost)
+            isSeqPerRule3Valid = true;
+            seqPerRule3 = (*it)->m_startSeq;
+            // A null sequence number is taken as unset, and superseded by the next candidate
+            if (seqPerRule3.GetValue() == 0)
             {
-                NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
-                *seq = beginOfCurrentPkt;
-                *seqHigh = *seq + m_segmentSize;
-                return true;
-            }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
-            {
-                NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
-                isSeqPerRule3Valid = true;
-                seqPerRule3 = beginOfCurrentPkt;
+                it = FindFirst(unmarked, seqPerRule3 + 1);
+                if (it != m_sentList.end())
+                {
+                    seqPerRule3 = (*it)->m_startSeq;
+                }
             }
+            NS_LOG_INFO("Saving for rule 3 the seq " << seqPerRule3);
         }
-
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1016,7 +1152,7 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      */
     if (SizeFromSequence(m_firstByteSeq + m_sentSize) > 0)
     {
-        if (m_sentSize <= m_rWndCallback())
+        if (m_sentSize < m_rWndCallback())
         {
             NS_LOG_INFO("There is unsent data. Send it");
             *seq = m_firstByteSeq + m_sentSize;
@@ -1215,9 +1351,13 @@ TcpTxBuffer::ResetRenoSack()
     NS_LOG_FUNCTION(this);
 
     m_sackedOut = 0;
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    uint8_t sackedClasses = GetClasses(SACKED, 0);
+    for (auto it = FindFirst(sackedClasses, m_firstByteSeq); it != m_sentList.end();
+         it = FindFirst(sackedClasses, (*it)->m_startSeq))
     {
+        uint8_t oldClass = GetClass(*it);
         (*it)->m_sacked = false;
+        Reclassify(*it, oldClass);
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
@@ -1244,6 +1384,11 @@ TcpTxBuffer::ResetSentList()
         m_appList.push_front(item);
         m_sentList.pop_back();
     }
+    m_sentIndex.clear();
+    for (auto& scoreboard : m_scoreboard)
+    {
+        scoreboard.clear();
+    }
 
     m_sentSize = 0;
     m_lostOut = 0;
@@ -1260,6 +1405,7 @@ TcpTxBuffer::ResetLastSegmentSent()
     {
         TcpTxItem* item = m_sentList.back();
 
+        Unindex(item);
         m_sentList.pop_back();
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
@@ -1290,6 +1436,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
 
     for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
     {
+        uint8_t oldClass = GetClass(*it);
         if (resetSack)
         {
             (*it)->m_sacked = false;
@@ -1311,6 +1458,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         }
 
         (*it)->m_retrans = false;
+        Reclassify(*it, oldClass);
     }
 
     NS_LOG_INFO("Set sent list lost, status: " << *this);
@@ -1343,8 +1491,10 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
 
     if (m_sentList.front()->m_retrans)
     {
+        uint8_t oldClass = GetClass(m_sentList.front());
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        Reclassify(m_sentList.front(), oldClass);
     }
     ConsistencyCheck();
 }
@@ -1354,6 +1504,8 @@ TcpTxBuffer::MarkHeadAsLost()
 {
     if (!m_sentList.empty())
     {
+        uint8_t oldClass = GetClass(m_sentList.front());
+
         // If the head is sacked (reneging by the receiver the previously sent
         // information) we revert the sacked flag.
         // A sacked head means that we should advance SND.UNA.. so it's an error.
@@ -1374,10 +1526,60 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        Reclassify(m_sentList.front(), oldClass);
     }
     ConsistencyCheck();
 }
 
+Time
+TcpTxBuffer::MarkLostSentBefore(const Time& xmitTs,
+                                const SequenceNumber32& endSeq,
+                                const Time& lossDelay)
+{
+    NS_LOG_FUNCTION(this << xmitTs << endSeq << lossDelay);
+
+    Time timeout(0);
+    uint8_t candidates = GetClasses(0, SACKED | LOST) | GetClasses(LOST | RETRANS, SACKED);
+    for (auto it = FindFirst(candidates, m_firstByteSeq);
+         it != m_sentList.end() && (*it)->m_startSeq < endSeq;
+         it = FindFirst(candidates, (*it)->m_startSeq + 1))
+    {
+        TcpTxItem* item = *it;
+        uint32_t size = item->m_packet->GetSize();
+        if (item->m_lastSent > xmitTs ||
+            (item->m_lastSent == xmitTs && item->m_startSeq + size > endSeq))
+        {
+            // Retransmitted after the delivered segment
+            continue;
+        }
+
+        Time remaining = item->m_lastSent + lossDelay - Simulator::Now();
+        if (remaining.IsStrictlyPositive())
+        {
+            timeout = Max(timeout, remaining);
+            continue;
+        }
+
+        uint8_t oldClass = GetClass(item);
+        if (item->m_retrans)
+        {
+            item->m_retrans = false;
+            m_retrans -= size;
+        }
+        if (!item->m_lost)
+        {
+            item->m_lost = true;
+            m_lostOut += size;
+        }
+        Reclassify(item, oldClass);
+        NS_LOG_INFO("Segment " << *item << " deemed lost by RACK");
+    }
+
+    NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
+    ConsistencyCheck();
+    return timeout;
+}
+
 void
 TcpTxBuffer::AddRenoSack()
 {
@@ -1394,19 +1596,16 @@ TcpTxBuffer::AddRenoSack()
 
     m_renoSack = true;
 
-    // We can _never_ SACK the head, so start from the second segment sent
-    auto it = ++m_sentList.begin();
-
-    // Find the "highest sacked" point, that is SND.UNA + m_sackedOut
-    while (it != m_sentList.end() && (*it)->m_sacked)
-    {
-        ++it;
-    }
+    // We can _never_ SACK the head, so start from the second segment sent, and
+    // find the "highest sacked" point, that is SND.UNA + m_sackedOut
+    auto it = FindFirst(GetClasses(0, SACKED), m_sentList.front()->m_startSeq + 1);
 
     // Add to the sacked size the size of the first "not sacked" segment
     if (it != m_sentList.end())
     {
+        uint8_t oldClass = GetClass(*it);
         (*it)->m_sacked = true;
+        Reclassify(*it, oldClass);
         m_sackedOut += (*it)->m_packet->GetSize();
         m_highestSack = std::make_pair(it, (*it)->m_startSeq);
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
@@ -1455,6 +1654,23 @@ TcpTxBuffer::ConsistencyCheck() const
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
     NS_ASSERT_MSG(retrans == m_retrans,
                   " Counted retrans: " << retrans << " stored retrans: " << m_retrans);
+
+    std::size_t classified = 0;
+    for (const auto& scoreboard : m_scoreboard)
+    {
+        classified += scoreboard.size();
+    }
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size() && classified == m_sentList.size(),
+                  "Indexed: " << m_sentIndex.size() << " classified: " << classified
+                              << " sent items: " << m_sentList.size());
+    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    {
+        auto pos = m_sentIndex.find((*it)->m_startSeq);
+        NS_ASSERT_MSG(pos != m_sentIndex.end() && pos->second == it,
+                      "Item " << **it << " is not indexed");
+        NS_ASSERT_MSG(m_scoreboard[GetClass(*it)].count((*it)->m_startSeq) == 1,
+                      "Item " << **it << " is not in the set of its class");
+    }
 }
 
 std::ostream&
@@ -28,6 +28,9 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <map>
+#include <set>
+
 namespace ns3
 {
 class Packet;
@@ -74,6 +77,13 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * Since a window can hold thousands of segments, the sent list is also
+ * indexed by sequence number, and each sent item is classified by the
+ * combination of its sacked, lost and retransmitted flags in a per-class set
+ * of sequence numbers. Finding the segment covering a sequence, the first
+ * segment to retransmit or the segments to mark as lost then takes a few
+ * logarithmic lookups instead of a walk of the list.
+ *
  * Item properties
  * ---------------
  *
@@ -380,6 +390,28 @@ class TcpTxBuffer : public Object
      */
     void MarkHeadAsLost();
 
+    /**
+     * \brief Mark as lost the segments sent long enough before a delivered one
+     *
+     * This is the time-based loss detection of RACK (RFC 8985, Section 6.2,
+     * Step 5): a segment neither SACKed nor already lost is lost when it was
+     * sent before the most recently sent delivered segment, and at least
+     * lossDelay ago. A retransmission deemed lost is marked again as lost, so
+     * that NextSeg returns it once more.
+     *
+     * Only the segments starting below endSeq are visited, since the others
+     * were sent for the first time after the delivered segment.
+     *
+     * \param xmitTs transmission time of the most recently sent delivered segment
+     * \param endSeq end sequence of the most recently sent delivered segment
+     * \param lossDelay time after its transmission at which a segment is lost
+     * \return the time left before the next segment can be marked as lost,
+     * or zero if no segment is waiting to be marked
+     */
+    Time MarkLostSentBefore(const Time& xmitTs,
+                            const SequenceNumber32& endSeq,
+                            const Time& lossDelay);
+
     /**
      * \brief Emulate SACKs for SACKless connection: account for a new dupack.
      *
@@ -413,6 +445,72 @@ class TcpTxBuffer : public Object
 
     typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
+    /**
+     * \brief Flags that classify a sent item in the scoreboard.
+     *
+     * The class of an item is the bitwise OR of the flags it has set, and a
+     * set of classes is a bitmask with the bit of each class set.
+     */
+    enum ScoreboardFlag : uint8_t
+    {
+        RETRANS = 1, //!< The item is retransmitted
+        LOST = 2,    //!< The item is lost
+        SACKED = 4,  //!< The item is sacked
+    };
+
+    static constexpr uint8_t N_CLASSES = 8; //!< Number of scoreboard classes
+
+    /**
+     * \brief Get the scoreboard class of an item
+     * \param item the item
+     * \return the class of the item
+     */
+    static uint8_t GetClass(const TcpTxItem* item);
+
+    /**
+     * \brief Get the set of the classes having some flags set and others unset
+     * \param set flags that must be set
+     * \param unset flags that must be unset
+     * \return the bitmask of the matching classes
+     */
+    static uint8_t GetClasses(uint8_t set, uint8_t unset);
+
+    /**
+     * \brief Index a sent item by its start sequence and its class
+     * \param it iterator to the item in m_sentList
+     */
+    void Index(PacketList::iterator it);
+
+    /**
+     * \brief Remove a sent item from the indexes, before it is removed from the
+     * sent list or its start sequence changes
+     * \param item the item
+     */
+    void Unindex(const TcpTxItem* item);
+
+    /**
+     * \brief Move a sent item to the set of its class after its flags changed
+     * \param item the item
+     * \param oldClass the class of the item before the change
+     */
+    void Reclassify(const TcpTxItem* item, uint8_t oldClass);
+
+    /**
+     * \brief Find the first sent item of some classes starting at or after a sequence
+     * \param classes bitmask of the classes
+     * \param seq the sequence
+     * \return an iterator to the item, or the end of m_sentList if there is none
+     */
+    PacketList::const_iterator FindFirst(uint8_t classes, const SequenceNumber32& seq) const;
+
+    /**
+     * \brief Find the last sent item of some classes starting at or before a sequence
+     * \param classes bitmask of the classes
+     * \param seq the sequence
+     * \return an iterator to the item, or the end of m_sentList if there is none
+     */
+    PacketList::const_iterator FindLast(uint8_t classes, const SequenceNumber32& seq) const;
+
     /**
      * \brief Update the lost count
      *
@@ -428,8 +526,8 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. Only the dupAckThresh sacked items below the
+     * highest SACK and the items that become lost are visited.
      *
      */
     void UpdateLostCount();
@@ -564,7 +662,7 @@ class TcpTxBuffer : public Object
                                  const SequenceNumber32& startingSeq,
                                  uint32_t numBytes,
                                  const SequenceNumber32& requestedSeq,
-                                 bool* listEdited = nullptr) const;
+                                 bool* listEdited = nullptr);
 
     /**
      * \brief Merge two TcpTxItem
@@ -604,6 +702,10 @@ class TcpTxBuffer : public Object
 
     PacketList m_appList;              //!< Buffer for application data
     PacketList m_sentList;             //!< Buffer for sent (but not acked) data
+    std::map<SequenceNumber32, PacketList::iterator>
+        m_sentIndex; //!< Items of m_sentList by start sequence
+    std::set<SequenceNumber32>
+        m_scoreboard[N_CLASSES]; //!< Start sequences of the sent items of each class
     uint32_t m_maxBuffer;              //!< Max number of data bytes in buffer (SND.WND)
     uint32_t m_size;                   //!< Size of all data in this buffer
     uint32_t m_sentSize;               //!< Size of sent (and not discarded) segments
@@ -93,6 +93,12 @@ TcpTxItem::GetLastSent() const
     return m_lastSent;
 }
 
+const SequenceNumber32&
+TcpTxItem::GetStartSeq() const
+{
+    return m_startSeq;
+}
+
 TcpTxItem::RateInformation&
 TcpTxItem::GetRateInformation()
 {
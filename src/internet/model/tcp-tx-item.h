@@ -78,6 +78,12 @@ class TcpTxItem
      */
     const Time& GetLastSent() const;
 
+    /**
+     * \brief Get the sequence number of the first byte of the item
+     * \return the start sequence number (meaningful only once transmitted)
+     */
+    const SequenceNumber32& GetStartSeq() const;
+
     /**
      * \brief Various rate-related information, can be accessed by TcpRateOps.
      *
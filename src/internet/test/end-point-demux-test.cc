@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the matching priority and the index maintenance of Ipv4EndPointDemux.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase()
+    : TestCase("Check the IPv4 end point demux lookups")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun()
+{
+    Ipv4EndPointDemux demux;
+    Ptr<Ipv4Interface> iface = CreateObject<Ipv4Interface>();
+    iface->AddAddress(Ipv4InterfaceAddress(Ipv4Address("10.0.0.1"), Ipv4Mask("255.255.255.0")));
+
+    Ipv4Address local("10.0.0.1");
+    Ipv4Address peer("10.0.0.2");
+
+    Ipv4EndPoint* any = demux.Allocate(nullptr, 80);
+    Ipv4EndPoint* bound = demux.Allocate(nullptr, local, 80);
+    NS_TEST_ASSERT_MSG_NE(bound, nullptr, "A listener on a specific address can coexist");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 80),
+                          nullptr,
+                          "Duplicated listeners must be refused");
+
+    auto found = demux.Lookup(local, 80, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one listener");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), bound, "The bound listener is more specific");
+    found = demux.Lookup(Ipv4Address("10.0.0.7"), 80, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one listener");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), any, "Only the wildcard listener matches");
+
+    Ipv4EndPoint* connected = demux.Allocate(nullptr, local, 80, peer, 5000);
+    NS_TEST_ASSERT_MSG_NE(connected, nullptr, "Connected end point not allocated");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 5000),
+                          nullptr,
+                          "Duplicated connections must be refused");
+    found = demux.Lookup(local, 80, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one connection");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), connected, "The exact match is preferred");
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 5000), connected, "Exact match");
+    found = demux.Lookup(local, 80, peer, 5001, iface);
+    NS_TEST_EXPECT_MSG_EQ(found.front(), bound, "Other peers reach the listener");
+
+    connected->SetRxEnabled(false);
+    found = demux.Lookup(local, 80, peer, 5000, iface);
+    NS_TEST_EXPECT_MSG_EQ(found.front(), bound, "Rx disabled end points are skipped");
+    connected->SetRxEnabled(true);
+
+    // An end point changing its four-tuple after allocation is re-indexed
+    Ipv4EndPoint* client = demux.Allocate();
+    uint16_t port = client->GetLocalPort();
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(port), true, "Ephemeral port not in use");
+    client->SetLocalAddress(local);
+    client->SetPeer(Ipv4Address("10.0.0.3"), 443);
+    found = demux.Lookup(local, port, Ipv4Address("10.0.0.3"), 443, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Re-indexed end point not found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), client, "Wrong end point");
+    found = demux.Lookup(local, port, Ipv4Address("10.0.0.4"), 443, iface);
+    NS_TEST_EXPECT_MSG_EQ(found.empty(), true, "The old wildcard key must be gone");
+
+    // Subnet-directed broadcast reaches an end point bound to the network address
+    Ipv4EndPoint* subnet = demux.Allocate(nullptr, Ipv4Address("10.0.0.0"), 9);
+    found = demux.Lookup(Ipv4Address("10.0.0.255"), 9, peer, 5000, iface);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Subnet-directed end point not found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), subnet, "Wrong end point");
+    found = demux.Lookup(Ipv4Address("10.0.1.255"), 9, peer, 5000, iface);
+    NS_TEST_EXPECT_MSG_EQ(found.empty(), true, "Other subnets must not match");
+
+    demux.DeAllocate(connected);
+    demux.DeAllocate(bound);
+    demux.DeAllocate(any);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(80), false, "Port 80 should be free");
+    NS_TEST_EXPECT_MSG_EQ(demux.Lookup(local, 80, peer, 5000, iface).empty(),
+                          true,
+                          "No end point left on port 80");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetAllEndPoints().size(), 2, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the matching priority and the index maintenance of Ipv6EndPointDemux.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv6EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase()
+    : TestCase("Check the IPv6 end point demux lookups")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun()
+{
+    Ipv6EndPointDemux demux;
+    Ipv6Address local("2001:db8::1");
+    Ipv6Address peer("2001:db8::2");
+
+    Ipv6EndPoint* any = demux.Allocate(nullptr, 80);
+    Ipv6EndPoint* bound = demux.Allocate(nullptr, local, 80);
+    auto found = demux.Lookup(local, 80, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one listener");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), bound, "The bound listener is more specific");
+    found = demux.Lookup(Ipv6Address("2001:db8::7"), 80, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one listener");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), any, "Only the wildcard listener matches");
+
+    Ipv6EndPoint* connected = demux.Allocate(nullptr, local, 80, peer, 5000);
+    found = demux.Lookup(local, 80, peer, 5000, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Expected one connection");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), connected, "The exact match is preferred");
+
+    Ipv6EndPoint* client = demux.Allocate();
+    client->SetLocalAddress(local);
+    client->SetLocalPort(8080);
+    client->SetPeer(peer, 443);
+    found = demux.Lookup(local, 8080, peer, 443, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(found.size(), 1, "Re-indexed end point not found");
+    NS_TEST_EXPECT_MSG_EQ(found.front(), client, "Wrong end point");
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(8080), true, "Port 8080 should be in use");
+
+    demux.DeAllocate(client);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(8080), false, "Port 8080 should be free");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetEndPoints().size(), 3, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite()
+    : TestSuite("end-point-demux", UNIT)
+{
+    AddTestCase(new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
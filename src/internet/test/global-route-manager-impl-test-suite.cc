@@ -27,6 +27,7 @@
 #include "ns3/test.h"
 
 #include <cstdlib> // for rand()
+#include <vector>
 
 using namespace ns3;
 
@@ -215,6 +216,81 @@ GlobalRouteManagerImplTestCase::DoRun()
     // does not crash
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Candidate queue test
+ *
+ * Vertices are pushed with random distances, some of them are found by their
+ * ID and moved up the queue, and all are checked to be popped by increasing
+ * distance, in the order of their last update when the distances are equal.
+ */
+class CandidateQueueTestCase : public TestCase
+{
+  public:
+    CandidateQueueTestCase();
+    void DoRun() override;
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase()
+    : TestCase("CandidateQueueTestCase")
+{
+}
+
+void
+CandidateQueueTestCase::DoRun()
+{
+    CandidateQueue candidate;
+    const uint32_t nVertices = 1000;
+    // order of the last push or update of each vertex
+    std::vector<uint32_t> updated(nVertices, 0);
+
+    for (uint32_t i = 0; i < nVertices; ++i)
+    {
+        auto v = new SPFVertex;
+        v->SetVertexType(SPFVertex::VertexRouter);
+        v->SetVertexId(Ipv4Address(i + 1));
+        v->SetDistanceFromRoot(std::rand() % 100);
+        candidate.Push(v);
+        updated[i] = i;
+    }
+    NS_TEST_ASSERT_MSG_EQ(candidate.Size(), nVertices, "Wrong size");
+
+    for (uint32_t i = 0; i < nVertices; i += 7)
+    {
+        SPFVertex* v = candidate.Find(Ipv4Address(i + 1));
+        NS_TEST_ASSERT_MSG_NE(v, nullptr, "Vertex not found");
+        NS_TEST_ASSERT_MSG_EQ(v->GetVertexId(), Ipv4Address(i + 1), "Wrong vertex found");
+        if (v->GetDistanceFromRoot() > 0)
+        {
+            v->SetDistanceFromRoot(v->GetDistanceFromRoot() / 2);
+            candidate.Update(v);
+            updated[i] = nVertices + i;
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(candidate.Find(Ipv4Address(nVertices + 1)),
+                          nullptr,
+                          "Unknown vertex found");
+
+    uint32_t lastDistance = 0;
+    uint32_t lastUpdated = 0;
+    for (uint32_t i = 0; i < nVertices; ++i)
+    {
+        SPFVertex* v = candidate.Pop();
+        uint32_t index = v->GetVertexId().Get() - 1;
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(v->GetDistanceFromRoot(), lastDistance, "Wrong order");
+        if (i > 0 && v->GetDistanceFromRoot() == lastDistance)
+        {
+            NS_TEST_ASSERT_MSG_GT(updated[index], lastUpdated, "Ties not popped in order");
+        }
+        NS_TEST_ASSERT_MSG_EQ(candidate.Find(v->GetVertexId()), nullptr, "Popped vertex found");
+        lastDistance = v->GetDistanceFromRoot();
+        lastUpdated = updated[index];
+        delete v;
+    }
+    NS_TEST_ASSERT_MSG_EQ(candidate.Empty(), true, "Queue not empty");
+}
+
 /**
  * \ingroup internet-test
  *
@@ -232,6 +308,7 @@ GlobalRouteManagerImplTestSuite::GlobalRouteManagerImplTestSuite()
     : TestSuite("global-route-manager-impl", UNIT)
 {
     AddTestCase(new GlobalRouteManagerImplTestCase(), TestCase::QUICK);
+    AddTestCase(new CandidateQueueTestCase(), TestCase::QUICK);
 }
 
 static GlobalRouteManagerImplTestSuite
@@ -39,6 +39,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/socket.h"
 #include "ns3/test.h"
+#include "ns3/udp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/udp-socket.h"
@@ -50,8 +51,10 @@
 #include <netinet/in.h>
 #endif
 
+#include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -575,6 +578,155 @@ Ipv4FragmentationTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 overlapping fragments Test
+ *
+ * The fragments of a UDP datagram are received out of order, duplicated and
+ * overlapping, with different bytes in the overlaps: the bytes received
+ * first are checked to be kept in the reassembled datagram.
+ */
+class Ipv4OverlappingFragmentsTest : public TestCase
+{
+  public:
+    Ipv4OverlappingFragmentsTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Handle incoming packets.
+     * \param socket The receiving socket.
+     */
+    void HandleRead(Ptr<Socket> socket);
+
+    /**
+     * \brief Receive a fragment.
+     * \param bytes the bytes of the datagram
+     * \param offset the offset of the fragment
+     * \param size the size of the fragment
+     * \param more whether more fragments follow
+     */
+    void ReceiveFragment(const std::vector<uint8_t>& bytes,
+                         uint16_t offset,
+                         uint16_t size,
+                         bool more);
+
+    Ptr<Ipv4L3Protocol> m_ipv4;          //!< IPv4 of the receiver
+    Ptr<NetDevice> m_device;             //!< Device of the receiver
+    std::vector<Ptr<Packet>> m_received; //!< Packets received
+};
+
+Ipv4OverlappingFragmentsTest::Ipv4OverlappingFragmentsTest()
+    : TestCase("Verify the IPv4 reassembly of duplicated and overlapping fragments")
+{
+}
+
+void
+Ipv4OverlappingFragmentsTest::HandleRead(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        m_received.push_back(packet);
+    }
+}
+
+void
+Ipv4OverlappingFragmentsTest::ReceiveFragment(const std::vector<uint8_t>& bytes,
+                                              uint16_t offset,
+                                              uint16_t size,
+                                              bool more)
+{
+    Ptr<Packet> fragment = Create<Packet>(bytes.data() + offset, size);
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("10.0.0.2"));
+    header.SetDestination(Ipv4Address("10.0.0.1"));
+    header.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+    header.SetIdentification(1);
+    header.SetTtl(64);
+    header.SetPayloadSize(size);
+    header.SetFragmentOffset(offset);
+    if (more)
+    {
+        header.SetMoreFragments();
+    }
+    else
+    {
+        header.SetLastFragment();
+    }
+    fragment->AddHeader(header);
+    m_ipv4->Receive(m_device,
+                    fragment,
+                    Ipv4L3Protocol::PROT_NUMBER,
+                    m_device->GetBroadcast(),
+                    m_device->GetAddress(),
+                    NetDevice::PACKET_HOST);
+}
+
+void
+Ipv4OverlappingFragmentsTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(node);
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetAddress(Mac48Address::ConvertFrom(Mac48Address::Allocate()));
+    node->AddDevice(device);
+    m_device = device;
+    m_ipv4 = node->GetObject<Ipv4L3Protocol>();
+    uint32_t netdev_idx = m_ipv4->AddInterface(device);
+    m_ipv4->AddAddress(netdev_idx, Ipv4InterfaceAddress("10.0.0.1", "255.255.255.0"));
+    m_ipv4->SetUp(netdev_idx);
+
+    Ptr<Socket> socket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
+    socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), 9));
+    socket->SetRecvCallback(MakeCallback(&Ipv4OverlappingFragmentsTest::HandleRead, this));
+
+    // A datagram of 1000 bytes, and a copy whose bytes all differ from it
+    std::vector<uint8_t> payload(992);
+    for (uint32_t i = 0; i < payload.size(); i++)
+    {
+        payload[i] = i % 251;
+    }
+    Ptr<Packet> datagram = Create<Packet>(payload.data(), payload.size());
+    UdpHeader udpHeader;
+    udpHeader.SetSourcePort(1234);
+    udpHeader.SetDestinationPort(9);
+    datagram->AddHeader(udpHeader);
+    std::vector<uint8_t> bytes(datagram->GetSize());
+    datagram->CopyData(bytes.data(), bytes.size());
+    std::vector<uint8_t> other(bytes.size());
+    std::transform(bytes.begin(), bytes.end(), other.begin(), [](uint8_t b) { return ~b; });
+
+    // The last fragment overlaps the bytes received before it, with other bytes
+    std::vector<uint8_t> mixed = bytes;
+    std::copy(other.begin() + 392, other.begin() + 408, mixed.begin() + 392);
+    std::copy(other.begin() + 600, other.begin() + 608, mixed.begin() + 600);
+
+    ReceiveFragment(bytes, 0, 400, true);
+    ReceiveFragment(other, 0, 400, true);
+    ReceiveFragment(bytes, 600, 400, false);
+    ReceiveFragment(bytes, 400, 8, true);
+    NS_TEST_EXPECT_MSG_EQ(m_received.size(), 0, "Datagram with a hole received");
+    ReceiveFragment(mixed, 392, 216, true);
+
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), 1, "Datagram not reassembled");
+    NS_TEST_ASSERT_MSG_EQ(m_received[0]->GetSize(), payload.size(), "Wrong size");
+    std::vector<uint8_t> received(payload.size());
+    m_received[0]->CopyData(received.data(), received.size());
+    for (uint32_t i = 0; i < payload.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(uint32_t(received[i]), uint32_t(payload[i]), "Byte " << i);
+    }
+
+    socket->Close();
+    m_ipv4 = nullptr;
+    m_device = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -591,6 +743,7 @@ Ipv4FragmentationTestSuite::Ipv4FragmentationTestSuite()
 {
     AddTestCase(new Ipv4FragmentationTest(false), TestCase::QUICK);
     AddTestCase(new Ipv4FragmentationTest(true), TestCase::QUICK);
+    AddTestCase(new Ipv4OverlappingFragmentsTest(), TestCase::QUICK);
 }
 
 static Ipv4FragmentationTestSuite
@@ -16,6 +16,9 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -31,6 +34,7 @@
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
@@ -38,9 +42,13 @@
 #include "ns3/socket-factory.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1319,543 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting parallel SPF test
+ *
+ * The routes of a grid of routers with point-to-point links, and of a LAN
+ * attached to one of them, are computed in several threads, and checked to
+ * be the same, in the same order, as the routes computed in a single thread.
+ */
+class ParallelSpfTest : public TestCase
+{
+  public:
+    ParallelSpfTest();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Describe the global routes of all the nodes
+     * \return one string per route, in the order of the routing tables
+     */
+    std::vector<std::string> GetRoutes() const;
+
+    static constexpr uint32_t SIZE = 6; //!< Number of rows and columns of the grid
+    NodeContainer m_nodes;              //!< Nodes used in the test.
+};
+
+ParallelSpfTest::ParallelSpfTest()
+    : TestCase("Global routing computed in parallel threads")
+{
+}
+
+void
+ParallelSpfTest::DoSetup()
+{
+    m_nodes.Create(SIZE * SIZE + 2);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.252");
+    for (uint32_t row = 0; row < SIZE; row++)
+    {
+        for (uint32_t col = 0; col < SIZE; col++)
+        {
+            Ptr<Node> node = m_nodes.Get(row * SIZE + col);
+            if (col + 1 < SIZE)
+            {
+                NodeContainer link(node, m_nodes.Get(row * SIZE + col + 1));
+                ipv4.Assign(simpleHelper.Install(link));
+                ipv4.NewNetwork();
+            }
+            if (row + 1 < SIZE)
+            {
+                NodeContainer link(node, m_nodes.Get((row + 1) * SIZE + col));
+                ipv4.Assign(simpleHelper.Install(link));
+                ipv4.NewNetwork();
+            }
+        }
+    }
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper lanHelper;
+    NetDeviceContainer lan = lanHelper.Install(m_nodes.Get(SIZE * SIZE - 1), channel);
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE * SIZE), channel));
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE * SIZE + 1), channel));
+    ipv4.SetBase("10.2.0.0", "255.255.255.0");
+    ipv4.Assign(lan);
+}
+
+std::vector<std::string>
+ParallelSpfTest::GetRoutes() const
+{
+    std::vector<std::string> routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> routing =
+            m_nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+        for (uint32_t j = 0; j < routing->GetNRoutes(); j++)
+        {
+            std::ostringstream oss;
+            oss << "node " << i << ": " << *routing->GetRoute(j);
+            routes.push_back(oss.str());
+        }
+    }
+    return routes;
+}
+
+void
+ParallelSpfTest::DoRun()
+{
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::vector<std::string> serial = GetRoutes();
+    // every router has a route to the 84 subnets but its own, and to the
+    // addresses of the other routers on point-to-point links
+    NS_TEST_ASSERT_MSG_GT(serial.size(), SIZE * SIZE * 100, "Too few routes");
+
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(4));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    std::vector<std::string> parallel = GetRoutes();
+    NS_TEST_ASSERT_MSG_EQ(parallel.size(), serial.size(), "Different number of routes");
+    for (std::size_t i = 0; i < serial.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(parallel[i], serial[i], "Different route");
+    }
+}
+
+void
+ParallelSpfTest::DoTeardown()
+{
+    Config::Reset();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting incremental SPF test
+ *
+ * The links of a grid of routers with point-to-point links and of two LANs
+ * are brought down and up, their metrics are changed, and external routes
+ * are injected and withdrawn.  The routes updated incrementally after each
+ * change are checked to be the same as the routes computed from scratch, and
+ * the equal-cost routes to each destination, of which the grid has many, to
+ * be listed in the same order.
+ */
+class IncrementalSpfTest : public TestCase
+{
+  public:
+    IncrementalSpfTest();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Describe the global routes of all the nodes
+     * \return one string per route, sorted by node and destination, the routes
+     * to a destination in the order of the routing table
+     */
+    std::vector<std::string> GetRoutes() const;
+
+    static constexpr uint32_t SIZE = 5; //!< Number of rows and columns of the grid
+    NodeContainer m_nodes;              //!< Nodes used in the test.
+};
+
+IncrementalSpfTest::IncrementalSpfTest()
+    : TestCase("Global routing updated incrementally")
+{
+}
+
+void
+IncrementalSpfTest::DoSetup()
+{
+    m_nodes.Create(SIZE * SIZE + 2);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.252");
+    for (uint32_t row = 0; row < SIZE; row++)
+    {
+        for (uint32_t col = 0; col < SIZE; col++)
+        {
+            Ptr<Node> node = m_nodes.Get(row * SIZE + col);
+            if (col + 1 < SIZE)
+            {
+                NodeContainer link(node, m_nodes.Get(row * SIZE + col + 1));
+                ipv4.Assign(simpleHelper.Install(link));
+                ipv4.NewNetwork();
+            }
+            if (row + 1 < SIZE)
+            {
+                NodeContainer link(node, m_nodes.Get((row + 1) * SIZE + col));
+                ipv4.Assign(simpleHelper.Install(link));
+                ipv4.NewNetwork();
+            }
+        }
+    }
+
+    // A transit LAN across the grid, and a LAN with two routers off the grid
+    SimpleNetDeviceHelper lanHelper;
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    NetDeviceContainer lan = lanHelper.Install(m_nodes.Get(0), channel);
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE + 2), channel));
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE * SIZE - 1), channel));
+    ipv4.SetBase("10.2.0.0", "255.255.255.0");
+    ipv4.Assign(lan);
+    channel = CreateObject<SimpleChannel>();
+    lan = lanHelper.Install(m_nodes.Get(SIZE - 1), channel);
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE * SIZE), channel));
+    lan.Add(lanHelper.Install(m_nodes.Get(SIZE * SIZE + 1), channel));
+    ipv4.SetBase("10.3.0.0", "255.255.255.0");
+    ipv4.Assign(lan);
+}
+
+std::vector<std::string>
+IncrementalSpfTest::GetRoutes() const
+{
+    // The node and the destination of the route, and the route
+    std::vector<std::pair<std::string, std::string>> routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> routing =
+            m_nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+        for (uint32_t j = 0; j < routing->GetNRoutes(); j++)
+        {
+            Ipv4RoutingTableEntry* route = routing->GetRoute(j);
+            std::ostringstream dest;
+            dest << "node " << i << ": " << route->GetDestNetwork() << "/"
+                 << route->GetDestNetworkMask().GetPrefixLength();
+            std::ostringstream oss;
+            oss << *route;
+            routes.emplace_back(dest.str(), oss.str());
+        }
+    }
+    std::stable_sort(routes.begin(), routes.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    std::vector<std::string> sorted;
+    for (const auto& [dest, route] : routes)
+    {
+        sorted.push_back(dest + " " + route);
+    }
+    return sorted;
+}
+
+void
+IncrementalSpfTest::DoRun()
+{
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::vector<std::string> initial = GetRoutes();
+
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        Ptr<Node> node = m_nodes.Get(rand->GetInteger(0, m_nodes.GetN() - 1));
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        uint32_t interface = rand->GetInteger(1, ipv4->GetNInterfaces() - 1);
+        switch (rand->GetInteger(0, 3))
+        {
+        case 0:
+        case 1:
+            if (ipv4->IsUp(interface))
+            {
+                ipv4->SetDown(interface);
+            }
+            else
+            {
+                ipv4->SetUp(interface);
+            }
+            break;
+        case 2:
+            ipv4->SetMetric(interface, rand->GetInteger(1, 3));
+            break;
+        default:
+            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
+            Ipv4Address network("192.168.0.0");
+            Ipv4Mask mask("255.255.255.0");
+            if (!router->WithdrawRoute(network, mask))
+            {
+                router->InjectRoute(network, mask);
+            }
+            break;
+        }
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+        if (i % 3 != 2)
+        {
+            continue;
+        }
+
+        std::vector<std::string> incremental = GetRoutes();
+        GlobalRouteManager::DeleteGlobalRoutes();
+        GlobalRouteManager::BuildGlobalRoutingDatabase();
+        GlobalRouteManager::InitializeRoutes();
+        std::vector<std::string> full = GetRoutes();
+        NS_TEST_ASSERT_MSG_EQ(incremental.size(), full.size(), "Different number of routes");
+        for (std::size_t j = 0; j < full.size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(incremental[j], full[j], "Different route");
+        }
+    }
+
+    // Restore the topology
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4> ipv4 = m_nodes.Get(i)->GetObject<Ipv4>();
+        for (uint32_t j = 1; j < ipv4->GetNInterfaces(); j++)
+        {
+            ipv4->SetUp(j);
+            ipv4->SetMetric(j, 1);
+        }
+        m_nodes.Get(i)->GetObject<GlobalRouter>()->WithdrawRoute("192.168.0.0", "255.255.255.0");
+    }
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    std::vector<std::string> restored = GetRoutes();
+    NS_TEST_ASSERT_MSG_EQ(restored.size(), initial.size(), "Different number of routes");
+    for (std::size_t j = 0; j < initial.size(); j++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(restored[j], initial[j], "Different route");
+    }
+}
+
+void
+IncrementalSpfTest::DoTeardown()
+{
+    Config::Reset();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting ECMP modes test
+ *
+ * A router has two equal-cost routes to a network.  UDP packets of many
+ * flows are forwarded, and the routes chosen are checked to be the same for
+ * all the packets of a flow with the FlowHash EcmpMode, in proportion to the
+ * weights of the routes, and to change only between the flowlets of a flow
+ * with the Flowlet EcmpMode.
+ */
+class EcmpModeTest : public TestCase
+{
+  public:
+    EcmpModeTest();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Forward a UDP packet to the network of the equal-cost routes
+     * \param sourcePort the source port of the packet
+     * \param size the size of the payload of the packet
+     * \return the output interface of the packet, or 0 if it is not forwarded
+     */
+    uint32_t Forward(uint16_t sourcePort, uint32_t size = 100);
+
+    /**
+     * \brief Forward the next packet of a flow, and record its output interface
+     * \param sourcePort the source port of the packet
+     */
+    void ForwardFlowPacket(uint16_t sourcePort);
+
+    /**
+     * \brief Forward the packets of many flows, with a source port each
+     * \param nFlows the number of flows
+     * \param interface an output interface
+     * \return the fraction of the flows forwarded on the interface
+     */
+    double GetFractionOfFlows(uint32_t nFlows, uint32_t interface);
+
+    NodeContainer m_nodes;                  //!< Nodes used in the test.
+    Ptr<Ipv4> m_ipv4;                       //!< IPv4 of the router
+    Ptr<Ipv4GlobalRouting> m_routing;       //!< Global routing of the router
+    std::vector<uint32_t> m_flowInterfaces; //!< Output interfaces of the packets of a flow
+};
+
+EcmpModeTest::EcmpModeTest()
+    : TestCase("Global routing ECMP by flow hash, weight and flowlet")
+{
+}
+
+void
+EcmpModeTest::DoSetup()
+{
+    // The router, the next hops of the two routes, and the source of the packets
+    m_nodes.Create(4);
+    InternetStackHelper internet;
+    internet.Install(m_nodes);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("192.168.1.0", "255.255.255.0");
+    for (uint32_t i = 1; i < m_nodes.GetN(); i++)
+    {
+        ipv4.Assign(simpleHelper.Install(NodeContainer(m_nodes.Get(0), m_nodes.Get(i))));
+        ipv4.NewNetwork();
+    }
+
+    m_ipv4 = m_nodes.Get(0)->GetObject<Ipv4>();
+    m_routing = CreateObject<Ipv4GlobalRouting>();
+    m_routing->SetIpv4(m_ipv4);
+    m_routing->AddNetworkRouteTo("10.0.0.0", "255.0.0.0", "192.168.1.2", 1);
+    m_routing->AddNetworkRouteTo("10.0.0.0", "255.0.0.0", "192.168.2.2", 2);
+}
+
+uint32_t
+EcmpModeTest::Forward(uint16_t sourcePort, uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    UdpHeader udpHeader;
+    udpHeader.SetSourcePort(sourcePort);
+    udpHeader.SetDestinationPort(9);
+    p->AddHeader(udpHeader);
+    Ipv4Header header;
+    header.SetSource("172.16.0.1");
+    header.SetDestination("10.1.2.3");
+    header.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+
+    uint32_t interface = 0;
+    Ipv4RoutingProtocol::UnicastForwardCallback ucb =
+        [this, &interface](Ptr<Ipv4Route> route, Ptr<const Packet>, const Ipv4Header&) {
+            interface = m_ipv4->GetInterfaceForDevice(route->GetOutputDevice());
+        };
+    m_routing->RouteInput(p,
+                          header,
+                          m_ipv4->GetNetDevice(3),
+                          ucb,
+                          Ipv4RoutingProtocol::MulticastForwardCallback(),
+                          Ipv4RoutingProtocol::LocalDeliverCallback(),
+                          Ipv4RoutingProtocol::ErrorCallback());
+    return interface;
+}
+
+void
+EcmpModeTest::ForwardFlowPacket(uint16_t sourcePort)
+{
+    m_flowInterfaces.push_back(Forward(sourcePort));
+}
+
+double
+EcmpModeTest::GetFractionOfFlows(uint32_t nFlows, uint32_t interface)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        n += Forward(10000 + i) == interface ? 1 : 0;
+    }
+    return static_cast<double>(n) / nFlows;
+}
+
+void
+EcmpModeTest::DoRun()
+{
+    const uint32_t nFlows = 2000;
+    NS_TEST_ASSERT_MSG_NE(m_routing->GetRoutesVersion(), 0, "Routes cannot be cached");
+
+    // All the packets of a flow take the same route, whatever their size
+    m_routing->SetAttribute("EcmpMode", EnumValue(Ipv4GlobalRouting::ECMP_FLOW_HASH));
+    NS_TEST_ASSERT_MSG_EQ(m_routing->GetRoutesVersion(), 0, "Routes can be cached");
+    std::vector<uint32_t> interfaces;
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        interfaces.push_back(Forward(10000 + i));
+        NS_TEST_ASSERT_MSG_EQ((interfaces.back() == 1 || interfaces.back() == 2),
+                              true,
+                              "Not forwarded");
+    }
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(Forward(10000 + i, 1000), interfaces[i], "Flow moved");
+    }
+    double fraction = GetFractionOfFlows(nFlows, 1);
+    NS_TEST_EXPECT_MSG_EQ_TOL(fraction, 0.5, 0.05, "Routes not used equally");
+
+    // The seed changes the route of some of the flows
+    m_routing->SetAttribute("EcmpHashSeed", UintegerValue(1));
+    uint32_t moved = 0;
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        moved += Forward(10000 + i) != interfaces[i] ? 1 : 0;
+    }
+    NS_TEST_EXPECT_MSG_GT(moved, nFlows / 4, "Seed not hashed");
+
+    // The flows are shared in proportion to the weights of the routes
+    m_routing->SetEcmpWeight(1, 3);
+    NS_TEST_ASSERT_MSG_EQ(m_routing->GetEcmpWeight(1), 3, "Wrong weight");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->GetEcmpWeight(2), 1, "Wrong default weight");
+    fraction = GetFractionOfFlows(nFlows, 1);
+    NS_TEST_EXPECT_MSG_EQ_TOL(fraction, 0.75, 0.05, "Routes not used by weight");
+    m_routing->SetEcmpWeight(2, 0);
+    fraction = GetFractionOfFlows(nFlows, 1);
+    NS_TEST_EXPECT_MSG_EQ(fraction, 1, "Route of weight 0 used");
+    m_routing->SetEcmpWeight(1, 1);
+    m_routing->SetEcmpWeight(2, 1);
+
+    // The packets of a flow take the same route within a flowlet, and the
+    // flowlets take both routes
+    m_routing->SetAttribute("EcmpMode", EnumValue(Ipv4GlobalRouting::ECMP_FLOWLET));
+    m_routing->SetAttribute("FlowletGap", TimeValue(MicroSeconds(500)));
+    const uint32_t nFlowlets = 50;
+    const uint32_t nPackets = 20;
+    for (uint32_t i = 0; i < nFlowlets; i++)
+    {
+        for (uint32_t j = 0; j < nPackets; j++)
+        {
+            Simulator::Schedule(MilliSeconds(10 * i) + MicroSeconds(100 * j),
+                                &EcmpModeTest::ForwardFlowPacket,
+                                this,
+                                10000);
+        }
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_flowInterfaces.size(), nFlowlets * nPackets, "Packets missing");
+    uint32_t changes = 0;
+    for (uint32_t i = 0; i < nFlowlets; i++)
+    {
+        for (uint32_t j = 1; j < nPackets; j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(m_flowInterfaces[i * nPackets + j],
+                                  m_flowInterfaces[i * nPackets],
+                                  "Flow moved within a flowlet");
+        }
+        if (i > 0)
+        {
+            changes += m_flowInterfaces[i * nPackets] != m_flowInterfaces[(i - 1) * nPackets];
+        }
+    }
+    NS_TEST_EXPECT_MSG_GT(changes, 0, "Flowlets always on the same route");
+    NS_TEST_EXPECT_MSG_LT(changes, nFlowlets - 1, "Flowlets never on the same route");
+}
+
+void
+EcmpModeTest::DoTeardown()
+{
+    m_routing->Dispose();
+    m_routing = nullptr;
+    m_ipv4 = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1878,9 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new ParallelSpfTest, TestCase::QUICK);
+    AddTestCase(new IncrementalSpfTest, TestCase::QUICK);
+    AddTestCase(new EcmpModeTest, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
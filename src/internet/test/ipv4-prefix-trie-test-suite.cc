@@ -0,0 +1,235 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-prefix-trie.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <iterator>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4PrefixTrie Test
+ *
+ * Random prefixes, some of them nested or duplicated and some with a
+ * non-contiguous mask, are inserted in the trie, and the lookup of random
+ * destinations is checked against a scan of all the prefixes.
+ */
+class Ipv4PrefixTrieTestCase : public TestCase
+{
+  public:
+    Ipv4PrefixTrieTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4PrefixTrieTestCase::Ipv4PrefixTrieTestCase()
+    : TestCase("Lookup of random prefixes in a trie")
+{
+}
+
+void
+Ipv4PrefixTrieTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    const uint8_t lengths[] = {0, 8, 16, 20, 24, 24, 24, 30, 30, 32, 32};
+    std::vector<std::pair<Ipv4Address, Ipv4Mask>> prefixes;
+    Ipv4PrefixTrie trie;
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), true, "New trie not empty");
+
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        // Draw the prefixes in a few /8s, so that they nest
+        uint32_t address = (rand->GetInteger(10, 13) << 24) | rand->GetInteger(0, 0xffffff);
+        Ipv4Mask mask;
+        if (i % 100 == 99)
+        {
+            mask = Ipv4Mask(0xff00ff00); // non-contiguous
+        }
+        else if (i % 10 == 9 && !prefixes.empty())
+        {
+            mask = prefixes[rand->GetInteger(0, prefixes.size() - 1)].second; // duplicate
+            address = prefixes[rand->GetInteger(0, prefixes.size() - 1)].first.Get();
+        }
+        else
+        {
+            uint8_t length = lengths[rand->GetInteger(0, std::size(lengths) - 1)];
+            mask = Ipv4Mask(length == 0 ? 0 : 0xffffffff << (32 - length));
+        }
+        prefixes.emplace_back(Ipv4Address(address), mask);
+        trie.Insert(Ipv4Address(address), mask, i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), false, "Trie empty");
+
+    std::vector<uint32_t> positions;
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        uint32_t address = (rand->GetInteger(9, 13) << 24) | rand->GetInteger(0, 0xffffff);
+        if (i % 2)
+        {
+            // Look for an address in one of the prefixes
+            const auto& prefix = prefixes[rand->GetInteger(0, prefixes.size() - 1)];
+            address = (prefix.first.Get() & prefix.second.Get()) | (address & ~prefix.second.Get());
+        }
+        Ipv4Address dest(address);
+        std::vector<uint32_t> expected;
+        for (uint32_t j = 0; j < prefixes.size(); j++)
+        {
+            if (prefixes[j].second.IsMatch(dest, prefixes[j].first))
+            {
+                expected.push_back(j);
+            }
+        }
+        trie.Lookup(dest, positions);
+        NS_TEST_ASSERT_MSG_EQ(positions.size(), expected.size(), "Wrong number of matches");
+        for (uint32_t j = 0; j < expected.size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(positions[j], expected[j], "Wrong match for " << dest);
+        }
+    }
+
+    trie.Clear();
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), true, "Cleared trie not empty");
+    trie.Lookup(Ipv4Address("10.0.0.1"), positions);
+    NS_TEST_ASSERT_MSG_EQ(positions.empty(), true, "Match in an empty trie");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4StaticRouting lookup Test
+ *
+ * The route chosen by Ipv4StaticRouting is checked to have the longest
+ * prefix, then the lowest metric, and to be the last one added among the
+ * routes of equal metric, as the routes are added and removed.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the gateway of the route to a destination.
+     * \param dest the destination
+     * \param oif the output device, if any
+     * \return the gateway, or 255.255.255.255 if there is no route
+     */
+    Ipv4Address GetGateway(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
+
+    Ptr<Ipv4StaticRouting> m_routing; //!< Static routing under test
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase()
+    : TestCase("Lookup of the static routes")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLookupTestCase::GetGateway(Ipv4Address dest, Ptr<NetDevice> oif)
+{
+    Ipv4Header header;
+    header.SetDestination(dest);
+    Socket::SocketErrno err;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(Create<Packet>(), header, oif, err);
+    return route ? route->GetGateway() : Ipv4Address::GetBroadcast();
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simple;
+    NetDeviceContainer devices = simple.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    devices.Add(simple.Install(NodeContainer(nodes.Get(0), nodes.Get(2))));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("192.168.1.0", "255.255.255.0");
+    ipv4.Assign(NetDeviceContainer(devices.Get(0), devices.Get(1)));
+    ipv4.SetBase("192.168.2.0", "255.255.255.0");
+    ipv4.Assign(NetDeviceContainer(devices.Get(2), devices.Get(3)));
+
+    Ipv4StaticRoutingHelper helper;
+    m_routing = helper.GetStaticRouting(nodes.Get(0)->GetObject<Ipv4>());
+    uint32_t nRoutes = m_routing->GetNRoutes();
+
+    m_routing->AddNetworkRouteTo("10.0.0.0", "255.0.0.0", "192.168.1.8", 1, 5);
+    m_routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "192.168.1.16", 1, 10);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.1.16"), "Not longest");
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.2.2.3"), Ipv4Address("192.168.1.8"), "Not matching");
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("11.1.2.3"), Ipv4Address::GetBroadcast(), "Unexpected");
+
+    m_routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "192.168.2.16", 2, 10);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.2.16"), "Not last");
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3", devices.Get(0)),
+                          Ipv4Address("192.168.1.16"),
+                          "Not on the output device");
+
+    m_routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "192.168.2.32", 2, 1);
+    m_routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "192.168.1.32", 1, 20);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.2.32"), "Not lowest");
+
+    m_routing->SetDefaultRoute("192.168.1.1", 1);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("11.1.2.3"), Ipv4Address("192.168.1.1"), "Not default");
+
+    m_routing->RemoveRoute(nRoutes + 3);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.2.16"), "Not removed");
+    m_routing->RemoveRoute(nRoutes + 2);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.1.16"), "Not removed");
+
+    m_routing->AddHostRouteTo("10.1.2.3", "192.168.2.64", 2, 30);
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.3"), Ipv4Address("192.168.2.64"), "Not host");
+    NS_TEST_ASSERT_MSG_EQ(GetGateway("10.1.2.4"), Ipv4Address("192.168.1.16"), "Host route");
+
+    m_routing = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4PrefixTrie TestSuite
+ */
+class Ipv4PrefixTrieTestSuite : public TestSuite
+{
+  public:
+    Ipv4PrefixTrieTestSuite();
+};
+
+Ipv4PrefixTrieTestSuite::Ipv4PrefixTrieTestSuite()
+    : TestSuite("ipv4-prefix-trie", UNIT)
+{
+    AddTestCase(new Ipv4PrefixTrieTestCase(), TestCase::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLookupTestCase(), TestCase::QUICK);
+}
+
+static Ipv4PrefixTrieTestSuite
+    g_ipv4PrefixTrieTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,306 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Routing protocol counting its lookups
+ *
+ * All the packets are forwarded on the interface 2, and the version of the
+ * routes is set by the test.
+ */
+class CountingRouting : public Ipv4RoutingProtocol
+{
+  public:
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override;
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv4Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override;
+
+    void NotifyInterfaceUp(uint32_t interface) override
+    {
+    }
+
+    void NotifyInterfaceDown(uint32_t interface) override
+    {
+    }
+
+    void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) override
+    {
+    }
+
+    void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) override
+    {
+    }
+
+    void SetIpv4(Ptr<Ipv4> ipv4) override
+    {
+        m_ipv4 = ipv4;
+    }
+
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
+                           Time::Unit unit = Time::S) const override
+    {
+    }
+
+    uint64_t GetRoutesVersion() const override
+    {
+        return m_version;
+    }
+
+    uint32_t m_inputs{0};  //!< Number of RouteInput calls
+    uint32_t m_outputs{0}; //!< Number of RouteOutput calls
+    uint64_t m_version{1}; //!< Version of the routes
+
+  private:
+    /**
+     * \brief Build the route to a destination
+     * \param dest the destination
+     * \return the route
+     */
+    Ptr<Ipv4Route> MakeRoute(Ipv4Address dest) const;
+
+    Ptr<Ipv4> m_ipv4; //!< IPv4 of the node
+};
+
+Ptr<Ipv4Route>
+CountingRouting::MakeRoute(Ipv4Address dest) const
+{
+    Ptr<Ipv4Route> route = Create<Ipv4Route>();
+    route->SetDestination(dest);
+    route->SetGateway(Ipv4Address::GetZero());
+    route->SetSource(m_ipv4->GetAddress(2, 0).GetLocal());
+    route->SetOutputDevice(m_ipv4->GetNetDevice(2));
+    return route;
+}
+
+Ptr<Ipv4Route>
+CountingRouting::RouteOutput(Ptr<Packet> p,
+                             const Ipv4Header& header,
+                             Ptr<NetDevice> oif,
+                             Socket::SocketErrno& sockerr)
+{
+    m_outputs++;
+    sockerr = Socket::ERROR_NOTERROR;
+    return MakeRoute(header.GetDestination());
+}
+
+bool
+CountingRouting::RouteInput(Ptr<const Packet> p,
+                            const Ipv4Header& header,
+                            Ptr<const NetDevice> idev,
+                            const UnicastForwardCallback& ucb,
+                            const MulticastForwardCallback& mcb,
+                            const LocalDeliverCallback& lcb,
+                            const ErrorCallback& ecb)
+{
+    m_inputs++;
+    ucb(MakeRoute(header.GetDestination()), p, header);
+    return true;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4L3Protocol route cache Test
+ *
+ * The packets received by a router are checked to be routed once per
+ * destination, until the routes, the interfaces or the addresses change,
+ * and on every packet if the routing protocol has no version or the cache is
+ * disabled.
+ */
+class Ipv4RouteCacheTestCase : public TestCase
+{
+  public:
+    Ipv4RouteCacheTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the routes looked up, once the simulation started
+     */
+    void CheckCache();
+
+    /**
+     * \brief Receive a packet on the interface 1 of the router
+     * \param dest the destination of the packet
+     */
+    void ReceivePacket(Ipv4Address dest);
+
+    /**
+     * \brief Count a forwarded packet
+     * \param header the IPv4 header
+     * \param packet the packet
+     * \param interface the input interface
+     */
+    void Forwarded(const Ipv4Header& header, Ptr<const Packet> packet, uint32_t interface);
+
+    Ptr<Ipv4L3Protocol> m_ipv4;     //!< IPv4 of the router
+    Ptr<NetDevice> m_device;        //!< Device of the interface 1 of the router
+    Ptr<CountingRouting> m_routing; //!< Routing protocol of the router
+    uint32_t m_forwarded{0};        //!< Number of packets forwarded
+};
+
+Ipv4RouteCacheTestCase::Ipv4RouteCacheTestCase()
+    : TestCase("Cache of the forwarded routes")
+{
+}
+
+void
+Ipv4RouteCacheTestCase::ReceivePacket(Ipv4Address dest)
+{
+    Ptr<Packet> packet = Create<Packet>(100);
+    Ipv4Header header;
+    header.SetSource("10.1.1.1");
+    header.SetDestination(dest);
+    header.SetProtocol(17);
+    header.SetPayloadSize(packet->GetSize());
+    header.SetTtl(64);
+    packet->AddHeader(header);
+    m_ipv4->Receive(m_device,
+                    packet,
+                    Ipv4L3Protocol::PROT_NUMBER,
+                    m_device->GetBroadcast(),
+                    m_device->GetAddress(),
+                    NetDevice::PACKET_HOST);
+}
+
+void
+Ipv4RouteCacheTestCase::Forwarded(const Ipv4Header& header,
+                                  Ptr<const Packet> packet,
+                                  uint32_t interface)
+{
+    m_forwarded++;
+}
+
+void
+Ipv4RouteCacheTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices = simple.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    devices.Add(simple.Install(NodeContainer(nodes.Get(0), nodes.Get(2))));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    ipv4.Assign(NetDeviceContainer(devices.Get(0), devices.Get(1)));
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    ipv4.Assign(NetDeviceContainer(devices.Get(2), devices.Get(3)));
+
+    m_ipv4 = nodes.Get(0)->GetObject<Ipv4L3Protocol>();
+    m_device = devices.Get(0);
+    m_routing = CreateObject<CountingRouting>();
+    m_ipv4->SetRoutingProtocol(m_routing);
+    m_ipv4->TraceConnectWithoutContext("UnicastForward",
+                                       MakeCallback(&Ipv4RouteCacheTestCase::Forwarded, this));
+
+    Simulator::Schedule(Seconds(1), &Ipv4RouteCacheTestCase::CheckCache, this);
+    Simulator::Run();
+    m_ipv4 = nullptr;
+    m_device = nullptr;
+    m_routing = nullptr;
+    Simulator::Destroy();
+}
+
+void
+Ipv4RouteCacheTestCase::CheckCache()
+{
+    ReceivePacket("10.2.0.1");
+    ReceivePacket("10.2.0.1");
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 3, "Packets not forwarded");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 1, "Route not cached");
+    ReceivePacket("10.2.0.2");
+    ReceivePacket("10.2.0.2");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 2, "Route not cached by destination");
+
+    m_routing->m_version++;
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 3, "Cache not flushed on a new version");
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 3, "Route not cached in the new version");
+
+    m_ipv4->SetMetric(2, 10);
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 4, "Cache not flushed on an interface change");
+    m_ipv4->AddAddress(2, Ipv4InterfaceAddress("10.1.3.1", "255.255.255.0"));
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 5, "Cache not flushed on a new address");
+
+    m_routing->m_version = 0;
+    ReceivePacket("10.2.0.1");
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 7, "Route cached without a version");
+
+    m_routing->m_version = 10;
+    m_ipv4->SetAttribute("RouteCacheSize", UintegerValue(0));
+    ReceivePacket("10.2.0.1");
+    ReceivePacket("10.2.0.1");
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_inputs, 9, "Route cached by a disabled cache");
+    NS_TEST_ASSERT_MSG_EQ(m_forwarded, 13, "Packets not forwarded");
+
+    // Packets sent without a route
+    m_ipv4->SetAttribute("RouteCacheSize", UintegerValue(1024));
+    Ipv4Address source = m_ipv4->GetAddress(2, 0).GetLocal();
+    m_ipv4->Send(Create<Packet>(100), source, "10.2.0.1", 17, nullptr);
+    m_ipv4->Send(Create<Packet>(100), source, "10.2.0.1", 17, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_outputs, 1, "Output route not cached");
+    m_routing->m_version++;
+    m_ipv4->Send(Create<Packet>(100), source, "10.2.0.1", 17, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(m_routing->m_outputs, 2, "Output cache not flushed");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4L3Protocol route cache TestSuite
+ */
+class Ipv4RouteCacheTestSuite : public TestSuite
+{
+  public:
+    Ipv4RouteCacheTestSuite();
+};
+
+Ipv4RouteCacheTestSuite::Ipv4RouteCacheTestSuite()
+    : TestSuite("ipv4-route-cache", UNIT)
+{
+    AddTestCase(new Ipv4RouteCacheTestCase(), TestCase::QUICK);
+}
+
+static Ipv4RouteCacheTestSuite
+    g_ipv4RouteCacheTestSuite; //!< Static variable for test initialization
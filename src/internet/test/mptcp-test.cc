@@ -0,0 +1,373 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mptcp-scheduler.h"
+#include "ns3/mptcp-socket.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-bbr.h"
+#include "ns3/tcp-cubic.h"
+#include "ns3/tcp-lia.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a transfer over two subflows of heterogeneous paths.
+ *
+ * The client and the server are connected by two links, of 10 Mbps and
+ * 10 ms RTT and of 5 Mbps and 50 ms RTT, and the client opens a subflow on
+ * each. The server is checked to receive the byte stream intact, both
+ * subflows to carry data, and the transfer to complete faster than the
+ * fastest link alone could.
+ *
+ * With a transmission buffer of the subflows holding a whole number of
+ * segments, the buffers are full when the client closes the connection, and
+ * its DATA_FIN waits for room in them.
+ */
+class MpTcpTransferTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param scheduler the type of the packet scheduler
+     * \param congestion1 the congestion control of the first subflow
+     * \param congestion2 the congestion control of the second subflow
+     * \param subflowSndBuf the transmission buffer of the subflows, in segments
+     * (zero for the default of TcpSocket)
+     */
+    MpTcpTransferTestCase(TypeId scheduler,
+                          TypeId congestion1,
+                          TypeId congestion2,
+                          uint32_t subflowSndBuf = 0);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Check the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Close the connection once the client has closed it.
+     * \param s the socket
+     */
+    void ServerPeerClosed(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+
+    TypeId m_scheduler;                        //!< Type of the packet scheduler
+    TypeId m_congestion1;                      //!< Congestion control of the first subflow
+    TypeId m_congestion2;                      //!< Congestion control of the second subflow
+    uint32_t m_subflowSndBuf;                  //!< Transmission buffer of the subflows
+    static constexpr uint32_t TOTAL = 2000000; //!< Bytes to transfer
+    uint32_t m_sent{0};                        //!< Bytes queued by the client
+    uint32_t m_received{0};                    //!< Bytes received by the server
+    uint32_t m_corrupted{0};                   //!< Bytes received with a wrong value
+    Time m_completed;                          //!< Time the last byte was received
+    bool m_closed{false};                      //!< Whether the server saw the close
+    Ptr<Socket> m_serverSocket;                //!< The connection accepted by the server
+};
+
+MpTcpTransferTestCase::MpTcpTransferTestCase(TypeId scheduler,
+                                             TypeId congestion1,
+                                             TypeId congestion2,
+                                             uint32_t subflowSndBuf)
+    : TestCase("Check a multipath transfer with " + scheduler.GetName() + ", " +
+               congestion1.GetName() + " and " + congestion2.GetName() +
+               (subflowSndBuf ? ", subflow buffers of " + std::to_string(subflowSndBuf) +
+                                    " segments"
+                              : "")),
+      m_scheduler(scheduler),
+      m_congestion1(congestion1),
+      m_congestion2(congestion2),
+      m_subflowSndBuf(subflowSndBuf)
+{
+}
+
+void
+MpTcpTransferTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    m_serverSocket = s;
+    s->SetRecvCallback(MakeCallback(&MpTcpTransferTestCase::ServerRecv, this));
+    s->SetCloseCallbacks(MakeCallback(&MpTcpTransferTestCase::ServerPeerClosed, this),
+                         MakeNullCallback<void, Ptr<Socket>>());
+}
+
+void
+MpTcpTransferTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        std::vector<uint8_t> data(p->GetSize());
+        p->CopyData(data.data(), data.size());
+        for (uint8_t byte : data)
+        {
+            if (byte != m_received++ % 251)
+            {
+                m_corrupted++;
+            }
+        }
+    }
+    if (m_received == TOTAL)
+    {
+        m_completed = Simulator::Now();
+    }
+}
+
+void
+MpTcpTransferTestCase::ServerPeerClosed(Ptr<Socket> s)
+{
+    m_closed = true;
+    s->Close();
+}
+
+void
+MpTcpTransferTestCase::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (m_sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        std::vector<uint8_t> data(std::min(TOTAL - m_sent, s->GetTxAvailable()));
+        for (auto& byte : data)
+        {
+            byte = m_sent++ % 251;
+        }
+        s->Send(Create<Packet>(data.data(), data.size()));
+    }
+    if (m_sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+void
+MpTcpTransferTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    NetDeviceContainer fast = simple.Install(nodes);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("5Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(25)));
+    NetDeviceContainer slow = simple.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer fastInterfaces = ipv4.Assign(fast);
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer slowInterfaces = ipv4.Assign(slow);
+
+    Ptr<MpTcpSocket> server = CreateObject<MpTcpSocket>();
+    server->SetNode(nodes.Get(1));
+    server->SetAttribute("SchedulerType", TypeIdValue(m_scheduler));
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&MpTcpTransferTestCase::ServerAccept, this));
+
+    Ptr<MpTcpSocket> client = CreateObject<MpTcpSocket>();
+    client->SetNode(nodes.Get(0));
+    client->SetAttribute("SchedulerType", TypeIdValue(m_scheduler));
+    client->SetAttribute("SndBufSize", UintegerValue(TOTAL));
+    client->SetAttribute("DataWindow", UintegerValue(TOTAL));
+    Ptr<MpTcpSubflow> subflow1 =
+        client->AddSubflow(InetSocketAddress(fastInterfaces.GetAddress(0)),
+                           InetSocketAddress(fastInterfaces.GetAddress(1), 80),
+                           m_congestion1);
+    Ptr<MpTcpSubflow> subflow2 =
+        client->AddSubflow(InetSocketAddress(slowInterfaces.GetAddress(0)),
+                           InetSocketAddress(slowInterfaces.GetAddress(1), 80),
+                           m_congestion2);
+    if (m_subflowSndBuf)
+    {
+        for (const auto& subflow : {subflow1, subflow2})
+        {
+            subflow->GetSocket()->SetAttribute(
+                "SndBufSize",
+                UintegerValue(m_subflowSndBuf * subflow->GetSegmentSize()));
+        }
+    }
+    client->SetSendCallback(MakeCallback(&MpTcpTransferTestCase::ClientSend, this));
+    Simulator::Schedule(Seconds(1),
+                        &Socket::Connect,
+                        client,
+                        InetSocketAddress(fastInterfaces.GetAddress(1), 80));
+
+    Simulator::Stop(Seconds(20));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, TOTAL, "The server did not receive all the data");
+    NS_TEST_EXPECT_MSG_EQ(m_corrupted, 0, "The server received corrupted or reordered data");
+    NS_TEST_EXPECT_MSG_EQ(m_closed, true, "The server did not see the end of the data");
+    NS_TEST_EXPECT_MSG_EQ(subflow1->GetDataSent() + subflow2->GetDataSent(),
+                          TOTAL,
+                          "The subflows did not send the data exactly once");
+    NS_TEST_EXPECT_MSG_GT(subflow1->GetDataSent(), 0, "The fast subflow did not send data");
+    NS_TEST_EXPECT_MSG_GT(subflow2->GetDataSent(), 0, "The slow subflow did not send data");
+    // The fast link alone needs 1.6 s, without the headers and the slow start
+    NS_TEST_EXPECT_MSG_LT(m_completed - Seconds(1),
+                          Seconds(1.6),
+                          "The transfer was not faster than over the fast link alone");
+}
+
+void
+MpTcpTransferTestCase::DoTeardown()
+{
+    m_serverSocket = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the coupled increase of TcpLia.
+ *
+ * Two subflows, of different congestion windows and RTTs, are coupled; the
+ * increase of their congestion windows in congestion avoidance is checked
+ * against RFC 6356, and against TcpNewReno once uncoupled.
+ */
+class TcpLiaTestCase : public TestCase
+{
+  public:
+    TcpLiaTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create the congestion state of a subflow in congestion avoidance
+     * \param cWnd the congestion window
+     * \param rtt the smoothed RTT
+     * \return the congestion state
+     */
+    static Ptr<TcpSocketState> CreateState(uint32_t cWnd, Time rtt);
+};
+
+TcpLiaTestCase::TcpLiaTestCase()
+    : TestCase("Check the coupled increase of TcpLia")
+{
+}
+
+Ptr<TcpSocketState>
+TcpLiaTestCase::CreateState(uint32_t cWnd, Time rtt)
+{
+    Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState>();
+    tcb->m_segmentSize = 1000;
+    tcb->m_cWnd = cWnd;
+    tcb->m_ssThresh = 1000;
+    tcb->m_lastRtt = rtt;
+    return tcb;
+}
+
+void
+TcpLiaTestCase::DoRun()
+{
+    Ptr<TcpSocketState> tcb1 = CreateState(20000, MilliSeconds(10));
+    Ptr<TcpSocketState> tcb2 = CreateState(40000, MilliSeconds(50));
+    Ptr<TcpLiaCoupling> coupling = Create<TcpLiaCoupling>();
+    Ptr<TcpLia> lia1 = CreateObject<TcpLia>();
+    Ptr<TcpLia> lia2 = CreateObject<TcpLia>();
+    lia1->SetCoupling(coupling);
+    lia1->Init(tcb1);
+    lia2->Init(tcb2);
+    lia2->SetCoupling(coupling);
+    NS_TEST_ASSERT_MSG_EQ(coupling->GetSubflows().size(), 2, "Subflows not coupled");
+
+    // alpha = 60000 * max(20000 / 0.01^2, 40000 / 0.05^2) / (20000 / 0.01 + 40000 / 0.05)^2
+    double alpha = 60000.0 * (20000 / 1e-4) / ((2e6 + 8e5) * (2e6 + 8e5));
+    uint32_t expected1 = 20000 + std::min(alpha * 1e6 / 60000, 1e6 / 20000);
+    uint32_t expected2 = 40000 + std::min(alpha * 1e6 / 60000, 1e6 / 40000);
+    lia1->IncreaseWindow(tcb1, 1);
+    NS_TEST_EXPECT_MSG_EQ(tcb1->m_cWnd.Get(), expected1, "Wrong coupled increase");
+    tcb1->m_cWnd = 20000;
+    lia2->IncreaseWindow(tcb2, 1);
+    NS_TEST_EXPECT_MSG_EQ(tcb2->m_cWnd.Get(), expected2, "Wrong coupled increase");
+    NS_TEST_EXPECT_MSG_LT(expected1 - 20000, 1e6 / 20000, "The increase was not coupled");
+
+    // Once alone, the subflow increases its window as TcpNewReno
+    lia2 = nullptr;
+    NS_TEST_ASSERT_MSG_EQ(coupling->GetSubflows().size(), 1, "Subflow not uncoupled");
+    lia1->IncreaseWindow(tcb1, 1);
+    NS_TEST_EXPECT_MSG_EQ(tcb1->m_cWnd.Get(), 20000 + 1e6 / 20000, "Not a NewReno increase");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Multipath TCP TestSuite
+ */
+class MpTcpTestSuite : public TestSuite
+{
+  public:
+    MpTcpTestSuite();
+};
+
+MpTcpTestSuite::MpTcpTestSuite()
+    : TestSuite("mptcp", UNIT)
+{
+    AddTestCase(new TcpLiaTestCase(), TestCase::QUICK);
+    AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                          TcpLia::GetTypeId(),
+                                          TcpLia::GetTypeId()),
+                TestCase::QUICK);
+    AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerRoundRobin::GetTypeId(),
+                                          TcpLia::GetTypeId(),
+                                          TcpLia::GetTypeId()),
+                TestCase::QUICK);
+    AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerBlest::GetTypeId(),
+                                          TcpLia::GetTypeId(),
+                                          TcpLia::GetTypeId()),
+                TestCase::QUICK);
+    AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                          TcpCubic::GetTypeId(),
+                                          TcpBbr::GetTypeId()),
+                TestCase::QUICK);
+    AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                          TcpLia::GetTypeId(),
+                                          TcpLia::GetTypeId(),
+                                          64),
+                TestCase::QUICK);
+}
+
+static MpTcpTestSuite g_mpTcpTestSuite; //!< Static variable for test initialization
@@ -17,6 +17,7 @@
  * Author: Zhiheng Dong <dzh2077@gmail.com>
  */
 
+#include "ns3/arp-cache.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -26,6 +27,8 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/ipv6-routing-helper.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ndisc-cache.h"
 #include "ns3/neighbor-cache-helper.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
@@ -37,6 +40,10 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -1221,6 +1228,346 @@ DynamicPartialTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Neighbor Cache Index Test
+ *
+ * Entries are added to an ARP cache and to an NDISC cache in a shuffled
+ * order, several of them with the same MAC address, and the lookups by IP
+ * and by MAC address are checked as the MAC addresses of the entries change
+ * and the entries are removed.  The reachable timer of an NDISC entry is
+ * checked to expire after the last reachability confirmation.
+ */
+class CacheIndexTest : public TestCase
+{
+  public:
+    void DoRun() override;
+    CacheIndexTest();
+
+  private:
+    /**
+     * \brief Check the IPv4 addresses of the ARP entries of a MAC address.
+     * \param arp the ARP cache
+     * \param mac the MAC address
+     * \param expected the IPv4 addresses, sorted
+     */
+    void CheckInverse(Ptr<ArpCache> arp, Address mac, const std::vector<Ipv4Address>& expected);
+
+    /**
+     * \brief Record the state of an NDISC entry.
+     * \param entry the entry
+     */
+    void RecordReachable(NdiscCache::Entry* entry);
+
+    std::vector<bool> m_reachable; //!< Whether the NDISC entry was reachable, at each check
+};
+
+CacheIndexTest::CacheIndexTest()
+    : TestCase("The CacheIndexTest checks the lookups of the ARP and NDISC cache entries by IP "
+               "and MAC address.")
+{
+}
+
+void
+CacheIndexTest::CheckInverse(Ptr<ArpCache> arp,
+                             Address mac,
+                             const std::vector<Ipv4Address>& expected)
+{
+    std::list<ArpCache::Entry*> entries = arp->LookupInverse(mac);
+    NS_TEST_ASSERT_MSG_EQ(entries.size(), expected.size(), "Wrong number of entries of " << mac);
+    auto address = expected.begin();
+    for (ArpCache::Entry* entry : entries)
+    {
+        NS_TEST_EXPECT_MSG_EQ(entry->GetIpv4Address(), *address, "Wrong entry of " << mac);
+        NS_TEST_EXPECT_MSG_EQ(entry->GetMacAddress(), mac, "Wrong MAC address");
+        address++;
+    }
+}
+
+void
+CacheIndexTest::RecordReachable(NdiscCache::Entry* entry)
+{
+    m_reachable.push_back(entry->IsReachable());
+}
+
+void
+CacheIndexTest::DoRun()
+{
+    const uint32_t nEntries = 200;
+    const uint32_t nMacs = 50;
+    std::vector<uint32_t> order(nEntries);
+    for (uint32_t i = 0; i < nEntries; i++)
+    {
+        order[i] = (i * 73) % nEntries; // shuffled, as 73 and 200 are coprime
+    }
+    auto macOf = [](uint32_t i) {
+        uint8_t buffer[6] = {0, 0, 0, 0, 1, static_cast<uint8_t>(i % nMacs)};
+        Mac48Address mac;
+        mac.CopyFrom(buffer);
+        return Address(mac);
+    };
+    auto ipv6Of = [](uint32_t i) {
+        return Ipv6Address(("2001:db8::" + std::to_string(i + 1)).c_str());
+    };
+
+    Ptr<ArpCache> arp = CreateObject<ArpCache>();
+    arp->SetDevice(CreateObject<SimpleNetDevice>(), nullptr);
+    for (uint32_t i : order)
+    {
+        ArpCache::Entry* entry = arp->Add(Ipv4Address(0x0a000001 + i));
+        entry->SetMacAddress(macOf(i));
+        entry->MarkAutoGenerated();
+    }
+    for (uint32_t i = 0; i < nEntries; i++)
+    {
+        ArpCache::Entry* entry = arp->Lookup(Ipv4Address(0x0a000001 + i));
+        NS_TEST_ASSERT_MSG_NE(entry, nullptr, "Entry not found");
+        NS_TEST_EXPECT_MSG_EQ(entry->GetIpv4Address(), Ipv4Address(0x0a000001 + i), "Wrong entry");
+    }
+    NS_TEST_EXPECT_MSG_EQ(arp->Lookup(Ipv4Address(0x0a000001 + nEntries)), nullptr, "Found");
+    CheckInverse(arp,
+                 macOf(3),
+                 {Ipv4Address(0x0a000004),
+                  Ipv4Address(0x0a000036),
+                  Ipv4Address(0x0a000068),
+                  Ipv4Address(0x0a00009a)});
+
+    // An entry moved to another MAC address
+    arp->Lookup(Ipv4Address(0x0a000036))->SetMacAddress(macOf(4));
+    CheckInverse(arp, macOf(3), {Ipv4Address(0x0a000004), Ipv4Address(0x0a000068),
+                                 Ipv4Address(0x0a00009a)});
+    CheckInverse(arp,
+                 macOf(4),
+                 {Ipv4Address(0x0a000005),
+                  Ipv4Address(0x0a000036),
+                  Ipv4Address(0x0a000037),
+                  Ipv4Address(0x0a000069),
+                  Ipv4Address(0x0a00009b)});
+
+    // The entries are printed in the order of their addresses
+    std::ostringstream oss;
+    arp->PrintArpCache(Create<OutputStreamWrapper>(&oss));
+    std::istringstream iss(oss.str());
+    std::string line;
+    std::vector<Ipv4Address> printed;
+    while (std::getline(iss, line))
+    {
+        printed.emplace_back(line.substr(0, line.find(' ')).c_str());
+    }
+    NS_TEST_EXPECT_MSG_EQ(printed.size(), nEntries, "Wrong number of entries printed");
+    NS_TEST_EXPECT_MSG_EQ(std::is_sorted(printed.begin(), printed.end()), true, "Not sorted");
+
+    // Removed entries
+    arp->Remove(arp->Lookup(Ipv4Address(0x0a000068)));
+    NS_TEST_EXPECT_MSG_EQ(arp->Lookup(Ipv4Address(0x0a000068)), nullptr, "Not removed");
+    CheckInverse(arp, macOf(3), {Ipv4Address(0x0a000004), Ipv4Address(0x0a00009a)});
+    ArpCache::Entry* dynamic = arp->Add(Ipv4Address(0x0a000068));
+    dynamic->MarkWaitReply(ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(), Ipv4Header()));
+    CheckInverse(arp, Address(), {});
+    dynamic->MarkAlive(macOf(3));
+    arp->RemoveAutoGeneratedEntries();
+    CheckInverse(arp, macOf(3), {Ipv4Address(0x0a000068)});
+    CheckInverse(arp, macOf(4), {});
+    arp->Flush();
+    CheckInverse(arp, macOf(3), {});
+    arp->Dispose();
+
+    // The same lookups in an NDISC cache
+    Ptr<Icmpv6L4Protocol> icmpv6 = CreateObject<Icmpv6L4Protocol>();
+    Ptr<NdiscCache> ndisc = CreateObject<NdiscCache>();
+    ndisc->SetDevice(CreateObject<SimpleNetDevice>(), nullptr, icmpv6);
+    for (uint32_t i : order)
+    {
+        NdiscCache::Entry* entry = ndisc->Add(ipv6Of(i));
+        entry->SetMacAddress(macOf(i));
+        entry->MarkAutoGenerated();
+    }
+    std::list<NdiscCache::Entry*> entries = ndisc->LookupInverse(macOf(7));
+    NS_TEST_ASSERT_MSG_EQ(entries.size(), nEntries / nMacs, "Wrong number of entries");
+    NS_TEST_EXPECT_MSG_EQ(std::is_sorted(entries.begin(),
+                                         entries.end(),
+                                         [](NdiscCache::Entry* a, NdiscCache::Entry* b) {
+                                             return a->GetIpv6Address() < b->GetIpv6Address();
+                                         }),
+                          true,
+                          "Entries not sorted");
+    NdiscCache::Entry* entry = entries.front();
+    NS_TEST_EXPECT_MSG_EQ(entry->GetIpv6Address(), ipv6Of(7), "Wrong first entry");
+    NS_TEST_EXPECT_MSG_EQ(ndisc->Lookup(ipv6Of(7)), entry, "Wrong entry");
+    entry->MarkStale(macOf(8));
+    NS_TEST_EXPECT_MSG_EQ(ndisc->LookupInverse(macOf(7)).size(), nEntries / nMacs - 1, "Not moved");
+    NS_TEST_EXPECT_MSG_EQ(ndisc->LookupInverse(macOf(8)).size(), nEntries / nMacs + 1, "Not moved");
+    ndisc->Remove(entry);
+    NS_TEST_EXPECT_MSG_EQ(ndisc->LookupInverse(macOf(8)).size(), nEntries / nMacs, "Not removed");
+
+    // The reachable timer expires 30 s after the last confirmation, at 40 s
+    entry = entries.back();
+    entry->MarkReachable();
+    entry->StartReachableTimer();
+    for (uint32_t t : {1, 5, 10})
+    {
+        Simulator::Schedule(Seconds(t), &NdiscCache::Entry::UpdateReachableTimer, entry);
+    }
+    for (double t : {30.5, 39.9, 40.1})
+    {
+        Simulator::Schedule(Seconds(t), &CacheIndexTest::RecordReachable, this, entry);
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_reachable.size(), 3, "Missing checks");
+    NS_TEST_EXPECT_MSG_EQ(m_reachable[0], true, "Stale before the timeout");
+    NS_TEST_EXPECT_MSG_EQ(m_reachable[1], true, "Stale before the timeout");
+    NS_TEST_EXPECT_MSG_EQ(m_reachable[2], false, "Reachable after the timeout");
+    NS_TEST_EXPECT_MSG_EQ(entry->IsStale(), true, "Not stale");
+
+    ndisc->Dispose();
+    icmpv6->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Shared neighbor table Test
+ *
+ * The neighbor caches of a channel are populated with a shared table, and
+ * the table is checked to hold the addresses of all the devices, to be
+ * updated when an address is added or removed, and to resolve the addresses
+ * without any private entry.
+ */
+class SharedTableTest : public TestCase
+{
+  public:
+    void DoRun() override;
+    SharedTableTest();
+
+  private:
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+    uint32_t m_received{0}; //!< Number of packets received.
+};
+
+SharedTableTest::SharedTableTest()
+    : TestCase("The SharedTableTest checks that the neighbor caches of a channel are correctly "
+               "populated with a shared neighbor table.")
+{
+}
+
+void
+SharedTableTest::ReceivePkt(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_received++;
+    }
+}
+
+void
+SharedTableTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer net = simpleHelper.Install(nodes, channel);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(net);
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:0::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer icv6 = ipv6.Assign(net);
+
+    NeighborCacheHelper neighborCache;
+    neighborCache.SetSharedNeighborTable(true);
+    neighborCache.SetDynamicNeighborCache(true);
+    neighborCache.PopulateNeighborCache();
+
+    Ptr<ArpCache> arpTable = channel->GetObject<ArpCache>();
+    Ptr<NdiscCache> ndiscTable = channel->GetObject<NdiscCache>();
+    NS_TEST_ASSERT_MSG_NE(arpTable, nullptr, "No shared ARP table");
+    NS_TEST_ASSERT_MSG_NE(ndiscTable, nullptr, "No shared NDISC table");
+    for (uint32_t n = 0; n < nodes.GetN(); n++)
+    {
+        Ptr<Ipv4Interface> ipv4Interface =
+            nodes.Get(n)->GetObject<Ipv4L3Protocol>()->GetInterface(1);
+        Ptr<Ipv6Interface> ipv6Interface =
+            nodes.Get(n)->GetObject<Ipv6L3Protocol>()->GetInterface(1);
+        NS_TEST_EXPECT_MSG_EQ(ipv4Interface->GetArpCache()->GetNeighborTable(),
+                              arpTable,
+                              "ARP cache of node " << n << " without the shared table");
+        NS_TEST_EXPECT_MSG_EQ(ipv6Interface->GetNdiscCache()->GetNeighborTable(),
+                              ndiscTable,
+                              "NDISC cache of node " << n << " without the shared table");
+
+        ArpCache::Entry* arpEntry = arpTable->Lookup(i.GetAddress(n));
+        NS_TEST_ASSERT_MSG_NE(arpEntry, nullptr, "No shared entry for " << i.GetAddress(n));
+        NS_TEST_EXPECT_MSG_EQ(arpEntry->IsAutoGenerated(), true, "Not auto-generated");
+        NS_TEST_EXPECT_MSG_EQ(arpEntry->GetMacAddress(), net.Get(n)->GetAddress(), "Wrong MAC");
+        for (uint32_t j = 0; j < 2; j++)
+        {
+            NdiscCache::Entry* ndiscEntry = ndiscTable->Lookup(icv6.GetAddress(n, j));
+            NS_TEST_ASSERT_MSG_NE(ndiscEntry,
+                                  nullptr,
+                                  "No shared entry for " << icv6.GetAddress(n, j));
+            NS_TEST_EXPECT_MSG_EQ(ndiscEntry->IsAutoGenerated(), true, "Not auto-generated");
+            NS_TEST_EXPECT_MSG_EQ(ndiscEntry->GetMacAddress(),
+                                  net.Get(n)->GetAddress(),
+                                  "Wrong MAC");
+        }
+    }
+
+    // Remove and add back the IPv4 address of node 1
+    Ptr<Ipv4Interface> ipv4Interface1 = nodes.Get(1)->GetObject<Ipv4L3Protocol>()->GetInterface(1);
+    Ipv4InterfaceAddress ifAddr = ipv4Interface1->RemoveAddress(0);
+    NS_TEST_EXPECT_MSG_EQ(arpTable->Lookup(ifAddr.GetLocal()), nullptr, "Entry not removed");
+    ipv4Interface1->AddAddress(ifAddr);
+    NS_TEST_EXPECT_MSG_NE(arpTable->Lookup(ifAddr.GetLocal()), nullptr, "Entry not added");
+
+    // Send from node 0 to node 2
+    TypeId tid = UdpSocketFactory::GetTypeId();
+    Ptr<Socket> rxSocket = Socket::CreateSocket(nodes.Get(2), tid);
+    rxSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), 1234));
+    rxSocket->SetRecvCallback(MakeCallback(&SharedTableTest::ReceivePkt, this));
+    Ptr<Socket> rxSocketv6 = Socket::CreateSocket(nodes.Get(2), tid);
+    rxSocketv6->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 1234));
+    rxSocketv6->SetRecvCallback(MakeCallback(&SharedTableTest::ReceivePkt, this));
+    Ptr<Socket> txSocket = Socket::CreateSocket(nodes.Get(0), tid);
+    Ptr<Socket> txSocketv6 = Socket::CreateSocket(nodes.Get(0), tid);
+    Simulator::ScheduleWithContext(nodes.Get(0)->GetId(), Seconds(10), [=]() {
+        txSocket->SendTo(Create<Packet>(123), 0, InetSocketAddress(i.GetAddress(2), 1234));
+        txSocketv6->SendTo(Create<Packet>(123),
+                           0,
+                           Inet6SocketAddress(icv6.GetAddress(2, 1), 1234));
+    });
+
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, 2, "Packets not received");
+    Ptr<ArpCache> arpCache0 =
+        nodes.Get(0)->GetObject<Ipv4L3Protocol>()->GetInterface(1)->GetArpCache();
+    NS_TEST_EXPECT_MSG_EQ(arpCache0->Lookup(i.GetAddress(2)), nullptr, "Address resolved by ARP");
+    Ptr<NdiscCache> ndiscCache0 =
+        nodes.Get(0)->GetObject<Ipv6L3Protocol>()->GetInterface(1)->GetNdiscCache();
+    NS_TEST_EXPECT_MSG_EQ(ndiscCache0->Lookup(icv6.GetAddress(2, 1)),
+                          nullptr,
+                          "Address resolved by NDISC");
+
+    neighborCache.FlushAutoGenerated();
+    NS_TEST_EXPECT_MSG_EQ(arpTable->Lookup(i.GetAddress(0)), nullptr, "Table not flushed");
+    NS_TEST_EXPECT_MSG_EQ(ndiscTable->Lookup(icv6.GetAddress(0, 1)), nullptr, "Table not flushed");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1239,6 +1586,8 @@ class NeighborCacheTestSuite : public TestSuite
         AddTestCase(new FlushTest, TestCase::QUICK);
         AddTestCase(new DuplicateTest, TestCase::QUICK);
         AddTestCase(new DynamicPartialTest, TestCase::QUICK);
+        AddTestCase(new CacheIndexTest, TestCase::QUICK);
+        AddTestCase(new SharedTableTest, TestCase::QUICK);
     }
 };
 
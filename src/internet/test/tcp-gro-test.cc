@@ -0,0 +1,273 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a bulk transfer to a receiver using GRO or ACK thinning.
+ *
+ * The receiver is checked to get the whole byte stream, to see segments
+ * larger than the sender MSS only when GRO is enabled, and to send fewer
+ * ACKs than with the standard delayed ACKs.
+ */
+class TcpGroTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param groTimeout the GRO timeout of the receiver (zero disables GRO)
+     * \param ackThinning the ACK thinning interval of the receiver (zero disables it)
+     */
+    TcpGroTestCase(Time groTimeout, Time ackThinning);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+    /**
+     * \brief Count the data segments sent by the client.
+     * \param p the packet, without the TCP header
+     * \param h the TCP header
+     * \param socket the socket
+     */
+    void ClientTx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket);
+    /**
+     * \brief Count the ACKs sent by the server.
+     * \param p the packet, without the TCP header
+     * \param h the TCP header
+     * \param socket the socket
+     */
+    void ServerTx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket);
+    /**
+     * \brief Record the size of the segments received by the server socket.
+     * \param p the packet, without the TCP header
+     * \param h the TCP header
+     * \param socket the socket
+     */
+    void ServerRx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket);
+
+    Time m_groTimeout;                         //!< GRO timeout of the receiver
+    Time m_ackThinning;                        //!< ACK thinning interval of the receiver
+    static constexpr uint32_t TOTAL = 1000000; //!< Bytes to transfer
+    static constexpr uint32_t SEGMENT = 1400;  //!< TCP segment size
+    uint32_t m_sent{0};                        //!< Bytes queued by the client
+    uint32_t m_received{0};                    //!< Bytes received by the server
+    uint32_t m_dataSegments{0};                //!< Data segments sent by the client
+    uint32_t m_acks{0};                        //!< Pure ACKs sent by the server
+    Time m_firstAck;                           //!< Time of the first pure ACK
+    Time m_lastAck;                            //!< Time of the last pure ACK
+    uint32_t m_maxRxSize{0};                   //!< Largest segment received by the server
+};
+
+TcpGroTestCase::TcpGroTestCase(Time groTimeout, Time ackThinning)
+    : TestCase("Check a TCP transfer to a receiver with GroTimeout=" +
+               std::to_string(groTimeout.GetMicroSeconds()) + "us and AckThinningInterval=" +
+               std::to_string(ackThinning.GetMicroSeconds()) + "us"),
+      m_groTimeout(groTimeout),
+      m_ackThinning(ackThinning)
+{
+}
+
+void
+TcpGroTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&TcpGroTestCase::ServerRecv, this));
+    s->TraceConnectWithoutContext("Tx", MakeCallback(&TcpGroTestCase::ServerTx, this));
+    s->TraceConnectWithoutContext("Rx", MakeCallback(&TcpGroTestCase::ServerRx, this));
+}
+
+void
+TcpGroTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+    }
+}
+
+void
+TcpGroTestCase::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (m_sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min(TOTAL - m_sent, s->GetTxAvailable());
+        int sent = s->Send(Create<Packet>(size));
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sent += sent;
+    }
+    if (m_sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+void
+TcpGroTestCase::ClientTx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket)
+{
+    if (p->GetSize() > 0)
+    {
+        m_dataSegments++;
+    }
+}
+
+void
+TcpGroTestCase::ServerTx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket)
+{
+    if (p->GetSize() == 0 && h.GetFlags() == TcpHeader::ACK)
+    {
+        if (m_acks == 0)
+        {
+            m_firstAck = Simulator::Now();
+        }
+        m_lastAck = Simulator::Now();
+        m_acks++;
+    }
+}
+
+void
+TcpGroTestCase::ServerRx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket)
+{
+    m_maxRxSize = std::max(m_maxRxSize, p->GetSize());
+}
+
+void
+TcpGroTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    nodes.Get(1)->GetObject<TcpL4Protocol>()->SetAttribute("GroTimeout", TimeValue(m_groTimeout));
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->SetAttribute("AckThinningInterval", TimeValue(m_ackThinning));
+    server->SetAttribute("RcvBufSize", UintegerValue(TOTAL));
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpGroTestCase::ServerAccept, this));
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("SegmentSize", UintegerValue(SEGMENT));
+    client->SetAttribute("SndBufSize", UintegerValue(TOTAL));
+    client->TraceConnectWithoutContext("Tx", MakeCallback(&TcpGroTestCase::ClientTx, this));
+    client->SetSendCallback(MakeCallback(&TcpGroTestCase::ClientSend, this));
+    client->Bind();
+    Simulator::Schedule(Seconds(1),
+                        &Socket::Connect,
+                        client,
+                        InetSocketAddress(interfaces.GetAddress(1), 80));
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, TOTAL, "The server did not receive all the data");
+    if (m_groTimeout.IsStrictlyPositive())
+    {
+        NS_TEST_EXPECT_MSG_GT(m_maxRxSize, SEGMENT, "GRO did not coalesce any segment");
+        NS_TEST_EXPECT_MSG_LT(m_acks * 4, m_dataSegments, "Too many ACKs with GRO");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_maxRxSize, SEGMENT, "Segments coalesced without GRO");
+    }
+    if (m_ackThinning.IsStrictlyPositive())
+    {
+        // one more ACK than intervals, plus ACKs not subject to thinning (e.g., of the FIN)
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(m_acks,
+                                    (m_lastAck - m_firstAck) / m_ackThinning + 3,
+                                    "ACKs more frequent than the thinning interval");
+        NS_TEST_EXPECT_MSG_LT(m_acks * 4, m_dataSegments, "Too many ACKs with ACK thinning");
+    }
+    if (!m_groTimeout.IsStrictlyPositive() && !m_ackThinning.IsStrictlyPositive())
+    {
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(m_acks * 3, m_dataSegments, "Too few delayed ACKs");
+    }
+}
+
+void
+TcpGroTestCase::DoTeardown()
+{
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP generic receive offload and ACK thinning TestSuite
+ */
+class TcpGroTestSuite : public TestSuite
+{
+  public:
+    TcpGroTestSuite();
+};
+
+TcpGroTestSuite::TcpGroTestSuite()
+    : TestSuite("tcp-gro", UNIT)
+{
+    AddTestCase(new TcpGroTestCase(Seconds(0), Seconds(0)), TestCase::QUICK);
+    AddTestCase(new TcpGroTestCase(MilliSeconds(1), Seconds(0)), TestCase::QUICK);
+    AddTestCase(new TcpGroTestCase(Seconds(0), MilliSeconds(5)), TestCase::QUICK);
+    AddTestCase(new TcpGroTestCase(MilliSeconds(1), MilliSeconds(5)), TestCase::QUICK);
+}
+
+static TcpGroTestSuite g_tcpGroTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,353 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/gso-tag.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/uinteger.h"
+
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the segments built out of a TCP GSO packet.
+ */
+class TcpGsoSegmentTestCase : public TestCase
+{
+  public:
+    TcpGsoSegmentTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TcpGsoSegmentTestCase::TcpGsoSegmentTestCase()
+    : TestCase("Check the segmentation of a TCP GSO packet")
+{
+}
+
+void
+TcpGsoSegmentTestCase::DoRun()
+{
+    Ptr<Packet> p = Create<Packet>(3000);
+    p->AddPacketTag(GsoTag(1400));
+    TcpHeader header;
+    header.SetSourcePort(49153);
+    header.SetDestinationPort(80);
+    header.SetSequenceNumber(SequenceNumber32(1000));
+    header.SetFlags(TcpHeader::ACK | TcpHeader::PSH | TcpHeader::FIN | TcpHeader::CWR);
+    p->AddHeader(header);
+
+    auto segments = TcpL4Protocol::GsoSegment(p,
+                                              1400,
+                                              Ipv4Address("10.0.0.1"),
+                                              Ipv4Address("10.0.0.2"));
+    NS_TEST_ASSERT_MSG_EQ(segments.size(), 3, "Wrong number of segments");
+
+    uint32_t sizes[] = {1400, 1400, 200};
+    for (uint32_t i = 0; i < segments.size(); i++)
+    {
+        TcpHeader h;
+        Ptr<Packet> segment = segments[i]->Copy();
+        segment->RemoveHeader(h);
+        NS_TEST_EXPECT_MSG_EQ(segment->GetSize(), sizes[i], "Wrong size of segment " << i);
+        NS_TEST_EXPECT_MSG_EQ(h.GetSequenceNumber(),
+                              SequenceNumber32(1000 + 1400 * i),
+                              "Wrong sequence number of segment " << i);
+        NS_TEST_EXPECT_MSG_EQ(h.GetSourcePort(), 49153, "Wrong source port");
+        NS_TEST_EXPECT_MSG_EQ(bool(h.GetFlags() & TcpHeader::ACK), true, "ACK must be kept");
+        NS_TEST_EXPECT_MSG_EQ(bool(h.GetFlags() & TcpHeader::CWR),
+                              (i == 0),
+                              "CWR only belongs to the first segment");
+        NS_TEST_EXPECT_MSG_EQ(bool(h.GetFlags() & (TcpHeader::PSH | TcpHeader::FIN)),
+                              (i == 2),
+                              "PSH and FIN only belong to the last segment");
+        GsoTag tag;
+        NS_TEST_EXPECT_MSG_EQ(segment->PeekPacketTag(tag), false, "Segments are not GSO packets");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a bulk transfer of a TCP socket using GSO.
+ *
+ * The devices drop packets larger than their MTU, hence the transfer can only
+ * complete if the GSO packets built by the sender are segmented on their way
+ * out, either by the queue disc or by the traffic control layer when the
+ * device has no queue disc. Over IPv4, the segments received are checked to
+ * carry distinct identification values, across consecutive GSO packets.
+ */
+class TcpGsoTransferTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param ipv6 whether to use IPv6 instead of IPv4
+     * \param queueDisc whether the devices have a queue disc
+     */
+    TcpGsoTransferTestCase(bool ipv6, bool queueDisc);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+    /**
+     * \brief Record the size of a packet sent by the client TCP socket.
+     * \param p the packet, without the TCP header
+     * \param h the TCP header
+     * \param socket the socket
+     */
+    void ClientTx(Ptr<const Packet> p, const TcpHeader& h, Ptr<const TcpSocketBase> socket);
+    /**
+     * \brief Record the size of a packet received by the server node (IPv4 version).
+     * \param p the packet
+     * \param ipv4 the IPv4 protocol
+     * \param interface the incoming interface
+     */
+    void ServerIpv4Rx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+    /**
+     * \brief Record the size of a packet received by the server node (IPv6 version).
+     * \param p the packet
+     * \param ipv6 the IPv6 protocol
+     * \param interface the incoming interface
+     */
+    void ServerIpv6Rx(Ptr<const Packet> p, Ptr<Ipv6> ipv6, uint32_t interface);
+
+    bool m_ipv6;                               //!< Use IPv6
+    bool m_queueDisc;                          //!< The devices have a queue disc
+    static constexpr uint32_t TOTAL = 1000000; //!< Bytes to transfer
+    static constexpr uint32_t MTU = 1500;      //!< MTU of the devices
+    static constexpr uint32_t SEGMENT = 1400;  //!< TCP segment size
+    static constexpr uint32_t GSO_MAX = 64000; //!< Maximum size of a GSO packet
+    uint32_t m_sent{0};                        //!< Bytes queued by the client
+    uint32_t m_received{0};                    //!< Bytes received by the server
+    uint32_t m_maxTcpTxSize{0};                //!< Largest packet sent by the client TCP
+    uint32_t m_maxIpRxSize{0};                 //!< Largest packet received by the server IP
+    std::set<uint16_t> m_ipIds;                //!< IPv4 identifications received
+    uint32_t m_duplicateIpIds{0};              //!< IPv4 identifications received twice
+};
+
+TcpGsoTransferTestCase::TcpGsoTransferTestCase(bool ipv6, bool queueDisc)
+    : TestCase(std::string("Check a TCP transfer with GSO over ") + (ipv6 ? "IPv6" : "IPv4") +
+               (queueDisc ? " with a queue disc" : " without a queue disc")),
+      m_ipv6(ipv6),
+      m_queueDisc(queueDisc)
+{
+}
+
+void
+TcpGsoTransferTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&TcpGsoTransferTestCase::ServerRecv, this));
+}
+
+void
+TcpGsoTransferTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+    }
+}
+
+void
+TcpGsoTransferTestCase::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (m_sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min(TOTAL - m_sent, s->GetTxAvailable());
+        int sent = s->Send(Create<Packet>(size));
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sent += sent;
+    }
+    if (m_sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+void
+TcpGsoTransferTestCase::ClientTx(Ptr<const Packet> p,
+                                 const TcpHeader& h,
+                                 Ptr<const TcpSocketBase> socket)
+{
+    m_maxTcpTxSize = std::max(m_maxTcpTxSize, p->GetSize());
+}
+
+void
+TcpGsoTransferTestCase::ServerIpv4Rx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    m_maxIpRxSize = std::max(m_maxIpRxSize, p->GetSize());
+    Ipv4Header header;
+    p->PeekHeader(header);
+    if (!m_ipIds.insert(header.GetIdentification()).second)
+    {
+        m_duplicateIpIds++;
+    }
+}
+
+void
+TcpGsoTransferTestCase::ServerIpv6Rx(Ptr<const Packet> p, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+    m_maxIpRxSize = std::max(m_maxIpRxSize, p->GetSize());
+}
+
+void
+TcpGsoTransferTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    NetDeviceContainer devices = simple.Install(nodes);
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        devices.Get(i)->SetMtu(MTU);
+    }
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    Address serverAddress;
+    if (m_ipv6)
+    {
+        Ipv6AddressHelper ipv6;
+        ipv6.SetBase(Ipv6Address("2001:db8::"), Ipv6Prefix(64));
+        Ipv6InterfaceContainer interfaces = ipv6.Assign(devices);
+        interfaces.SetForwarding(0, false);
+        serverAddress = Inet6SocketAddress(interfaces.GetAddress(1, 1), 80);
+        nodes.Get(1)->GetObject<Ipv6L3Protocol>()->TraceConnectWithoutContext(
+            "Rx",
+            MakeCallback(&TcpGsoTransferTestCase::ServerIpv6Rx, this));
+    }
+    else
+    {
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase("10.0.0.0", "255.255.255.0");
+        Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+        serverAddress = InetSocketAddress(interfaces.GetAddress(1), 80);
+        nodes.Get(1)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+            "Rx",
+            MakeCallback(&TcpGsoTransferTestCase::ServerIpv4Rx, this));
+    }
+    if (!m_queueDisc)
+    {
+        // address helpers install a default queue disc
+        TrafficControlHelper tch;
+        tch.Uninstall(devices);
+    }
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(m_ipv6 ? Address(Inet6SocketAddress(Ipv6Address::GetAny(), 80))
+                        : Address(InetSocketAddress(Ipv4Address::GetAny(), 80)));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpGsoTransferTestCase::ServerAccept, this));
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("SegmentSize", UintegerValue(SEGMENT));
+    client->SetAttribute("SndBufSize", UintegerValue(TOTAL));
+    client->SetAttribute("GsoMaxSize", UintegerValue(GSO_MAX));
+    client->TraceConnectWithoutContext("Tx", MakeCallback(&TcpGsoTransferTestCase::ClientTx, this));
+    client->SetSendCallback(MakeCallback(&TcpGsoTransferTestCase::ClientSend, this));
+    client->Bind(m_ipv6 ? Address(Inet6SocketAddress(Ipv6Address::GetAny(), 0))
+                        : Address(InetSocketAddress(Ipv4Address::GetAny(), 0)));
+    Simulator::Schedule(Seconds(2), &Socket::Connect, client, serverAddress);
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, TOTAL, "The server did not receive all the data");
+    NS_TEST_EXPECT_MSG_GT(m_maxTcpTxSize, SEGMENT, "The client did not build GSO packets");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxTcpTxSize, GSO_MAX, "GSO packet larger than GsoMaxSize");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxIpRxSize, MTU, "A packet larger than the MTU was received");
+    NS_TEST_EXPECT_MSG_EQ(m_duplicateIpIds,
+                          0,
+                          "Segments were received with the same IPv4 identification");
+}
+
+void
+TcpGsoTransferTestCase::DoTeardown()
+{
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP generic segmentation offload TestSuite
+ */
+class TcpGsoTestSuite : public TestSuite
+{
+  public:
+    TcpGsoTestSuite();
+};
+
+TcpGsoTestSuite::TcpGsoTestSuite()
+    : TestSuite("tcp-gso", UNIT)
+{
+    AddTestCase(new TcpGsoSegmentTestCase, TestCase::QUICK);
+    AddTestCase(new TcpGsoTransferTestCase(false, true), TestCase::QUICK);
+    AddTestCase(new TcpGsoTransferTestCase(false, false), TestCase::QUICK);
+    AddTestCase(new TcpGsoTransferTestCase(true, true), TestCase::QUICK);
+    AddTestCase(new TcpGsoTransferTestCase(true, false), TestCase::QUICK);
+}
+
+static TcpGsoTestSuite g_tcpGsoTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,457 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/double.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-pacing-wheel.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the release times of the departures of a TcpPacingWheel.
+ */
+class TcpPacingWheelReleaseTestCase : public TestCase
+{
+  public:
+    TcpPacingWheelReleaseTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Record the release of a departure
+     * \param id the identifier of the departure
+     */
+    void Released(uint32_t id);
+
+    Ptr<TcpPacingWheel> m_wheel;                       //!< The wheel under test
+    std::vector<std::pair<uint32_t, Time>> m_released; //!< Released departures and times
+};
+
+TcpPacingWheelReleaseTestCase::TcpPacingWheelReleaseTestCase()
+    : TestCase("Check the release times of the pacing wheel")
+{
+}
+
+void
+TcpPacingWheelReleaseTestCase::Released(uint32_t id)
+{
+    m_released.emplace_back(id, Simulator::Now());
+    if (id == 2)
+    {
+        // Departures scheduled while releasing the same tick are not lost
+        m_wheel->Schedule(Simulator::Now(),
+                          MakeCallback(&TcpPacingWheelReleaseTestCase::Released, this).Bind(5));
+    }
+}
+
+void
+TcpPacingWheelReleaseTestCase::DoRun()
+{
+    m_wheel = CreateObject<TcpPacingWheel>();
+    m_wheel->SetGranularity(MicroSeconds(100));
+
+    auto cb = [this](uint32_t id) {
+        return MakeCallback(&TcpPacingWheelReleaseTestCase::Released, this).Bind(id);
+    };
+    m_wheel->Schedule(MicroSeconds(250), cb(1));
+    m_wheel->Schedule(MicroSeconds(130), cb(2));
+    m_wheel->Schedule(MicroSeconds(200), cb(3));
+    m_wheel->Schedule(MicroSeconds(0), cb(4));
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetNPending(), 4, "Wrong number of pending departures");
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_released.size(), 5, "Some departures were not released");
+    std::vector<std::pair<uint32_t, Time>> expected = {{4, MicroSeconds(0)},
+                                                       {2, MicroSeconds(200)},
+                                                       {3, MicroSeconds(200)},
+                                                       {5, MicroSeconds(200)},
+                                                       {1, MicroSeconds(300)}};
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_released[i].first, expected[i].first, "Wrong release order");
+        NS_TEST_EXPECT_MSG_EQ(m_released[i].second, expected[i].second, "Wrong release time");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetNPending(), 0, "Departures left in the wheel");
+}
+
+void
+TcpPacingWheelReleaseTestCase::DoTeardown()
+{
+    m_wheel->Dispose();
+    m_wheel = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Compare many paced flows using the pacing wheel to per-socket pacing timers.
+ *
+ * The same bulk transfers are run with per-socket pacing timers and with a
+ * pacing wheel on the sender. The transfers must complete in about the same
+ * time, with fewer simulator events when using the wheel.
+ */
+class TcpPacingWheelFlowsTestCase : public TestCase
+{
+  public:
+    TcpPacingWheelFlowsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the transfers
+     * \param granularity the granularity of the pacing wheel (zero to use pacing timers)
+     * \param[out] events the number of simulator events
+     * \return the time the last byte was received
+     */
+    Time RunFlows(Time granularity, uint64_t& events);
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer of a flow has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+
+    static constexpr uint32_t FLOWS = 20;     //!< Number of flows
+    static constexpr uint32_t TOTAL = 100000; //!< Bytes to transfer per flow
+    std::map<Ptr<Socket>, uint32_t> m_sent;   //!< Bytes queued by each client
+    uint32_t m_received{0};                   //!< Bytes received by the server
+    Time m_lastRx;                            //!< Time of the last reception
+};
+
+TcpPacingWheelFlowsTestCase::TcpPacingWheelFlowsTestCase()
+    : TestCase("Check paced flows using the pacing wheel against pacing timers")
+{
+}
+
+void
+TcpPacingWheelFlowsTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&TcpPacingWheelFlowsTestCase::ServerRecv, this));
+}
+
+void
+TcpPacingWheelFlowsTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+        m_lastRx = Simulator::Now();
+    }
+}
+
+void
+TcpPacingWheelFlowsTestCase::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    uint32_t& sent = m_sent[s];
+    while (sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        int ret = s->Send(Create<Packet>(std::min(TOTAL - sent, s->GetTxAvailable())));
+        if (ret <= 0)
+        {
+            break;
+        }
+        sent += ret;
+    }
+    if (sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+Time
+TcpPacingWheelFlowsTestCase::RunFlows(Time granularity, uint64_t& events)
+{
+    m_sent.clear();
+    m_received = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    nodes.Get(0)->GetObject<TcpL4Protocol>()->SetAttribute("PacingGranularity",
+                                                           TimeValue(granularity));
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpPacingWheelFlowsTestCase::ServerAccept, this));
+
+    for (uint32_t i = 0; i < FLOWS; i++)
+    {
+        Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+        client->SetSendCallback(MakeCallback(&TcpPacingWheelFlowsTestCase::ClientSend, this));
+        client->Bind();
+        Simulator::Schedule(MilliSeconds(100 + i),
+                            &Socket::Connect,
+                            client,
+                            InetSocketAddress(interfaces.GetAddress(1), 80));
+    }
+
+    Simulator::Stop(Seconds(20));
+    Simulator::Run();
+    events = Simulator::GetEventCount();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, FLOWS * TOTAL, "Not all the data was received");
+    return m_lastRx;
+}
+
+void
+TcpPacingWheelFlowsTestCase::DoRun()
+{
+    Config::SetDefault("ns3::TcpSocketState::EnablePacing", BooleanValue(true));
+    Config::SetDefault("ns3::TcpSocketState::PaceInitialWindow", BooleanValue(true));
+
+    uint64_t timerEvents;
+    uint64_t wheelEvents;
+    Time timerEnd = RunFlows(Seconds(0), timerEvents);
+    Time wheelEnd = RunFlows(MicroSeconds(100), wheelEvents);
+
+    NS_TEST_EXPECT_MSG_EQ_TOL(wheelEnd.GetSeconds(),
+                              timerEnd.GetSeconds(),
+                              timerEnd.GetSeconds() * 0.01,
+                              "The pacing wheel changed the duration of the transfers");
+    NS_TEST_EXPECT_MSG_LT(wheelEvents,
+                          timerEvents,
+                          "The pacing wheel should schedule fewer events");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the first paced departure after a retransmission timeout.
+ *
+ * The ACKs of a flow paced at a low rate are dropped until the
+ * retransmission timer expires while a departure is pending. The next
+ * segment must follow the retransmission by one pacing gap, counted from the
+ * timeout and not from the cancelled departure, as with the pacing timers.
+ */
+class TcpPacingWheelRtoTestCase : public TestCase
+{
+  public:
+    TcpPacingWheelRtoTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the transfer
+     * \param granularity the granularity of the pacing wheel (zero to use pacing timers)
+     * \return the time between the retransmission and the next data segment
+     */
+    Time RunFlow(Time granularity);
+
+    /**
+     * \brief Record the time of the timeout, and let the ACKs through again.
+     * \param oldValue the previous congestion state
+     * \param newValue the new congestion state
+     */
+    void CongStateTrace(TcpSocketState::TcpCongState_t oldValue,
+                        TcpSocketState::TcpCongState_t newValue);
+    /**
+     * \brief Record the data segments sent after the timeout.
+     * \param packet the packet
+     * \param ipv4 the IPv4 protocol of the sender
+     * \param interface the output interface
+     */
+    void IpTxTrace(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    Ptr<ErrorModel> m_ackLoss; //!< Drops the ACKs received by the sender
+    Time m_rto;                //!< Time of the retransmission timeout
+    std::vector<Time> m_tx;    //!< Times of the data segments sent from the timeout
+};
+
+TcpPacingWheelRtoTestCase::TcpPacingWheelRtoTestCase()
+    : TestCase("Check the first paced departure after a retransmission timeout")
+{
+}
+
+void
+TcpPacingWheelRtoTestCase::CongStateTrace(TcpSocketState::TcpCongState_t oldValue,
+                                          TcpSocketState::TcpCongState_t newValue)
+{
+    if (newValue == TcpSocketState::CA_LOSS && m_rto.IsZero())
+    {
+        m_rto = Simulator::Now();
+        m_ackLoss->Disable();
+    }
+}
+
+void
+TcpPacingWheelRtoTestCase::IpTxTrace(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    // Data segments are larger than the IPv4 and TCP headers and options
+    if (!m_rto.IsZero() && packet->GetSize() > 100)
+    {
+        m_tx.push_back(Simulator::Now());
+    }
+}
+
+Time
+TcpPacingWheelRtoTestCase::RunFlow(Time granularity)
+{
+    m_rto = Time(0);
+    m_tx.clear();
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    m_ackLoss = CreateObject<RateErrorModel>();
+    m_ackLoss->SetAttribute("ErrorRate", DoubleValue(1.0));
+    m_ackLoss->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+    m_ackLoss->Disable();
+    devices.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(m_ackLoss));
+    Simulator::Schedule(Seconds(2), &ErrorModel::Enable, m_ackLoss);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    nodes.Get(0)->GetObject<TcpL4Protocol>()->SetAttribute("PacingGranularity",
+                                                           TimeValue(granularity));
+    nodes.Get(0)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&TcpPacingWheelRtoTestCase::IpTxTrace, this));
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->TraceConnectWithoutContext(
+        "CongState",
+        MakeCallback(&TcpPacingWheelRtoTestCase::CongStateTrace, this));
+    client->Bind();
+    Address serverAddress = InetSocketAddress(interfaces.GetAddress(1), 80);
+    Simulator::Schedule(MilliSeconds(100), [client, serverAddress]() {
+        client->Connect(serverAddress);
+        client->Send(Create<Packet>(100000));
+    });
+
+    Simulator::Stop(Seconds(5));
+    Simulator::Run();
+    Simulator::Destroy();
+    m_ackLoss = nullptr;
+
+    NS_TEST_EXPECT_MSG_EQ(m_rto.IsZero(), false, "No retransmission timeout");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_tx.size(), 2, "No data sent after the timeout");
+    if (m_tx.size() < 2)
+    {
+        return Time(0);
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_tx[0], m_rto, "The retransmission was not sent at the timeout");
+    return m_tx[1] - m_tx[0];
+}
+
+void
+TcpPacingWheelRtoTestCase::DoRun()
+{
+    Config::SetDefault("ns3::TcpSocketState::EnablePacing", BooleanValue(true));
+    Config::SetDefault("ns3::TcpSocketState::PaceInitialWindow", BooleanValue(true));
+    // The pacing gap (about 43 ms per segment) is much longer than the RTT
+    Config::SetDefault("ns3::TcpSocketState::MaxPacingRate", DataRateValue(DataRate("100kbps")));
+
+    Time timerGap = RunFlow(Seconds(0));
+    Time wheelGap = RunFlow(MicroSeconds(100));
+    Config::SetDefault("ns3::TcpSocketState::MaxPacingRate", DataRateValue(DataRate("4Gb/s")));
+
+    NS_TEST_EXPECT_MSG_EQ_TOL(wheelGap,
+                              timerGap,
+                              MicroSeconds(100),
+                              "The first departure after the timeout was delayed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP pacing wheel TestSuite
+ */
+class TcpPacingWheelTestSuite : public TestSuite
+{
+  public:
+    TcpPacingWheelTestSuite();
+};
+
+TcpPacingWheelTestSuite::TcpPacingWheelTestSuite()
+    : TestSuite("tcp-pacing-wheel", UNIT)
+{
+    AddTestCase(new TcpPacingWheelReleaseTestCase, TestCase::QUICK);
+    AddTestCase(new TcpPacingWheelFlowsTestCase, TestCase::QUICK);
+    AddTestCase(new TcpPacingWheelRtoTestCase, TestCase::QUICK);
+}
+
+static TcpPacingWheelTestSuite g_tcpPacingWheelTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,417 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+NS_LOG_COMPONENT_DEFINE("TcpRackTlpTestSuite");
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the recovery of a single loss near the tail of a transfer
+ *
+ * The sender transmits 100 segments, and one of them is dropped once. With
+ * fewer than DupThresh segments sent after the lost one, the DupThresh
+ * based loss detection waits for the retransmission timeout, while RACK
+ * (with the SACKs of the segments sent after it, or of a tail loss probe)
+ * repairs the loss in about one RTT.
+ */
+class TcpRackTlpTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param rackTlp whether RACK-TLP is enabled on the sender
+     * \param seqToDrop the sequence number of the segment to drop
+     * \param expectedRtos the expected number of retransmission timeouts
+     * \param desc the test description
+     */
+    TcpRackTlpTest(bool rackTlp, uint32_t seqToDrop, uint32_t expectedRtos, const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void RcvAck(const Ptr<const TcpSocketState> tcb, const TcpHeader& h, SocketWho who) override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    static constexpr uint32_t PKT_COUNT = 100; //!< Number of segments to transfer
+    static constexpr uint32_t PKT_SIZE = 500;  //!< Size of the segments
+
+    bool m_rackTlp;                   //!< Whether RACK-TLP is enabled
+    uint32_t m_seqToDrop;             //!< Sequence number of the segment to drop
+    uint32_t m_expectedRtos;          //!< Expected number of retransmission timeouts
+    uint32_t m_rtos{0};               //!< Retransmission timeouts of the sender
+    uint32_t m_retransmissions{0};    //!< Segments retransmitted by the sender
+    SequenceNumber32 m_highTx{0};     //!< Highest sequence sent by the sender
+    SequenceNumber32 m_highAck{0};    //!< Highest ACK received by the sender
+    Time m_repairTime{Seconds(0)};    //!< Time of the ACK covering the dropped segment
+    Time m_firstDataTime{Seconds(0)}; //!< Time of the first data segment
+};
+
+TcpRackTlpTest::TcpRackTlpTest(bool rackTlp,
+                               uint32_t seqToDrop,
+                               uint32_t expectedRtos,
+                               const std::string& desc)
+    : TcpGeneralTest(desc),
+      m_rackTlp(rackTlp),
+      m_seqToDrop(seqToDrop),
+      m_expectedRtos(expectedRtos)
+{
+}
+
+void
+TcpRackTlpTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(PKT_COUNT);
+    SetAppPktSize(PKT_SIZE);
+    SetAppPktInterval(MicroSeconds(100));
+    SetPropagationDelay(MilliSeconds(10));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRackTlpTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("RackTlp", BooleanValue(m_rackTlp));
+    return socket;
+}
+
+Ptr<ErrorModel>
+TcpRackTlpTest::CreateReceiverErrorModel()
+{
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(m_seqToDrop));
+    return errorModel;
+}
+
+void
+TcpRackTlpTest::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    if (who == SENDER)
+    {
+        NS_LOG_DEBUG("RTO expired at " << Simulator::Now().As(Time::MS));
+        m_rtos++;
+    }
+}
+
+void
+TcpRackTlpTest::RcvAck(const Ptr<const TcpSocketState> tcb, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER)
+    {
+        return;
+    }
+    if (m_highAck <= SequenceNumber32(m_seqToDrop) &&
+        h.GetAckNumber() > SequenceNumber32(m_seqToDrop))
+    {
+        m_repairTime = Simulator::Now();
+    }
+    m_highAck = std::max(m_highAck, h.GetAckNumber());
+}
+
+void
+TcpRackTlpTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER || p->GetSize() == 0)
+    {
+        return;
+    }
+    if (m_firstDataTime.IsZero())
+    {
+        m_firstDataTime = Simulator::Now();
+    }
+    if (h.GetSequenceNumber() < m_highTx)
+    {
+        NS_LOG_DEBUG("Retransmission of " << h.GetSequenceNumber() << " at "
+                                          << Simulator::Now().As(Time::MS));
+        m_retransmissions++;
+    }
+    m_highTx = std::max(m_highTx, h.GetSequenceNumber() + p->GetSize());
+}
+
+void
+TcpRackTlpTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(m_highAck,
+                                SequenceNumber32(1 + PKT_COUNT * PKT_SIZE),
+                                "Not all the data has been acknowledged");
+    NS_TEST_ASSERT_MSG_EQ(m_rtos, m_expectedRtos, "Unexpected number of RTOs");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(m_retransmissions, 1, "The dropped segment was not retransmitted");
+    if (m_rackTlp)
+    {
+        // At most a tail loss probe and the retransmission of the dropped segment
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(m_retransmissions, 2, "Spurious retransmissions");
+        // The sender needs about 8 RTTs of 20 ms to send the data, and an RTT
+        // and a probe timeout (or a reordering window) to repair the loss
+        NS_TEST_ASSERT_MSG_LT(m_repairTime - m_firstDataTime,
+                              MilliSeconds(500),
+                              "The loss was not repaired before the minimum RTO");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a bulk transfer over a link with random losses
+ *
+ * The same transfer is run without and with RACK-TLP: the transfer must
+ * complete in both cases, and RACK-TLP must avoid some of the retransmission
+ * timeouts, if any, of the sender without it.
+ */
+class TcpRackTlpRandomLossTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param errorRate the probability that a data packet is lost
+     */
+    TcpRackTlpRandomLossTestCase(double errorRate);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the transfer
+     * \param rackTlp whether RACK-TLP is enabled on the sender
+     * \param[out] rtos the number of retransmission timeouts of the sender
+     * \return the time the last byte was received
+     */
+    Time RunTransfer(bool rackTlp, uint32_t& rtos);
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+    /**
+     * \brief Count the retransmission timeouts of the client.
+     * \param oldValue the previous congestion state
+     * \param newValue the new congestion state
+     */
+    void CongStateChanged(TcpSocketState::TcpCongState_t oldValue,
+                          TcpSocketState::TcpCongState_t newValue);
+
+    static constexpr uint32_t TOTAL = 500000; //!< Bytes to transfer
+    double m_errorRate;                       //!< Probability that a data packet is lost
+    uint32_t m_sent{0};                       //!< Bytes queued by the client
+    uint32_t m_received{0};                   //!< Bytes received by the server
+    uint32_t m_rtos{0};                       //!< Retransmission timeouts of the client
+    Time m_lastRx;                            //!< Time of the last reception
+};
+
+TcpRackTlpRandomLossTestCase::TcpRackTlpRandomLossTestCase(double errorRate)
+    : TestCase("Check a transfer with " + std::to_string(static_cast<int>(errorRate * 100)) +
+               "% random losses without and with RACK-TLP"),
+      m_errorRate(errorRate)
+{
+}
+
+void
+TcpRackTlpRandomLossTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&TcpRackTlpRandomLossTestCase::ServerRecv, this));
+}
+
+void
+TcpRackTlpRandomLossTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+        m_lastRx = Simulator::Now();
+    }
+}
+
+void
+TcpRackTlpRandomLossTestCase::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (m_sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        int sent = s->Send(Create<Packet>(std::min(TOTAL - m_sent, s->GetTxAvailable())));
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sent += sent;
+    }
+    if (m_sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+void
+TcpRackTlpRandomLossTestCase::CongStateChanged(TcpSocketState::TcpCongState_t oldValue,
+                                               TcpSocketState::TcpCongState_t newValue)
+{
+    if (newValue == TcpSocketState::CA_LOSS && oldValue != TcpSocketState::CA_LOSS)
+    {
+        m_rtos++;
+    }
+}
+
+Time
+TcpRackTlpRandomLossTestCase::RunTransfer(bool rackTlp, uint32_t& rtos)
+{
+    m_sent = 0;
+    m_received = 0;
+    m_rtos = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    // Only the data segments are lost, on their way to the server
+    Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel>();
+    errorModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    errorModel->SetRate(m_errorRate);
+    errorModel->AssignStreams(1);
+    devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpRackTlpRandomLossTestCase::ServerAccept, this));
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("RackTlp", BooleanValue(rackTlp));
+    client->SetAttribute("SndBufSize", UintegerValue(TOTAL));
+    client->SetAttribute("SegmentSize", UintegerValue(1400));
+    client->SetAttribute("MinRto", TimeValue(MilliSeconds(200)));
+    client->TraceConnectWithoutContext(
+        "CongState",
+        MakeCallback(&TcpRackTlpRandomLossTestCase::CongStateChanged, this));
+    client->SetSendCallback(MakeCallback(&TcpRackTlpRandomLossTestCase::ClientSend, this));
+    client->Bind();
+    Simulator::Schedule(Seconds(1),
+                        &Socket::Connect,
+                        client,
+                        InetSocketAddress(interfaces.GetAddress(1), 80));
+
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, TOTAL, "The server did not receive all the data");
+    rtos = m_rtos;
+    return m_lastRx;
+}
+
+void
+TcpRackTlpRandomLossTestCase::DoRun()
+{
+    uint32_t plainRtos;
+    uint32_t rackRtos;
+    Time plainEnd = RunTransfer(false, plainRtos);
+    Time rackEnd = RunTransfer(true, rackRtos);
+    NS_LOG_DEBUG("Without RACK-TLP: " << plainRtos << " RTOs, done at " << plainEnd.As(Time::S)
+                                      << "; with RACK-TLP: " << rackRtos << " RTOs, done at "
+                                      << rackEnd.As(Time::S));
+
+    if (plainRtos > 0)
+    {
+        NS_TEST_EXPECT_MSG_LT(rackRtos, plainRtos, "RACK-TLP did not avoid any RTO");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(rackRtos, 0, "RTOs with RACK-TLP only");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for RACK-TLP loss detection
+ */
+class TcpRackTlpTestSuite : public TestSuite
+{
+  public:
+    TcpRackTlpTestSuite()
+        : TestSuite("tcp-rack-tlp", UNIT)
+    {
+        // Last segment: only a tail loss probe can elicit a SACK
+        uint32_t last = 1 + 99 * 500;
+        AddTestCase(new TcpRackTlpTest(false, last, 1, "Tail loss without RACK-TLP"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpRackTlpTest(true, last, 0, "Tail loss with RACK-TLP"),
+                    TestCase::QUICK);
+        // Third to last segment: two segments SACKed, less than DupThresh
+        uint32_t nearTail = 1 + 97 * 500;
+        AddTestCase(new TcpRackTlpTest(false, nearTail, 1, "Loss near the tail without RACK-TLP"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpRackTlpTest(true, nearTail, 0, "Loss near the tail with RACK-TLP"),
+                    TestCase::QUICK);
+        // Far from the tail, both detect the loss with the SACKs
+        uint32_t middle = 1 + 50 * 500;
+        AddTestCase(new TcpRackTlpTest(false, middle, 0, "Loss in the middle without RACK-TLP"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpRackTlpTest(true, middle, 0, "Loss in the middle with RACK-TLP"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpRackTlpRandomLossTestCase(0.01), TestCase::QUICK);
+        AddTestCase(new TcpRackTlpRandomLossTestCase(0.05), TestCase::QUICK);
+        AddTestCase(new TcpRackTlpRandomLossTestCase(0.1), TestCase::QUICK);
+    }
+};
+
+static TcpRackTlpTestSuite g_tcpRackTlpTestSuite; //!< Static variable for test initialization
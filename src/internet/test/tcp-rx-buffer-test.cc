@@ -42,6 +42,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of overlapping, out-of-order segments.
+     */
+    void TestReassembly();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +58,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReassembly();
 }
 
 void
@@ -288,6 +294,80 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReassembly()
+{
+    TcpRxBuffer rxBuf;
+    rxBuf.SetMaxBufferSize(10000);
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    TcpHeader h;
+
+    // Each byte of the stream is the low byte of its sequence number
+    auto segment = [](uint32_t seq, uint32_t size) {
+        std::vector<uint8_t> bytes(size);
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            bytes[j] = static_cast<uint8_t>(seq + j);
+        }
+        return Create<Packet>(bytes.data(), size);
+    };
+
+    // Out of order segments, one of them overlapping the next ones
+    h.SetSequenceNumber(SequenceNumber32(501));
+    rxBuf.Add(segment(501, 100), h);
+    h.SetSequenceNumber(SequenceNumber32(301));
+    rxBuf.Add(segment(301, 100), h);
+    h.SetSequenceNumber(SequenceNumber32(201));
+    rxBuf.Add(segment(201, 350), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 400, "Overlapping bytes should be stored once");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "Nothing is in order yet");
+    // The first block is the merge of the last segment with its neighbours
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().first,
+                          SequenceNumber32(201),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().second,
+                          SequenceNumber32(601),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(100), nullptr, "Nothing should be extracted");
+
+    // A duplicate is not stored
+    h.SetSequenceNumber(SequenceNumber32(301));
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(segment(301, 100), h), false, "Duplicate stored");
+
+    // Filling the hole makes everything available
+    h.SetSequenceNumber(SequenceNumber32(1));
+    rxBuf.Add(segment(1, 200), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(601),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 600, "All data should be available");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+
+    // Extract across and within segments, and check the stream content
+    uint32_t extracted = 0;
+    for (uint32_t size : {150, 150, 1, 299, 100})
+    {
+        Ptr<Packet> p = rxBuf.Extract(size);
+        if (extracted == 600)
+        {
+            NS_TEST_ASSERT_MSG_EQ(p, nullptr, "Nothing left to extract");
+            break;
+        }
+        NS_TEST_ASSERT_MSG_NE(p, nullptr, "Data should be extracted");
+        NS_TEST_ASSERT_MSG_EQ(p->GetSize(), size, "Wrong extracted size");
+        std::vector<uint8_t> bytes(size);
+        p->CopyData(bytes.data(), size);
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(bytes[j]),
+                                  static_cast<uint8_t>(1 + extracted + j),
+                                  "Wrong byte at offset " << extracted + j);
+        }
+        extracted += size;
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer should be empty");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
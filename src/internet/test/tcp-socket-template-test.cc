@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/object-map.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the sockets created with or without template sockets.
+ *
+ * Every connection opens a new client socket, and forks the listening
+ * socket of the server. The sockets are checked to carry the default
+ * values of their attributes, to be registered with TcpL4Protocol until
+ * they are closed, and to complete their transfers.
+ */
+class TcpSocketTemplateTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param socketTemplates whether the sockets are created from template sockets
+     */
+    TcpSocketTemplateTestCase(bool socketTemplates);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Close a server connection once the client has closed it.
+     * \param s the socket
+     */
+    void ServerPeerClosed(Ptr<Socket> s);
+    /**
+     * \brief Send the data of a client once connected.
+     * \param s the socket
+     */
+    void ClientConnected(Ptr<Socket> s);
+    /**
+     * \brief Open a client connection.
+     */
+    void OpenConnection();
+
+    /**
+     * \brief Get the number of sockets registered with a node.
+     * \param node the node
+     * \return the number of sockets
+     */
+    static std::size_t CountSockets(Ptr<Node> node);
+
+    bool m_socketTemplates;                    //!< Whether the sockets are copies of templates
+    static constexpr uint32_t CONNECTIONS = 8; //!< Number of client connections
+    static constexpr uint32_t DATA = 10000;    //!< Bytes sent per connection
+    static constexpr uint32_t SEGMENT = 1000;  //!< TCP segment size
+    Ptr<Node> m_client;                        //!< The client node
+    Address m_server;                          //!< The address of the server
+    std::vector<Ptr<Socket>> m_clients;        //!< Sockets of the clients
+    uint32_t m_accepted{0};                    //!< Connections accepted by the server
+    uint32_t m_received{0};                    //!< Bytes received by the server
+};
+
+TcpSocketTemplateTestCase::TcpSocketTemplateTestCase(bool socketTemplates)
+    : TestCase(std::string("Check the TCP sockets created with SocketTemplates=") +
+               (socketTemplates ? "true" : "false")),
+      m_socketTemplates(socketTemplates)
+{
+}
+
+std::size_t
+TcpSocketTemplateTestCase::CountSockets(Ptr<Node> node)
+{
+    ObjectMapValue sockets;
+    node->GetObject<TcpL4Protocol>()->GetAttribute("SocketList", sockets);
+    return sockets.GetN();
+}
+
+void
+TcpSocketTemplateTestCase::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    m_accepted++;
+    UintegerValue segmentSize;
+    s->GetAttribute("SegmentSize", segmentSize);
+    NS_TEST_EXPECT_MSG_EQ(segmentSize.Get(), SEGMENT, "Forked socket without the segment size");
+    s->SetRecvCallback(MakeCallback(&TcpSocketTemplateTestCase::ServerRecv, this));
+    s->SetCloseCallbacks(MakeCallback(&TcpSocketTemplateTestCase::ServerPeerClosed, this),
+                         MakeNullCallback<void, Ptr<Socket>>());
+}
+
+void
+TcpSocketTemplateTestCase::ServerPeerClosed(Ptr<Socket> s)
+{
+    s->Close();
+}
+
+void
+TcpSocketTemplateTestCase::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+    }
+}
+
+void
+TcpSocketTemplateTestCase::ClientConnected(Ptr<Socket> s)
+{
+    s->Send(Create<Packet>(DATA));
+    s->Close();
+}
+
+void
+TcpSocketTemplateTestCase::OpenConnection()
+{
+    Ptr<Socket> s = Socket::CreateSocket(m_client, TcpSocketFactory::GetTypeId());
+    UintegerValue segmentSize;
+    s->GetAttribute("SegmentSize", segmentSize);
+    NS_TEST_EXPECT_MSG_EQ(segmentSize.Get(), SEGMENT, "Client socket without the segment size");
+    for (const auto& other : m_clients)
+    {
+        NS_TEST_EXPECT_MSG_NE(other, s, "Client socket created twice");
+    }
+    m_clients.push_back(s);
+    s->SetConnectCallback(MakeCallback(&TcpSocketTemplateTestCase::ClientConnected, this),
+                          MakeNullCallback<void, Ptr<Socket>>());
+    s->Bind();
+    s->Connect(m_server);
+}
+
+void
+TcpSocketTemplateTestCase::DoRun()
+{
+    Config::SetDefault("ns3::TcpL4Protocol::SocketTemplates", BooleanValue(m_socketTemplates));
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(SEGMENT));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&TcpSocketTemplateTestCase::ServerAccept, this));
+
+    m_client = nodes.Get(0);
+    m_server = InetSocketAddress(interfaces.GetAddress(1), 80);
+    for (uint32_t i = 0; i < CONNECTIONS; i++)
+    {
+        Simulator::Schedule(Seconds(1) + MilliSeconds(i),
+                            &TcpSocketTemplateTestCase::OpenConnection,
+                            this);
+    }
+
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_clients.size(), CONNECTIONS, "Not all the clients were created");
+    NS_TEST_EXPECT_MSG_EQ(m_accepted, CONNECTIONS, "Not all the connections were accepted");
+    NS_TEST_EXPECT_MSG_EQ(m_received, CONNECTIONS * DATA, "The server did not receive all data");
+    // The sockets of the server are removed once closed, but the clients
+    // closed first, and their sockets wait in TIME_WAIT
+    NS_TEST_EXPECT_MSG_EQ(CountSockets(nodes.Get(1)), 1, "Server sockets still registered");
+    NS_TEST_EXPECT_MSG_EQ(CountSockets(m_client), CONNECTIONS, "Client sockets not registered");
+
+    Simulator::Stop(Seconds(300));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(CountSockets(m_client), 0, "Client sockets still registered");
+}
+
+void
+TcpSocketTemplateTestCase::DoTeardown()
+{
+    m_clients.clear();
+    m_client = nullptr;
+    Simulator::Destroy();
+    Config::Reset();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP socket templates TestSuite
+ */
+class TcpSocketTemplateTestSuite : public TestSuite
+{
+  public:
+    TcpSocketTemplateTestSuite();
+};
+
+TcpSocketTemplateTestSuite::TcpSocketTemplateTestSuite()
+    : TestSuite("tcp-socket-template", UNIT)
+{
+    AddTestCase(new TcpSocketTemplateTestCase(false), TestCase::QUICK);
+    AddTestCase(new TcpSocketTemplateTestCase(true), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static TcpSocketTemplateTestSuite g_tcpSocketTemplateTestSuite;
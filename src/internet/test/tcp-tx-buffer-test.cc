@@ -53,6 +53,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test the scoreboard of a large window with many SACK holes */
+    void TestLargeWindowRecovery();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -100,6 +102,14 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for a large window:
+     *  -> every other segment is sacked, only the holes below the
+     *     dupThresh-th highest SACK are lost
+     *  -> NextSeg walks the lost holes in order, then falls back to rule 3
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestLargeWindowRecovery, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -420,6 +430,71 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindowRecovery()
+{
+    const uint32_t segmentSize = 100;
+    const uint32_t segments = 2000;
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    SequenceNumber32 head(1);
+    txBuf->SetHeadSequence(head);
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetMaxBufferSize(segments * segmentSize);
+    txBuf->Add(Create<Packet>(segments * segmentSize));
+
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        txBuf->CopyFromSequence(segmentSize, head + (segmentSize * i));
+    }
+
+    // Sack every odd segment
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    for (uint32_t i = 1; i < segments; i += 2)
+    {
+        sack->AddSackBlock(TcpOptionSack::SackBlock(head + (segmentSize * i),
+                                                    head + (segmentSize * (i + 1))));
+    }
+    txBuf->Update(sack->GetSackList());
+
+    // The holes below the third highest sacked segment (1995) are lost
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), segments / 2 * segmentSize, "Wrong sacked bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 998 * segmentSize, "Wrong lost bytes");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(), 2 * segmentSize, "Wrong bytes in flight");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * 1994)), true, "Hole not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * 1995)), false, "Sacked, not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + (segmentSize * 1996)), false, "Hole not yet lost");
+
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+    for (uint32_t i = 0; i < 1996; i += 2)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true), true, "No lost hole");
+        NS_TEST_ASSERT_MSG_EQ(ret, head + (segmentSize * i), "Wrong lost hole");
+        txBuf->CopyFromSequence(segmentSize, ret);
+    }
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 998 * segmentSize, "Wrong retransmits");
+
+    // No lost hole nor new data left: rule 3 picks the first unsacked segment
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true), true, "No rule 3 segment");
+    NS_TEST_ASSERT_MSG_EQ(ret, head + (segmentSize * 1996), "Wrong rule 3 segment");
+
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + (segmentSize * 999)),
+                          true,
+                          "Segment 998 was retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + (segmentSize * 1000)),
+                          false,
+                          "Segment 999 was sacked");
+
+    // A cumulative ACK covering half of the window
+    txBuf->DiscardUpTo(head + (segmentSize * 1000));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 500 * segmentSize, "Wrong sacked bytes after ACK");
+
+    txBuf->DiscardUpTo(head + (segmentSize * segments));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Data inside the buffer");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
@@ -19,6 +19,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/hash.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -26,9 +27,12 @@
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/ptr.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace ns3
 {
@@ -179,6 +183,358 @@ PcapHelper::SinkWithHeader(Ptr<PcapFileWrapper> file, const Header& header, Ptr<
     file->Write(Simulator::Now(), header, p);
 }
 
+PcapHeaderCaptureHelper::PcapHeaderCaptureHelper()
+    : m_file(nullptr),
+      m_headersOnly(true),
+      m_sampleRatio(1.0),
+      m_seed(0),
+      m_rate(0),
+      m_burst(1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PcapHeaderCaptureHelper::~PcapHeaderCaptureHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PcapHeaderCaptureHelper::Open(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_file = CreateObject<PcapngFileWrapper>();
+    m_file->Open(filename);
+    NS_ABORT_MSG_IF(m_file->Fail(), "Unable to Open " << filename);
+}
+
+Ptr<PcapngFileWrapper>
+PcapHeaderCaptureHelper::GetFile() const
+{
+    return m_file;
+}
+
+void
+PcapHeaderCaptureHelper::SetHeadersOnly(bool headersOnly)
+{
+    NS_LOG_FUNCTION(this << headersOnly);
+    m_headersOnly = headersOnly;
+}
+
+void
+PcapHeaderCaptureHelper::SetFlowSampling(double ratio, uint32_t seed)
+{
+    NS_LOG_FUNCTION(this << ratio << seed);
+    NS_ABORT_MSG_IF(ratio < 0 || ratio > 1, "Flow sampling ratio must be in [0, 1]");
+    m_sampleRatio = ratio;
+    m_seed = seed;
+}
+
+void
+PcapHeaderCaptureHelper::SetRateLimit(uint32_t packetsPerSecond, uint32_t burst)
+{
+    NS_LOG_FUNCTION(this << packetsPerSecond << burst);
+    NS_ABORT_MSG_IF(burst == 0, "Rate limit burst must be at least one packet");
+    m_rate = packetsPerSecond;
+    m_burst = burst;
+}
+
+uint32_t
+PcapHeaderCaptureHelper::EnableCapture(Ptr<NetDevice> nd,
+                                       PcapHelper::DataLinkType dataLinkType,
+                                       std::string traceName,
+                                       bool useObjectNames)
+{
+    NS_LOG_FUNCTION(this << nd << dataLinkType << traceName << useObjectNames);
+    NS_ABORT_MSG_UNLESS(m_file, "PcapHeaderCaptureHelper::Open() must be called first");
+
+    std::string nodename;
+    std::string devicename;
+    if (useObjectNames)
+    {
+        nodename = Names::FindName(nd->GetNode());
+        devicename = Names::FindName(nd);
+    }
+    std::ostringstream oss;
+    if (!nodename.empty())
+    {
+        oss << nodename;
+    }
+    else
+    {
+        oss << nd->GetNode()->GetId();
+    }
+    oss << "-";
+    if (!devicename.empty())
+    {
+        oss << devicename;
+    }
+    else
+    {
+        oss << nd->GetIfIndex();
+    }
+
+    auto iface = Create<Interface>();
+    iface->file = m_file;
+    iface->id = m_file->AddInterface(dataLinkType,
+                                     m_headersOnly ? MAX_HEADER_BYTES : PcapFile::SNAPLEN_DEFAULT,
+                                     oss.str());
+    iface->dataLinkType = dataLinkType;
+    iface->headersOnly = m_headersOnly;
+    iface->sampleThreshold = static_cast<uint64_t>(m_sampleRatio * 4294967296.0);
+    iface->seed = m_seed;
+    iface->rate = m_rate;
+    iface->burst = m_burst;
+    iface->tokens = m_burst;
+    iface->lastRefill = Simulator::Now();
+
+    bool result =
+        nd->TraceConnectWithoutContext(traceName, MakeBoundCallback(&CaptureSink, iface));
+    NS_ABORT_MSG_UNLESS(result,
+                        "PcapHeaderCaptureHelper::EnableCapture():  Unable to hook \"" << traceName
+                                                                                       << "\"");
+    return iface->id;
+}
+
+void
+PcapHeaderCaptureHelper::EnableCapture(NetDeviceContainer d,
+                                       PcapHelper::DataLinkType dataLinkType,
+                                       std::string traceName)
+{
+    for (auto i = d.Begin(); i != d.End(); ++i)
+    {
+        EnableCapture(*i, dataLinkType, traceName);
+    }
+}
+
+PcapHeaderCaptureHelper::Classification
+PcapHeaderCaptureHelper::Classify(uint32_t dataLinkType,
+                                  const uint8_t* buffer,
+                                  uint32_t length,
+                                  uint32_t seed)
+{
+    Classification c;
+    c.headerLength = length;
+
+    //
+    // Find the network layer.  A zero ethertype means "look at the IP version
+    // nibble", which is what raw and BSD loopback captures need.
+    //
+    uint32_t offset = 0;
+    uint16_t etherType = 0;
+    switch (dataLinkType)
+    {
+    case PcapHelper::DLT_PPP:
+        if (length < 2)
+        {
+            return c;
+        }
+        offset = 2;
+        etherType = (buffer[0] << 8) | buffer[1];
+        etherType = etherType == 0x0021 ? 0x0800 : (etherType == 0x0057 ? 0x86DD : 0xffff);
+        break;
+    case PcapHelper::DLT_EN10MB:
+        if (length < 14)
+        {
+            return c;
+        }
+        offset = 14;
+        etherType = (buffer[12] << 8) | buffer[13];
+        if (etherType == 0x8100 && length >= 18)
+        {
+            offset = 18;
+            etherType = (buffer[16] << 8) | buffer[17];
+        }
+        if (etherType < 0x0600)
+        {
+            // 802.3 length field followed by an LLC/SNAP header
+            if (length < offset + 8 || buffer[offset] != 0xaa || buffer[offset + 1] != 0xaa)
+            {
+                return c;
+            }
+            etherType = (buffer[offset + 6] << 8) | buffer[offset + 7];
+            offset += 8;
+        }
+        break;
+    case PcapHelper::DLT_LINUX_SLL:
+        if (length < 16)
+        {
+            return c;
+        }
+        offset = 16;
+        etherType = (buffer[14] << 8) | buffer[15];
+        break;
+    case PcapHelper::DLT_NULL:
+        offset = 4;
+        break;
+    case PcapHelper::DLT_RAW:
+        break;
+    default:
+        return c;
+    }
+
+    if (length <= offset)
+    {
+        return c;
+    }
+    if (etherType == 0)
+    {
+        uint8_t version = buffer[offset] >> 4;
+        etherType = version == 4 ? 0x0800 : (version == 6 ? 0x86DD : 0xffff);
+    }
+
+    const uint8_t* ip = buffer + offset;
+    uint32_t available = length - offset;
+    uint8_t protocol;
+    uint32_t ipLength;
+    uint32_t addrOffset;
+    uint32_t addrLength;
+    bool firstFragment = true;
+    bool fragment = false;
+    if (etherType == 0x0800)
+    {
+        if (available < 20)
+        {
+            return c;
+        }
+        ipLength = (ip[0] & 0x0f) * 4;
+        protocol = ip[9];
+        addrOffset = 12;
+        addrLength = 4;
+        firstFragment = (((ip[6] & 0x1f) << 8) | ip[7]) == 0;
+        fragment = !firstFragment || (ip[6] & 0x20);
+    }
+    else if (etherType == 0x86DD)
+    {
+        if (available < 40)
+        {
+            return c;
+        }
+        ipLength = 40;
+        protocol = ip[6];
+        addrOffset = 8;
+        addrLength = 16;
+    }
+    else
+    {
+        // Not IP: keep whatever was inspected
+        return c;
+    }
+    if (ipLength < 20 || available < ipLength)
+    {
+        return c;
+    }
+
+    //
+    // Build a canonical five-tuple, with the lowest (address, port) endpoint
+    // first, so that both directions of a flow share the same hash.
+    //
+    const uint8_t* l4 = ip + ipLength;
+    uint32_t l4Available = available - ipLength;
+    uint32_t l4Length = 0;
+    uint16_t ports[2] = {0, 0};
+    if (firstFragment)
+    {
+        switch (protocol)
+        {
+        case 6: // TCP
+            if (l4Available >= 20)
+            {
+                l4Length = (l4[12] >> 4) * 4;
+            }
+            break;
+        case 17: // UDP
+            l4Length = 8;
+            break;
+        case 1:  // ICMP
+        case 58: // ICMPv6
+            l4Length = 8;
+            break;
+        default:
+            break;
+        }
+        if (l4Length > l4Available)
+        {
+            l4Length = l4Available;
+        }
+        // Only the first fragment of a datagram carries the ports: leave them
+        // out of the flow of all the fragments, which are kept or discarded
+        // together
+        if ((protocol == 6 || protocol == 17) && l4Length >= 4 && !fragment)
+        {
+            ports[0] = (l4[0] << 8) | l4[1];
+            ports[1] = (l4[2] << 8) | l4[3];
+        }
+    }
+
+    uint8_t key[1 + 2 * (16 + 2) + 4] = {0};
+    const uint8_t* src = ip + addrOffset;
+    const uint8_t* dst = ip + addrOffset + addrLength;
+    int order = std::memcmp(src, dst, addrLength);
+    if (order > 0 || (order == 0 && ports[0] > ports[1]))
+    {
+        std::swap(src, dst);
+        std::swap(ports[0], ports[1]);
+    }
+    uint32_t k = 0;
+    key[k++] = protocol;
+    std::memcpy(key + k, src, addrLength);
+    k += addrLength;
+    key[k++] = ports[0] >> 8;
+    key[k++] = ports[0] & 0xff;
+    std::memcpy(key + k, dst, addrLength);
+    k += addrLength;
+    key[k++] = ports[1] >> 8;
+    key[k++] = ports[1] & 0xff;
+    std::memcpy(key + k, &seed, sizeof(seed));
+    k += sizeof(seed);
+
+    c.headerLength = offset + ipLength + l4Length;
+    c.hasFlow = true;
+    c.flowHash = Hash32(reinterpret_cast<const char*>(key), k);
+    return c;
+}
+
+void
+PcapHeaderCaptureHelper::CaptureSink(Ptr<Interface> iface, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(iface << p);
+
+    uint8_t headers[MAX_HEADER_BYTES];
+    uint32_t size = p->GetSize();
+    uint32_t copied = p->CopyData(headers, std::min(size, MAX_HEADER_BYTES));
+    Classification c = Classify(iface->dataLinkType, headers, copied, iface->seed);
+
+    if (c.hasFlow && c.flowHash >= iface->sampleThreshold)
+    {
+        return;
+    }
+
+    if (iface->rate > 0)
+    {
+        Time now = Simulator::Now();
+        iface->tokens = std::min(iface->burst,
+                                 iface->tokens + (now - iface->lastRefill).GetSeconds() * iface->rate);
+        iface->lastRefill = now;
+        if (iface->tokens < 1)
+        {
+            return;
+        }
+        iface->tokens -= 1;
+    }
+
+    if (iface->headersOnly)
+    {
+        iface->file->Write(Simulator::Now(), iface->id, headers, c.headerLength, size);
+    }
+    else
+    {
+        std::vector<uint8_t> buffer(size);
+        p->CopyData(buffer.data(), size);
+        iface->file->Write(Simulator::Now(), iface->id, buffer.data(), size, size);
+    }
+}
+
 AsciiTraceHelper::AsciiTraceHelper()
 {
     NS_LOG_FUNCTION_NOARGS();
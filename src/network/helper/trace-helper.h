@@ -24,6 +24,7 @@
 #include "ns3/assert.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file-wrapper.h"
 #include "ns3/simulator.h"
 
 namespace ns3
@@ -163,6 +164,166 @@ PcapHelper::HookDefaultSink(Ptr<T> object, std::string tracename, Ptr<PcapFileWr
                   "PcapHelper::HookDefaultSink():  Unable to hook \"" << tracename << "\"");
 }
 
+/**
+ * \brief Capture protocol headers of many devices into a single pcapng file
+ *
+ * Full pcap tracing of a large topology records every byte of every packet
+ * in one file per device.  This helper instead stores, for each packet, only
+ * the L2, L3 (IPv4/IPv6) and L4 (TCP/UDP/ICMP) headers, keeps a deterministic
+ * subset of the flows chosen by a hash of their five-tuple, optionally limits
+ * the number of records per device and per second, and multiplexes all the
+ * devices into one pcapng file in which each device is an interface.
+ *
+ * The helper must be opened on a file before devices are added.  Sampling
+ * and rate-limit settings are applied to the devices enabled after they are
+ * set.  Packets that are not IP (e.g., ARP) are not subject to flow sampling.
+ */
+class PcapHeaderCaptureHelper
+{
+  public:
+    /**
+     * Protocol headers found at the beginning of a captured packet.
+     */
+    struct Classification
+    {
+        uint32_t headerLength{0}; //!< bytes up to the end of the last recognized header
+        bool hasFlow{false};      //!< true if an IPv4/IPv6 five-tuple was found
+        uint32_t flowHash{0};     //!< direction-independent hash of the five-tuple
+    };
+
+    /**
+     * Maximum number of bytes inspected (and stored in header-only mode) per packet.
+     */
+    static constexpr uint32_t MAX_HEADER_BYTES = 192;
+
+    /**
+     * @brief Create a header capture helper.
+     */
+    PcapHeaderCaptureHelper();
+
+    /**
+     * @brief Destroy a header capture helper.
+     */
+    ~PcapHeaderCaptureHelper();
+
+    /**
+     * @brief Create the pcapng file all the devices are captured into.
+     *
+     * @param filename file name
+     */
+    void Open(std::string filename);
+
+    /**
+     * @returns the pcapng file, or nullptr if Open() was not called
+     */
+    Ptr<PcapngFileWrapper> GetFile() const;
+
+    /**
+     * @brief Select whether only protocol headers or whole packets are stored.
+     *
+     * @param headersOnly if true (the default), truncate records after the L4 header
+     */
+    void SetHeadersOnly(bool headersOnly);
+
+    /**
+     * @brief Keep only a fraction of the flows.
+     *
+     * A flow is kept if the hash of its five-tuple, computed with the given
+     * seed, falls in the lowest ratio of the hash space.  Both directions of
+     * a flow hash to the same value, and the same flow is kept or discarded
+     * on all devices, so that its path across the topology can be followed.
+     * The IPv4 fragments are hashed without their ports, so that all the
+     * fragments of a datagram are kept or discarded together.
+     *
+     * @param ratio fraction of flows to keep, in [0, 1]
+     * @param seed seed mixed into the five-tuple hash
+     */
+    void SetFlowSampling(double ratio, uint32_t seed = 0);
+
+    /**
+     * @brief Limit the number of records written for each device.
+     *
+     * Records are admitted by a token bucket filled at the given rate.
+     *
+     * @param packetsPerSecond sustained rate of records per device (0 disables the limit)
+     * @param burst maximum number of records written back to back
+     */
+    void SetRateLimit(uint32_t packetsPerSecond, uint32_t burst = 1);
+
+    /**
+     * @brief Capture the packets of a net device.
+     *
+     * @param nd net device
+     * @param dataLinkType data link type of the packets reported by the trace source
+     * @param traceName trace source reporting the packets, with signature
+     *        void (Ptr<const Packet>)
+     * @param useObjectNames use node and device names in the interface name
+     * @returns the pcapng interface ID of the device
+     */
+    uint32_t EnableCapture(Ptr<NetDevice> nd,
+                           PcapHelper::DataLinkType dataLinkType,
+                           std::string traceName = "PromiscSniffer",
+                           bool useObjectNames = true);
+
+    /**
+     * @brief Capture the packets of each device in the container.
+     *
+     * @param d container of devices
+     * @param dataLinkType data link type of the packets reported by the trace source
+     * @param traceName trace source reporting the packets
+     */
+    void EnableCapture(NetDeviceContainer d,
+                       PcapHelper::DataLinkType dataLinkType,
+                       std::string traceName = "PromiscSniffer");
+
+    /**
+     * @brief Find the protocol headers at the beginning of a packet.
+     *
+     * @param dataLinkType data link type of the packet
+     * @param buffer packet bytes
+     * @param length number of bytes available in buffer
+     * @param seed seed mixed into the five-tuple hash
+     * @returns the headers length and the flow hash
+     */
+    static Classification Classify(uint32_t dataLinkType,
+                                   const uint8_t* buffer,
+                                   uint32_t length,
+                                   uint32_t seed);
+
+  private:
+    /**
+     * Capture state of one device.
+     */
+    struct Interface : public SimpleRefCount<Interface>
+    {
+        Ptr<PcapngFileWrapper> file; //!< shared pcapng file
+        uint32_t id;                 //!< pcapng interface ID
+        uint32_t dataLinkType;       //!< data link type
+        bool headersOnly;            //!< store headers only
+        uint64_t sampleThreshold;    //!< flows with a hash below this value are kept
+        uint32_t seed;               //!< flow hash seed
+        double rate;                 //!< token bucket rate (records/s), 0 if unlimited
+        double burst;                //!< token bucket depth
+        double tokens;               //!< tokens available
+        Time lastRefill;             //!< last token bucket update
+    };
+
+    /**
+     * The trace sink.
+     *
+     * @param iface the device capture state
+     * @param p the packet
+     */
+    static void CaptureSink(Ptr<Interface> iface, Ptr<const Packet> p);
+
+    Ptr<PcapngFileWrapper> m_file; //!< shared pcapng file
+    bool m_headersOnly;            //!< store headers only
+    double m_sampleRatio;          //!< fraction of flows kept
+    uint32_t m_seed;               //!< flow hash seed
+    uint32_t m_rate;               //!< records per second per device, 0 if unlimited
+    uint32_t m_burst;              //!< token bucket depth
+};
+
 /**
  * \brief Manage ASCII trace files for device models
  *
@@ -25,6 +25,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <string_view>
 
 namespace ns3
 {
@@ -242,6 +243,15 @@ operator<(const Address& a, const Address& b)
     return false;
 }
 
+size_t
+AddressHash::operator()(const Address& x) const
+{
+    uint8_t buffer[Address::MAX_SIZE];
+    uint32_t length = x.CopyTo(buffer);
+    return std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char*>(buffer), length));
+}
+
 std::ostream&
 operator<<(std::ostream& os, const Address& address)
 {
@@ -291,6 +291,25 @@ bool operator<(const Address& a, const Address& b);
 std::ostream& operator<<(std::ostream& os, const Address& address);
 std::istream& operator>>(std::istream& is, Address& address);
 
+/**
+ * \ingroup address
+ *
+ * \brief Class providing an hash for addresses
+ */
+class AddressHash
+{
+  public:
+    /**
+     * \brief Returns the hash of an address.
+     * \param x the address
+     * \return the hash
+     *
+     * The type of the address is not hashed, as the addresses of
+     * type zero are equal to the addresses of any type.
+     */
+    size_t operator()(const Address& x) const;
+};
+
 } // namespace ns3
 
 #endif /* ADDRESS_H */
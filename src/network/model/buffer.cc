@@ -21,6 +21,8 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 #define LOG_INTERNAL_STATE(y)                                                                      \
     NS_LOG_LOGIC(y << "start=" << m_start << ", end=" << m_end                                     \
                    << ", zero start=" << m_zeroAreaStart << ", zero end=" << m_zeroAreaEnd         \
@@ -47,6 +49,51 @@ struct Zeroes
     const uint32_t size; //!< buffer size
 } g_zeroes;              //!< Zero-filled buffer
 
+/**
+ * \ingroup packet
+ * \brief Add up the 16-bit little endian words of an array of bytes.
+ *
+ * A trailing odd byte is added as the low byte of a word, like in
+ * ns3::Buffer::Iterator::CalculateIpChecksum.  Bytes are summed four at a
+ * time into a 64-bit accumulator, which cannot overflow for arrays shorter
+ * than 2^32 bytes, and the end-around carries are folded once at the end.
+ *
+ * \param data the bytes to add up
+ * \param len the number of bytes
+ * \return the one's complement sum, folded to 16 bits
+ */
+uint32_t
+ChecksumAdd(const uint8_t* data, uint32_t len)
+{
+    uint64_t sum = 0;
+    while (len >= 16)
+    {
+        for (int i = 0; i < 16; i += 4)
+        {
+            sum += static_cast<uint32_t>(data[i]) | (static_cast<uint32_t>(data[i + 1]) << 8) |
+                   (static_cast<uint32_t>(data[i + 2]) << 16) |
+                   (static_cast<uint32_t>(data[i + 3]) << 24);
+        }
+        data += 16;
+        len -= 16;
+    }
+    while (len >= 2)
+    {
+        sum += static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8);
+        data += 2;
+        len -= 2;
+    }
+    if (len)
+    {
+        sum += data[0];
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return static_cast<uint32_t>(sum);
+}
+
 } // namespace
 
 namespace ns3
@@ -407,6 +454,21 @@ Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
+    if (m_data == o.m_data && m_end == o.m_start && m_zeroAreaStart == m_zeroAreaEnd &&
+        o.m_zeroAreaStart == o.m_zeroAreaEnd)
+    {
+        /**
+         * This is an optimization which kicks in when
+         * we attempt to aggregate two adjacent views of
+         * the same data, such as two fragments of a buffer:
+         * without zero area, the offsets of both are the
+         * offsets in the data, and the views are joined.
+         */
+        m_end = o.m_end;
+        NS_ASSERT(CheckInternalState());
+        return;
+    }
+
     if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
         m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
         o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
@@ -954,7 +1016,7 @@ void
 Buffer::Iterator::Write(const uint8_t* buffer, uint32_t size)
 {
     NS_LOG_FUNCTION(this << &buffer << size);
-    NS_ASSERT_MSG(CheckNoZero(m_current, size), GetWriteErrorMessage());
+    NS_ASSERT_MSG(CheckNoZero(m_current, m_current + size), GetWriteErrorMessage());
     uint8_t* to;
     if (m_current <= m_zeroStart)
     {
@@ -1131,9 +1193,26 @@ void
 Buffer::Iterator::Read(uint8_t* buffer, uint32_t size)
 {
     NS_LOG_FUNCTION(this << &buffer << size);
-    for (uint32_t i = 0; i < size; i++)
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
+    // Copy the bytes in one go when they are all on the same side of the
+    // zero area, which is the case of most of the headers.
+    if (m_current + size <= m_zeroStart)
+    {
+        memcpy(buffer, &m_data[m_current], size);
+        m_current += size;
+    }
+    else if (m_current >= m_zeroEnd)
     {
-        buffer[i] = ReadU8();
+        memcpy(buffer, &m_data[m_current - (m_zeroEnd - m_zeroStart)], size);
+        m_current += size;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            buffer[i] = ReadU8();
+        }
     }
 }
 
@@ -1148,17 +1227,42 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum(uint16_t size, uint32_t initialChecksum)
 {
     NS_LOG_FUNCTION(this << size << initialChecksum);
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
     /* see RFC 1071 to understand this code. */
-    uint32_t sum = initialChecksum;
-
-    for (int j = 0; j < size / 2; j++)
+    uint64_t sum = initialChecksum;
+    uint32_t end = m_current + size;
+    uint32_t offset = 0;
+
+    //
+    // Add up the bytes stored before the zero area, skip the zero area, which
+    // adds nothing, and add up the bytes stored after it.  If these start at an
+    // odd offset, they are the high bytes of the words, so their sum is
+    // byte-swapped (RFC 1071, section 2(B)).
+    //
+    if (m_current < m_zeroStart)
     {
-        sum += ReadU16();
+        uint32_t n = std::min(end, m_zeroStart) - m_current;
+        sum += ChecksumAdd(&m_data[m_current], n);
+        m_current += n;
+        offset += n;
     }
-
-    if (size & 1)
+    if (m_current < m_zeroEnd && m_current < end)
+    {
+        uint32_t n = std::min(end, m_zeroEnd) - m_current;
+        m_current += n;
+        offset += n;
+    }
+    if (m_current < end)
     {
-        sum += ReadU8();
+        uint32_t n = end - m_current;
+        uint32_t partial = ChecksumAdd(&m_data[m_current - (m_zeroEnd - m_zeroStart)], n);
+        if (offset & 1)
+        {
+            partial = ((partial & 0xff) << 8) | (partial >> 8);
+        }
+        sum += partial;
+        m_current += n;
     }
 
     while (sum >> 16)
@@ -343,7 +343,8 @@ class Buffer
          *
          * Copy size bytes of data from the internal buffer to the
          * input buffer and advance the Iterator by the number of
-         * bytes read.
+         * bytes read.  The bytes are copied at once unless they
+         * span the zero area.
          */
         void Read(uint8_t* buffer, uint32_t size);
 
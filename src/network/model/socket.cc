@@ -956,4 +956,60 @@ SocketIpv6TclassTag::Print(std::ostream& os) const
     os << "IPV6_TCLASS = " << m_ipv6Tclass;
 }
 
+SocketPacingRateTag::SocketPacingRateTag()
+{
+}
+
+void
+SocketPacingRateTag::SetPacingRate(DataRate rate)
+{
+    m_pacingRate = rate.GetBitRate();
+}
+
+DataRate
+SocketPacingRateTag::GetPacingRate() const
+{
+    return DataRate(m_pacingRate);
+}
+
+TypeId
+SocketPacingRateTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SocketPacingRateTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<SocketPacingRateTag>();
+    return tid;
+}
+
+TypeId
+SocketPacingRateTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SocketPacingRateTag::GetSerializedSize() const
+{
+    return sizeof(uint64_t);
+}
+
+void
+SocketPacingRateTag::Serialize(TagBuffer i) const
+{
+    i.WriteU64(m_pacingRate);
+}
+
+void
+SocketPacingRateTag::Deserialize(TagBuffer i)
+{
+    m_pacingRate = i.ReadU64();
+}
+
+void
+SocketPacingRateTag::Print(std::ostream& os) const
+{
+    os << "SO_MAX_PACING_RATE = " << m_pacingRate;
+}
+
 } // namespace ns3
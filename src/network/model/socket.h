@@ -27,6 +27,7 @@
 #include "tag.h"
 
 #include "ns3/callback.h"
+#include "ns3/data-rate.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/object.h"
@@ -1404,6 +1405,57 @@ class SocketIpv6TclassTag : public Tag
     uint8_t m_ipv6Tclass; //!< the Tclass carried by the tag
 };
 
+/**
+ * \brief indicates the pacing rate of the socket that sent the packet.
+ *
+ * This is the equivalent of the sk_pacing_rate field of a Linux socket,
+ * which queue discs such as FqQueueDisc read to space out the packets of
+ * each flow. The tag does not leave the sending node.
+ */
+class SocketPacingRateTag : public Tag
+{
+  public:
+    SocketPacingRateTag();
+
+    /**
+     * \brief Set the tag's pacing rate
+     *
+     * \param rate the pacing rate
+     */
+    void SetPacingRate(DataRate rate);
+
+    /**
+     * \brief Get the tag's pacing rate
+     *
+     * \returns the pacing rate
+     */
+    DataRate GetPacingRate() const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    // inherited function, no need to doc.
+    TypeId GetInstanceTypeId() const override;
+
+    // inherited function, no need to doc.
+    uint32_t GetSerializedSize() const override;
+
+    // inherited function, no need to doc.
+    void Serialize(TagBuffer i) const override;
+
+    // inherited function, no need to doc.
+    void Deserialize(TagBuffer i) override;
+
+    // inherited function, no need to doc.
+    void Print(std::ostream& os) const override;
+
+  private:
+    uint64_t m_pacingRate{0}; //!< the pacing rate carried by the tag, in bit/s
+};
+
 } // namespace ns3
 
 #endif /* NS3_SOCKET_H */
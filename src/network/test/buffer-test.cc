@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <cstring>
+
 using namespace ns3;
 
 /**
@@ -352,6 +354,20 @@ BufferTest::DoRun()
     i = other.Begin();
     i.Write(buffer.Begin(), buffer.End());
     ENSURE_WRITTEN_BYTES(other, 9, 0x1, 0x2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3, 0x4);
+    // Read the bytes before the zero area, after it, and across it
+    uint8_t bytes[9];
+    i = buffer.Begin();
+    i.Read(bytes, 2);
+    NS_TEST_ASSERT_MSG_EQ((bytes[0] == 0x1 && bytes[1] == 0x2), true, "Bad Read() before zero");
+    i = buffer.End();
+    i.Prev(2);
+    i.Read(bytes, 2);
+    NS_TEST_ASSERT_MSG_EQ((bytes[0] == 0x3 && bytes[1] == 0x4), true, "Bad Read() after zero");
+    i = buffer.Begin();
+    i.Read(bytes, 9);
+    const uint8_t expected[] = {0x1, 0x2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3, 0x4};
+    NS_TEST_ASSERT_MSG_EQ(memcmp(bytes, expected, 9), 0, "Bad Read() across zero");
+    NS_TEST_ASSERT_MSG_EQ(i.IsEnd(), true, "Read() did not advance");
 
     // See \bugid{1001}
     std::string ct("This is the next content of the buffer.");
@@ -393,6 +409,133 @@ BufferTest::DoRun()
     val2 <<= 8;
     val2 |= i.ReadU8();
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
+
+    // Adjacent fragments of a buffer are joined without copying their data.
+    buffer = Buffer();
+    buffer.AddAtStart(6);
+    i = buffer.Begin();
+    i.WriteU8(0x1, 2);
+    i.WriteU8(0x2, 2);
+    i.WriteU8(0x3, 2);
+    Buffer head = buffer.CreateFragment(0, 2);
+    Buffer middle = buffer.CreateFragment(2, 2);
+    Buffer tail = buffer.CreateFragment(4, 2);
+    head.AddAtEnd(middle);
+    ENSURE_WRITTEN_BYTES(head, 4, 0x1, 0x1, 0x2, 0x2);
+    NS_TEST_ASSERT_MSG_EQ(head.PeekData(), buffer.PeekData(), "Adjacent fragments copied");
+    head.AddAtEnd(tail);
+    ENSURE_WRITTEN_BYTES(head, 6, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3);
+    NS_TEST_ASSERT_MSG_EQ(head.PeekData(), buffer.PeekData(), "Adjacent fragments copied");
+    middle.AddAtEnd(buffer.CreateFragment(0, 2));
+    ENSURE_WRITTEN_BYTES(middle, 4, 0x2, 0x2, 0x1, 0x1);
+    ENSURE_WRITTEN_BYTES(buffer, 6, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer::Iterator::CalculateIpChecksum unit tests.
+ *
+ * The checksum of buffers made of data, a zero area and data again, computed
+ * from various start positions and sizes, is compared with the sum of the
+ * 16-bit words read one at a time.
+ */
+class BufferChecksumTest : public TestCase
+{
+  private:
+    /**
+     * Reference implementation of the checksum
+     * \param i The iterator to read from
+     * \param size The number of bytes to add up
+     * \param initialChecksum The initial value
+     * \returns the checksum
+     */
+    uint16_t ReferenceChecksum(Buffer::Iterator i, uint16_t size, uint32_t initialChecksum);
+
+  public:
+    void DoRun() override;
+    BufferChecksumTest();
+};
+
+BufferChecksumTest::BufferChecksumTest()
+    : TestCase("Buffer checksum")
+{
+}
+
+uint16_t
+BufferChecksumTest::ReferenceChecksum(Buffer::Iterator i, uint16_t size, uint32_t initialChecksum)
+{
+    uint32_t sum = initialChecksum;
+    for (int j = 0; j < size / 2; j++)
+    {
+        sum += i.ReadU16();
+    }
+    if (size & 1)
+    {
+        sum += i.ReadU8();
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum;
+}
+
+void
+BufferChecksumTest::DoRun()
+{
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+    for (uint32_t head : {0, 1, 20, 33})
+    {
+        for (uint32_t zeroes : {0, 1, 100, 1001})
+        {
+            for (uint32_t tail : {0, 7, 1460})
+            {
+                Buffer buffer(zeroes);
+                buffer.AddAtStart(head);
+                Buffer::Iterator it = buffer.Begin();
+                for (uint32_t j = 0; j < head; j++)
+                {
+                    it.WriteU8(rng->GetInteger(0, 255));
+                }
+                buffer.AddAtEnd(tail);
+                it = buffer.End();
+                it.Prev(tail);
+                for (uint32_t j = 0; j < tail; j++)
+                {
+                    it.WriteU8(rng->GetInteger(0, 255));
+                }
+
+                uint32_t total = buffer.GetSize();
+                for (uint32_t start : {0U, 1U, 2U, head + 1, total / 2})
+                {
+                    if (start > total)
+                    {
+                        continue;
+                    }
+                    for (uint32_t size : {total - start, (total - start) / 3})
+                    {
+                        uint32_t initial = rng->GetInteger(0, 0xffff);
+                        it = buffer.Begin();
+                        it.Next(start);
+                        uint16_t expected = ReferenceChecksum(it, size, initial);
+                        uint16_t checksum = it.CalculateIpChecksum(size, initial);
+                        NS_TEST_EXPECT_MSG_EQ(checksum,
+                                              expected,
+                                              "Bad checksum for head=" << head << " zeroes="
+                                                                       << zeroes << " tail=" << tail
+                                                                       << " start=" << start
+                                                                       << " size=" << size);
+                        NS_TEST_EXPECT_MSG_EQ(it.GetDistanceFrom(buffer.Begin()),
+                                              start + size,
+                                              "Iterator not advanced past the summed bytes");
+                    }
+                }
+            }
+        }
+    }
 }
 
 /**
@@ -411,6 +554,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", UNIT)
 {
     AddTestCase(new BufferTest, TestCase::QUICK);
+    AddTestCase(new BufferChecksumTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
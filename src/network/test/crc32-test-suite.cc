@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/crc32.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief CRC-32 unit tests.
+ *
+ * Checks the standard check value, then compares the result for various
+ * lengths and alignments with a bitwise implementation.
+ */
+class Crc32TestCase : public TestCase
+{
+  public:
+    Crc32TestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Bitwise CRC-32 (IEEE 802.3, reflected)
+     * \param data the bytes
+     * \param length the number of bytes
+     * \returns the CRC-32 of the bytes
+     */
+    static uint32_t BitwiseCrc32(const uint8_t* data, int length);
+};
+
+Crc32TestCase::Crc32TestCase()
+    : TestCase("Check CRC-32 against the check value and a bitwise implementation")
+{
+}
+
+uint32_t
+Crc32TestCase::BitwiseCrc32(const uint8_t* data, int length)
+{
+    uint32_t crc = 0xffffffff;
+    for (int i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void
+Crc32TestCase::DoRun()
+{
+    const char* check = "123456789";
+    NS_TEST_EXPECT_MSG_EQ(CRC32Calculate(reinterpret_cast<const uint8_t*>(check), 9),
+                          0xCBF43926,
+                          "Wrong CRC-32 check value");
+    NS_TEST_EXPECT_MSG_EQ(CRC32Calculate(nullptr, 0), 0, "Wrong CRC-32 of no data");
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+    std::vector<uint8_t> data(1600);
+    for (auto& byte : data)
+    {
+        byte = rng->GetInteger(0, 255);
+    }
+    for (int offset = 0; offset < 8; offset++)
+    {
+        for (int length : {1, 7, 8, 9, 15, 16, 17, 64, 1514, 1591})
+        {
+            NS_TEST_EXPECT_MSG_EQ(CRC32Calculate(data.data() + offset, length),
+                                  BitwiseCrc32(data.data() + offset, length),
+                                  "Wrong CRC-32 for offset " << offset << " length " << length);
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief CRC-32 TestSuite
+ */
+class Crc32TestSuite : public TestSuite
+{
+  public:
+    Crc32TestSuite();
+};
+
+Crc32TestSuite::Crc32TestSuite()
+    : TestSuite("crc32", UNIT)
+{
+    AddTestCase(new Crc32TestCase, TestCase::QUICK);
+}
+
+static Crc32TestSuite g_crc32TestSuite; //!< Static variable for test initialization
@@ -16,9 +16,12 @@
  */
 
 #include "ns3/drop-tail-queue.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <list>
+
 using namespace ns3;
 
 /**
@@ -87,6 +90,106 @@ DropTailQueueTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(packet, nullptr, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBuffer unit tests, checked against a std::list holding the same elements.
+ */
+class RingBufferTestCase : public TestCase
+{
+  public:
+    RingBufferTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Check that the ring buffer and the reference list hold the same elements.
+     * \param ring the ring buffer
+     * \param ref the reference list
+     */
+    void CheckEqual(const RingBuffer<int>& ring, const std::list<int>& ref);
+};
+
+RingBufferTestCase::RingBufferTestCase()
+    : TestCase("Check the RingBuffer queue container")
+{
+}
+
+void
+RingBufferTestCase::CheckEqual(const RingBuffer<int>& ring, const std::list<int>& ref)
+{
+    NS_TEST_ASSERT_MSG_EQ(ring.size(), ref.size(), "Unexpected number of elements");
+    auto it = ring.begin();
+    for (auto v : ref)
+    {
+        NS_TEST_ASSERT_MSG_EQ(*it, v, "Unexpected element");
+        ++it;
+    }
+    NS_TEST_EXPECT_MSG_EQ((it == ring.end()), true, "Iterators do not reach end()");
+}
+
+void
+RingBufferTestCase::DoRun()
+{
+    RingBuffer<int> ring;
+    std::list<int> ref;
+
+    // FIFO usage, wrapping around the initial capacity several times
+    int next = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        ring.insert(ring.end(), next);
+        ref.push_back(next++);
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        ring.insert(ring.end(), next);
+        ref.push_back(next++);
+        ring.erase(ring.begin());
+        ref.pop_front();
+    }
+    CheckEqual(ring, ref);
+    NS_TEST_EXPECT_MSG_EQ(ring.capacity(),
+                          RingBuffer<int>::MIN_CAPACITY,
+                          "A FIFO with a bounded backlog should not grow");
+
+    // growth while wrapped
+    for (int i = 0; i < 40; i++)
+    {
+        ring.insert(ring.end(), next);
+        ref.push_back(next++);
+    }
+    CheckEqual(ring, ref);
+
+    // insertion and removal in the middle, on both sides
+    auto refIt = ref.begin();
+    std::advance(refIt, 3);
+    ref.insert(refIt, -1);
+    ring.insert(ring.begin() + 3, -1);
+    refIt = ref.begin();
+    std::advance(refIt, 45);
+    ref.insert(refIt, -2);
+    ring.insert(ring.begin() + 45, -2);
+    CheckEqual(ring, ref);
+
+    refIt = ref.begin();
+    std::advance(refIt, 5);
+    ref.erase(refIt);
+    ring.erase(ring.begin() + 5);
+    refIt = ref.begin();
+    std::advance(refIt, 40);
+    ref.erase(refIt);
+    ring.erase(ring.begin() + 40);
+    ref.pop_back();
+    ring.erase(ring.end() - 1);
+    CheckEqual(ring, ref);
+
+    ring.clear();
+    NS_TEST_EXPECT_MSG_EQ(ring.empty(), true, "The ring buffer should be empty");
+    NS_TEST_EXPECT_MSG_EQ(ring.capacity(), 0, "clear() should release the memory");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -100,6 +203,7 @@ class DropTailQueueTestSuite : public TestSuite
         : TestSuite("drop-tail-queue", UNIT)
     {
         AddTestCase(new DropTailQueueTestCase(), TestCase::QUICK);
+        AddTestCase(new RingBufferTestCase(), TestCase::QUICK);
     }
 };
 
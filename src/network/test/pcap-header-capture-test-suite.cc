@@ -0,0 +1,284 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/pcapng-file-wrapper.h"
+#include "ns3/test.h"
+#include "ns3/trace-helper.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Build a PPP frame carrying an IPv4 header and a 20-byte TCP header
+ * followed by a payload.
+ *
+ * \param src source address (last byte)
+ * \param dst destination address (last byte)
+ * \param sport source port
+ * \param dport destination port
+ * \param payload payload size
+ * \returns the frame bytes
+ */
+static std::vector<uint8_t>
+MakePppTcpFrame(uint8_t src, uint8_t dst, uint16_t sport, uint16_t dport, uint32_t payload)
+{
+    std::vector<uint8_t> frame(2 + 20 + 20 + payload, 0);
+    frame[0] = 0x00;
+    frame[1] = 0x21;
+    uint8_t* ip = frame.data() + 2;
+    ip[0] = 0x45;
+    ip[9] = 6;
+    ip[12] = 10;
+    ip[15] = src;
+    ip[16] = 10;
+    ip[19] = dst;
+    uint8_t* tcp = ip + 20;
+    tcp[0] = sport >> 8;
+    tcp[1] = sport & 0xff;
+    tcp[2] = dport >> 8;
+    tcp[3] = dport & 0xff;
+    tcp[12] = 5 << 4;
+    return frame;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the L2-L4 headers and flow of a packet are identified.
+ */
+class PcapHeaderClassifyTestCase : public TestCase
+{
+  public:
+    PcapHeaderClassifyTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PcapHeaderClassifyTestCase::PcapHeaderClassifyTestCase()
+    : TestCase("Check header length and flow hash of captured packets")
+{
+}
+
+void
+PcapHeaderClassifyTestCase::DoRun()
+{
+    auto fwd = MakePppTcpFrame(1, 2, 49153, 80, 1000);
+    auto c = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP, fwd.data(), fwd.size(), 0);
+    NS_TEST_EXPECT_MSG_EQ(c.hasFlow, true, "PPP/IPv4/TCP flow not recognized");
+    NS_TEST_EXPECT_MSG_EQ(c.headerLength, 42, "Wrong PPP/IPv4/TCP header length");
+
+    auto rev = MakePppTcpFrame(2, 1, 80, 49153, 0);
+    auto r = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP, rev.data(), rev.size(), 0);
+    NS_TEST_EXPECT_MSG_EQ(r.flowHash, c.flowHash, "Both directions must share the flow hash");
+
+    auto other = MakePppTcpFrame(1, 2, 49154, 80, 1000);
+    auto o = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP, other.data(), other.size(), 0);
+    NS_TEST_EXPECT_MSG_NE(o.flowHash, c.flowHash, "Different flows should hash differently");
+
+    auto s = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP, fwd.data(), fwd.size(), 7);
+    NS_TEST_EXPECT_MSG_NE(s.flowHash, c.flowHash, "The seed should change the flow hash");
+
+    // Ethernet + IPv6 + UDP
+    std::vector<uint8_t> eth(14 + 40 + 8 + 500, 0);
+    eth[12] = 0x86;
+    eth[13] = 0xdd;
+    eth[14] = 0x60;
+    eth[14 + 6] = 17;
+    auto e = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_EN10MB, eth.data(), eth.size(), 0);
+    NS_TEST_EXPECT_MSG_EQ(e.hasFlow, true, "Ethernet/IPv6/UDP flow not recognized");
+    NS_TEST_EXPECT_MSG_EQ(e.headerLength, 62, "Wrong Ethernet/IPv6/UDP header length");
+
+    // ARP is not sampled and is kept as inspected
+    std::vector<uint8_t> arp(14 + 28, 0);
+    arp[12] = 0x08;
+    arp[13] = 0x06;
+    auto a = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_EN10MB, arp.data(), arp.size(), 0);
+    NS_TEST_EXPECT_MSG_EQ(a.hasFlow, false, "ARP has no five-tuple");
+    NS_TEST_EXPECT_MSG_EQ(a.headerLength, arp.size(), "Non-IP frames are kept whole");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the fragments of a datagram belong to the same flow.
+ *
+ * A UDP datagram is split into three IPv4 fragments, of which only the
+ * first carries the UDP header. The fragments must have the same flow hash
+ * for any seed, so that they are all kept or all discarded by the sampling.
+ */
+class PcapHeaderFragmentTestCase : public TestCase
+{
+  public:
+    PcapHeaderFragmentTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PcapHeaderFragmentTestCase::PcapHeaderFragmentTestCase()
+    : TestCase("Check that the fragments of a datagram share the flow hash")
+{
+}
+
+void
+PcapHeaderFragmentTestCase::DoRun()
+{
+    // PPP + IPv4 fragments of a 3008-byte UDP datagram, 1480 bytes each
+    std::vector<std::vector<uint8_t>> fragments;
+    for (uint16_t offset : {0, 1480, 2960})
+    {
+        std::vector<uint8_t> frame(2 + 20 + 1480, 0);
+        frame[0] = 0x00;
+        frame[1] = 0x21;
+        uint8_t* ip = frame.data() + 2;
+        ip[0] = 0x45;
+        ip[6] = ((offset / 8) >> 8) | (offset < 2960 ? 0x20 : 0);
+        ip[7] = (offset / 8) & 0xff;
+        ip[9] = 17;
+        ip[12] = 10;
+        ip[15] = 1;
+        ip[16] = 10;
+        ip[19] = 2;
+        if (offset == 0)
+        {
+            uint8_t* udp = ip + 20;
+            udp[0] = 49153 >> 8;
+            udp[1] = 49153 & 0xff;
+            udp[2] = 0;
+            udp[3] = 53;
+        }
+        fragments.push_back(frame);
+    }
+
+    auto first = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP,
+                                                   fragments[0].data(),
+                                                   fragments[0].size(),
+                                                   0);
+    NS_TEST_EXPECT_MSG_EQ(first.hasFlow, true, "First fragment flow not recognized");
+    NS_TEST_EXPECT_MSG_EQ(first.headerLength, 30, "Wrong first fragment header length");
+    auto last = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP,
+                                                  fragments[2].data(),
+                                                  fragments[2].size(),
+                                                  0);
+    NS_TEST_EXPECT_MSG_EQ(last.headerLength, 22, "Wrong trailing fragment header length");
+
+    for (uint32_t seed = 0; seed < 100; seed++)
+    {
+        auto c = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP,
+                                                   fragments[0].data(),
+                                                   fragments[0].size(),
+                                                   seed);
+        for (const auto& fragment : fragments)
+        {
+            auto f = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP,
+                                                       fragment.data(),
+                                                       fragment.size(),
+                                                       seed);
+            NS_TEST_EXPECT_MSG_EQ(f.hasFlow, true, "Fragment flow not recognized");
+            NS_TEST_EXPECT_MSG_EQ(f.flowHash, c.flowHash, "Fragments sampled differently");
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the block layout of a pcapng file.
+ */
+class PcapngWriteTestCase : public TestCase
+{
+  public:
+    PcapngWriteTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PcapngWriteTestCase::PcapngWriteTestCase()
+    : TestCase("Check the pcapng section, interface and packet blocks")
+{
+}
+
+void
+PcapngWriteTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("pcapng-write-test.pcapng");
+    auto file = CreateObject<PcapngFileWrapper>();
+    file->Open(filename);
+    NS_TEST_ASSERT_MSG_EQ(file->Fail(), false, "Unable to open " << filename);
+    NS_TEST_EXPECT_MSG_EQ(file->AddInterface(PcapHelper::DLT_PPP, 192, "0-1"), 0, "First id");
+    NS_TEST_EXPECT_MSG_EQ(file->AddInterface(PcapHelper::DLT_EN10MB, 192, ""), 1, "Second id");
+    uint8_t data[5] = {1, 2, 3, 4, 5};
+    file->Write(NanoSeconds(0x100000002ULL), 1, data, sizeof(data), 1500);
+    file->Close();
+
+    std::ifstream in(filename, std::ios::binary);
+    std::vector<uint32_t> words;
+    uint32_t word;
+    while (in.read(reinterpret_cast<char*>(&word), sizeof(word)))
+    {
+        words.push_back(word);
+    }
+
+    // SHB (28) + IDB with a 3-byte name (40) + IDB (32) + EPB with 5 bytes (40)
+    NS_TEST_ASSERT_MSG_EQ(words.size(), (28 + 40 + 32 + 40) / 4, "Wrong file size");
+    NS_TEST_EXPECT_MSG_EQ(words[0], PcapngFileWrapper::SHB_TYPE, "Missing section header");
+    NS_TEST_EXPECT_MSG_EQ(words[2], PcapngFileWrapper::BYTE_ORDER_MAGIC, "Wrong byte order");
+    NS_TEST_EXPECT_MSG_EQ(words[7], PcapngFileWrapper::IDB_TYPE, "Missing first interface");
+    NS_TEST_EXPECT_MSG_EQ(words[8], 40, "Wrong first interface block length");
+    NS_TEST_EXPECT_MSG_EQ(words[17], PcapngFileWrapper::IDB_TYPE, "Missing second interface");
+    uint32_t epb = 25;
+    NS_TEST_EXPECT_MSG_EQ(words[epb], PcapngFileWrapper::EPB_TYPE, "Missing packet block");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 1], 40, "Wrong packet block length");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 2], 1, "Wrong interface id");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 3], 1, "Wrong timestamp (high)");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 4], 2, "Wrong timestamp (low)");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 5], 5, "Wrong captured length");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 6], 1500, "Wrong original length");
+    NS_TEST_EXPECT_MSG_EQ(words[epb + 9], 40, "Wrong trailing block length");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapHeaderCaptureHelper TestSuite
+ */
+class PcapHeaderCaptureTestSuite : public TestSuite
+{
+  public:
+    PcapHeaderCaptureTestSuite();
+};
+
+PcapHeaderCaptureTestSuite::PcapHeaderCaptureTestSuite()
+    : TestSuite("pcap-header-capture", UNIT)
+{
+    AddTestCase(new PcapHeaderClassifyTestCase, TestCase::QUICK);
+    AddTestCase(new PcapHeaderFragmentTestCase, TestCase::QUICK);
+    AddTestCase(new PcapngWriteTestCase, TestCase::QUICK);
+}
+
+static PcapHeaderCaptureTestSuite
+    g_pcapHeaderCaptureTestSuite; //!< Static variable for test initialization
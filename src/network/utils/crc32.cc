@@ -24,7 +24,7 @@
  * COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or
  * code or tables extracted from it, as desired without restriction.
  */
-#include <stdint.h>
+#include "crc32.h"
 
 namespace ns3
 {
@@ -67,12 +67,65 @@ static uint32_t crc32table[256] = {
     0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
 };
 
+/**
+ * Tables for the slice-by-8 algorithm: entry i of table k is the CRC-32
+ * remainder of byte i followed by k zero bytes.  Table 0 is crc32table.
+ */
+static uint32_t crc32slices[8][256];
+
+/**
+ * Compute the tables for the slice-by-8 algorithm on first use.
+ *
+ * \returns the tables for the slice-by-8 algorithm
+ */
+static const uint32_t (*GetCrc32Slices())[256]
+{
+    static const bool initialized = []() {
+        for (int i = 0; i < 256; i++)
+        {
+            crc32slices[0][i] = crc32table[i];
+        }
+        for (int k = 1; k < 8; k++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                uint32_t c = crc32slices[k - 1][i];
+                crc32slices[k][i] = (c >> 8) ^ crc32slices[0][c & 0xFF];
+            }
+        }
+        return true;
+    }();
+    (void)initialized;
+    return crc32slices;
+}
+
 uint32_t
 CRC32Calculate(const uint8_t* data, int length)
 {
     uint32_t crc = 0xffffffff;
 
-    while (length--)
+    //
+    // Slice-by-8: fold eight bytes into the remainder per iteration, with one
+    // independent table lookup per byte, then finish byte at a time.
+    //
+    if (length >= 8)
+    {
+        const uint32_t(*t)[256] = GetCrc32Slices();
+        while (length >= 8)
+        {
+            uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) |
+                                 (static_cast<uint32_t>(data[1]) << 8) |
+                                 (static_cast<uint32_t>(data[2]) << 16) |
+                                 (static_cast<uint32_t>(data[3]) << 24));
+            crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^
+                  t[4][lo >> 24] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^
+                  t[0][data[7]];
+            data += 8;
+            length -= 8;
+        }
+    }
+
+    while (length-- > 0)
     {
         crc = (crc >> 8) ^ crc32table[(crc & 0xFF) ^ *data++];
     }
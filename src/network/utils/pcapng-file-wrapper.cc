@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcapng-file-wrapper.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PcapngFileWrapper");
+
+NS_OBJECT_ENSURE_REGISTERED(PcapngFileWrapper);
+
+/// Option code terminating an option list
+static const uint16_t OPT_ENDOFOPT = 0;
+/// Interface name option code
+static const uint16_t OPT_IF_NAME = 2;
+/// Interface timestamp resolution option code
+static const uint16_t OPT_IF_TSRESOL = 9;
+
+/**
+ * \param length a length in bytes
+ * \returns length rounded up to a multiple of 4
+ */
+static uint32_t
+Pad32(uint32_t length)
+{
+    return (length + 3) & ~3U;
+}
+
+TypeId
+PcapngFileWrapper::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PcapngFileWrapper")
+                            .SetParent<Object>()
+                            .SetGroupName("Network")
+                            .AddConstructor<PcapngFileWrapper>();
+    return tid;
+}
+
+PcapngFileWrapper::PcapngFileWrapper()
+    : m_nInterfaces(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PcapngFileWrapper::~PcapngFileWrapper()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+PcapngFileWrapper::Fail() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_file.fail();
+}
+
+void
+PcapngFileWrapper::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    m_nInterfaces = 0;
+
+    //
+    // Section Header Block without options: block type, total length, byte
+    // order magic, version 1.0, unknown (-1) section length, total length.
+    //
+    const uint32_t length = 28;
+    Write32(SHB_TYPE);
+    Write32(length);
+    Write32(BYTE_ORDER_MAGIC);
+    Write16(1);
+    Write16(0);
+    Write32(0xffffffff);
+    Write32(0xffffffff);
+    Write32(length);
+}
+
+void
+PcapngFileWrapper::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+uint32_t
+PcapngFileWrapper::AddInterface(uint16_t dataLinkType, uint32_t snapLen, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << dataLinkType << snapLen << name);
+
+    // 16 bytes of fixed fields, if_tsresol (8), opt_endofopt (4), trailing length (4)
+    uint32_t length = 32;
+    if (!name.empty())
+    {
+        length += 4 + Pad32(name.size());
+    }
+
+    Write32(IDB_TYPE);
+    Write32(length);
+    Write16(dataLinkType);
+    Write16(0);
+    Write32(snapLen);
+    if (!name.empty())
+    {
+        Write16(OPT_IF_NAME);
+        Write16(name.size());
+        m_file.write(name.data(), name.size());
+        WritePadding(name.size());
+    }
+    Write16(OPT_IF_TSRESOL);
+    Write16(1);
+    uint8_t resolution = 9; // 10^-9 s
+    m_file.write(reinterpret_cast<const char*>(&resolution), 1);
+    WritePadding(1);
+    Write16(OPT_ENDOFOPT);
+    Write16(0);
+    Write32(length);
+
+    return m_nInterfaces++;
+}
+
+uint32_t
+PcapngFileWrapper::GetNInterfaces() const
+{
+    return m_nInterfaces;
+}
+
+void
+PcapngFileWrapper::Write(Time t,
+                         uint32_t interfaceId,
+                         const uint8_t* buffer,
+                         uint32_t capturedLength,
+                         uint32_t originalLength)
+{
+    NS_LOG_FUNCTION(this << t << interfaceId << capturedLength << originalLength);
+    NS_ASSERT_MSG(interfaceId < m_nInterfaces, "Unknown pcapng interface " << interfaceId);
+
+    uint64_t ts = t.GetNanoSeconds();
+    uint32_t length = 32 + Pad32(capturedLength);
+
+    Write32(EPB_TYPE);
+    Write32(length);
+    Write32(interfaceId);
+    Write32(ts >> 32);
+    Write32(ts & 0xffffffff);
+    Write32(capturedLength);
+    Write32(originalLength);
+    m_file.write(reinterpret_cast<const char*>(buffer), capturedLength);
+    WritePadding(capturedLength);
+    Write32(length);
+}
+
+void
+PcapngFileWrapper::Write16(uint16_t data)
+{
+    m_file.write(reinterpret_cast<const char*>(&data), sizeof(data));
+}
+
+void
+PcapngFileWrapper::Write32(uint32_t data)
+{
+    m_file.write(reinterpret_cast<const char*>(&data), sizeof(data));
+}
+
+void
+PcapngFileWrapper::WritePadding(uint32_t length)
+{
+    static const char zeros[4] = {0, 0, 0, 0};
+    m_file.write(zeros, Pad32(length) - length);
+}
+
+} // namespace ns3
@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_WRAPPER_H
+#define PCAPNG_FILE_WRAPPER_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <fstream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief A write-only pcapng file holding packets captured on several interfaces.
+ *
+ * Unlike the classic pcap format handled by PcapFileWrapper, a pcapng section
+ * can describe any number of interfaces, each with its own data link type and
+ * snap length, and every packet record refers to the interface it was captured
+ * on.  This lets a whole topology be traced into a single file.
+ *
+ * The file is written in host byte order with nanosecond timestamp resolution
+ * on every interface.
+ *
+ * See https://datatracker.ietf.org/doc/draft-ietf-opsawg-pcapng/
+ */
+class PcapngFileWrapper : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    PcapngFileWrapper();
+    ~PcapngFileWrapper() override;
+
+    static constexpr uint32_t SHB_TYPE = 0x0A0D0D0A; //!< Section Header Block type
+    static constexpr uint32_t IDB_TYPE = 0x00000001; //!< Interface Description Block type
+    static constexpr uint32_t EPB_TYPE = 0x00000006; //!< Enhanced Packet Block type
+    static constexpr uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D; //!< Section byte order magic
+
+    /**
+     * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+     */
+    bool Fail() const;
+
+    /**
+     * Create (truncating) a pcapng file and write its Section Header Block.
+     *
+     * \param filename String containing the name of the file.
+     */
+    void Open(const std::string& filename);
+
+    /**
+     * Close the underlying file.
+     */
+    void Close();
+
+    /**
+     * \brief Describe a new capture interface in the file.
+     *
+     * \param dataLinkType the data link type of the packets captured on the interface
+     * \param snapLen maximum number of bytes stored per packet of this interface
+     * \param name interface name stored in the if_name option (omitted if empty)
+     * \returns the interface ID to be passed to Write()
+     */
+    uint32_t AddInterface(uint16_t dataLinkType, uint32_t snapLen, const std::string& name);
+
+    /**
+     * \returns the number of interfaces described so far
+     */
+    uint32_t GetNInterfaces() const;
+
+    /**
+     * \brief Write an Enhanced Packet Block.
+     *
+     * \param t Packet timestamp as ns3::Time.
+     * \param interfaceId interface returned by AddInterface()
+     * \param buffer the captured bytes
+     * \param capturedLength number of bytes of buffer to store
+     * \param originalLength length of the packet on the wire
+     */
+    void Write(Time t,
+               uint32_t interfaceId,
+               const uint8_t* buffer,
+               uint32_t capturedLength,
+               uint32_t originalLength);
+
+  private:
+    /**
+     * Write a 16-bit value in host byte order.
+     * \param data the value
+     */
+    void Write16(uint16_t data);
+    /**
+     * Write a 32-bit value in host byte order.
+     * \param data the value
+     */
+    void Write32(uint32_t data);
+    /**
+     * Write zero bytes up to the next 32-bit boundary.
+     * \param length number of bytes written since the last boundary
+     */
+    void WritePadding(uint32_t length);
+
+    std::ofstream m_file;   //!< output stream
+    uint32_t m_nInterfaces; //!< number of Interface Description Blocks written
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_WRAPPER_H */
@@ -31,9 +31,12 @@
 namespace ns3
 {
 
+template <typename T>
+class RingBuffer;
+
 // Forward declaration of template class Queue specifying
 // the default value for the template template parameter Container
-template <typename Item, typename Container = std::list<Ptr<Item>>>
+template <typename Item, typename Container = RingBuffer<Ptr<Item>>>
 class Queue;
 
 } // namespace ns3
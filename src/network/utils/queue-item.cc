@@ -146,4 +146,10 @@ QueueDiscItem::Hash(uint32_t perturbation) const
     return 0;
 }
 
+std::vector<Ptr<QueueDiscItem>>
+QueueDiscItem::GsoSegment()
+{
+    return {};
+}
+
 } // namespace ns3
@@ -24,6 +24,8 @@
 #include "ns3/simple-ref-count.h"
 #include <ns3/address.h>
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -217,6 +219,25 @@ class QueueDiscItem : public QueueItem
      */
     virtual uint32_t Hash(uint32_t perturbation = 0) const;
 
+    /**
+     * \brief Split a packet built by generic segmentation offload (GSO)
+     *
+     * A transport protocol may build packets larger than the MTU of the device,
+     * leaving their segmentation to the point where they are handed to the
+     * device. This method returns the items carrying the wire-sized segments of
+     * such a packet, with the same address, protocol, transmission queue index
+     * and timestamp as this item and their header not added yet. It must be
+     * called before AddHeader.
+     *
+     * This method just returns an empty list, meaning that the packet is to be
+     * sent as is. Subclasses should implement it for the protocols that build
+     * GSO packets.
+     *
+     * \return the items carrying the segments, or an empty list if the packet
+     *         is not a GSO packet
+     */
+    virtual std::vector<Ptr<QueueDiscItem>> GsoSegment();
+
   private:
     Address m_address;   //!< MAC destination address
     uint16_t m_protocol; //!< L3 Protocol number
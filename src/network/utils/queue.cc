@@ -86,6 +86,12 @@ QueueBase::IsEmpty() const
     return m_nPackets.Get() == 0;
 }
 
+bool
+QueueBase::IsTraced() const
+{
+    return !m_nBytes.IsEmpty() || !m_nPackets.IsEmpty();
+}
+
 uint32_t
 QueueBase::GetNPackets() const
 {
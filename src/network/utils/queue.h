@@ -25,6 +25,7 @@
 #include "queue-fwd.h"
 #include "queue-item.h"
 #include "queue-size.h"
+#include "ring-buffer.h"
 
 #include "ns3/log.h"
 #include "ns3/object.h"
@@ -190,6 +191,12 @@ class QueueBase : public Object
      */
     bool WouldOverflow(uint32_t nPackets, uint32_t nBytes) const;
 
+    /**
+     * \brief Check whether any trace sink is connected to the trace sources of the queue
+     * \return true if a trace sink is connected
+     */
+    virtual bool IsTraced() const;
+
 #if 0
   // average calculation requires keeping around
   // a buffer with the date of arrival of past received packets
@@ -246,7 +253,10 @@ class QueueBase : public Object
  * container used internally to store queue items. The container type must provide
  * the methods insert(), erase() and clear() and define the iterator and const_iterator
  * types, following the usual syntax of C++ containers. The default container type
- * is std::list (as defined in queue-fwd.h). In case the container is such that
+ * is RingBuffer (as defined in queue-fwd.h), which does not allocate memory on
+ * enqueue and dequeue once it has grown to the largest queue occupancy; std::list
+ * can be used instead when iterators must remain valid across insertions and
+ * removals. In case the container is such that
  * an object stored within the queue is obtained from a container element through
  * an operation other than dereferencing an iterator pointing to the container
  * element, the container has to provide a public method named GetItem that
@@ -311,6 +321,8 @@ class Queue : public QueueBase
      */
     void Flush();
 
+    bool IsTraced() const override;
+
     /// Define ItemType as the type of the stored elements
     typedef Item ItemType;
 
@@ -614,6 +626,15 @@ Queue<Item, Container>::Flush()
     }
 }
 
+template <typename Item, typename Container>
+bool
+Queue<Item, Container>::IsTraced() const
+{
+    return QueueBase::IsTraced() || !m_traceEnqueue.IsEmpty() || !m_traceDequeue.IsEmpty() ||
+           !m_traceDrop.IsEmpty() || !m_traceDropBeforeEnqueue.IsEmpty() ||
+           !m_traceDropAfterDequeue.IsEmpty();
+}
+
 template <typename Item, typename Container>
 void
 Queue<Item, Container>::DoDispose()
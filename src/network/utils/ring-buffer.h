@@ -0,0 +1,513 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup queue
+ * ns3::RingBuffer declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief A growable circular buffer usable as the container of a Queue
+ *
+ * Elements are stored contiguously in a power-of-two sized array indexed
+ * modulo its capacity.  Inserting at the end and erasing at the beginning,
+ * which is all a FIFO queue does, are constant time and do not allocate
+ * memory once the buffer has grown to the largest occupancy of the queue.
+ * When full, the capacity doubles (starting from MIN_CAPACITY); it never
+ * shrinks, except on clear().  Inserting or erasing elsewhere is supported
+ * for completeness and shifts the elements on the shorter side of the
+ * position.
+ *
+ * Iterators designate a position relative to the first element; they are
+ * invalidated by any insertion or removal, like std::vector iterators.
+ *
+ * \tparam T the type of the stored elements
+ */
+template <typename T>
+class RingBuffer
+{
+  public:
+    /**
+     * Random access iterator over the elements of a RingBuffer
+     * \tparam Const whether the iterator provides read-only access
+     */
+    template <bool Const>
+    class IteratorImpl
+    {
+      public:
+        /// Buffer type, const qualified if needed
+        using Buffer = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+
+        using iterator_category = std::random_access_iterator_tag; //!< iterator category
+        using value_type = T;                                      //!< value type
+        using difference_type = std::ptrdiff_t;                    //!< difference type
+        using pointer = std::conditional_t<Const, const T*, T*>;   //!< pointer type
+        using reference = std::conditional_t<Const, const T&, T&>; //!< reference type
+
+        IteratorImpl()
+            : m_buffer(nullptr),
+              m_index(0)
+        {
+        }
+
+        /**
+         * Constructor
+         * \param buffer the buffer
+         * \param index the position relative to the first element
+         */
+        IteratorImpl(Buffer* buffer, std::size_t index)
+            : m_buffer(buffer),
+              m_index(index)
+        {
+        }
+
+        /**
+         * Conversion from a non-const iterator
+         * \param other the iterator to convert
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorImpl(const IteratorImpl<false>& other)
+            : m_buffer(other.m_buffer),
+              m_index(other.m_index)
+        {
+        }
+
+        /** \return a reference to the designated element */
+        reference operator*() const
+        {
+            return m_buffer->m_slots[m_buffer->Slot(m_index)];
+        }
+
+        /** \return a pointer to the designated element */
+        pointer operator->() const
+        {
+            return &(**this);
+        }
+
+        /**
+         * \param n offset
+         * \return a reference to the element n positions ahead
+         */
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        /** \return this iterator, advanced by one */
+        IteratorImpl& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        /** \return a copy of this iterator before advancing it by one */
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl tmp = *this;
+            ++m_index;
+            return tmp;
+        }
+
+        /** \return this iterator, moved back by one */
+        IteratorImpl& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        /** \return a copy of this iterator before moving it back by one */
+        IteratorImpl operator--(int)
+        {
+            IteratorImpl tmp = *this;
+            --m_index;
+            return tmp;
+        }
+
+        /**
+         * \param n offset
+         * \return this iterator, advanced by n
+         */
+        IteratorImpl& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        /**
+         * \param n offset
+         * \return this iterator, moved back by n
+         */
+        IteratorImpl& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        /**
+         * \param n offset
+         * \return an iterator n positions ahead
+         */
+        IteratorImpl operator+(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index + n);
+        }
+
+        /**
+         * \param n offset
+         * \return an iterator n positions behind
+         */
+        IteratorImpl operator-(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index - n);
+        }
+
+        /**
+         * \param other another iterator on the same buffer
+         * \return the distance between the two iterators
+         */
+        difference_type operator-(const IteratorImpl& other) const
+        {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        /**
+         * \param other another iterator
+         * \return true if both iterators designate the same position
+         */
+        bool operator==(const IteratorImpl& other) const
+        {
+            return m_buffer == other.m_buffer && m_index == other.m_index;
+        }
+
+        /**
+         * \param other another iterator
+         * \return true if the iterators designate different positions
+         */
+        bool operator!=(const IteratorImpl& other) const
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * \param other another iterator on the same buffer
+         * \return true if this iterator precedes the other one
+         */
+        bool operator<(const IteratorImpl& other) const
+        {
+            return m_index < other.m_index;
+        }
+
+      private:
+        friend class RingBuffer;
+        friend class IteratorImpl<!Const>;
+
+        Buffer* m_buffer;    //!< the buffer
+        std::size_t m_index; //!< position relative to the first element
+    };
+
+    using value_type = T;                      //!< value type
+    using size_type = std::size_t;             //!< size type
+    using reference = T&;                      //!< reference type
+    using const_reference = const T&;          //!< const reference type
+    using iterator = IteratorImpl<false>;      //!< iterator
+    using const_iterator = IteratorImpl<true>; //!< const iterator
+
+    static constexpr std::size_t MIN_CAPACITY = 16; //!< capacity allocated by the first insertion
+
+    RingBuffer()
+        : m_head(0),
+          m_size(0)
+    {
+    }
+
+    /** \return an iterator to the first element */
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /** \return an iterator past the last element */
+    iterator end()
+    {
+        return iterator(this, m_size);
+    }
+
+    /** \return a const iterator to the first element */
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /** \return a const iterator past the last element */
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /** \return a const iterator to the first element */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /** \return a const iterator past the last element */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /** \return the number of elements */
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /** \return true if there are no elements */
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /** \return the number of elements that can be stored without reallocating */
+    size_type capacity() const
+    {
+        return m_slots.size();
+    }
+
+    /**
+     * Make room for at least the given number of elements.
+     * \param n the number of elements
+     */
+    void reserve(size_type n)
+    {
+        if (n > capacity())
+        {
+            Reallocate(n);
+        }
+    }
+
+    /** \return the first element */
+    reference front()
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[m_head];
+    }
+
+    /** \return the first element */
+    const_reference front() const
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[m_head];
+    }
+
+    /** \return the last element */
+    reference back()
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[Slot(m_size - 1)];
+    }
+
+    /** \return the last element */
+    const_reference back() const
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[Slot(m_size - 1)];
+    }
+
+    /**
+     * \param i the position of an element
+     * \return the element at the given position
+     */
+    reference operator[](size_type i)
+    {
+        return m_slots[Slot(i)];
+    }
+
+    /**
+     * \param i the position of an element
+     * \return the element at the given position
+     */
+    const_reference operator[](size_type i) const
+    {
+        return m_slots[Slot(i)];
+    }
+
+    /**
+     * Append an element.
+     * \param value the element
+     */
+    void push_back(const T& value)
+    {
+        if (m_size == capacity())
+        {
+            Reallocate(2 * m_size);
+        }
+        m_slots[Slot(m_size)] = value;
+        ++m_size;
+    }
+
+    /**
+     * Remove the first element.
+     */
+    void pop_front()
+    {
+        NS_ASSERT(m_size > 0);
+        m_slots[m_head] = T();
+        m_head = (m_head + 1) & (capacity() - 1);
+        --m_size;
+    }
+
+    /**
+     * Insert an element.
+     * \param pos the position before which the element is inserted
+     * \param value the element
+     * \return an iterator to the inserted element
+     */
+    iterator insert(const_iterator pos, const T& value)
+    {
+        std::size_t index = pos.m_index;
+        NS_ASSERT(index <= m_size);
+        if (index == m_size)
+        {
+            push_back(value);
+            return iterator(this, index);
+        }
+        if (m_size == capacity())
+        {
+            Reallocate(2 * m_size);
+        }
+        if (index < m_size / 2)
+        {
+            // open a slot before the first element and shift the front left
+            m_head = (m_head + capacity() - 1) & (capacity() - 1);
+            ++m_size;
+            for (std::size_t i = 0; i < index; ++i)
+            {
+                m_slots[Slot(i)] = std::move(m_slots[Slot(i + 1)]);
+            }
+        }
+        else
+        {
+            ++m_size;
+            for (std::size_t i = m_size - 1; i > index; --i)
+            {
+                m_slots[Slot(i)] = std::move(m_slots[Slot(i - 1)]);
+            }
+        }
+        m_slots[Slot(index)] = value;
+        return iterator(this, index);
+    }
+
+    /**
+     * Remove an element.
+     * \param pos the position of the element to remove
+     * \return an iterator to the element following the removed one
+     */
+    iterator erase(const_iterator pos)
+    {
+        std::size_t index = pos.m_index;
+        NS_ASSERT(index < m_size);
+        if (index == 0)
+        {
+            pop_front();
+            return begin();
+        }
+        if (index < m_size / 2)
+        {
+            for (std::size_t i = index; i > 0; --i)
+            {
+                m_slots[Slot(i)] = std::move(m_slots[Slot(i - 1)]);
+            }
+            pop_front();
+        }
+        else
+        {
+            for (std::size_t i = index; i + 1 < m_size; ++i)
+            {
+                m_slots[Slot(i)] = std::move(m_slots[Slot(i + 1)]);
+            }
+            m_slots[Slot(m_size - 1)] = T();
+            --m_size;
+        }
+        return iterator(this, index);
+    }
+
+    /**
+     * Remove all the elements and release the memory.
+     */
+    void clear()
+    {
+        m_slots.clear();
+        m_slots.shrink_to_fit();
+        m_head = 0;
+        m_size = 0;
+    }
+
+  private:
+    /**
+     * \param i a position relative to the first element
+     * \return the index of the corresponding slot
+     */
+    std::size_t Slot(std::size_t i) const
+    {
+        return (m_head + i) & (capacity() - 1);
+    }
+
+    /**
+     * Move the elements to a new array of at least the given capacity.
+     * \param n the requested capacity
+     */
+    void Reallocate(std::size_t n)
+    {
+        std::size_t newCapacity = MIN_CAPACITY;
+        while (newCapacity < n)
+        {
+            newCapacity *= 2;
+        }
+        std::vector<T> slots(newCapacity);
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            slots[i] = std::move(m_slots[Slot(i)]);
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+    }
+
+    std::vector<T> m_slots; //!< storage, its size is the capacity (a power of two)
+    std::size_t m_head;     //!< slot of the first element
+    std::size_t m_size;     //!< number of elements
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
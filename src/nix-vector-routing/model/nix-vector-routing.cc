@@ -25,13 +25,19 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <queue>
+#include <thread>
 
 namespace ns3
 {
@@ -41,6 +47,63 @@ NS_LOG_COMPONENT_DEFINE("NixVectorRouting");
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv4RoutingProtocol);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv6RoutingProtocol);
 
+/**
+ * \ingroup nix-vector-routing
+ * \brief Whether the paths are looked up in a table of all the shortest paths.
+ */
+static GlobalValue g_nixVectorPrecompute(
+    "NixVectorPrecompute",
+    "Compute the shortest paths between all the nodes at once, on the first "
+    "route lookup after a topology change, instead of a breadth first search "
+    "for each new destination of each node",
+    BooleanValue(false),
+    MakeBooleanChecker());
+
+/**
+ * \ingroup nix-vector-routing
+ * \brief The number of threads computing the table of the shortest paths.
+ */
+static GlobalValue g_nixVectorThreads(
+    "NixVectorThreads",
+    "The number of threads computing the shortest paths between all the nodes "
+    "when NixVectorPrecompute is set (0 for one per hardware thread)",
+    UintegerValue(1),
+    MakeUintegerChecker<uint32_t>());
+
+/**
+ * \brief Read an entry of the table of the shortest paths
+ * \param paths the entries
+ * \param width the size of an entry, in bytes
+ * \param index the index of the entry
+ * \return the entry
+ */
+static inline uint32_t
+GetNixTableEntry(const std::vector<uint8_t>& paths, uint32_t width, std::size_t index)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < width; i++)
+    {
+        value |= static_cast<uint32_t>(paths[index * width + i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * \brief Write an entry of the table of the shortest paths
+ * \param paths the entries
+ * \param width the size of an entry, in bytes
+ * \param index the index of the entry
+ * \param value the entry
+ */
+static inline void
+SetNixTableEntry(std::vector<uint8_t>& paths, uint32_t width, std::size_t index, uint32_t value)
+{
+    for (uint32_t i = 0; i < width; i++)
+    {
+        paths[index * width + i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
 template <typename T>
 bool NixVectorRouting<T>::g_isCacheDirty = false;
 
@@ -55,6 +118,9 @@ template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap
     NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+typename NixVectorRouting<T>::NixTable NixVectorRouting<T>::g_nixTable;
+
 template <typename T>
 TypeId
 NixVectorRouting<T>::GetTypeId()
@@ -168,6 +234,9 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
+
+    // Same for the table of the shortest paths
+    g_nixTable = NixTable();
 }
 
 template <typename T>
@@ -217,6 +286,30 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
     {
         // otherwise proceed as normal
         // and build the nix vector
+        // Look up the path in the table of all the shortest paths, unless
+        // a specific output interface must be used
+        if (!oif)
+        {
+            if (g_nixTable.paths.empty())
+            {
+                BooleanValue precompute;
+                g_nixVectorPrecompute.GetValue(precompute);
+                if (precompute.Get())
+                {
+                    BuildNixTable();
+                }
+            }
+            if (source->GetId() < g_nixTable.nNodes && destNode->GetId() < g_nixTable.nNodes)
+            {
+                if (BuildNixVectorFromTable(source->GetId(), destNode->GetId(), nixVector))
+                {
+                    return nixVector;
+                }
+                NS_LOG_ERROR("No routing path exists");
+                return nullptr;
+            }
+        }
+
         std::vector<Ptr<Node>> parentVector;
 
         if (BFS(NodeList::GetNNodes(), source, destNode, parentVector, oif))
@@ -356,6 +449,221 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
     return true;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::BuildNixTable() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    uint32_t numberOfNodes = NodeList::GetNNodes();
+
+    // The nodes reached in one hop by BFS from each node, in the order BFS
+    // visits them, and the neighbors of each node, in the order of their
+    // nix index (see BFS and BuildNixVector)
+    std::vector<std::vector<uint32_t>> reached(numberOfNodes);
+    std::vector<std::vector<uint32_t>> neighbors(numberOfNodes);
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        Ptr<Node> node = NodeList::GetNode(id);
+        Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+            if (!localNetDevice->IsBridge())
+            {
+                for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End();
+                     iter++)
+                {
+                    neighbors[id].push_back((*iter)->GetNode()->GetId());
+                }
+            }
+
+            if (ip && !ip->IsUp(ip->GetInterfaceForDevice(localNetDevice)))
+            {
+                continue;
+            }
+            if (!localNetDevice->IsLinkUp())
+            {
+                continue;
+            }
+            for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+            {
+                Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+                if (remoteIpInterface && remoteIpInterface->IsUp())
+                {
+                    reached[id].push_back((*iter)->GetNode()->GetId());
+                }
+            }
+        }
+    }
+
+    // The parents of each node, sorted, and the nix index of the node at
+    // each of them
+    NixTable table;
+    table.nNodes = numberOfNodes;
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        for (uint32_t remote : reached[id])
+        {
+            links.emplace_back(remote, id);
+        }
+    }
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+    table.parentOffsets.assign(numberOfNodes + 1, 0);
+    uint32_t maxParents = 0;
+    for (const auto& [child, parent] : links)
+    {
+        table.parentOffsets[child + 1]++;
+        table.parents.push_back(parent);
+    }
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        maxParents = std::max(maxParents, table.parentOffsets[id + 1]);
+        table.parentOffsets[id + 1] += table.parentOffsets[id];
+    }
+    auto findParent = [&table](uint32_t child, uint32_t parent) {
+        auto begin = table.parents.begin() + table.parentOffsets[child];
+        auto end = table.parents.begin() + table.parentOffsets[child + 1];
+        auto it = std::lower_bound(begin, end, parent);
+        return it != end && *it == parent ? it - table.parents.begin() : -1;
+    };
+    table.nixIndexes.assign(table.parents.size(), 0);
+    table.nixBits.assign(numberOfNodes, 0);
+    Ptr<NixVector> nixVector = Create<NixVector>();
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        table.nixBits[id] = nixVector->BitCount(neighbors[id].size());
+        for (uint32_t index = 0; index < neighbors[id].size(); index++)
+        {
+            // If the node appears several times, the last index is used
+            auto position = findParent(neighbors[id][index], id);
+            if (position >= 0)
+            {
+                table.nixIndexes[position] = index;
+            }
+        }
+    }
+
+    // The edges followed by BFS, with the position of the node BFS comes
+    // from among the parents of the node it reaches
+    std::vector<uint32_t> edgeOffsets(numberOfNodes + 1, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        for (uint32_t remote : reached[id])
+        {
+            uint32_t position = findParent(remote, id) - table.parentOffsets[remote];
+            edges.emplace_back(remote, position + 1);
+        }
+        edgeOffsets[id + 1] = edges.size();
+    }
+    reached.clear();
+    neighbors.clear();
+
+    table.width = maxParents < 0xff ? 1 : maxParents < 0xffff ? 2 : 4;
+    table.paths.assign(static_cast<std::size_t>(numberOfNodes) * numberOfNodes * table.width, 0);
+
+    UintegerValue threads;
+    g_nixVectorThreads.GetValue(threads);
+    uint32_t nThreads = threads.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nThreads = std::max(std::min(nThreads, numberOfNodes), 1U);
+    NS_LOG_INFO("Computing the shortest paths between " << numberOfNodes << " nodes with "
+                                                         << nThreads << " threads");
+
+    // Each thread runs BFS from the sources it takes from the list, and
+    // writes the rows of these sources only
+    std::atomic<uint32_t> next{0};
+    auto search = [&table, &edges, &edgeOffsets, &next]() {
+        uint32_t n = table.nNodes;
+        std::vector<uint32_t> greyNodeList;
+        std::vector<uint8_t> visited;
+        for (uint32_t source = next++; source < n; source = next++)
+        {
+            std::size_t row = static_cast<std::size_t>(source) * n;
+            visited.assign(n, 0);
+            visited[source] = 1;
+            greyNodeList.assign(1, source);
+            for (std::size_t head = 0; head < greyNodeList.size(); head++)
+            {
+                uint32_t currNode = greyNodeList[head];
+                for (uint32_t e = edgeOffsets[currNode]; e < edgeOffsets[currNode + 1]; e++)
+                {
+                    auto [remote, parent] = edges[e];
+                    if (!visited[remote])
+                    {
+                        visited[remote] = 1;
+                        SetNixTableEntry(table.paths, table.width, row + remote, parent);
+                        greyNodeList.push_back(remote);
+                    }
+                }
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        workers.emplace_back(search);
+    }
+    search();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    g_nixTable = std::move(table);
+    NS_LOG_INFO("Shortest paths computed, using " << GetNixTableMemory() << " bytes");
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::BuildNixVectorFromTable(uint32_t source,
+                                             uint32_t dest,
+                                             Ptr<NixVector> nixVector) const
+{
+    NS_LOG_FUNCTION(this << source << dest << nixVector);
+
+    std::size_t row = static_cast<std::size_t>(source) * g_nixTable.nNodes;
+    for (uint32_t node = dest; node != source;)
+    {
+        uint32_t entry = GetNixTableEntry(g_nixTable.paths, g_nixTable.width, row + node);
+        if (entry == 0)
+        {
+            return false;
+        }
+        uint32_t position = g_nixTable.parentOffsets[node] + entry - 1;
+        uint32_t parent = g_nixTable.parents[position];
+        NS_LOG_LOGIC("Adding Nix: " << g_nixTable.nixIndexes[position] << " with "
+                                    << g_nixTable.nixBits[parent] << " bits, for node "
+                                    << parent);
+        nixVector->AddNeighborIndex(g_nixTable.nixIndexes[position], g_nixTable.nixBits[parent]);
+        node = parent;
+    }
+    return true;
+}
+
+template <typename T>
+std::size_t
+NixVectorRouting<T>::GetNixTableMemory() const
+{
+    return g_nixTable.parentOffsets.capacity() * sizeof(uint32_t) +
+           g_nixTable.parents.capacity() * sizeof(uint32_t) +
+           g_nixTable.nixIndexes.capacity() * sizeof(uint32_t) +
+           g_nixTable.nixBits.capacity() * sizeof(uint32_t) + g_nixTable.paths.capacity();
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::GetAdjacentNetDevices(Ptr<NetDevice> netDevice,
@@ -758,7 +1066,9 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
         // Build the nix-vector, given this node and the
         // dest IP address
         nixVectorInCache = GetNixVector(m_node, destAddress, oif);
-        if (nixVectorInCache)
+        // The nix-vectors are built from the table of the shortest paths, if
+        // any, as fast as they are found in the cache
+        if (nixVectorInCache && g_nixTable.paths.empty())
         {
             // cache it
             m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
@@ -1430,6 +1740,8 @@ NixVectorRouting<T>::CheckCacheStateAndFlush() const
 }
 
 /* Public template function declarations */
+template std::size_t NixVectorRouting<Ipv4RoutingProtocol>::GetNixTableMemory() const;
+template std::size_t NixVectorRouting<Ipv6RoutingProtocol>::GetNixTableMemory() const;
 template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv4RoutingProtocol>::FlushGlobalNixRoutingCache() const;
@@ -43,6 +43,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -142,6 +143,13 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                           Ptr<OutputStreamWrapper> stream,
                           Time::Unit unit) const;
 
+    /**
+     * @brief Get the memory used by the table of the shortest paths between
+     * all the nodes (see the NixVectorPrecompute global value)
+     * @return the size of the table, in bytes, or 0 if it is not built
+     */
+    std::size_t GetNixTableMemory() const;
+
   private:
     /**
      * Flushes the cache which stores nix-vector based on
@@ -229,6 +237,22 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                         uint32_t dest,
                         Ptr<NixVector> nixVector) const;
 
+    /**
+     * Builds the table of the shortest paths between all the nodes, with a
+     * breadth first search from every node, in one or more threads
+     */
+    void BuildNixTable() const;
+
+    /**
+     * Walks the table of the shortest paths back from the destination
+     * and builds the nixvector, as BuildNixVector does
+     * \param [in] source Source Node index
+     * \param [in] dest Destination Node index
+     * \param [out] nixVector the NixVector to be used for routing
+     * \returns true on success, false if dest is not reachable.
+     */
+    bool BuildNixVectorFromTable(uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
+
     /**
      * Simply iterates through the nodes net-devices and determines
      * how many neighbors the node has.
@@ -491,6 +515,31 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static uint32_t g_epoch;
 
+    /**
+     * Table of the shortest paths between all the nodes, as found by BFS
+     * from each of them.  The parent of a node in the BFS tree of a source
+     * is identified by its position among the nodes that can reach that
+     * node in one hop, so that an entry of the table fits in one byte unless
+     * a node has more than 254 neighbors.
+     */
+    struct NixTable
+    {
+        uint32_t nNodes{0};                  //!< Number of nodes
+        uint32_t width{0};                   //!< Size of an entry of paths, in bytes
+        std::vector<uint32_t> parentOffsets; //!< Position of the parents of each node
+        std::vector<uint32_t> parents;       //!< Nodes that reach each node in one hop
+        std::vector<uint32_t> nixIndexes;    //!< Nix index of the node at each of its parents
+        std::vector<uint32_t> nixBits;       //!< Number of bits of the nix index of each node
+        /**
+         * For each source and destination, one plus the position of the
+         * parent of the destination among its parents, or 0 if the
+         * destination is not reachable
+         */
+        std::vector<uint8_t> paths;
+    };
+
+    static NixTable g_nixTable; //!< Table of the shortest paths between all the nodes
+
     /** Cache stores nix-vectors based on destination ip */
     mutable NixMap_t m_nixCache;
 
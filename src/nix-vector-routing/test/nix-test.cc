@@ -17,6 +17,8 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
+#include "ns3/config.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -25,6 +27,8 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -32,6 +36,7 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -393,6 +398,133 @@ NixVectorRoutingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief IPv4 Nix-Vector Routing precomputed paths Test
+ *
+ * On a ring of routers with random chords and a shared channel, the paths
+ * between all the nodes are printed with the paths found by BFS for each
+ * destination, and with the table of all the shortest paths computed in one
+ * and in several threads: they must be the same, before and after some
+ * interfaces are brought down.
+ */
+class NixVectorPrecomputeTest : public TestCase
+{
+  public:
+    NixVectorPrecomputeTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Print the paths from every node to every address
+     * \param nodes the nodes
+     * \param precompute whether the paths are looked up in the table
+     * \param threads the number of threads computing the table
+     * \return the paths
+     */
+    std::string PrintPaths(const NodeContainer& nodes, bool precompute, uint32_t threads);
+};
+
+NixVectorPrecomputeTest::NixVectorPrecomputeTest()
+    : TestCase("precomputed paths between all nodes")
+{
+}
+
+std::string
+NixVectorPrecomputeTest::PrintPaths(const NodeContainer& nodes, bool precompute, uint32_t threads)
+{
+    Config::SetGlobal("NixVectorPrecompute", BooleanValue(precompute));
+    Config::SetGlobal("NixVectorThreads", UintegerValue(threads));
+    Ptr<Ipv4NixVectorRouting> routing = nodes.Get(0)->GetObject<Ipv4NixVectorRouting>();
+    routing->FlushGlobalNixRoutingCache();
+
+    std::ostringstream paths;
+    Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper>(&paths);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        for (uint32_t j = 0; j < nodes.GetN(); j++)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(j)->GetObject<Ipv4>();
+            for (uint32_t interface = 1; interface < ipv4->GetNInterfaces(); interface++)
+            {
+                Ipv4Address dest = ipv4->GetAddress(interface, 0).GetLocal();
+                nodes.Get(i)->GetObject<Ipv4NixVectorRouting>()->PrintRoutingPath(nodes.Get(i),
+                                                                                  dest,
+                                                                                  stream,
+                                                                                  Time::S);
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ((routing->GetNixTableMemory() > 0),
+                          precompute,
+                          "Table of the shortest paths not used as expected");
+    return paths.str();
+}
+
+void
+NixVectorPrecomputeTest::DoRun()
+{
+    const uint32_t size = 20;
+    NodeContainer nodes;
+    nodes.Create(size);
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(nixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    SimpleNetDeviceHelper p2p;
+    p2p.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address;
+    address.SetBase("10.0.0.0", "255.255.255.0");
+    NetDeviceContainer devices;
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        uint32_t chord = rand->GetInteger(0, size - 1);
+        for (uint32_t j : {(i + 1) % size, chord})
+        {
+            if (j != i)
+            {
+                NetDeviceContainer link = p2p.Install(NodeContainer(nodes.Get(i), nodes.Get(j)));
+                address.Assign(link);
+                address.NewNetwork();
+                devices.Add(link);
+            }
+        }
+    }
+    SimpleNetDeviceHelper lan;
+    address.Assign(lan.Install(NodeContainer(nodes.Get(0), nodes.Get(5), nodes.Get(10))));
+
+    std::string bfs = PrintPaths(nodes, false, 1);
+    NS_TEST_EXPECT_MSG_EQ(PrintPaths(nodes, true, 1), bfs, "Precomputed paths differ");
+    NS_TEST_EXPECT_MSG_EQ(PrintPaths(nodes, true, 3), bfs, "Precomputed paths differ");
+
+    // Cut some of the links, from one end or the other, and the last node
+    for (uint32_t i = 0; i < devices.GetN(); i += 5)
+    {
+        Ptr<Ipv4> ipv4 = devices.Get(i)->GetNode()->GetObject<Ipv4>();
+        ipv4->SetDown(ipv4->GetInterfaceForDevice(devices.Get(i)));
+    }
+    Ptr<Ipv4> ipv4 = nodes.Get(size - 1)->GetObject<Ipv4>();
+    for (uint32_t interface = 1; interface < ipv4->GetNInterfaces(); interface++)
+    {
+        ipv4->SetDown(interface);
+    }
+    bfs = PrintPaths(nodes, false, 1);
+    NS_TEST_EXPECT_MSG_EQ((bfs.find("There does not exist a path") != std::string::npos),
+                          true,
+                          "No node cut off");
+    NS_TEST_EXPECT_MSG_EQ(PrintPaths(nodes, true, 2), bfs, "Precomputed paths differ");
+
+    Config::SetGlobal("NixVectorPrecompute", BooleanValue(false));
+    Config::SetGlobal("NixVectorThreads", UintegerValue(1));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -406,6 +538,7 @@ class NixVectorRoutingTestSuite : public TestSuite
         : TestSuite("nix-vector-routing", UNIT)
     {
         AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorPrecomputeTest(), TestCase::QUICK);
     }
 };
 
@@ -20,6 +20,7 @@
 #include "point-to-point-net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -107,6 +108,42 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
     return true;
 }
 
+bool
+PointToPointChannel::CanTransmitBurst() const
+{
+    return m_txrxPointToPoint.IsEmpty();
+}
+
+bool
+PointToPointChannel::TransmitBurst(Ptr<const PacketBurst> burst,
+                                   Ptr<PointToPointNetDevice> src,
+                                   const std::vector<Time>& txEnd)
+{
+    NS_LOG_FUNCTION(this << burst << src);
+    NS_ASSERT_MSG(burst->GetNPackets() == txEnd.size() && !txEnd.empty(),
+                  "Need one transmission end time per packet");
+
+    NS_ASSERT(m_link[0].m_state != INITIALIZING);
+    NS_ASSERT(m_link[1].m_state != INITIALIZING);
+
+    uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+    std::vector<Time> arrivals;
+    arrivals.reserve(txEnd.size());
+    for (const auto& t : txEnd)
+    {
+        arrivals.push_back(Simulator::Now() + t + m_delay);
+    }
+
+    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
+                                   txEnd.front() + m_delay,
+                                   &PointToPointNetDevice::ReceiveBurst,
+                                   m_link[wire].m_dst,
+                                   burst->Copy(),
+                                   arrivals);
+    return true;
+}
+
 std::size_t
 PointToPointChannel::GetNDevices() const
 {
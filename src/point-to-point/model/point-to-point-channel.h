@@ -25,12 +25,14 @@
 #include "ns3/traced-callback.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
 
 class PointToPointNetDevice;
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup point-to-point
@@ -81,6 +83,33 @@ class PointToPointChannel : public Channel
      */
     virtual bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+    /**
+     * \brief Check whether a burst of packets can be passed to TransmitBurst()
+     *
+     * Bursts are delivered by a single event, so they are not supported when
+     * the TxRxPointToPoint trace source, which reports each packet when its
+     * transmission starts, is connected.
+     *
+     * \returns true if TransmitBurst() can be used
+     */
+    virtual bool CanTransmitBurst() const;
+
+    /**
+     * \brief Transmit a burst of back-to-back packets over this channel
+     *
+     * The packets are delivered to the destination device, in order, by a
+     * single event scheduled at the reception time of the first one; the
+     * device receives each of them at its own reception time.
+     *
+     * \param burst Packets to transmit, in transmission order
+     * \param src Source PointToPointNetDevice
+     * \param txEnd For each packet, time from now at which its last bit is sent
+     * \returns true if successful (currently always true)
+     */
+    virtual bool TransmitBurst(Ptr<const PacketBurst> burst,
+                               Ptr<PointToPointNetDevice> src,
+                               const std::vector<Time>& txEnd);
+
     /**
      * \brief Get number of devices on this channel
      * \returns number of devices on this channel
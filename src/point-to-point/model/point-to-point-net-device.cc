@@ -20,10 +20,14 @@
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/error-model.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -71,6 +75,23 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("TxBurstSize",
+                          "The maximum number of back-to-back packets sent to the channel "
+                          "as a single burst; 1 disables bursts",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PointToPointNetDevice::m_txBurstSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("FastForward",
+                          "Omit the transmit complete event of packets sent while the device "
+                          "queue is empty and the link utilization is low",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointNetDevice::m_fastForward),
+                          MakeBooleanChecker())
+            .AddAttribute("FastForwardMaxUtilization",
+                          "The link utilization above which FastForward is not used",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&PointToPointNetDevice::m_fastForwardMaxUtilization),
+                          MakeDoubleChecker<double>(0, 1))
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -177,6 +198,10 @@ PointToPointNetDevice::GetTypeId()
 PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
       m_channel(nullptr),
+      m_txBurstSize(1),
+      m_fastForward(false),
+      m_fastForwardMaxUtilization(0.5),
+      m_utilization(0),
       m_linkUp(false),
       m_currentPkt(nullptr)
 {
@@ -216,6 +241,7 @@ PointToPointNetDevice::DoDispose()
     m_receiveErrorModel = nullptr;
     m_currentPkt = nullptr;
     m_queue = nullptr;
+    m_rxBurst.clear();
     NetDevice::DoDispose();
 }
 
@@ -249,11 +275,36 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
+    if (!m_queue->IsEmpty() && CanTransmitBurst())
+    {
+        return TransmitBurst(p);
+    }
+
     Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
     Time txCompleteTime = txTime + m_tInterframeGap;
 
-    NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
-    Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    if (m_fastForward)
+    {
+        UpdateUtilization(txCompleteTime);
+    }
+
+    if (m_queue->IsEmpty() && CanFastForward())
+    {
+        //
+        // Nothing is waiting behind this packet, so there is nothing to do when
+        // its transmission completes unless another packet is sent before.
+        // Just remember when that happens; Send () schedules TransmitComplete
+        // if needed.
+        //
+        NS_LOG_LOGIC("Fast-forward, transmitter ready in " << txCompleteTime.As(Time::S));
+        m_txMachineState = READY;
+        m_txReadyTime = Simulator::Now() + txCompleteTime;
+    }
+    else
+    {
+        NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
+        Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    }
 
     bool result = m_channel->TransmitStart(p, this, txTime);
     if (!result)
@@ -297,6 +348,82 @@ PointToPointNetDevice::TransmitComplete()
     TransmitStart(p);
 }
 
+bool
+PointToPointNetDevice::CanTransmitBurst() const
+{
+    //
+    // The packets of a burst leave the device queue when the burst starts, so
+    // bursts are not used while their dequeue times can be observed, from the
+    // traces of the queue or by the traffic control layer, which is woken up
+    // when the device queue drains.
+    //
+    return m_txBurstSize > 1 && m_phyTxBeginTrace.IsEmpty() && m_phyTxEndTrace.IsEmpty() &&
+           m_snifferTrace.IsEmpty() && m_promiscSnifferTrace.IsEmpty() && !m_queue->IsTraced() &&
+           !GetObject<NetDeviceQueueInterface>() && m_channel->CanTransmitBurst();
+}
+
+bool
+PointToPointNetDevice::TransmitBurst(Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+
+    //
+    // The packets waiting in the device queue would be sent back to back after
+    // this one, so their serialization schedule is already known.  Hand them
+    // to the channel together, and only come back when the last one is done.
+    //
+    Ptr<PacketBurst> burst = CreateObject<PacketBurst>();
+    std::vector<Time> txEnd;
+    Time txStart;
+    while (true)
+    {
+        burst->AddPacket(p);
+        txEnd.push_back(txStart + m_bps.CalculateBytesTxTime(p->GetSize()));
+        txStart = txEnd.back() + m_tInterframeGap;
+        m_currentPkt = p;
+        if (burst->GetNPackets() == m_txBurstSize)
+        {
+            break;
+        }
+        p = m_queue->Dequeue();
+        if (!p)
+        {
+            break;
+        }
+    }
+
+    NS_LOG_LOGIC("Schedule TransmitCompleteEvent for a burst of "
+                 << burst->GetNPackets() << " packets in " << txStart.As(Time::S));
+    Simulator::Schedule(txStart, &PointToPointNetDevice::TransmitComplete, this);
+
+    return m_channel->TransmitBurst(burst, this, txEnd);
+}
+
+void
+PointToPointNetDevice::UpdateUtilization(Time txTime)
+{
+    Time now = Simulator::Now();
+    if (m_lastTxTime.IsStrictlyPositive())
+    {
+        Time interval = now - m_lastTxStart;
+        double sample = 1;
+        if (interval > m_lastTxTime)
+        {
+            sample = m_lastTxTime.GetSeconds() / interval.GetSeconds();
+        }
+        m_utilization = 0.875 * m_utilization + 0.125 * sample;
+    }
+    m_lastTxStart = now;
+    m_lastTxTime = txTime;
+}
+
+bool
+PointToPointNetDevice::CanFastForward() const
+{
+    return m_fastForward && m_utilization <= m_fastForwardMaxUtilization &&
+           m_phyTxEndTrace.IsEmpty();
+}
+
 bool
 PointToPointNetDevice::Attach(Ptr<PointToPointChannel> ch)
 {
@@ -384,6 +511,49 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveBurst(Ptr<PacketBurst> burst, const std::vector<Time>& arrivals)
+{
+    NS_LOG_FUNCTION(this << burst);
+    NS_ASSERT_MSG(burst->GetNPackets() == arrivals.size(), "Need one arrival time per packet");
+
+    //
+    // Bursts sent over the same wire cannot overlap, but if the previous one
+    // is still being received, its pending event will also take care of this
+    // one.
+    //
+    bool idle = m_rxBurst.empty();
+    auto arrival = arrivals.begin();
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++arrival)
+    {
+        m_rxBurst.emplace_back(*arrival, *it);
+    }
+    if (idle)
+    {
+        ReceiveNextInBurst();
+    }
+}
+
+void
+PointToPointNetDevice::ReceiveNextInBurst()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_rxBurst.empty())
+    {
+        return;
+    }
+
+    Ptr<Packet> packet = m_rxBurst.front().second;
+    m_rxBurst.pop_front();
+    if (!m_rxBurst.empty())
+    {
+        Simulator::Schedule(m_rxBurst.front().first - Simulator::Now(),
+                            &PointToPointNetDevice::ReceiveNextInBurst,
+                            this);
+    }
+    Receive(packet);
+}
+
 Ptr<Queue<Packet>>
 PointToPointNetDevice::GetQueue() const
 {
@@ -539,6 +709,20 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     //
     if (m_queue->Enqueue(packet))
     {
+        //
+        // If the transmit complete event of the previous packet was omitted
+        // and its transmission is not over, schedule the event now so that
+        // this packet is sent when it is.
+        //
+        if (m_txMachineState == READY && m_txReadyTime > Simulator::Now())
+        {
+            m_txMachineState = BUSY;
+            Simulator::Schedule(m_txReadyTime - Simulator::Now(),
+                                &PointToPointNetDevice::TransmitComplete,
+                                this);
+            return true;
+        }
+
         //
         // If the channel is ready for transition we send the packet right now
         //
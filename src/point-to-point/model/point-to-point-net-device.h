@@ -31,12 +31,16 @@
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
 
 class PointToPointChannel;
 class ErrorModel;
+class PacketBurst;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -59,6 +63,29 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device
  * include a queue, data rate, and interframe transmission gap (the
  * propagation delay is set in the PointToPointChannel).
+ *
+ * When the TxBurstSize attribute is larger than one, the packets waiting in
+ * the device queue when a transmission starts are sent to the channel as a
+ * single burst: one transmit complete event is scheduled for the whole burst
+ * and the channel delivers it with one event, instead of one of each per
+ * packet.  The peer device still receives every packet at the time its last
+ * bit arrives.  Packets of a burst leave the device queue when the burst
+ * starts.  Bursts are not used while any of the PhyTxBegin, PhyTxEnd,
+ * Sniffer and PromiscSniffer trace sources or a trace source of the device
+ * queue is connected, so that they keep reporting every packet at its own
+ * transmission time, nor while a NetDeviceQueueInterface is aggregated to
+ * the device, so that the traffic control layer is woken up when the device
+ * queue drains as without bursts.  PointToPointHelper aggregates one unless
+ * its flow control is disabled.
+ *
+ * When the FastForward attribute is true and the link is lightly loaded, a
+ * packet sent while the device queue is empty is not followed by a transmit
+ * complete event: the device only records when its transmitter becomes
+ * ready again.  If another packet is sent before that time, the event is
+ * scheduled at that point and the device operates as usual until its queue
+ * drains.  The only event left for such a packet is its reception by the
+ * peer device.  Fast-forwarding is not used while the PhyTxEnd trace source
+ * is connected.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -154,6 +181,18 @@ class PointToPointNetDevice : public NetDevice
      */
     void Receive(Ptr<Packet> p);
 
+    /**
+     * Receive a burst of packets from a connected PointToPointChannel.
+     *
+     * This method is called by the channel when the last bit of the first
+     * packet of a burst has arrived at the device.  Each packet of the burst
+     * is passed to Receive() at its own reception time.
+     *
+     * \param burst the received packets, in transmission order
+     * \param arrivals the absolute reception time of each packet
+     */
+    void ReceiveBurst(Ptr<PacketBurst> burst, const std::vector<Time>& arrivals);
+
     // The remaining methods are documented in ns3::NetDevice*
 
     void SetIfIndex(const uint32_t index) override;
@@ -261,6 +300,44 @@ class PointToPointNetDevice : public NetDevice
      */
     void TransmitComplete();
 
+    /**
+     * \returns true if the packets waiting in the device queue can be sent to
+     * the channel as a burst
+     */
+    bool CanTransmitBurst() const;
+
+    /**
+     * Start sending a packet and the packets waiting behind it in the device
+     * queue down the wire, as a single burst.
+     *
+     * A single TransmitComplete event is scheduled for the end of the
+     * interframe gap following the last packet of the burst.
+     *
+     * \see PointToPointChannel::TransmitBurst ()
+     * \param p the first packet of the burst
+     * \returns true if success, false on failure
+     */
+    bool TransmitBurst(Ptr<Packet> p);
+
+    /**
+     * Update the estimate of the link utilization on a transmission start.
+     *
+     * \param txTime the time needed to send the packet, interframe gap included
+     */
+    void UpdateUtilization(Time txTime);
+
+    /**
+     * \returns true if the transmit complete event of a packet sent while the
+     * device queue is empty can be omitted
+     */
+    bool CanFastForward() const;
+
+    /**
+     * Pass the next packet of the received bursts to Receive() and schedule
+     * the reception of the following one.
+     */
+    void ReceiveNextInBurst();
+
     /**
      * \brief Make the link up and running
      *
@@ -308,6 +385,38 @@ class PointToPointNetDevice : public NetDevice
      */
     Ptr<Queue<Packet>> m_queue;
 
+    /**
+     * Maximum number of packets sent to the channel as a single burst
+     */
+    uint32_t m_txBurstSize;
+
+    /**
+     * Packets of the received bursts not yet passed to Receive(), along with
+     * their reception time
+     */
+    std::deque<std::pair<Time, Ptr<Packet>>> m_rxBurst;
+
+    /**
+     * Whether transmit complete events may be omitted when the device queue
+     * is empty
+     */
+    bool m_fastForward;
+
+    /**
+     * Link utilization above which transmit complete events are not omitted
+     */
+    double m_fastForwardMaxUtilization;
+
+    double m_utilization; //!< moving average of the link utilization
+    Time m_lastTxStart;   //!< start time of the last transmission
+    Time m_lastTxTime;    //!< duration of the last transmission, interframe gap included
+
+    /**
+     * The time at which the transmitter gets ready, if the transmit complete
+     * event of the last packet was omitted
+     */
+    Time m_txReadyTime;
+
     /**
      * Error model for receive packet events
      */
@@ -73,4 +73,10 @@ PointToPointRemoteChannel::TransmitStart(Ptr<const Packet> p,
     return true;
 }
 
+bool
+PointToPointRemoteChannel::CanTransmitBurst() const
+{
+    return false;
+}
+
 } // namespace ns3
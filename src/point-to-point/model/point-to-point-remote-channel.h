@@ -67,6 +67,13 @@ class PointToPointRemoteChannel : public PointToPointChannel
      * \returns true if successful (currently always true)
      */
     bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override;
+
+    /**
+     * \brief Bursts are not sent to remote systems
+     *
+     * \returns false
+     */
+    bool CanTransmitBurst() const override;
 };
 
 } // namespace ns3
@@ -17,14 +17,23 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/pcapng-file-wrapper.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/trace-helper.h"
+#include "ns3/uinteger.h"
 
+#include <fstream>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +148,620 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test class for the burst transmission mode of the PointToPoint model
+ *
+ * It sends packets back to back with and without bursts, and checks that
+ * they are received at the same times while fewer events are executed.
+ */
+class PointToPointBurstTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBurstTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /// Reception time and size of each received packet
+    using Receptions = std::vector<std::pair<Time, uint32_t>>;
+
+    /**
+     * \brief Send packets of increasing size over a link
+     *
+     * \param burstSize The TxBurstSize attribute of the sending device
+     * \param [out] nEvents The number of events executed
+     * \return the received packets
+     */
+    Receptions Run(uint32_t burstSize, uint64_t& nEvents);
+
+    /**
+     * \brief Callback function which records the received packets
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    Receptions m_receptions; //!< received packets
+};
+
+PointToPointBurstTest::PointToPointBurstTest()
+    : TestCase("PointToPoint burst transmission")
+{
+}
+
+bool
+PointToPointBurstTest::RxPacket(Ptr<NetDevice> dev,
+                                Ptr<const Packet> pkt,
+                                uint16_t mode,
+                                const Address& sender)
+{
+    m_receptions.emplace_back(Simulator::Now(), pkt->GetSize());
+    return true;
+}
+
+PointToPointBurstTest::Receptions
+PointToPointBurstTest::Run(uint32_t burstSize, uint64_t& nEvents)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(2)));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devA->SetDataRate(DataRate("10Mbps"));
+    devA->SetInterframeGap(MicroSeconds(3));
+    devA->SetAttribute("TxBurstSize", UintegerValue(burstSize));
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(MakeCallback(&PointToPointBurstTest::RxPacket, this));
+    m_receptions.clear();
+
+    // 20 packets at once, then 20 more while the first ones are in flight
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i < 20 ? 0 : 5), [devA, i]() {
+            devA->Send(Create<Packet>(100 + 50 * i), devA->GetBroadcast(), 0x800);
+        });
+    }
+
+    Simulator::Run();
+    nEvents = Simulator::GetEventCount();
+    Simulator::Destroy();
+    return m_receptions;
+}
+
+void
+PointToPointBurstTest::DoRun()
+{
+    uint64_t packetEvents;
+    uint64_t burstEvents;
+    Receptions expected = Run(1, packetEvents);
+    Receptions received = Run(8, burstEvents);
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), 40, "Not all the packets were received");
+    NS_TEST_ASSERT_MSG_EQ(received.size(), expected.size(), "Different number of packets");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(received[i].first,
+                              expected[i].first,
+                              "Packet " << i << " received at a different time");
+        NS_TEST_EXPECT_MSG_EQ(received[i].second,
+                              expected[i].second,
+                              "Packet " << i << " received out of order");
+    }
+    NS_TEST_EXPECT_MSG_LT(burstEvents, packetEvents, "Bursts should save events");
+}
+
+/**
+ * \brief Test class for the burst transmission mode of the PointToPoint model
+ * when the device queue is observed
+ *
+ * It sends packets with and without bursts, first with the Enqueue and
+ * Dequeue traces of the device queue connected, then through a
+ * NetDeviceQueueInterface whose wake callback sends more packets as the
+ * traffic control layer does, and checks that the packets spend the same
+ * time in the device queue and that the device queue is woken up at the
+ * same times.
+ */
+class PointToPointBurstQueueTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBurstQueueTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets over a link
+     *
+     * \param burstSize The TxBurstSize attribute of the sending device
+     * \param flowControl Whether the packets are sent through a NetDeviceQueueInterface
+     */
+    void Run(uint32_t burstSize, bool flowControl);
+
+    /**
+     * \brief Send packets until the device queue is stopped or all are sent
+     */
+    void SendPackets();
+
+    Ptr<PointToPointNetDevice> m_device; //!< sending device
+    Ptr<NetDeviceQueue> m_txQueue;       //!< device queue of the NetDeviceQueueInterface
+    uint32_t m_toSend{0};                //!< packets left to send
+    std::vector<Time> m_enqueued;        //!< enqueue times of the packets
+    std::vector<Time> m_sojourns;        //!< time spent by each packet in the device queue
+    std::vector<Time> m_wakes;           //!< times the device queue was woken up
+};
+
+PointToPointBurstQueueTest::PointToPointBurstQueueTest()
+    : TestCase("PointToPoint burst transmission with an observed device queue")
+{
+}
+
+void
+PointToPointBurstQueueTest::SendPackets()
+{
+    while (m_toSend > 0 && !(m_txQueue && m_txQueue->IsStopped()))
+    {
+        m_device->Send(Create<Packet>(500 + 100 * (m_toSend % 5)), m_device->GetBroadcast(), 0x800);
+        m_toSend--;
+    }
+}
+
+void
+PointToPointBurstQueueTest::Run(uint32_t burstSize, bool flowControl)
+{
+    m_enqueued.clear();
+    m_sojourns.clear();
+    m_wakes.clear();
+    m_toSend = 50;
+
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    m_device = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(2)));
+
+    Ptr<Queue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+    queue->SetMaxSize(QueueSize("5p"));
+    m_device->Attach(channel);
+    m_device->SetAddress(Mac48Address::Allocate());
+    m_device->SetQueue(queue);
+    m_device->SetDataRate(DataRate("10Mbps"));
+    m_device->SetAttribute("TxBurstSize", UintegerValue(burstSize));
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    a->AddDevice(m_device);
+    b->AddDevice(devB);
+
+    if (flowControl)
+    {
+        Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface>();
+        m_txQueue = ndqi->GetTxQueue(0);
+        m_txQueue->ConnectQueueTraces(queue);
+        m_txQueue->SetWakeCallback([this]() {
+            m_wakes.push_back(Simulator::Now());
+            SendPackets();
+        });
+        m_device->AggregateObject(ndqi);
+    }
+    else
+    {
+        queue->TraceConnectWithoutContext("Enqueue",
+                                          Callback<void, Ptr<const Packet>>(
+                                              [this](Ptr<const Packet>) {
+                                                  m_enqueued.push_back(Simulator::Now());
+                                              }));
+        queue->TraceConnectWithoutContext("Dequeue",
+                                          Callback<void, Ptr<const Packet>>(
+                                              [this](Ptr<const Packet>) {
+                                                  m_sojourns.push_back(
+                                                      Simulator::Now() -
+                                                      m_enqueued[m_sojourns.size()]);
+                                              }));
+    }
+
+    // The device queue holds 5 packets: without flow control, keep it full
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i), &PointToPointBurstQueueTest::SendPackets, this);
+    }
+
+    Simulator::Run();
+    Simulator::Destroy();
+    m_device = nullptr;
+    m_txQueue = nullptr;
+}
+
+void
+PointToPointBurstQueueTest::DoRun()
+{
+    for (bool flowControl : {false, true})
+    {
+        Run(1, flowControl);
+        std::vector<Time> expectedSojourns = m_sojourns;
+        std::vector<Time> expectedWakes = m_wakes;
+        Run(8, flowControl);
+
+        NS_TEST_EXPECT_MSG_EQ((flowControl ? m_wakes.empty() : m_sojourns.empty()),
+                              false,
+                              "Nothing was observed");
+        NS_TEST_ASSERT_MSG_EQ(m_sojourns.size(), expectedSojourns.size(), "Different dequeues");
+        for (std::size_t i = 0; i < m_sojourns.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_sojourns[i],
+                                  expectedSojourns[i],
+                                  "Packet " << i << " spent a different time in the queue");
+        }
+        NS_TEST_ASSERT_MSG_EQ(m_wakes.size(), expectedWakes.size(), "Different wake ups");
+        for (std::size_t i = 0; i < m_wakes.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_wakes[i],
+                                  expectedWakes[i],
+                                  "Wake up " << i << " at a different time");
+        }
+    }
+}
+
+/**
+ * \brief Test class for the fast-forward mode of the PointToPoint model
+ *
+ * It sends sparse packets, some of them while the previous one is still
+ * being transmitted, and a series of back-to-back packets, with and without
+ * fast-forward, and checks that they are received at the same times while
+ * fewer events are executed.
+ */
+class PointToPointFastForwardTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointFastForwardTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /// Reception time and size of each received packet
+    using Receptions = std::vector<std::pair<Time, uint32_t>>;
+
+    /**
+     * \brief Send packets over a link
+     *
+     * \param fastForward The FastForward attribute of the sending device
+     * \param [out] nEvents The number of events executed
+     * \return the received packets
+     */
+    Receptions Run(bool fastForward, uint64_t& nEvents);
+
+    /**
+     * \brief Callback function which records the received packets
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    Receptions m_receptions; //!< received packets
+};
+
+PointToPointFastForwardTest::PointToPointFastForwardTest()
+    : TestCase("PointToPoint fast-forward")
+{
+}
+
+bool
+PointToPointFastForwardTest::RxPacket(Ptr<NetDevice> dev,
+                                      Ptr<const Packet> pkt,
+                                      uint16_t mode,
+                                      const Address& sender)
+{
+    m_receptions.emplace_back(Simulator::Now(), pkt->GetSize());
+    return true;
+}
+
+PointToPointFastForwardTest::Receptions
+PointToPointFastForwardTest::Run(bool fastForward, uint64_t& nEvents)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(2)));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devA->SetDataRate(DataRate("10Mbps"));
+    devA->SetInterframeGap(MicroSeconds(3));
+    devA->SetAttribute("FastForward", BooleanValue(fastForward));
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(MakeCallback(&PointToPointFastForwardTest::RxPacket, this));
+    m_receptions.clear();
+
+    // 1000 bytes take 800 us to send: every fourth packet is sent 400 us
+    // after the previous one, the others are 10 ms apart
+    Time t;
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        t += (i % 4 == 3) ? MicroSeconds(400) : MilliSeconds(10);
+        Simulator::Schedule(t, [devA]() {
+            devA->Send(Create<Packet>(1000), devA->GetBroadcast(), 0x800);
+        });
+    }
+    // then 20 back-to-back packets, followed by sparse ones again
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        if (i >= 20)
+        {
+            t += MilliSeconds(10);
+        }
+        Simulator::Schedule(t, [devA, i]() {
+            devA->Send(Create<Packet>(100 + 50 * i), devA->GetBroadcast(), 0x800);
+        });
+    }
+
+    Simulator::Run();
+    nEvents = Simulator::GetEventCount();
+    Simulator::Destroy();
+    return m_receptions;
+}
+
+void
+PointToPointFastForwardTest::DoRun()
+{
+    uint64_t packetEvents;
+    uint64_t fastForwardEvents;
+    Receptions expected = Run(false, packetEvents);
+    Receptions received = Run(true, fastForwardEvents);
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), 80, "Not all the packets were received");
+    NS_TEST_ASSERT_MSG_EQ(received.size(), expected.size(), "Different number of packets");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(received[i].first,
+                              expected[i].first,
+                              "Packet " << i << " received at a different time");
+        NS_TEST_EXPECT_MSG_EQ(received[i].second,
+                              expected[i].second,
+                              "Packet " << i << " received out of order");
+    }
+    NS_TEST_EXPECT_MSG_LT(fastForwardEvents, packetEvents, "Fast-forward should save events");
+}
+
+/**
+ * \brief Test class for the header capture of PointToPoint devices
+ *
+ * It sends the packets of several TCP flows over a link whose devices are
+ * captured into one pcapng file, with flow sampling on both devices and a
+ * rate limit on the receiving one, reads the file back, and checks that
+ * only the sampled flows are recorded, that all their packets are recorded
+ * on the sending device, and that the records of the receiving device
+ * respect the token bucket.
+ */
+class PointToPointHeaderCaptureTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointHeaderCaptureTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Build an IPv4 packet carrying a 20-byte TCP header and a payload
+     *
+     * \param sport The TCP source port.
+     * \return the packet bytes
+     */
+    static std::vector<uint8_t> MakeTcpPacket(uint16_t sport);
+};
+
+PointToPointHeaderCaptureTest::PointToPointHeaderCaptureTest()
+    : TestCase("PointToPoint header capture with flow sampling and rate limit")
+{
+}
+
+std::vector<uint8_t>
+PointToPointHeaderCaptureTest::MakeTcpPacket(uint16_t sport)
+{
+    std::vector<uint8_t> packet(20 + 20 + 100, 0);
+    uint8_t* ip = packet.data();
+    ip[0] = 0x45;
+    ip[2] = packet.size() >> 8;
+    ip[3] = packet.size() & 0xff;
+    ip[9] = 6;
+    ip[12] = 10;
+    ip[15] = 1;
+    ip[16] = 10;
+    ip[19] = 2;
+    uint8_t* tcp = ip + 20;
+    tcp[0] = sport >> 8;
+    tcp[1] = sport & 0xff;
+    tcp[3] = 80;
+    tcp[12] = 5 << 4;
+    return packet;
+}
+
+void
+PointToPointHeaderCaptureTest::DoRun()
+{
+    const uint32_t nFlows = 20;
+    const uint32_t nPackets = 1000;
+    const uint32_t seed = 1;
+    const uint32_t rate = 100;
+    const uint32_t burst = 5;
+
+    // The flows kept by the sampling, from the hash of their first PPP frame
+    std::set<uint16_t> sampled;
+    for (uint16_t sport = 49153; sport < 49153 + nFlows; sport++)
+    {
+        std::vector<uint8_t> frame{0x00, 0x21};
+        std::vector<uint8_t> packet = MakeTcpPacket(sport);
+        frame.insert(frame.end(), packet.begin(), packet.end());
+        auto c = PcapHeaderCaptureHelper::Classify(PcapHelper::DLT_PPP,
+                                                   frame.data(),
+                                                   frame.size(),
+                                                   seed);
+        NS_TEST_ASSERT_MSG_EQ(c.hasFlow, true, "PPP/IPv4/TCP flow not recognized");
+        if (c.flowHash < 0x80000000U)
+        {
+            sampled.insert(sport);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ((sampled.empty() || sampled.size() == nFlows),
+                          false,
+                          "The seed should sample some of the flows only");
+
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(2)));
+
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    devA->SetDataRate(DataRate("10Mbps"));
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    std::string filename = CreateTempDirFilename("p2p-header-capture-test.pcapng");
+    PcapHeaderCaptureHelper capture;
+    capture.Open(filename);
+    capture.SetFlowSampling(0.5, seed);
+    uint32_t idA = capture.EnableCapture(devA, PcapHelper::DLT_PPP);
+    capture.SetRateLimit(rate, burst);
+    uint32_t idB = capture.EnableCapture(devB, PcapHelper::DLT_PPP);
+
+    // One packet per millisecond, the flows in turn
+    uint32_t sampledPackets = 0;
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        uint16_t sport = 49153 + i % nFlows;
+        sampledPackets += sampled.count(sport);
+        Simulator::Schedule(MilliSeconds(i), [devA, sport]() {
+            std::vector<uint8_t> packet = MakeTcpPacket(sport);
+            devA->Send(Create<Packet>(packet.data(), packet.size()), devA->GetBroadcast(), 0x800);
+        });
+    }
+
+    Simulator::Run();
+    Simulator::Destroy();
+    capture.GetFile()->Close();
+
+    std::ifstream in(filename, std::ios::binary);
+    std::vector<uint32_t> words;
+    uint32_t word;
+    while (in.read(reinterpret_cast<char*>(&word), sizeof(word)))
+    {
+        words.push_back(word);
+    }
+
+    // Record times (ns) and source ports of each interface
+    std::map<uint32_t, std::vector<std::pair<uint64_t, uint16_t>>> records;
+    for (std::size_t i = 0; i + 1 < words.size(); i += words[i + 1] / 4)
+    {
+        NS_TEST_ASSERT_MSG_GT(words[i + 1], 0, "Invalid block length");
+        if (words[i] != PcapngFileWrapper::EPB_TYPE)
+        {
+            continue;
+        }
+        NS_TEST_ASSERT_MSG_EQ(words[i + 5], 2 + 20 + 20, "Only the headers should be stored");
+        NS_TEST_ASSERT_MSG_EQ(words[i + 6], 2 + 20 + 20 + 100, "Wrong original length");
+        const auto* frame = reinterpret_cast<const uint8_t*>(&words[i + 7]);
+        uint64_t t = (static_cast<uint64_t>(words[i + 3]) << 32) | words[i + 4];
+        uint16_t sport = (frame[22] << 8) | frame[23];
+        records[words[i + 2]].emplace_back(t, sport);
+    }
+
+    for (const auto& [id, ifaceRecords] : records)
+    {
+        NS_TEST_EXPECT_MSG_EQ((id == idA || id == idB), true, "Unknown interface " << id);
+        for (const auto& record : ifaceRecords)
+        {
+            NS_TEST_EXPECT_MSG_EQ(sampled.count(record.second),
+                                  1,
+                                  "Flow " << record.second << " should not be captured");
+        }
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(records[idA].size(),
+                          sampledPackets,
+                          "All the sampled packets should be captured without rate limit");
+
+    // Any run of records must fit in the bucket depth plus the tokens added
+    // since its first record, and the rate limit is reached over the test
+    const auto& limited = records[idB];
+    for (std::size_t i = 0; i < limited.size(); i++)
+    {
+        for (std::size_t j = i; j < limited.size(); j++)
+        {
+            double tokens = burst + (limited[j].first - limited[i].first) * 1e-9 * rate;
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(j - i + 1,
+                                        tokens + 1e-6,
+                                        "Records " << i << " to " << j << " exceed the rate limit");
+        }
+    }
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(limited.size(),
+                                nPackets / 1000 * rate,
+                                "The rate limit should be reached");
+    NS_TEST_EXPECT_MSG_LT(limited.size(),
+                          sampledPackets,
+                          "The rate limit should discard sampled packets");
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +778,10 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointBurstTest, TestCase::QUICK);
+    AddTestCase(new PointToPointBurstQueueTest, TestCase::QUICK);
+    AddTestCase(new PointToPointFastForwardTest, TestCase::QUICK);
+    AddTestCase(new PointToPointHeaderCaptureTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
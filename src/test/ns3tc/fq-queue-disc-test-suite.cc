@@ -0,0 +1,397 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/fq-queue-disc.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * Build an IPv4 queue disc item.
+ *
+ * \param source the source address, identifying the flow
+ * \param size the payload size
+ * \param rate the pacing rate carried by the packet (zero for none)
+ * \return the queue disc item
+ */
+static Ptr<Ipv4QueueDiscItem>
+CreateFqTestItem(Ipv4Address source, uint32_t size, DataRate rate = DataRate(0))
+{
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(size);
+    hdr.SetSource(source);
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    Ptr<Packet> p = Create<Packet>(size);
+    if (rate.GetBitRate() > 0)
+    {
+        SocketPacingRateTag tag;
+        tag.SetPacingRate(rate);
+        p->AddPacketTag(tag);
+    }
+    return Create<Ipv4QueueDiscItem>(p, Address(), 0, hdr);
+}
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * This class tests the flow separation and the packet limits of FqQueueDisc.
+ */
+class FqQueueDiscFlowsAndLimits : public TestCase
+{
+  public:
+    FqQueueDiscFlowsAndLimits();
+
+  private:
+    void DoRun() override;
+};
+
+FqQueueDiscFlowsAndLimits::FqQueueDiscFlowsAndLimits()
+    : TestCase("Test flows separation and packet limits")
+{
+}
+
+void
+FqQueueDiscFlowsAndLimits::DoRun()
+{
+    Ptr<FqQueueDisc> queueDisc = CreateObjectWithAttributes<FqQueueDisc>("MaxSize",
+                                                                         StringValue("5p"),
+                                                                         "FlowLimit",
+                                                                         UintegerValue(3),
+                                                                         "Quantum",
+                                                                         UintegerValue(1500),
+                                                                         "InitialQuantum",
+                                                                         UintegerValue(1500));
+    queueDisc->Initialize();
+
+    Ipv4Address first("10.10.1.1");
+    Ipv4Address second("10.10.1.3");
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        queueDisc->Enqueue(CreateFqTestItem(first, 100));
+    }
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 1, "Expected one flow");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNPackets(), 3, "The flow limit was not enforced");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(FqQueueDisc::FLOW_LIMIT_DROP),
+                          1,
+                          "Expected one drop due to the flow limit");
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        queueDisc->Enqueue(CreateFqTestItem(second, 100));
+    }
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 2, "Expected two flows");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNPackets(), 5, "The queue disc limit was not enforced");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(FqQueueDisc::OVERLIMIT_DROP),
+                          1,
+                          "Expected one drop due to the queue disc limit");
+
+    // The new flow is served first, then the flows alternate by quantum
+    Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+    NS_TEST_EXPECT_MSG_EQ(DynamicCast<Ipv4QueueDiscItem>(item)->GetHeader().GetSource(),
+                          first,
+                          "The first flow was the first new flow");
+    uint32_t packets = 1;
+    while (queueDisc->Dequeue())
+    {
+        packets++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(packets, 5, "Not all the packets were dequeued");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNThrottledFlows(), 0, "No flow should be paced");
+
+    queueDisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * This class tests that FqQueueDisc paces the packets carrying a pacing rate,
+ * and only those.
+ */
+class FqQueueDiscPacing : public TestCase
+{
+  public:
+    FqQueueDiscPacing();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record the transmission of a packet.
+     * \param item the packet
+     */
+    void Sent(Ptr<QueueDiscItem> item);
+
+    std::vector<Time> m_pacedTimes;   //!< Transmission times of the paced flow
+    std::vector<Time> m_unpacedTimes; //!< Transmission times of the unpaced flow
+};
+
+FqQueueDiscPacing::FqQueueDiscPacing()
+    : TestCase("Test the pacing of flows")
+{
+}
+
+void
+FqQueueDiscPacing::Sent(Ptr<QueueDiscItem> item)
+{
+    Ipv4Address source = DynamicCast<Ipv4QueueDiscItem>(item)->GetHeader().GetSource();
+    if (source == Ipv4Address("10.10.1.1"))
+    {
+        m_pacedTimes.push_back(Simulator::Now());
+    }
+    else
+    {
+        m_unpacedTimes.push_back(Simulator::Now());
+    }
+    SocketPacingRateTag tag;
+    NS_TEST_EXPECT_MSG_EQ(item->GetPacket()->PeekPacketTag(tag),
+                          false,
+                          "The pacing rate tag must not leave the node");
+}
+
+void
+FqQueueDiscPacing::DoRun()
+{
+    Ptr<FqQueueDisc> queueDisc = CreateObjectWithAttributes<FqQueueDisc>("Quantum",
+                                                                         UintegerValue(1500),
+                                                                         "InitialQuantum",
+                                                                         UintegerValue(1500));
+    queueDisc->SetSendCallback(MakeCallback(&FqQueueDiscPacing::Sent, this));
+    queueDisc->Initialize();
+
+    // 30 packets of 1020 bytes paced at 1 Mbps, 10 packets of an unpaced flow
+    DataRate rate("1Mbps");
+    const uint32_t nPaced = 30;
+    for (uint32_t i = 0; i < nPaced; i++)
+    {
+        queueDisc->Enqueue(CreateFqTestItem(Ipv4Address("10.10.1.1"), 1000, rate));
+    }
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        queueDisc->Enqueue(CreateFqTestItem(Ipv4Address("10.10.1.3"), 1000));
+    }
+    queueDisc->Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_unpacedTimes.size(), 10, "The unpaced flow should not be delayed");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNThrottledFlows(), 1, "The paced flow is throttled");
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_pacedTimes.size(), nPaced, "Not all the paced packets were sent");
+    // The flow sends its quantum back to back before being paced
+    NS_TEST_EXPECT_MSG_EQ(m_pacedTimes[1], Seconds(0), "The initial quantum is not paced");
+    NS_TEST_EXPECT_MSG_EQ(m_pacedTimes[2], rate.CalculateBytesTxTime(1500), "Wrong pacing delay");
+    // In the long run, the flow is sent at the pacing rate
+    double seconds = (m_pacedTimes.back() - m_pacedTimes[2]).GetSeconds();
+    double bps = (nPaced - 3) * 1020 * 8 / seconds;
+    NS_TEST_EXPECT_MSG_EQ_TOL(bps, rate.GetBitRate(), rate.GetBitRate() * 0.05, "Wrong rate");
+
+    queueDisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * This class checks that a paced TCP flow gets the same throughput when
+ * pacing is left to FqQueueDisc as with the pacing timer of the socket.
+ */
+class FqQueueDiscTcpPacing : public TestCase
+{
+  public:
+    FqQueueDiscTcpPacing();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run a bulk transfer
+     * \param queueDiscPacing whether pacing is left to FqQueueDisc
+     * \return the time the last byte was received
+     */
+    Time RunTransfer(bool queueDiscPacing);
+
+    /**
+     * \brief Accept a connection on the server.
+     * \param s the connected socket
+     * \param from the address of the client
+     */
+    void ServerAccept(Ptr<Socket> s, const Address& from);
+    /**
+     * \brief Read the data received by the server.
+     * \param s the socket
+     */
+    void ServerRecv(Ptr<Socket> s);
+    /**
+     * \brief Send data until the whole transfer has been queued.
+     * \param s the socket
+     * \param available the free space in the transmission buffer
+     */
+    void ClientSend(Ptr<Socket> s, uint32_t available);
+
+    static constexpr uint32_t TOTAL = 500000; //!< Bytes to transfer
+    uint32_t m_sent{0};                       //!< Bytes queued by the client
+    uint32_t m_received{0};                   //!< Bytes received by the server
+    Time m_lastRx;                            //!< Time of the last reception
+    Ptr<FqQueueDisc> m_fq;                    //!< The queue disc of the client
+    uint32_t m_maxThrottled{0};               //!< Maximum number of throttled flows seen
+};
+
+FqQueueDiscTcpPacing::FqQueueDiscTcpPacing()
+    : TestCase("Test a TCP flow paced by FqQueueDisc")
+{
+}
+
+void
+FqQueueDiscTcpPacing::ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    s->SetRecvCallback(MakeCallback(&FqQueueDiscTcpPacing::ServerRecv, this));
+}
+
+void
+FqQueueDiscTcpPacing::ServerRecv(Ptr<Socket> s)
+{
+    while (Ptr<Packet> p = s->Recv())
+    {
+        m_received += p->GetSize();
+        m_lastRx = Simulator::Now();
+    }
+    m_maxThrottled = std::max(m_maxThrottled, m_fq->GetNThrottledFlows());
+}
+
+void
+FqQueueDiscTcpPacing::ClientSend(Ptr<Socket> s, uint32_t available)
+{
+    while (m_sent < TOTAL && s->GetTxAvailable() > 0)
+    {
+        int ret = s->Send(Create<Packet>(std::min(TOTAL - m_sent, s->GetTxAvailable())));
+        if (ret <= 0)
+        {
+            break;
+        }
+        m_sent += ret;
+    }
+    if (m_sent == TOTAL)
+    {
+        s->Close();
+    }
+}
+
+Time
+FqQueueDiscTcpPacing::RunTransfer(bool queueDiscPacing)
+{
+    m_sent = 0;
+    m_received = 0;
+    m_maxThrottled = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer devices = simple.Install(nodes);
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        devices.Get(i)->SetMtu(1500);
+    }
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+    TrafficControlHelper tch;
+    tch.Uninstall(devices.Get(0));
+    tch.SetRootQueueDisc("ns3::FqQueueDisc");
+    m_fq = DynamicCast<FqQueueDisc>(tch.Install(devices.Get(0)).Get(0));
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), 80));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&FqQueueDiscTcpPacing::ServerAccept, this));
+
+    Ptr<Socket> client = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    client->SetAttribute("QueueDiscPacing", BooleanValue(queueDiscPacing));
+    client->SetSendCallback(MakeCallback(&FqQueueDiscTcpPacing::ClientSend, this));
+    client->Bind();
+    Simulator::Schedule(MilliSeconds(100),
+                        &Socket::Connect,
+                        client,
+                        InetSocketAddress(interfaces.GetAddress(1), 80));
+
+    Simulator::Stop(Seconds(20));
+    Simulator::Run();
+    Simulator::Destroy();
+    m_fq = nullptr;
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, TOTAL, "Not all the data was received");
+    return m_lastRx;
+}
+
+void
+FqQueueDiscTcpPacing::DoRun()
+{
+    Config::SetDefault("ns3::TcpSocketState::EnablePacing", BooleanValue(true));
+
+    Time timerEnd = RunTransfer(false);
+    Time fqEnd = RunTransfer(true);
+    NS_TEST_EXPECT_MSG_GT(m_maxThrottled, 0, "FqQueueDisc did not pace the flow");
+
+    NS_TEST_EXPECT_MSG_EQ_TOL(fqEnd.GetSeconds(),
+                              timerEnd.GetSeconds(),
+                              timerEnd.GetSeconds() * 0.05,
+                              "Pacing by FqQueueDisc changed the duration of the transfer");
+}
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * Fq queue disc test suite.
+ */
+class FqQueueDiscTestSuite : public TestSuite
+{
+  public:
+    FqQueueDiscTestSuite();
+};
+
+FqQueueDiscTestSuite::FqQueueDiscTestSuite()
+    : TestSuite("fq-queue-disc", UNIT)
+{
+    AddTestCase(new FqQueueDiscFlowsAndLimits, TestCase::QUICK);
+    AddTestCase(new FqQueueDiscPacing, TestCase::QUICK);
+    AddTestCase(new FqQueueDiscTcpPacing, TestCase::QUICK);
+}
+
+/// Do not forget to allocate an instance of this TestSuite.
+static FqQueueDiscTestSuite g_fqQueueDiscTestSuite;
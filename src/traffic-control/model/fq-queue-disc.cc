@@ -0,0 +1,493 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fq-queue-disc.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(FqFlow);
+
+TypeId
+FqFlow::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FqFlow")
+                            .SetParent<QueueDiscClass>()
+                            .SetGroupName("TrafficControl")
+                            .AddConstructor<FqFlow>();
+    return tid;
+}
+
+FqFlow::FqFlow()
+    : m_credit(0),
+      m_status(INACTIVE)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FqFlow::~FqFlow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqFlow::SetCredit(int32_t credit)
+{
+    NS_LOG_FUNCTION(this << credit);
+    m_credit = credit;
+}
+
+int32_t
+FqFlow::GetCredit() const
+{
+    return m_credit;
+}
+
+void
+FqFlow::IncreaseCredit(int32_t credit)
+{
+    NS_LOG_FUNCTION(this << credit);
+    m_credit += credit;
+}
+
+void
+FqFlow::SetStatus(FlowStatus status)
+{
+    NS_LOG_FUNCTION(this);
+    m_status = status;
+}
+
+FqFlow::FlowStatus
+FqFlow::GetStatus() const
+{
+    return m_status;
+}
+
+void
+FqFlow::SetTimeToSend(Time time)
+{
+    NS_LOG_FUNCTION(this << time);
+    m_timeToSend = time;
+}
+
+Time
+FqFlow::GetTimeToSend() const
+{
+    return m_timeToSend;
+}
+
+void
+FqFlow::SetInactiveSince(Time time)
+{
+    NS_LOG_FUNCTION(this << time);
+    m_inactiveSince = time;
+}
+
+Time
+FqFlow::GetInactiveSince() const
+{
+    return m_inactiveSince;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(FqQueueDisc);
+
+TypeId
+FqQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FqQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<FqQueueDisc>()
+            .AddAttribute("MaxSize",
+                          "The maximum number of packets accepted by this queue disc",
+                          QueueSizeValue(QueueSize("10000p")),
+                          MakeQueueSizeAccessor(&QueueDisc::SetMaxSize, &QueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("FlowLimit",
+                          "The maximum number of packets queued for a flow",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&FqQueueDisc::m_flowLimit),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Quantum",
+                          "The credit in bytes given to a flow at each round of the scheduling "
+                          "algorithm. Zero sets it to twice the MTU of the device.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FqQueueDisc::m_quantum),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("InitialQuantum",
+                          "The credit in bytes given to a new flow. Zero sets it to ten times "
+                          "the MTU of the device.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FqQueueDisc::m_initialQuantum),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Perturbation",
+                          "The salt used as an additional input to the hash function used to "
+                          "classify packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FqQueueDisc::m_perturbation),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EnablePacing",
+                          "True to space the packets of each flow according to its pacing rate",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&FqQueueDisc::m_enablePacing),
+                          MakeBooleanChecker())
+            .AddAttribute("MaxRate",
+                          "The maximum pacing rate of a flow. Zero means no limit, i.e., only "
+                          "the packets carrying the pacing rate of their socket are paced.",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&FqQueueDisc::m_maxRate),
+                          MakeDataRateChecker())
+            .AddAttribute("LowRateThreshold",
+                          "The pacing rate under which every packet of a flow is paced, instead "
+                          "of a quantum of bytes at a time",
+                          DataRateValue(DataRate("550Kbps")),
+                          MakeDataRateAccessor(&FqQueueDisc::m_lowRateThreshold),
+                          MakeDataRateChecker())
+            .AddAttribute("FlowRefillDelay",
+                          "The time a flow must have been inactive to get a new quantum when "
+                          "it becomes active again",
+                          TimeValue(MilliSeconds(40)),
+                          MakeTimeAccessor(&FqQueueDisc::m_refillDelay),
+                          MakeTimeChecker());
+    return tid;
+}
+
+FqQueueDisc::FqQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FqQueueDisc::~FqQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_watchdog.Cancel();
+    m_newFlows.clear();
+    m_oldFlows.clear();
+    m_throttledFlows.clear();
+    QueueDisc::DoDispose();
+}
+
+uint32_t
+FqQueueDisc::GetNThrottledFlows() const
+{
+    return m_throttledFlows.size();
+}
+
+bool
+FqQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    uint32_t flowHash;
+
+    if (GetNPacketFilters() == 0)
+    {
+        flowHash = item->Hash(m_perturbation);
+    }
+    else
+    {
+        int32_t ret = Classify(item);
+
+        if (ret != PacketFilter::PF_NO_MATCH)
+        {
+            flowHash = static_cast<uint32_t>(ret);
+        }
+        else
+        {
+            NS_LOG_ERROR("No filter has been able to classify this packet, drop it.");
+            DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+            return false;
+        }
+    }
+
+    if (GetCurrentSize() >= GetMaxSize())
+    {
+        NS_LOG_DEBUG("Queue disc full, drop the packet");
+        DropBeforeEnqueue(item, OVERLIMIT_DROP);
+        return false;
+    }
+
+    Ptr<FqFlow> flow;
+    auto it = m_flowsIndices.find(flowHash);
+    if (it == m_flowsIndices.end())
+    {
+        NS_LOG_DEBUG("Creating a new flow queue for flow hash " << flowHash);
+        flow = m_flowFactory.Create<FqFlow>();
+        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
+        qd->Initialize();
+        flow->SetQueueDisc(qd);
+        flow->SetCredit(m_initialQuantum);
+        AddQueueDiscClass(flow);
+
+        m_flowsIndices[flowHash] = GetNQueueDiscClasses() - 1;
+    }
+    else
+    {
+        flow = StaticCast<FqFlow>(GetQueueDiscClass(it->second));
+    }
+
+    if (flow->GetQueueDisc()->GetNPackets() >= m_flowLimit)
+    {
+        NS_LOG_DEBUG("Flow queue full, drop the packet");
+        DropBeforeEnqueue(item, FLOW_LIMIT_DROP);
+        return false;
+    }
+
+    if (flow->GetStatus() == FqFlow::INACTIVE)
+    {
+        flow->SetStatus(FqFlow::NEW_FLOW);
+        if (Simulator::Now() - flow->GetInactiveSince() > m_refillDelay)
+        {
+            flow->SetCredit(std::max<int32_t>(flow->GetCredit(), m_quantum));
+        }
+        m_newFlows.push_back(flow);
+    }
+
+    flow->GetQueueDisc()->Enqueue(item);
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << flowHash);
+
+    return true;
+}
+
+void
+FqQueueDisc::UnthrottleFlows(Time now)
+{
+    NS_LOG_FUNCTION(this << now);
+
+    while (!m_throttledFlows.empty() && m_throttledFlows.begin()->first <= now)
+    {
+        Ptr<FqFlow> flow = m_throttledFlows.begin()->second;
+        m_throttledFlows.erase(m_throttledFlows.begin());
+        flow->SetStatus(FqFlow::OLD_FLOW);
+        m_oldFlows.push_back(flow);
+    }
+}
+
+Ptr<QueueDiscItem>
+FqQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    UnthrottleFlows(now);
+
+    Ptr<FqFlow> flow;
+    Ptr<QueueDiscItem> item;
+
+    while (!item)
+    {
+        std::list<Ptr<FqFlow>>* head = &m_newFlows;
+        if (head->empty())
+        {
+            head = &m_oldFlows;
+        }
+        if (head->empty())
+        {
+            if (!m_throttledFlows.empty())
+            {
+                Time next = m_throttledFlows.begin()->first;
+                if (!m_watchdog.IsRunning() ||
+                    Simulator::GetDelayLeft(m_watchdog) > next - now)
+                {
+                    NS_LOG_DEBUG("No flow can send, wake up at " << next);
+                    m_watchdog.Cancel();
+                    m_watchdog = Simulator::Schedule(next - now, &QueueDisc::Run, this);
+                }
+            }
+            return nullptr;
+        }
+
+        flow = head->front();
+
+        if (flow->GetCredit() <= 0)
+        {
+            NS_LOG_DEBUG("Increase credit of the flow at the head of the list");
+            flow->IncreaseCredit(m_quantum);
+            flow->SetStatus(FqFlow::OLD_FLOW);
+            m_oldFlows.splice(m_oldFlows.end(), *head, head->begin());
+            continue;
+        }
+
+        if (flow->GetQueueDisc()->GetNPackets() == 0)
+        {
+            head->pop_front();
+            // a new flow that has emptied its queue goes through the old flows
+            // before becoming inactive, to prevent it from gaining priority again
+            if (head == &m_newFlows && !m_oldFlows.empty())
+            {
+                flow->SetStatus(FqFlow::OLD_FLOW);
+                m_oldFlows.push_back(flow);
+            }
+            else
+            {
+                flow->SetStatus(FqFlow::INACTIVE);
+                flow->SetInactiveSince(now);
+            }
+            continue;
+        }
+
+        if (now < flow->GetTimeToSend())
+        {
+            NS_LOG_DEBUG("Throttle the flow until " << flow->GetTimeToSend());
+            head->pop_front();
+            flow->SetStatus(FqFlow::THROTTLED);
+            m_throttledFlows.emplace(flow->GetTimeToSend(), flow);
+            continue;
+        }
+
+        item = flow->GetQueueDisc()->Dequeue();
+    }
+
+    NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+    flow->IncreaseCredit(-static_cast<int32_t>(item->GetSize()));
+
+    if (m_enablePacing)
+    {
+        PaceFlow(flow, item, now);
+    }
+
+    return item;
+}
+
+void
+FqQueueDisc::PaceFlow(Ptr<FqFlow> flow, Ptr<const QueueDiscItem> item, Time now)
+{
+    NS_LOG_FUNCTION(this << flow << item << now);
+
+    DataRate rate = m_maxRate;
+    SocketPacingRateTag tag;
+    if (item->GetPacket()->PeekPacketTag(tag) && tag.GetPacingRate().GetBitRate() > 0 &&
+        (rate.GetBitRate() == 0 || tag.GetPacingRate() < rate))
+    {
+        rate = tag.GetPacingRate();
+    }
+    if (rate.GetBitRate() == 0)
+    {
+        return;
+    }
+    NS_LOG_DEBUG("Pacing rate of the flow: " << rate);
+
+    uint32_t length = item->GetSize();
+    if (rate <= m_lowRateThreshold)
+    {
+        // pace every packet of slow flows
+        flow->SetCredit(0);
+    }
+    else
+    {
+        // send a quantum of bytes back to back before pacing the flow
+        length = std::max(length, m_quantum);
+        if (flow->GetCredit() > 0)
+        {
+            return;
+        }
+    }
+
+    Time delay = rate.CalculateBytesTxTime(length);
+    if (flow->GetTimeToSend().IsStrictlyPositive())
+    {
+        // recover (part of) the time the flow waited after its time to send
+        delay -= std::min(delay / 2, now - flow->GetTimeToSend());
+    }
+    flow->SetTimeToSend(now + delay);
+}
+
+bool
+FqQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("FqQueueDisc cannot have classes");
+        return false;
+    }
+
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("FqQueueDisc cannot have internal queues");
+        return false;
+    }
+
+    // we are at initialization time. If the user has not set the quantum values,
+    // set them according to the MTU of the device (if any)
+    uint32_t mtu = 0;
+    Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+    Ptr<NetDevice> dev;
+    // if the NetDeviceQueueInterface object is aggregated to a
+    // NetDevice, get the MTU of such NetDevice
+    if (ndqi && (dev = ndqi->GetObject<NetDevice>()))
+    {
+        mtu = dev->GetMtu();
+    }
+
+    if (!m_quantum)
+    {
+        m_quantum = 2 * mtu;
+        NS_LOG_DEBUG("Setting the quantum to twice the MTU of the device: " << m_quantum);
+    }
+    if (!m_initialQuantum)
+    {
+        m_initialQuantum = 10 * mtu;
+        NS_LOG_DEBUG("Setting the initial quantum to ten times the MTU of the device: "
+                     << m_initialQuantum);
+    }
+
+    if (!m_quantum || !m_initialQuantum)
+    {
+        NS_LOG_ERROR("The quantum parameters cannot be null");
+        return false;
+    }
+
+    if (GetMaxSize().GetUnit() != QueueSizeUnit::PACKETS)
+    {
+        NS_LOG_ERROR("The size of FqQueueDisc must be expressed in packets");
+        return false;
+    }
+    return true;
+}
+
+void
+FqQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_flowFactory.SetTypeId("ns3::FqFlow");
+
+    m_queueDiscFactory.SetTypeId("ns3::FifoQueueDisc");
+    m_queueDiscFactory.Set("MaxSize",
+                           QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, m_flowLimit)));
+}
+
+} // namespace ns3
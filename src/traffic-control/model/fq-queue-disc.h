@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_QUEUE_DISC_H
+#define FQ_QUEUE_DISC_H
+
+#include "queue-disc.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue used by the Fq queue disc
+ */
+class FqFlow : public QueueDiscClass
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FqFlow constructor
+     */
+    FqFlow();
+
+    ~FqFlow() override;
+
+    /**
+     * \enum FlowStatus
+     * \brief Used to determine the status of this flow queue
+     */
+    enum FlowStatus
+    {
+        INACTIVE,
+        NEW_FLOW,
+        OLD_FLOW,
+        THROTTLED
+    };
+
+    /**
+     * \brief Set the credit for this flow
+     * \param credit the credit for this flow
+     */
+    void SetCredit(int32_t credit);
+    /**
+     * \brief Get the credit for this flow
+     * \return the credit for this flow
+     */
+    int32_t GetCredit() const;
+    /**
+     * \brief Increase the credit for this flow
+     * \param credit the amount by which the credit is to be increased
+     */
+    void IncreaseCredit(int32_t credit);
+    /**
+     * \brief Set the status for this flow
+     * \param status the status for this flow
+     */
+    void SetStatus(FlowStatus status);
+    /**
+     * \brief Get the status of this flow
+     * \return the status of this flow
+     */
+    FlowStatus GetStatus() const;
+    /**
+     * \brief Set the earliest time the next packet of this flow can be sent
+     * \param time the time to send the next packet
+     */
+    void SetTimeToSend(Time time);
+    /**
+     * \brief Get the earliest time the next packet of this flow can be sent
+     * \return the time to send the next packet (zero if the flow was never paced)
+     */
+    Time GetTimeToSend() const;
+    /**
+     * \brief Set the time this flow became inactive
+     * \param time the time this flow became inactive
+     */
+    void SetInactiveSince(Time time);
+    /**
+     * \brief Get the time this flow became inactive
+     * \return the time this flow became inactive
+     */
+    Time GetInactiveSince() const;
+
+  private:
+    int32_t m_credit;     //!< the credit for this flow
+    FlowStatus m_status;  //!< the status of this flow
+    Time m_timeToSend;    //!< the earliest time to send the next packet
+    Time m_inactiveSince; //!< the time this flow became inactive
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A Fq (Fair Queue) packet queue disc, with per-flow pacing
+ *
+ * This is a model of the Linux fq qdisc. Packets are classified into flows
+ * by a hash of their five-tuple, and each flow has its own FIFO queue. Flows
+ * are served in a deficit round robin fashion, new flows first.
+ *
+ * When pacing is enabled, the packets of a flow are spaced according to the
+ * pacing rate of the socket that sent them (carried by a SocketPacingRateTag),
+ * capped by the MaxRate attribute. A flow whose next packet cannot be sent
+ * yet is throttled: it is moved out of the round robin lists and into a set
+ * of flows ordered by the time to send their next packet, and a single timer
+ * wakes the queue disc up when the earliest of them is due.
+ */
+class FqQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FqQueueDisc constructor
+     */
+    FqQueueDisc();
+
+    ~FqQueueDisc() override;
+
+    /**
+     * \brief Get the number of flows waiting for their time to send
+     * \return the number of throttled flows
+     */
+    uint32_t GetNThrottledFlows() const;
+
+    // Reasons for dropping packets
+    static constexpr const char* UNCLASSIFIED_DROP =
+        "Unclassified drop"; //!< No packet filter able to classify packet
+    static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Queue disc full
+    static constexpr const char* FLOW_LIMIT_DROP = "Flow limit drop"; //!< Flow queue full
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief Move the throttled flows whose time to send has come to the old flows
+     * \param now the current time
+     */
+    void UnthrottleFlows(Time now);
+
+    /**
+     * \brief Pace a flow after one of its packets has been dequeued
+     * \param flow the flow
+     * \param item the packet dequeued
+     * \param now the current time
+     */
+    void PaceFlow(Ptr<FqFlow> flow, Ptr<const QueueDiscItem> item, Time now);
+
+    uint32_t m_quantum;          //!< Credit assigned to flows at each round
+    uint32_t m_initialQuantum;   //!< Credit assigned to new flows
+    uint32_t m_flowLimit;        //!< Maximum number of packets of a flow queue
+    uint32_t m_perturbation;     //!< hash perturbation value
+    bool m_enablePacing;         //!< True if flows are paced
+    DataRate m_maxRate;          //!< Maximum pacing rate of a flow (zero for no limit)
+    DataRate m_lowRateThreshold; //!< Rate under which the packets of a flow are all paced
+    Time m_refillDelay;          //!< Time after which an inactive flow gets a new quantum
+
+    std::list<Ptr<FqFlow>> m_newFlows;                     //!< The list of new flows
+    std::list<Ptr<FqFlow>> m_oldFlows;                     //!< The list of old flows
+    std::multimap<Time, Ptr<FqFlow>> m_throttledFlows;     //!< Throttled flows by time to send
+    std::unordered_map<uint32_t, uint32_t> m_flowsIndices; //!< Class index of each flow hash
+    EventId m_watchdog;                                    //!< Run at the earliest time to send
+
+    ObjectFactory m_flowFactory;      //!< Factory to create a new flow
+    ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+};
+
+} // namespace ns3
+
+#endif /* FQ_QUEUE_DISC_H */
@@ -382,6 +382,7 @@ QueueDisc::DoDispose()
     m_devQueueIface = nullptr;
     m_send = nullptr;
     m_requeued = nullptr;
+    m_gsoSegments.clear();
     m_internalQueueDbeFunctor = nullptr;
     m_internalQueueDadFunctor = nullptr;
     m_childQueueDiscDbeFunctor = nullptr;
@@ -1024,6 +1025,17 @@ QueueDisc::DequeuePacket()
             }
         }
     }
+    // Then check if segments of the last dequeued GSO packet are left to transmit
+    else if (!m_gsoSegments.empty())
+    {
+        if (!m_devQueueIface ||
+            !m_devQueueIface->GetTxQueue(m_gsoSegments.back()->GetTxQueueIndex())->IsStopped())
+        {
+            item = m_gsoSegments.back();
+            m_gsoSegments.pop_back();
+            item->AddHeader();
+        }
+    }
     else
     {
         // If the device is multi-queue (actually, Linux checks if the queue disc has
@@ -1038,6 +1050,14 @@ QueueDisc::DequeuePacket()
             // If the item is not null, add the header to the packet.
             if (item)
             {
+                // Like Linux (validate_xmit_skb), split a GSO packet into the segments
+                // to transmit, which are then handed to the device one at a time
+                std::vector<Ptr<QueueDiscItem>> segments = item->GsoSegment();
+                if (!segments.empty())
+                {
+                    item = segments.front();
+                    m_gsoSegments.assign(segments.rbegin(), std::prev(segments.rend()));
+                }
                 item->AddHeader();
             }
             // Here, Linux tries bulk dequeues
@@ -1081,6 +1101,9 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
         SocketPriorityTag priorityTag;
         item->GetPacket()->RemovePacketTag(priorityTag);
     }
+    // the pacing rate is only meaningful to the queue discs of the sending node
+    SocketPacingRateTag pacingRateTag;
+    item->GetPacket()->RemovePacketTag(pacingRateTag);
     NS_ASSERT_MSG(m_send, "Send callback not set");
     m_send(item);
 
@@ -1098,10 +1121,11 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
     // of the value returned by NetDevice::Send does not match that of the value
     // returned by ndo_start_xmit.
 
-    // if the queue disc is empty or the device queue is now stopped, return false so
-    // that the Run method does not attempt to dequeue other packets and exits
+    // if the queue disc is empty (and no GSO segment is left) or the device queue is
+    // now stopped, return false so that the Run method does not attempt to dequeue
+    // other packets and exits
     return !(
-        GetNPackets() == 0 ||
+        (GetNPackets() == 0 && m_gsoSegments.empty()) ||
         (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped()));
 }
 
@@ -650,6 +650,8 @@ class QueueDisc : public Object
 
     /**
      * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
+     * A packet built by generic segmentation offload is split into its segments,
+     * which are returned by this and the following calls.
      * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
      */
     Ptr<QueueDiscItem> DequeuePacket();
@@ -702,6 +704,8 @@ class QueueDisc : public Object
     SendCallback m_send;           //!< Callback used to send a packet to the receiving object
     bool m_running;                //!< The queue disc is performing multiple dequeue operations
     Ptr<QueueDiscItem> m_requeued; //!< The last packet that failed to be transmitted
+    /// Segments of the last dequeued GSO packet not transmitted yet, in reverse order
+    std::vector<Ptr<QueueDiscItem>> m_gsoSegments;
     bool m_peeked;                 //!< A packet was dequeued because Peek was called
     std::string m_childQueueDiscDropMsg; //!< Reason why a packet was dropped by a child queue disc
     std::string m_childQueueDiscMarkMsg; //!< Reason why a packet was marked by a child queue disc
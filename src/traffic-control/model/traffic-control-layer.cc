@@ -390,21 +390,32 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
     if (ndi == m_netDevices.end() || !ndi->second.m_rootQueueDisc)
     {
         // The device has no attached queue disc, thus add the header to the packet and
-        // send it directly to the device if the selected queue is not stopped
-        item->AddHeader();
-        if (!devQueueIface || !devQueueIface->GetTxQueue(txq)->IsStopped())
+        // send it directly to the device if the selected queue is not stopped.
+        // A GSO packet is split into the segments to send
+        std::vector<Ptr<QueueDiscItem>> items = item->GsoSegment();
+        if (items.empty())
         {
-            // a single queue device makes no use of the priority tag
-            if (!devQueueIface || devQueueIface->GetNTxQueues() == 1)
-            {
-                SocketPriorityTag priorityTag;
-                item->GetPacket()->RemovePacketTag(priorityTag);
-            }
-            device->Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
+            items.push_back(item);
         }
-        else
+        for (auto& segment : items)
         {
-            m_dropped(item->GetPacket());
+            segment->AddHeader();
+            if (!devQueueIface || !devQueueIface->GetTxQueue(txq)->IsStopped())
+            {
+                // a single queue device makes no use of the priority tag
+                if (!devQueueIface || devQueueIface->GetNTxQueues() == 1)
+                {
+                    SocketPriorityTag priorityTag;
+                    segment->GetPacket()->RemovePacketTag(priorityTag);
+                }
+                SocketPacingRateTag pacingRateTag;
+                segment->GetPacket()->RemovePacketTag(pacingRateTag);
+                device->Send(segment->GetPacket(), segment->GetAddress(), segment->GetProtocol());
+            }
+            else
+            {
+                m_dropped(segment->GetPacket());
+            }
         }
     }
     else
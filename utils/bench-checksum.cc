@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark CRC32Calculate () and
+// Buffer::Iterator::CalculateIpChecksum () on 'n' packets of 'size' bytes,
+// against straightforward byte-at-a-time and word-at-a-time versions.
+// Sample usage:  ./ns3 run 'bench-checksum --n=1000000 --size=1500'
+
+#include "ns3/buffer.h"
+#include "ns3/command-line.h"
+#include "ns3/crc32.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Sink for the computed values, so that the computations are not optimized out
+static uint32_t g_result = 0;
+
+/**
+ * Table-driven CRC-32, one byte at a time
+ * \param data the bytes
+ * \param length the number of bytes
+ * \returns the CRC-32 of the bytes
+ */
+static uint32_t
+ByteCrc32(const uint8_t* data, uint32_t length)
+{
+    static std::vector<uint32_t> table;
+    if (table.empty())
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int b = 0; b < 8; b++)
+            {
+                c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+            }
+            table.push_back(c);
+        }
+    }
+    uint32_t crc = 0xffffffff;
+    while (length--)
+    {
+        crc = (crc >> 8) ^ table[(crc & 0xFF) ^ *data++];
+    }
+    return ~crc;
+}
+
+/**
+ * Internet checksum, reading one 16-bit word at a time from the iterator
+ * \param i the iterator
+ * \param size the number of bytes
+ * \returns the checksum
+ */
+static uint16_t
+WordChecksum(Buffer::Iterator i, uint16_t size)
+{
+    uint32_t sum = 0;
+    for (int j = 0; j < size / 2; j++)
+    {
+        sum += i.ReadU16();
+    }
+    if (size & 1)
+    {
+        sum += i.ReadU8();
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum;
+}
+
+/**
+ * \param n number of packets
+ * \param buffer the packet bytes
+ */
+static void
+benchCrc32(uint32_t n, const Buffer& buffer)
+{
+    const uint8_t* data = buffer.PeekData();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_result += CRC32Calculate(data, buffer.GetSize());
+    }
+}
+
+/**
+ * \param n number of packets
+ * \param buffer the packet bytes
+ */
+static void
+benchByteCrc32(uint32_t n, const Buffer& buffer)
+{
+    const uint8_t* data = buffer.PeekData();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_result += ByteCrc32(data, buffer.GetSize());
+    }
+}
+
+/**
+ * \param n number of packets
+ * \param buffer the packet bytes
+ */
+static void
+benchChecksum(uint32_t n, const Buffer& buffer)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_result += buffer.Begin().CalculateIpChecksum(buffer.GetSize());
+    }
+}
+
+/**
+ * \param n number of packets
+ * \param buffer the packet bytes
+ */
+static void
+benchWordChecksum(uint32_t n, const Buffer& buffer)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_result += WordChecksum(buffer.Begin(), buffer.GetSize());
+    }
+}
+
+/**
+ * Run a benchmark several times and report the best throughput.
+ *
+ * \param f the benchmark
+ * \param n number of packets
+ * \param buffer the packet bytes
+ * \param minIterations number of runs
+ * \param name the benchmark name
+ */
+static void
+runBench(void (*f)(uint32_t, const Buffer&),
+         uint32_t n,
+         const Buffer& buffer,
+         uint32_t minIterations,
+         const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        (*f)(n, buffer);
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    double ps = n;
+    ps *= 1000;
+    ps /= std::max<uint64_t>(minDelay, 1);
+    double mbps = ps * buffer.GetSize() / 1e6;
+    std::cout << ps << " packets/s, " << mbps << " MB/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    uint32_t size = 1500;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark CRC-32 and Internet checksum computation");
+    cmd.AddValue("n", "number of packets", n);
+    cmd.AddValue("size", "packet size (bytes)", size);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of packets must be specified "
+                  << "by command-line argument --n=(number of packets)" << std::endl;
+        exit(1);
+    }
+    if (size == 0 || size > 65535)
+    {
+        std::cerr << "Error-- packet size must be between 1 and 65535 bytes" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-checksum with n=" << n << " size=" << size << std::endl;
+
+    Buffer buffer;
+    buffer.AddAtStart(size);
+    Buffer::Iterator it = buffer.Begin();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        it.WriteU8(static_cast<uint8_t>(i * 7 + 3));
+    }
+
+    runBench(&benchCrc32, n, buffer, minIterations, "CRC32Calculate");
+    runBench(&benchByteCrc32, n, buffer, minIterations, "CRC-32 byte at a time");
+    runBench(&benchChecksum, n, buffer, minIterations, "CalculateIpChecksum");
+    runBench(&benchWordChecksum, n, buffer, minIterations, "checksum word at a time");
+    std::cout << "(" << g_result << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark Ipv4EndPointDemux lookups on a server
+// with a wildcard listener and 'endpoints' established connections, for
+// segments of established connections and for new connection requests.  A
+// linear scan of the end point list, which is what every lookup used to do,
+// is reported as a baseline.
+// Sample usage:  ./ns3 run 'bench-demux --n=1000000 --endpoints=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Local port of the server
+static const uint16_t SERVER_PORT = 80;
+
+/**
+ * \param i a connection index
+ * \return the address of the peer of the connection
+ */
+static Ipv4Address
+PeerAddress(uint32_t i)
+{
+    return Ipv4Address(0x0a010000 + i / 1000);
+}
+
+/**
+ * \param i a connection index
+ * \return the port of the peer of the connection
+ */
+static uint16_t
+PeerPort(uint32_t i)
+{
+    return 10000 + i % 1000;
+}
+
+/// Benchmark context
+struct Context
+{
+    Ipv4EndPointDemux demux;       //!< the demux under test
+    Ptr<Ipv4Interface> iface;      //!< the incoming interface
+    Ipv4Address local{"10.0.0.1"}; //!< the server address
+    uint32_t endpoints;            //!< number of established connections
+    uint64_t found{0};             //!< sink preventing the lookups from being optimized out
+};
+
+/**
+ * Look up segments of established connections.
+ * \param ctx the context
+ * \param n number of lookups
+ */
+static void
+benchEstablished(Context& ctx, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t c = (i * 7919) % ctx.endpoints;
+        ctx.found +=
+            ctx.demux.Lookup(ctx.local, SERVER_PORT, PeerAddress(c), PeerPort(c), ctx.iface)
+                .size();
+    }
+}
+
+/**
+ * Look up connection requests, which reach the listener.
+ * \param ctx the context
+ * \param n number of lookups
+ */
+static void
+benchListener(Context& ctx, uint32_t n)
+{
+    Ipv4Address peer("192.168.0.1");
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ctx.found +=
+            ctx.demux.Lookup(ctx.local, SERVER_PORT, peer, 1024 + i % 60000, ctx.iface).size();
+    }
+}
+
+/**
+ * Find established connections by scanning the end point list.
+ * \param ctx the context
+ * \param n number of lookups
+ */
+static void
+benchLinearScan(Context& ctx, uint32_t n)
+{
+    auto endPoints = ctx.demux.GetAllEndPoints();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t c = (i * 7919) % ctx.endpoints;
+        Ipv4Address peer = PeerAddress(c);
+        uint16_t peerPort = PeerPort(c);
+        for (auto endP : endPoints)
+        {
+            if (endP->GetLocalPort() == SERVER_PORT && endP->GetLocalAddress() == ctx.local &&
+                endP->GetPeerAddress() == peer && endP->GetPeerPort() == peerPort)
+            {
+                ctx.found++;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Run a benchmark several times and report the best throughput.
+ *
+ * \param f the benchmark
+ * \param ctx the context
+ * \param n number of lookups
+ * \param minIterations number of runs
+ * \param name the benchmark name
+ */
+static void
+runBench(void (*f)(Context&, uint32_t),
+         Context& ctx,
+         uint32_t n,
+         uint32_t minIterations,
+         const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        (*f)(ctx, n);
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    double ps = n;
+    ps *= 1000;
+    ps /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ps << " lookups/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    uint32_t endpoints = 10000;
+    uint32_t scanLookups = 10000;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark Ipv4EndPointDemux lookups with many established connections");
+    cmd.AddValue("n", "number of lookups", n);
+    cmd.AddValue("endpoints", "number of established connections", endpoints);
+    cmd.AddValue("scan-lookups", "number of lookups of the linear scan baseline", scanLookups);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0 || endpoints == 0)
+    {
+        std::cerr << "Error-- number of lookups must be specified "
+                  << "by command-line argument --n=(number of lookups)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-demux with n=" << n << " endpoints=" << endpoints << std::endl;
+
+    Context ctx;
+    ctx.endpoints = endpoints;
+    ctx.iface = CreateObject<Ipv4Interface>();
+    ctx.iface->AddAddress(Ipv4InterfaceAddress(ctx.local, Ipv4Mask("255.255.255.0")));
+    ctx.demux.Allocate(nullptr, SERVER_PORT);
+    for (uint32_t i = 0; i < endpoints; i++)
+    {
+        ctx.demux.Allocate(nullptr, ctx.local, SERVER_PORT, PeerAddress(i), PeerPort(i));
+    }
+
+    runBench(&benchEstablished, ctx, n, minIterations, "established");
+    runBench(&benchListener, ctx, n, minIterations, "listener");
+    runBench(&benchLinearScan, ctx, scanLookups, minIterations, "linear scan (baseline)");
+
+    return ctx.found > 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the computation of the global
+// routes, on a grid of routers or on a fat-tree of switches connected by
+// point-to-point links.  The wall clock time of PopulateRoutingTables () is
+// reported, for the given number of threads (see the GlobalRoutingThreads
+// global value).  Then random links are brought down and up again, and the
+// mean wall clock time of RecomputeRoutingTables () after each change is
+// reported, with the routes updated incrementally or not (see the
+// GlobalRoutingIncremental global value).
+// Sample usage:  ./ns3 run 'bench-global-routing --topology=fattree --k=8 --threads=4'
+//                ./ns3 run 'bench-global-routing --n=20 --toggles=10 --incremental=1'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <string>
+
+using namespace ns3;
+
+/**
+ * Connect two nodes with a point-to-point link, in a new subnet.
+ * \param a the first node
+ * \param b the second node
+ * \param helper the device helper
+ * \param ipv4 the address helper
+ */
+static void
+Connect(Ptr<Node> a, Ptr<Node> b, SimpleNetDeviceHelper& helper, Ipv4AddressHelper& ipv4)
+{
+    ipv4.Assign(helper.Install(NodeContainer(a, b)));
+    ipv4.NewNetwork();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string topology = "grid";
+    uint32_t n = 10;
+    uint32_t k = 4;
+    uint32_t threads = 1;
+    uint32_t toggles = 0;
+    bool incremental = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the computation of the global routes");
+    cmd.AddValue("topology", "grid or fattree", topology);
+    cmd.AddValue("n", "number of rows and columns of the grid", n);
+    cmd.AddValue("k", "number of ports of the fat-tree switches (even)", k);
+    cmd.AddValue("threads", "number of threads (0 for one per hardware thread)", threads);
+    cmd.AddValue("toggles", "number of links brought down and up", toggles);
+    cmd.AddValue("incremental", "update the routes incrementally", incremental);
+    cmd.Parse(argc, argv);
+
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(threads));
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(incremental));
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    InternetStackHelper internet;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    NodeContainer nodes;
+    uint32_t links = 0;
+
+    if (topology == "grid")
+    {
+        nodes.Create(n * n);
+        internet.Install(nodes);
+        for (uint32_t row = 0; row < n; row++)
+        {
+            for (uint32_t col = 0; col < n; col++)
+            {
+                if (col + 1 < n)
+                {
+                    Connect(nodes.Get(row * n + col), nodes.Get(row * n + col + 1), simple, ipv4);
+                    links++;
+                }
+                if (row + 1 < n)
+                {
+                    Connect(nodes.Get(row * n + col), nodes.Get((row + 1) * n + col), simple, ipv4);
+                    links++;
+                }
+            }
+        }
+    }
+    else if (topology == "fattree" && k >= 2 && k % 2 == 0)
+    {
+        uint32_t half = k / 2;
+        NodeContainer core;
+        core.Create(half * half);
+        internet.Install(core);
+        nodes.Add(core);
+        for (uint32_t pod = 0; pod < k; pod++)
+        {
+            NodeContainer aggregation;
+            aggregation.Create(half);
+            NodeContainer edge;
+            edge.Create(half);
+            nodes.Add(aggregation);
+            nodes.Add(edge);
+            internet.Install(aggregation);
+            internet.Install(edge);
+            for (uint32_t a = 0; a < half; a++)
+            {
+                for (uint32_t e = 0; e < half; e++)
+                {
+                    Connect(aggregation.Get(a), edge.Get(e), simple, ipv4);
+                    links++;
+                }
+            }
+            for (uint32_t a = 0; a < half; a++)
+            {
+                for (uint32_t c = 0; c < half; c++)
+                {
+                    Connect(aggregation.Get(a), core.Get(a * half + c), simple, ipv4);
+                    links++;
+                }
+            }
+        }
+    }
+    else
+    {
+        std::cerr << "Error-- unknown topology " << topology << " or odd k" << std::endl;
+        exit(1);
+    }
+
+    std::cout << "Running bench-global-routing with topology=" << topology
+              << " nodes=" << nodes.GetN() << " links=" << links << " threads=" << threads
+              << " toggles=" << toggles << " incremental=" << incremental << std::endl;
+
+    SystemWallClockMs time;
+    time.Start();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    int64_t elapsed = time.End();
+    std::cout << "Routes computed in " << elapsed << " ms" << std::endl;
+
+    if (toggles > 0)
+    {
+        Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+        elapsed = 0;
+        for (uint32_t i = 0; i < toggles; i++)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(rand->GetInteger(0, nodes.GetN() - 1))->GetObject<Ipv4>();
+            uint32_t interface = rand->GetInteger(1, ipv4->GetNInterfaces() - 1);
+            ipv4->SetDown(interface);
+            time.Start();
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+            elapsed += time.End();
+            ipv4->SetUp(interface);
+            time.Start();
+            Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+            elapsed += time.End();
+        }
+        std::cout << "Routes recomputed in " << static_cast<double>(elapsed) / (2 * toggles)
+                  << " ms per link change" << std::endl;
+    }
+    Simulator::Destroy();
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the population of the neighbor
+// caches of the hosts of a single LAN segment by NeighborCacheHelper, with
+// one entry per neighbor in the ARP cache of every host, then with a table
+// shared by all the caches of the channel (see
+// NeighborCacheHelper::SetSharedNeighborTable).  The setup time, the number
+// of entries and the time to resolve the address of a random neighbor are
+// reported for 100, 1000 and 5000 hosts.  The per-host entries grow with the
+// square of the number of hosts: they are only populated up to --maxPerHost.
+// Sample usage:  ./ns3 run 'bench-neighbor-cache --maxPerHost=5000'
+
+#include "ns3/arp-cache.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Populate the neighbor caches of the hosts of a LAN segment, and resolve
+ * the addresses of random neighbors.
+ * \param nHosts the number of hosts
+ * \param shared whether the hosts share a neighbor table
+ * \param nLookups the number of resolutions
+ */
+static void
+Run(uint32_t nHosts, bool shared, uint32_t nLookups)
+{
+    NodeContainer hosts;
+    hosts.Create(nHosts);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(hosts);
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simple;
+    NetDeviceContainer devices = simple.Install(hosts, channel);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.0.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    NeighborCacheHelper neighborCache;
+    neighborCache.SetSharedNeighborTable(shared);
+    SystemWallClockMs time;
+    time.Start();
+    neighborCache.PopulateNeighborCache(channel);
+    int64_t elapsed = time.End();
+
+    // Count the entries of the first host, the other ones hold as many
+    uint32_t entries = 0;
+    Ptr<ArpCache> cache = hosts.Get(0)->GetObject<Ipv4L3Protocol>()->GetInterface(1)->GetArpCache();
+    for (uint32_t i = 0; i < nHosts; i++)
+    {
+        entries += cache->Lookup(interfaces.GetAddress(i)) ? 1 : 0;
+    }
+    entries = shared ? nHosts : entries * nHosts;
+
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    Ptr<Packet> packet = Create<Packet>();
+    Ipv4Header header;
+    Address hardwareDestination;
+    uint32_t resolved = 0;
+    SystemWallClockMs lookupTime;
+    lookupTime.Start();
+    for (uint32_t i = 0; i < nLookups; i++)
+    {
+        uint32_t source = rand->GetInteger(0, nHosts - 1);
+        uint32_t dest = (source + rand->GetInteger(1, nHosts - 1)) % nHosts;
+        Ptr<Node> node = hosts.Get(source);
+        resolved += node->GetObject<ArpL3Protocol>()->Lookup(
+                        packet,
+                        header,
+                        interfaces.GetAddress(dest),
+                        devices.Get(source),
+                        node->GetObject<Ipv4L3Protocol>()->GetInterface(1)->GetArpCache(),
+                        &hardwareDestination)
+                        ? 1
+                        : 0;
+    }
+    int64_t lookupElapsed = std::max<int64_t>(lookupTime.End(), 1);
+
+    std::cout << (shared ? "  shared table:    " : "  per-host caches: ") << elapsed << " ms, "
+              << entries << " entries, " << lookupElapsed * 1e6 / nLookups
+              << " ns/resolution (" << resolved << "/" << nLookups << " resolved)" << std::endl;
+
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t maxPerHost = 1000;
+    uint32_t nLookups = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the population of the neighbor caches of a LAN segment");
+    cmd.AddValue("maxPerHost", "largest segment populated with per-host entries", maxPerHost);
+    cmd.AddValue("lookups", "number of address resolutions", nLookups);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-neighbor-cache with maxPerHost=" << maxPerHost
+              << " lookups=" << nLookups << std::endl;
+
+    for (uint32_t nHosts : {100, 1000, 5000})
+    {
+        std::cout << nHosts << " hosts" << std::endl;
+        if (nHosts <= maxPerHost)
+        {
+            Run(nHosts, false, nLookups);
+        }
+        else
+        {
+            std::cout << "  per-host caches: skipped" << std::endl;
+        }
+        Run(nHosts, true, nLookups);
+    }
+
+    return 0;
+}
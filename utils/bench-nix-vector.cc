@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the nix-vector routing between the
+// hosts of a fat-tree.  The routes between random pairs of hosts are looked
+// up with a breadth first search for each pair, then with the table of the
+// shortest paths between all the nodes (see the NixVectorPrecompute and
+// NixVectorThreads global values).  The wall clock time per lookup, the time
+// to compute the table and the memory it uses are reported.
+// Sample usage:  ./ns3 run 'bench-nix-vector --k=16 --pairs=1000 --threads=4'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Connect two nodes with a point-to-point link, in a new subnet.
+ * \param a the first node
+ * \param b the second node
+ * \param helper the device helper
+ * \param ipv4 the address helper
+ */
+static void
+Connect(Ptr<Node> a, Ptr<Node> b, SimpleNetDeviceHelper& helper, Ipv4AddressHelper& ipv4)
+{
+    ipv4.Assign(helper.Install(NodeContainer(a, b)));
+    ipv4.NewNetwork();
+}
+
+/**
+ * Look up the routes between pairs of hosts.
+ * \param hosts the hosts
+ * \param pairs the indexes of the source and destination hosts
+ * \param first the first pair
+ * \param routes the next hops of the routes, filled
+ * \return the wall clock time, in ms
+ */
+static int64_t
+LookUp(const NodeContainer& hosts,
+       const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+       std::size_t first,
+       std::vector<Ipv4Address>& routes)
+{
+    Ipv4Header header;
+    Socket::SocketErrno err;
+    SystemWallClockMs time;
+    time.Start();
+    for (std::size_t i = first; i < pairs.size(); i++)
+    {
+        Ptr<Ipv4> ipv4 = hosts.Get(pairs[i].first)->GetObject<Ipv4>();
+        header.SetDestination(
+            hosts.Get(pairs[i].second)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal());
+        Ptr<Ipv4Route> route =
+            ipv4->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, err);
+        routes[i] = route ? route->GetGateway() : Ipv4Address::GetAny();
+    }
+    return time.End();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t k = 8;
+    uint32_t nPairs = 1000;
+    uint32_t threads = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the nix-vector routing between the hosts of a fat-tree");
+    cmd.AddValue("k", "number of ports of the fat-tree switches (even)", k);
+    cmd.AddValue("pairs", "number of pairs of hosts", nPairs);
+    cmd.AddValue("threads", "number of threads (0 for one per hardware thread)", threads);
+    cmd.Parse(argc, argv);
+
+    if (k < 2 || k % 2 != 0 || nPairs == 0)
+    {
+        std::cerr << "Error-- odd k or no pairs" << std::endl;
+        exit(1);
+    }
+
+    Config::SetGlobal("NixVectorThreads", UintegerValue(threads));
+
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(nixRouting);
+    internet.SetIpv6StackInstall(false);
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+
+    // Each host has a single interface, on the link to its edge switch
+    uint32_t half = k / 2;
+    NodeContainer hosts;
+    hosts.Create(k * half * half);
+    NodeContainer switches;
+    switches.Create(half * half + k * k);
+    internet.Install(hosts);
+    internet.Install(switches);
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        uint32_t aggregation = half * half + pod * k;
+        uint32_t edge = aggregation + half;
+        for (uint32_t e = 0; e < half; e++)
+        {
+            for (uint32_t h = 0; h < half; h++)
+            {
+                Connect(hosts.Get((pod * half + e) * half + h),
+                        switches.Get(edge + e),
+                        simple,
+                        ipv4);
+            }
+        }
+        for (uint32_t a = 0; a < half; a++)
+        {
+            for (uint32_t e = 0; e < half; e++)
+            {
+                Connect(switches.Get(aggregation + a), switches.Get(edge + e), simple, ipv4);
+            }
+            for (uint32_t c = 0; c < half; c++)
+            {
+                Connect(switches.Get(aggregation + a), switches.Get(a * half + c), simple, ipv4);
+            }
+        }
+    }
+
+    std::cout << "Running bench-nix-vector with k=" << k << " hosts=" << hosts.GetN()
+              << " switches=" << switches.GetN() << " pairs=" << nPairs << " threads=" << threads
+              << std::endl;
+
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (uint32_t i = 0; i < nPairs; i++)
+    {
+        uint32_t source = rand->GetInteger(0, hosts.GetN() - 1);
+        uint32_t dest = (source + rand->GetInteger(1, hosts.GetN() - 1)) % hosts.GetN();
+        pairs.emplace_back(source, dest);
+    }
+
+    std::vector<Ipv4Address> bfsRoutes(nPairs);
+    int64_t elapsed = LookUp(hosts, pairs, 0, bfsRoutes);
+    double perPair = static_cast<double>(elapsed) / nPairs;
+    double allPairs = perPair * hosts.GetN() * (hosts.GetN() - 1) / 1000;
+    std::cout << "BFS for each pair" << std::endl;
+    std::cout << "  " << perPair << " ms/lookup, " << allPairs << " s for all the pairs of hosts"
+              << std::endl;
+
+    Config::SetGlobal("NixVectorPrecompute", BooleanValue(true));
+    Ptr<Ipv4NixVectorRouting> routing = hosts.Get(0)->GetObject<Ipv4NixVectorRouting>();
+    routing->FlushGlobalNixRoutingCache();
+    std::vector<Ipv4Address> tableRoutes(nPairs);
+    elapsed = LookUp(hosts, pairs, nPairs - 1, tableRoutes);
+    std::cout << "Table of the shortest paths" << std::endl;
+    std::cout << "  computed in " << elapsed << " ms, "
+              << routing->GetNixTableMemory() / (1024.0 * 1024.0) << " MB" << std::endl;
+    elapsed = LookUp(hosts, pairs, 0, tableRoutes);
+    std::cout << "  " << static_cast<double>(elapsed) / nPairs * 1000 << " us/lookup"
+              << std::endl;
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < nPairs; i++)
+    {
+        mismatches += bfsRoutes[i] != tableRoutes[i] ? 1 : 0;
+    }
+    std::cout << mismatches << " routes differ" << std::endl;
+
+    Simulator::Destroy();
+
+    return mismatches == 0 ? 0 : 1;
+}
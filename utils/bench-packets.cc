@@ -18,13 +18,16 @@
  */
 
 // This program can be used to benchmark packet serialization/deserialization
-// operations using Headers and Tags, for various numbers of packets 'n'
+// operations using Headers and Tags, for various numbers of packets 'n'.
+// The last benchmark uses the actual IPv4 and TCP headers.
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-header.h"
 
 #include <algorithm>
 #include <iostream>
@@ -350,6 +353,34 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchIpv4Tcp(uint32_t n)
+{
+    Ipv4Header ipv4;
+    ipv4.SetSource(Ipv4Address("10.0.0.1"));
+    ipv4.SetDestination(Ipv4Address("10.0.0.2"));
+    ipv4.SetProtocol(6);
+    ipv4.SetTtl(64);
+    ipv4.SetPayloadSize(1020);
+    TcpHeader tcp;
+    tcp.SetSourcePort(49153);
+    tcp.SetDestinationPort(80);
+    tcp.SetSequenceNumber(SequenceNumber32(1000));
+    tcp.SetAckNumber(SequenceNumber32(2000));
+    tcp.SetFlags(TcpHeader::ACK);
+    tcp.SetWindowSize(65535);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(tcp);
+        p->AddHeader(ipv4);
+        Ptr<Packet> o = p->Copy();
+        o->RemoveHeader(ipv4);
+        o->RemoveHeader(tcp);
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -407,6 +438,7 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchIpv4Tcp, n, minIterations, "Add and remove IPv4 and TCP headers");
 
     return 0;
 }
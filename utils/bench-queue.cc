@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the enqueue/dequeue throughput of
+// DropTailQueue<Packet> with the default RingBuffer container and with a
+// std::list container, for various numbers of enqueue/dequeue pairs 'n' and
+// standing queue occupancies 'backlog'.
+// Sample usage:  ./ns3 run 'bench-queue --n=10000000 --backlog=100'
+
+#include "ns3/command-line.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include "ns3/queue-size.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <stdlib.h> // for exit ()
+
+namespace ns3
+{
+
+/// std::list container, used as the baseline
+using PacketList = std::list<Ptr<Packet>>;
+
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(Queue, Packet, PacketList);
+NS_OBJECT_TEMPLATE_CLASS_TWO_DEFINE(DropTailQueue, Packet, PacketList);
+
+} // namespace ns3
+
+using namespace ns3;
+
+/**
+ * Perform enqueue/dequeue pairs on a queue holding a standing backlog.
+ *
+ * \tparam Q the queue type
+ * \param n number of enqueue/dequeue pairs
+ * \param backlog number of packets kept in the queue
+ */
+template <typename Q>
+static void
+bench(uint32_t n, uint32_t backlog)
+{
+    Ptr<Q> queue = CreateObject<Q>();
+    queue->SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, backlog + 1));
+    Ptr<Packet> p = Create<Packet>(1448);
+    for (uint32_t i = 0; i < backlog; i++)
+    {
+        queue->Enqueue(p);
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        queue->Enqueue(p);
+        queue->Dequeue();
+    }
+    queue->Dispose();
+}
+
+/**
+ * Run a benchmark several times and report the best throughput.
+ *
+ * \param f the benchmark
+ * \param n number of enqueue/dequeue pairs
+ * \param backlog number of packets kept in the queue
+ * \param minIterations number of runs
+ * \param name the benchmark name
+ */
+static void
+runBench(void (*f)(uint32_t, uint32_t),
+         uint32_t n,
+         uint32_t backlog,
+         uint32_t minIterations,
+         const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        (*f)(n, backlog);
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    double ps = n;
+    ps *= 1000;
+    ps /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ps << " pairs/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    uint32_t backlog = 100;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark enqueue/dequeue pairs on DropTailQueue containers");
+    cmd.AddValue("n", "number of enqueue/dequeue pairs", n);
+    cmd.AddValue("backlog", "number of packets standing in the queue", backlog);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of pairs must be specified "
+                  << "by command-line argument --n=(number of pairs)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-queue with n=" << n << " backlog=" << backlog << std::endl;
+
+    runBench(&bench<DropTailQueue<Packet>>, n, backlog, minIterations, "RingBuffer");
+    runBench(&bench<DropTailQueue<Packet, PacketList>>, n, backlog, minIterations, "std::list");
+
+    return 0;
+}
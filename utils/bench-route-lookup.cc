@@ -0,0 +1,200 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the route lookups of
+// Ipv4StaticRouting and Ipv4GlobalRouting in a large routing table, against
+// a linear scan of the same routes.  The time per lookup is reported.
+// Sample usage:  ./ns3 run 'bench-route-lookup --routes=10000 --lookups=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Number of interfaces of the router (besides the loopback)
+static const uint32_t INTERFACES = 4;
+
+/**
+ * Find the route to a destination by scanning all the routes, with the
+ * rules of Ipv4StaticRouting: longest prefix, then lowest metric.
+ * \param routes the routes, with their metric
+ * \param dest the destination
+ * \return the route, or nullptr
+ */
+static const Ipv4RoutingTableEntry*
+LinearLookup(const std::vector<std::pair<Ipv4RoutingTableEntry, uint32_t>>& routes,
+             Ipv4Address dest)
+{
+    const Ipv4RoutingTableEntry* result = nullptr;
+    uint16_t longestMask = 0;
+    uint32_t shortestMetric = 0xffffffff;
+    for (const auto& [route, metric] : routes)
+    {
+        Ipv4Mask mask = route.GetDestNetworkMask();
+        if (!mask.IsMatch(dest, route.GetDestNetwork()))
+        {
+            continue;
+        }
+        uint16_t masklen = mask.GetPrefixLength();
+        if (masklen < longestMask)
+        {
+            continue;
+        }
+        if (masklen > longestMask)
+        {
+            shortestMetric = 0xffffffff;
+        }
+        longestMask = masklen;
+        if (metric > shortestMetric)
+        {
+            continue;
+        }
+        shortestMetric = metric;
+        result = &route;
+    }
+    return result;
+}
+
+/**
+ * Time the lookups of a routing protocol.
+ * \param routing the routing protocol
+ * \param destinations the destinations to look up
+ * \return the time per lookup, in ns
+ */
+static double
+TimeLookups(Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address>& destinations)
+{
+    Ptr<Packet> p = Create<Packet>();
+    Ipv4Header header;
+    Socket::SocketErrno err;
+    uint32_t found = 0;
+    SystemWallClockMs time;
+    time.Start();
+    for (const auto& dest : destinations)
+    {
+        header.SetDestination(dest);
+        found += routing->RouteOutput(p, header, nullptr, err) ? 1 : 0;
+    }
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+    std::cout << "  " << found << " routes found" << std::endl;
+    return elapsed * 1e6 / destinations.size();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nRoutes = 10000;
+    uint32_t nLookups = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the route lookups in a large routing table");
+    cmd.AddValue("routes", "number of routes", nRoutes);
+    cmd.AddValue("lookups", "number of lookups", nLookups);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-route-lookup with routes=" << nRoutes << " lookups=" << nLookups
+              << std::endl;
+
+    NodeContainer nodes;
+    nodes.Create(INTERFACES + 1);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simple;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("192.168.0.0", "255.255.255.0");
+    for (uint32_t i = 1; i <= INTERFACES; i++)
+    {
+        ipv4.Assign(simple.Install(NodeContainer(nodes.Get(0), nodes.Get(i))));
+        ipv4.NewNetwork();
+    }
+    Ptr<Ipv4> router = nodes.Get(0)->GetObject<Ipv4>();
+    Ipv4StaticRoutingHelper staticHelper;
+    Ptr<Ipv4StaticRouting> staticRouting = staticHelper.GetStaticRouting(router);
+    Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting>();
+    globalRouting->SetIpv4(router);
+
+    // Routes to /16 to /28 networks in 10.0.0.0/8, and a default route
+    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+    std::vector<std::pair<Ipv4RoutingTableEntry, uint32_t>> routes;
+    for (uint32_t i = 0; i < nRoutes; i++)
+    {
+        uint32_t length = rand->GetInteger(16, 28);
+        Ipv4Mask mask(0xffffffff << (32 - length));
+        Ipv4Address network((0x0a000000 | rand->GetInteger(0, 0xffffff)) & mask.Get());
+        uint32_t interface = rand->GetInteger(1, INTERFACES);
+        Ipv4Address gateway(0xc0a80000 | ((interface - 1) << 8) | 2);
+        uint32_t metric = rand->GetInteger(0, 3);
+        staticRouting->AddNetworkRouteTo(network, mask, gateway, interface, metric);
+        globalRouting->AddNetworkRouteTo(network, mask, gateway, interface);
+        routes.emplace_back(
+            Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, mask, gateway, interface),
+            metric);
+    }
+    staticRouting->SetDefaultRoute("192.168.0.2", 1);
+    routes.emplace_back(Ipv4RoutingTableEntry::CreateNetworkRouteTo(Ipv4Address::GetZero(),
+                                                                    Ipv4Mask::GetZero(),
+                                                                    "192.168.0.2",
+                                                                    1),
+                        0);
+
+    // Half of the destinations are in the routed networks
+    std::vector<Ipv4Address> destinations;
+    for (uint32_t i = 0; i < nLookups; i++)
+    {
+        uint32_t prefix = i % 2 ? 0x0a000000 : rand->GetInteger(0, 0xff) << 24;
+        destinations.emplace_back(prefix | rand->GetInteger(0, 0xffffff));
+    }
+
+    std::cout << "Ipv4StaticRouting" << std::endl;
+    double staticNs = TimeLookups(staticRouting, destinations);
+    std::cout << "  " << staticNs << " ns/lookup" << std::endl;
+
+    std::cout << "Ipv4GlobalRouting" << std::endl;
+    double globalNs = TimeLookups(globalRouting, destinations);
+    std::cout << "  " << globalNs << " ns/lookup" << std::endl;
+
+    // The linear scan is much slower: time a fraction of the lookups
+    uint32_t nLinear = std::max<uint32_t>(nLookups / std::max<uint32_t>(nRoutes / 100, 1), 1);
+    uint32_t found = 0;
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < nLinear; i++)
+    {
+        found += LinearLookup(routes, destinations[i]) ? 1 : 0;
+    }
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+    std::cout << "Linear scan (" << nLinear << " lookups)" << std::endl;
+    std::cout << "  " << found << " routes found" << std::endl;
+    std::cout << "  " << elapsed * 1e6 / nLinear << " ns/lookup" << std::endl;
+
+    globalRouting->Dispose();
+    Simulator::Destroy();
+
+    return 0;
+}
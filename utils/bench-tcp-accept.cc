@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the connection setup of TCP, with a
+// server accepting short HTTP-style connections: each client connection sends
+// a request, the server answers and closes the connection.  The rate of the
+// connections is reported per second of wall clock time.
+// Sample usage:  ./ns3 run 'bench-tcp-accept --n=100000'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-socket-factory.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Port of the server
+static const uint16_t SERVER_PORT = 80;
+/// Size of the requests
+static const uint32_t REQUEST_SIZE = 100;
+/// Size of the responses
+static const uint32_t RESPONSE_SIZE = 1000;
+
+/// Benchmark context
+struct Context
+{
+    Ptr<Node> client;        //!< the client node
+    Address server;          //!< the address of the server
+    uint32_t opened{0};      //!< connections opened by the client
+    uint32_t accepted{0};    //!< connections accepted by the server
+    uint32_t completed{0};   //!< responses fully received by the client
+    Time interval;           //!< interval between new connections
+    uint32_t connections{0}; //!< number of connections to open
+};
+
+/// The context of the running benchmark
+static Context g_ctx;
+
+/**
+ * Receive a request, send the response and close the connection.
+ * \param s the server socket
+ */
+static void
+ServerRecv(Ptr<Socket> s)
+{
+    while (s->Recv())
+    {
+    }
+    s->Send(Create<Packet>(RESPONSE_SIZE));
+    s->Close();
+}
+
+/**
+ * Accept a connection.
+ * \param s the server socket
+ * \param from the address of the client
+ */
+static void
+ServerAccept(Ptr<Socket> s, const Address& from)
+{
+    g_ctx.accepted++;
+    s->SetRecvCallback(MakeCallback(&ServerRecv));
+}
+
+/**
+ * Send the request once connected.
+ * \param s the client socket
+ */
+static void
+ClientConnected(Ptr<Socket> s)
+{
+    s->Send(Create<Packet>(REQUEST_SIZE));
+}
+
+/**
+ * Read the response.
+ * \param s the client socket
+ */
+static void
+ClientRecv(Ptr<Socket> s)
+{
+    while (s->Recv())
+    {
+    }
+}
+
+/**
+ * Close the connection once the server has closed it.
+ * \param s the client socket
+ */
+static void
+ClientPeerClosed(Ptr<Socket> s)
+{
+    g_ctx.completed++;
+    s->Close();
+}
+
+/**
+ * Open a client connection, and schedule the next one.
+ */
+static void
+OpenConnection()
+{
+    Ptr<Socket> s = Socket::CreateSocket(g_ctx.client, TcpSocketFactory::GetTypeId());
+    s->SetConnectCallback(MakeCallback(&ClientConnected),
+                          MakeNullCallback<void, Ptr<Socket>>());
+    s->SetRecvCallback(MakeCallback(&ClientRecv));
+    s->SetCloseCallbacks(MakeCallback(&ClientPeerClosed), MakeNullCallback<void, Ptr<Socket>>());
+    s->Bind();
+    s->Connect(g_ctx.server);
+    if (++g_ctx.opened < g_ctx.connections)
+    {
+        Simulator::Schedule(g_ctx.interval, &OpenConnection);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    Time interval = MicroSeconds(20);
+    bool socketTemplates = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the setup of short TCP connections to a server");
+    cmd.AddValue("n", "number of connections", n);
+    cmd.AddValue("interval", "simulated time between new connections", interval);
+    cmd.AddValue("templates", "create the sockets from template sockets", socketTemplates);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of connections must be specified "
+                  << "by command-line argument --n=(number of connections)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-tcp-accept with n=" << n << " interval=" << interval.As(Time::US)
+              << " templates=" << socketTemplates << std::endl;
+    Config::SetDefault("ns3::TcpL4Protocol::SocketTemplates", BooleanValue(socketTemplates));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Gbps")));
+    simple.SetChannelAttribute("Delay", TimeValue(MicroSeconds(100)));
+    NetDeviceContainer devices = simple.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    Ptr<Socket> server = Socket::CreateSocket(nodes.Get(1), TcpSocketFactory::GetTypeId());
+    server->Bind(InetSocketAddress(Ipv4Address::GetAny(), SERVER_PORT));
+    server->Listen();
+    server->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                              MakeCallback(&ServerAccept));
+
+    g_ctx.client = nodes.Get(0);
+    g_ctx.server = InetSocketAddress(interfaces.GetAddress(1), SERVER_PORT);
+    g_ctx.interval = interval;
+    g_ctx.connections = n;
+    Simulator::Schedule(Seconds(1), &OpenConnection);
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    uint64_t elapsed = std::max<int64_t>(time.End(), 1);
+    Simulator::Destroy();
+
+    double cps = g_ctx.accepted;
+    cps *= 1000;
+    cps /= elapsed;
+    std::cout << cps << " connections/s (" << elapsed << " ms elapsed, " << g_ctx.accepted
+              << " accepted, " << g_ctx.completed << " completed)" << std::endl;
+
+    return g_ctx.completed == n ? 0 : 1;
+}